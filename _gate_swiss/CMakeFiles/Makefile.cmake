@@ -0,0 +1,104 @@
+# CMAKE generated file: DO NOT EDIT!
+# Generated by "Unix Makefiles" Generator, CMake Version 3.25
+
+# The generator used is:
+set(CMAKE_DEPENDS_GENERATOR "Unix Makefiles")
+
+# The top level Makefile was generated from the following files:
+set(CMAKE_MAKEFILE_DEPENDS
+  "CMakeCache.txt"
+  "/root/repo/.git/HEAD"
+  "/root/repo/.git/refs/heads/master"
+  "/root/repo/CMake/AddCXXCompilerFlag.cmake"
+  "/root/repo/CMake/FindAtomics.cmake"
+  "/root/repo/CMake/GetGitRevisionDescription.cmake"
+  "/root/repo/CMake/GetGitRevisionDescription.cmake.in"
+  "/root/repo/CMake/PreventInSourceBuild.cmake"
+  "/root/repo/CMake/TdSetUpCompiler.cmake"
+  "/root/repo/CMake/illumos.cmake"
+  "/root/repo/CMakeLists.txt"
+  "CMakeFiles/3.25.1/CMakeCCompiler.cmake"
+  "CMakeFiles/3.25.1/CMakeCXXCompiler.cmake"
+  "CMakeFiles/3.25.1/CMakeSystem.cmake"
+  "CMakeFiles/git-data/grabRef.cmake"
+  "/root/repo/td/generate/CMakeLists.txt"
+  "/root/repo/td/generate/tl-parser/CMakeLists.txt"
+  "/root/repo/td/telegram/GitCommitHash.cpp.in"
+  "/root/repo/tdtl/CMakeLists.txt"
+  "/root/repo/tdutils/CMakeLists.txt"
+  "/root/repo/tdutils/generate/CMakeLists.txt"
+  "/root/repo/tdutils/td/utils/config.h.in"
+  "/usr/share/cmake-3.25/Modules/CMakeCInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeCXXInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeCheckCompilerFlagCommonPatterns.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeCommonLanguageInclude.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeGenericSystem.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeInitializeConfigs.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeLanguageInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeSystemSpecificInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeSystemSpecificInitialize.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckCSourceCompiles.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckCXXCompilerFlag.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckCXXSourceCompiles.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckIncludeFile.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckLibraryExists.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/CMakeCommonCompilerMacros.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/GNU-C.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/GNU-CXX.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/GNU.cmake"
+  "/usr/share/cmake-3.25/Modules/FindGit.cmake"
+  "/usr/share/cmake-3.25/Modules/FindOpenSSL.cmake"
+  "/usr/share/cmake-3.25/Modules/FindPackageHandleStandardArgs.cmake"
+  "/usr/share/cmake-3.25/Modules/FindPackageMessage.cmake"
+  "/usr/share/cmake-3.25/Modules/FindPkgConfig.cmake"
+  "/usr/share/cmake-3.25/Modules/FindThreads.cmake"
+  "/usr/share/cmake-3.25/Modules/FindZLIB.cmake"
+  "/usr/share/cmake-3.25/Modules/Internal/CheckCompilerFlag.cmake"
+  "/usr/share/cmake-3.25/Modules/Internal/CheckFlagCommonConfig.cmake"
+  "/usr/share/cmake-3.25/Modules/Internal/CheckSourceCompiles.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux-GNU-C.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux-GNU-CXX.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux-GNU.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/UnixPaths.cmake"
+  "/usr/share/cmake-3.25/Modules/SelectLibraryConfigurations.cmake"
+  )
+
+# The corresponding makefile is:
+set(CMAKE_MAKEFILE_OUTPUTS
+  "Makefile"
+  "CMakeFiles/cmake.check_cache"
+  )
+
+# Byproducts of CMake generate step:
+set(CMAKE_MAKEFILE_PRODUCTS
+  "CMakeFiles/git-data/HEAD"
+  "CMakeFiles/git-data/grabRef.cmake"
+  "CMakeFiles/git-data/head-ref"
+  "td/telegram/GitCommitHash.cpp"
+  "CMakeFiles/CMakeDirectoryInformation.cmake"
+  "tdtl/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "tdutils/td/utils/config.h"
+  "tdutils/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "tdutils/generate/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "td/generate/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "td/generate/tl-parser/CMakeFiles/CMakeDirectoryInformation.cmake"
+  )
+
+# Dependency information for all targets:
+set(CMAKE_DEPEND_INFO_FILES
+  "CMakeFiles/prepare_cross_compiling.dir/DependInfo.cmake"
+  "tdtl/CMakeFiles/tdtl.dir/DependInfo.cmake"
+  "tdutils/CMakeFiles/tdutils.dir/DependInfo.cmake"
+  "tdutils/CMakeFiles/binary_log_dump.dir/DependInfo.cmake"
+  "td/generate/CMakeFiles/tl_generate_tlo.dir/DependInfo.cmake"
+  "td/generate/CMakeFiles/generate_common.dir/DependInfo.cmake"
+  "td/generate/CMakeFiles/tl_generate_common.dir/DependInfo.cmake"
+  "td/generate/CMakeFiles/generate_c.dir/DependInfo.cmake"
+  "td/generate/CMakeFiles/tl_generate_c.dir/DependInfo.cmake"
+  "td/generate/CMakeFiles/td_generate_java_api.dir/DependInfo.cmake"
+  "td/generate/CMakeFiles/generate_json.dir/DependInfo.cmake"
+  "td/generate/CMakeFiles/tl_generate_json.dir/DependInfo.cmake"
+  "td/generate/CMakeFiles/remove_documentation.dir/DependInfo.cmake"
+  "td/generate/tl-parser/CMakeFiles/tl-parser.dir/DependInfo.cmake"
+  )
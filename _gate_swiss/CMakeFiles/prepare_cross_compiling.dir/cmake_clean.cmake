@@ -0,0 +1,8 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/prepare_cross_compiling"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang )
+  include(CMakeFiles/prepare_cross_compiling.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
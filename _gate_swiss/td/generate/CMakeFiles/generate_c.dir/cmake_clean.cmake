@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/generate_c.dir/generate_c.cpp.o"
+  "CMakeFiles/generate_c.dir/generate_c.cpp.o.d"
+  "generate_c"
+  "generate_c.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/generate_c.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,27 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/td/generate/generate_common.cpp" "td/generate/CMakeFiles/generate_common.dir/generate_common.cpp.o" "gcc" "td/generate/CMakeFiles/generate_common.dir/generate_common.cpp.o.d"
+  "/root/repo/td/generate/tl_object_copier.cpp" "td/generate/CMakeFiles/generate_common.dir/tl_object_copier.cpp.o" "gcc" "td/generate/CMakeFiles/generate_common.dir/tl_object_copier.cpp.o.d"
+  "/root/repo/td/generate/tl_writer_cpp.cpp" "td/generate/CMakeFiles/generate_common.dir/tl_writer_cpp.cpp.o" "gcc" "td/generate/CMakeFiles/generate_common.dir/tl_writer_cpp.cpp.o.d"
+  "/root/repo/td/generate/tl_writer_h.cpp" "td/generate/CMakeFiles/generate_common.dir/tl_writer_h.cpp.o" "gcc" "td/generate/CMakeFiles/generate_common.dir/tl_writer_h.cpp.o.d"
+  "/root/repo/td/generate/tl_writer_hpp.cpp" "td/generate/CMakeFiles/generate_common.dir/tl_writer_hpp.cpp.o" "gcc" "td/generate/CMakeFiles/generate_common.dir/tl_writer_hpp.cpp.o.d"
+  "/root/repo/td/generate/tl_writer_jni_cpp.cpp" "td/generate/CMakeFiles/generate_common.dir/tl_writer_jni_cpp.cpp.o" "gcc" "td/generate/CMakeFiles/generate_common.dir/tl_writer_jni_cpp.cpp.o.d"
+  "/root/repo/td/generate/tl_writer_jni_h.cpp" "td/generate/CMakeFiles/generate_common.dir/tl_writer_jni_h.cpp.o" "gcc" "td/generate/CMakeFiles/generate_common.dir/tl_writer_jni_h.cpp.o.d"
+  "/root/repo/td/generate/tl_writer_td.cpp" "td/generate/CMakeFiles/generate_common.dir/tl_writer_td.cpp.o" "gcc" "td/generate/CMakeFiles/generate_common.dir/tl_writer_td.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_gate_swiss/tdtl/CMakeFiles/tdtl.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
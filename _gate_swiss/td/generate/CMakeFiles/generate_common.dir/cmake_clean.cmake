@@ -0,0 +1,25 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/generate_common.dir/generate_common.cpp.o"
+  "CMakeFiles/generate_common.dir/generate_common.cpp.o.d"
+  "CMakeFiles/generate_common.dir/tl_object_copier.cpp.o"
+  "CMakeFiles/generate_common.dir/tl_object_copier.cpp.o.d"
+  "CMakeFiles/generate_common.dir/tl_writer_cpp.cpp.o"
+  "CMakeFiles/generate_common.dir/tl_writer_cpp.cpp.o.d"
+  "CMakeFiles/generate_common.dir/tl_writer_h.cpp.o"
+  "CMakeFiles/generate_common.dir/tl_writer_h.cpp.o.d"
+  "CMakeFiles/generate_common.dir/tl_writer_hpp.cpp.o"
+  "CMakeFiles/generate_common.dir/tl_writer_hpp.cpp.o.d"
+  "CMakeFiles/generate_common.dir/tl_writer_jni_cpp.cpp.o"
+  "CMakeFiles/generate_common.dir/tl_writer_jni_cpp.cpp.o.d"
+  "CMakeFiles/generate_common.dir/tl_writer_jni_h.cpp.o"
+  "CMakeFiles/generate_common.dir/tl_writer_jni_h.cpp.o.d"
+  "CMakeFiles/generate_common.dir/tl_writer_td.cpp.o"
+  "CMakeFiles/generate_common.dir/tl_writer_td.cpp.o.d"
+  "generate_common"
+  "generate_common.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/generate_common.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
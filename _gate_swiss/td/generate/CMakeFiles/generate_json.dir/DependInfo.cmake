@@ -0,0 +1,22 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/td/generate/generate_json.cpp" "td/generate/CMakeFiles/generate_json.dir/generate_json.cpp.o" "gcc" "td/generate/CMakeFiles/generate_json.dir/generate_json.cpp.o.d"
+  "/root/repo/td/generate/tl_json_converter.cpp" "td/generate/CMakeFiles/generate_json.dir/tl_json_converter.cpp.o" "gcc" "td/generate/CMakeFiles/generate_json.dir/tl_json_converter.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_gate_swiss/tdtl/CMakeFiles/tdtl.dir/DependInfo.cmake"
+  "/root/repo/_gate_swiss/tdutils/CMakeFiles/tdutils.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
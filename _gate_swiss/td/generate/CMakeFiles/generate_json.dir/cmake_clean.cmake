@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/generate_json.dir/generate_json.cpp.o"
+  "CMakeFiles/generate_json.dir/generate_json.cpp.o.d"
+  "CMakeFiles/generate_json.dir/tl_json_converter.cpp.o"
+  "CMakeFiles/generate_json.dir/tl_json_converter.cpp.o.d"
+  "generate_json"
+  "generate_json.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/generate_json.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
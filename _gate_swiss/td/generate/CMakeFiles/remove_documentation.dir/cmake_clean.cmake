@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/remove_documentation.dir/remove_documentation.cpp.o"
+  "CMakeFiles/remove_documentation.dir/remove_documentation.cpp.o.d"
+  "remove_documentation"
+  "remove_documentation.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/remove_documentation.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
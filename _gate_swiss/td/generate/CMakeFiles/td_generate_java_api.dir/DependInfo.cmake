@@ -0,0 +1,21 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/td/generate/generate_java.cpp" "td/generate/CMakeFiles/td_generate_java_api.dir/generate_java.cpp.o" "gcc" "td/generate/CMakeFiles/td_generate_java_api.dir/generate_java.cpp.o.d"
+  "/root/repo/td/generate/tl_writer_java.cpp" "td/generate/CMakeFiles/td_generate_java_api.dir/tl_writer_java.cpp.o" "gcc" "td/generate/CMakeFiles/td_generate_java_api.dir/tl_writer_java.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_gate_swiss/tdtl/CMakeFiles/tdtl.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/td_generate_java_api.dir/generate_java.cpp.o"
+  "CMakeFiles/td_generate_java_api.dir/generate_java.cpp.o.d"
+  "CMakeFiles/td_generate_java_api.dir/tl_writer_java.cpp.o"
+  "CMakeFiles/td_generate_java_api.dir/tl_writer_java.cpp.o.d"
+  "td_generate_java_api"
+  "td_generate_java_api.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/td_generate_java_api.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
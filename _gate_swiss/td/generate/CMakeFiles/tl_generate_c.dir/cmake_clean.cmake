@@ -0,0 +1,8 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/tl_generate_c"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang )
+  include(CMakeFiles/tl_generate_c.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,8 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/tl_generate_json"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang )
+  include(CMakeFiles/tl_generate_json.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
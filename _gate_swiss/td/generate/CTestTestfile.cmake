@@ -0,0 +1,7 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/td/generate
+# Build directory: /root/repo/_gate_swiss/td/generate
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+subdirs("tl-parser")
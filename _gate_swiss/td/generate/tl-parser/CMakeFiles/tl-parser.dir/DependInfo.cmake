@@ -0,0 +1,21 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/td/generate/tl-parser/crc32.c" "td/generate/tl-parser/CMakeFiles/tl-parser.dir/crc32.c.o" "gcc" "td/generate/tl-parser/CMakeFiles/tl-parser.dir/crc32.c.o.d"
+  "/root/repo/td/generate/tl-parser/tl-parser.c" "td/generate/tl-parser/CMakeFiles/tl-parser.dir/tl-parser.c.o" "gcc" "td/generate/tl-parser/CMakeFiles/tl-parser.dir/tl-parser.c.o.d"
+  "/root/repo/td/generate/tl-parser/tlc.c" "td/generate/tl-parser/CMakeFiles/tl-parser.dir/tlc.c.o" "gcc" "td/generate/tl-parser/CMakeFiles/tl-parser.dir/tlc.c.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,15 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/tl-parser.dir/crc32.c.o"
+  "CMakeFiles/tl-parser.dir/crc32.c.o.d"
+  "CMakeFiles/tl-parser.dir/tl-parser.c.o"
+  "CMakeFiles/tl-parser.dir/tl-parser.c.o.d"
+  "CMakeFiles/tl-parser.dir/tlc.c.o"
+  "CMakeFiles/tl-parser.dir/tlc.c.o.d"
+  "tl-parser"
+  "tl-parser.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/tl-parser.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
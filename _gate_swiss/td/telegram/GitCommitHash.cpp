@@ -0,0 +1,15 @@
+//
+// Copyright Aliaksei Levin (levlam@telegram.org), Arseny Smirnov (arseny30@gmail.com) 2014-2024
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+#include "td/telegram/GitCommitHash.h"
+
+namespace td {
+
+const char *get_git_commit_hash() {
+  return "7f2fdb718bd85e846c8c12c2d5388bf048018cc9";
+}
+
+}  // namespace td
@@ -0,0 +1,26 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/tdtl/td/tl/tl_config.cpp" "tdtl/CMakeFiles/tdtl.dir/td/tl/tl_config.cpp.o" "gcc" "tdtl/CMakeFiles/tdtl.dir/td/tl/tl_config.cpp.o.d"
+  "/root/repo/tdtl/td/tl/tl_core.cpp" "tdtl/CMakeFiles/tdtl.dir/td/tl/tl_core.cpp.o" "gcc" "tdtl/CMakeFiles/tdtl.dir/td/tl/tl_core.cpp.o.d"
+  "/root/repo/tdtl/td/tl/tl_file_outputer.cpp" "tdtl/CMakeFiles/tdtl.dir/td/tl/tl_file_outputer.cpp.o" "gcc" "tdtl/CMakeFiles/tdtl.dir/td/tl/tl_file_outputer.cpp.o.d"
+  "/root/repo/tdtl/td/tl/tl_file_utils.cpp" "tdtl/CMakeFiles/tdtl.dir/td/tl/tl_file_utils.cpp.o" "gcc" "tdtl/CMakeFiles/tdtl.dir/td/tl/tl_file_utils.cpp.o.d"
+  "/root/repo/tdtl/td/tl/tl_generate.cpp" "tdtl/CMakeFiles/tdtl.dir/td/tl/tl_generate.cpp.o" "gcc" "tdtl/CMakeFiles/tdtl.dir/td/tl/tl_generate.cpp.o.d"
+  "/root/repo/tdtl/td/tl/tl_outputer.cpp" "tdtl/CMakeFiles/tdtl.dir/td/tl/tl_outputer.cpp.o" "gcc" "tdtl/CMakeFiles/tdtl.dir/td/tl/tl_outputer.cpp.o.d"
+  "/root/repo/tdtl/td/tl/tl_string_outputer.cpp" "tdtl/CMakeFiles/tdtl.dir/td/tl/tl_string_outputer.cpp.o" "gcc" "tdtl/CMakeFiles/tdtl.dir/td/tl/tl_string_outputer.cpp.o.d"
+  "/root/repo/tdtl/td/tl/tl_writer.cpp" "tdtl/CMakeFiles/tdtl.dir/td/tl/tl_writer.cpp.o" "gcc" "tdtl/CMakeFiles/tdtl.dir/td/tl/tl_writer.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,25 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/tdtl.dir/td/tl/tl_config.cpp.o"
+  "CMakeFiles/tdtl.dir/td/tl/tl_config.cpp.o.d"
+  "CMakeFiles/tdtl.dir/td/tl/tl_core.cpp.o"
+  "CMakeFiles/tdtl.dir/td/tl/tl_core.cpp.o.d"
+  "CMakeFiles/tdtl.dir/td/tl/tl_file_outputer.cpp.o"
+  "CMakeFiles/tdtl.dir/td/tl/tl_file_outputer.cpp.o.d"
+  "CMakeFiles/tdtl.dir/td/tl/tl_file_utils.cpp.o"
+  "CMakeFiles/tdtl.dir/td/tl/tl_file_utils.cpp.o.d"
+  "CMakeFiles/tdtl.dir/td/tl/tl_generate.cpp.o"
+  "CMakeFiles/tdtl.dir/td/tl/tl_generate.cpp.o.d"
+  "CMakeFiles/tdtl.dir/td/tl/tl_outputer.cpp.o"
+  "CMakeFiles/tdtl.dir/td/tl/tl_outputer.cpp.o.d"
+  "CMakeFiles/tdtl.dir/td/tl/tl_string_outputer.cpp.o"
+  "CMakeFiles/tdtl.dir/td/tl/tl_string_outputer.cpp.o.d"
+  "CMakeFiles/tdtl.dir/td/tl/tl_writer.cpp.o"
+  "CMakeFiles/tdtl.dir/td/tl/tl_writer.cpp.o.d"
+  "libtdtl.a"
+  "libtdtl.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/tdtl.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/binary_log_dump.dir/td/utils/binary_log_dump.cpp.o"
+  "CMakeFiles/binary_log_dump.dir/td/utils/binary_log_dump.cpp.o.d"
+  "binary_log_dump"
+  "binary_log_dump.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/binary_log_dump.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
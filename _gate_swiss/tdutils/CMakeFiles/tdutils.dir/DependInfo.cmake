@@ -0,0 +1,92 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/tdutils/td/utils/AsyncFileLog.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/AsyncFileLog.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/AsyncFileLog.cpp.o.d"
+  "/root/repo/tdutils/td/utils/BigNum.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/BigNum.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/BigNum.cpp.o.d"
+  "/root/repo/tdutils/td/utils/BinaryFileLog.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/BinaryFileLog.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/BinaryFileLog.cpp.o.d"
+  "/root/repo/tdutils/td/utils/BufferedUdp.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/BufferedUdp.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/BufferedUdp.cpp.o.d"
+  "/root/repo/tdutils/td/utils/ExitGuard.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/ExitGuard.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/ExitGuard.cpp.o.d"
+  "/root/repo/tdutils/td/utils/FileLog.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/FileLog.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/FileLog.cpp.o.d"
+  "/root/repo/tdutils/td/utils/FlatHashTable.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/FlatHashTable.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/FlatHashTable.cpp.o.d"
+  "/root/repo/tdutils/td/utils/FloodControlGlobal.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/FloodControlGlobal.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/FloodControlGlobal.cpp.o.d"
+  "/root/repo/tdutils/td/utils/Gzip.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/Gzip.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/Gzip.cpp.o.d"
+  "/root/repo/tdutils/td/utils/GzipByteFlow.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/GzipByteFlow.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/GzipByteFlow.cpp.o.d"
+  "/root/repo/tdutils/td/utils/Hints.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/Hints.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/Hints.cpp.o.d"
+  "/root/repo/tdutils/td/utils/HttpUrl.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/HttpUrl.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/HttpUrl.cpp.o.d"
+  "/root/repo/tdutils/td/utils/JsonBuilder.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/JsonBuilder.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/JsonBuilder.cpp.o.d"
+  "/root/repo/tdutils/td/utils/MpmcQueue.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/MpmcQueue.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/MpmcQueue.cpp.o.d"
+  "/root/repo/tdutils/td/utils/OptionParser.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/OptionParser.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/OptionParser.cpp.o.d"
+  "/root/repo/tdutils/td/utils/PathView.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/PathView.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/PathView.cpp.o.d"
+  "/root/repo/tdutils/td/utils/Random.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/Random.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/Random.cpp.o.d"
+  "/root/repo/tdutils/td/utils/SharedSlice.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/SharedSlice.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/SharedSlice.cpp.o.d"
+  "/root/repo/tdutils/td/utils/Slice.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/Slice.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/Slice.cpp.o.d"
+  "/root/repo/tdutils/td/utils/StackAllocator.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/StackAllocator.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/StackAllocator.cpp.o.d"
+  "/root/repo/tdutils/td/utils/Status.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/Status.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/Status.cpp.o.d"
+  "/root/repo/tdutils/td/utils/StringBuilder.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/StringBuilder.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/StringBuilder.cpp.o.d"
+  "/root/repo/tdutils/td/utils/Time.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/Time.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/Time.cpp.o.d"
+  "/root/repo/tdutils/td/utils/Timer.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/Timer.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/Timer.cpp.o.d"
+  "/root/repo/tdutils/td/utils/TlObjectArena.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/TlObjectArena.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/TlObjectArena.cpp.o.d"
+  "/root/repo/tdutils/td/utils/TsCerr.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/TsCerr.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/TsCerr.cpp.o.d"
+  "/root/repo/tdutils/td/utils/TsFileLog.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/TsFileLog.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/TsFileLog.cpp.o.d"
+  "/root/repo/tdutils/td/utils/TsLog.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/TsLog.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/TsLog.cpp.o.d"
+  "/root/repo/tdutils/td/utils/base64.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/base64.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/base64.cpp.o.d"
+  "/root/repo/tdutils/td/utils/buffer.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/buffer.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/buffer.cpp.o.d"
+  "/root/repo/tdutils/td/utils/check.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/check.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/check.cpp.o.d"
+  "/root/repo/tdutils/td/utils/crypto.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/crypto.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/crypto.cpp.o.d"
+  "/root/repo/tdutils/td/utils/emoji.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/emoji.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/emoji.cpp.o.d"
+  "/root/repo/tdutils/td/utils/filesystem.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/filesystem.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/filesystem.cpp.o.d"
+  "/root/repo/tdutils/td/utils/find_boundary.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/find_boundary.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/find_boundary.cpp.o.d"
+  "/root/repo/tdutils/td/utils/logging.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/logging.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/logging.cpp.o.d"
+  "/root/repo/tdutils/td/utils/misc.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/misc.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/misc.cpp.o.d"
+  "/root/repo/tdutils/td/utils/port/Clocks.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/port/Clocks.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/port/Clocks.cpp.o.d"
+  "/root/repo/tdutils/td/utils/port/FileFd.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/port/FileFd.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/port/FileFd.cpp.o.d"
+  "/root/repo/tdutils/td/utils/port/IPAddress.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/port/IPAddress.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/port/IPAddress.cpp.o.d"
+  "/root/repo/tdutils/td/utils/port/MemoryMapping.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/port/MemoryMapping.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/port/MemoryMapping.cpp.o.d"
+  "/root/repo/tdutils/td/utils/port/PollFlags.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/port/PollFlags.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/port/PollFlags.cpp.o.d"
+  "/root/repo/tdutils/td/utils/port/ServerSocketFd.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/port/ServerSocketFd.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/port/ServerSocketFd.cpp.o.d"
+  "/root/repo/tdutils/td/utils/port/SocketFd.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/port/SocketFd.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/port/SocketFd.cpp.o.d"
+  "/root/repo/tdutils/td/utils/port/Stat.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/port/Stat.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/port/Stat.cpp.o.d"
+  "/root/repo/tdutils/td/utils/port/StdStreams.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/port/StdStreams.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/port/StdStreams.cpp.o.d"
+  "/root/repo/tdutils/td/utils/port/UdpSocketFd.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/port/UdpSocketFd.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/port/UdpSocketFd.cpp.o.d"
+  "/root/repo/tdutils/td/utils/port/detail/Epoll.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/port/detail/Epoll.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/port/detail/Epoll.cpp.o.d"
+  "/root/repo/tdutils/td/utils/port/detail/EventFdBsd.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/port/detail/EventFdBsd.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/port/detail/EventFdBsd.cpp.o.d"
+  "/root/repo/tdutils/td/utils/port/detail/EventFdLinux.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/port/detail/EventFdLinux.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/port/detail/EventFdLinux.cpp.o.d"
+  "/root/repo/tdutils/td/utils/port/detail/EventFdWindows.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/port/detail/EventFdWindows.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/port/detail/EventFdWindows.cpp.o.d"
+  "/root/repo/tdutils/td/utils/port/detail/Iocp.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/port/detail/Iocp.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/port/detail/Iocp.cpp.o.d"
+  "/root/repo/tdutils/td/utils/port/detail/KQueue.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/port/detail/KQueue.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/port/detail/KQueue.cpp.o.d"
+  "/root/repo/tdutils/td/utils/port/detail/NativeFd.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/port/detail/NativeFd.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/port/detail/NativeFd.cpp.o.d"
+  "/root/repo/tdutils/td/utils/port/detail/Poll.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/port/detail/Poll.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/port/detail/Poll.cpp.o.d"
+  "/root/repo/tdutils/td/utils/port/detail/Select.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/port/detail/Select.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/port/detail/Select.cpp.o.d"
+  "/root/repo/tdutils/td/utils/port/detail/ThreadIdGuard.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/port/detail/ThreadIdGuard.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/port/detail/ThreadIdGuard.cpp.o.d"
+  "/root/repo/tdutils/td/utils/port/detail/ThreadPthread.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/port/detail/ThreadPthread.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/port/detail/ThreadPthread.cpp.o.d"
+  "/root/repo/tdutils/td/utils/port/detail/WineventPoll.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/port/detail/WineventPoll.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/port/detail/WineventPoll.cpp.o.d"
+  "/root/repo/tdutils/td/utils/port/path.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/port/path.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/port/path.cpp.o.d"
+  "/root/repo/tdutils/td/utils/port/platform.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/port/platform.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/port/platform.cpp.o.d"
+  "/root/repo/tdutils/td/utils/port/rlimit.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/port/rlimit.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/port/rlimit.cpp.o.d"
+  "/root/repo/tdutils/td/utils/port/signals.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/port/signals.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/port/signals.cpp.o.d"
+  "/root/repo/tdutils/td/utils/port/sleep.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/port/sleep.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/port/sleep.cpp.o.d"
+  "/root/repo/tdutils/td/utils/port/stacktrace.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/port/stacktrace.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/port/stacktrace.cpp.o.d"
+  "/root/repo/tdutils/td/utils/port/thread_local.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/port/thread_local.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/port/thread_local.cpp.o.d"
+  "/root/repo/tdutils/td/utils/port/uname.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/port/uname.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/port/uname.cpp.o.d"
+  "/root/repo/tdutils/td/utils/port/user.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/port/user.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/port/user.cpp.o.d"
+  "/root/repo/tdutils/td/utils/port/wstring_convert.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/port/wstring_convert.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/port/wstring_convert.cpp.o.d"
+  "/root/repo/tdutils/td/utils/tests.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/tests.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/tests.cpp.o.d"
+  "/root/repo/tdutils/td/utils/tl_parsers.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/tl_parsers.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/tl_parsers.cpp.o.d"
+  "/root/repo/tdutils/td/utils/translit.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/translit.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/translit.cpp.o.d"
+  "/root/repo/tdutils/td/utils/unicode.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/unicode.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/unicode.cpp.o.d"
+  "/root/repo/tdutils/td/utils/utf8.cpp" "tdutils/CMakeFiles/tdutils.dir/td/utils/utf8.cpp.o" "gcc" "tdutils/CMakeFiles/tdutils.dir/td/utils/utf8.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,157 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/tdutils.dir/td/utils/AsyncFileLog.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/AsyncFileLog.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/BigNum.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/BigNum.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/BinaryFileLog.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/BinaryFileLog.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/BufferedUdp.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/BufferedUdp.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/ExitGuard.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/ExitGuard.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/FileLog.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/FileLog.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/FlatHashTable.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/FlatHashTable.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/FloodControlGlobal.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/FloodControlGlobal.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/Gzip.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/Gzip.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/GzipByteFlow.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/GzipByteFlow.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/Hints.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/Hints.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/HttpUrl.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/HttpUrl.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/JsonBuilder.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/JsonBuilder.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/MpmcQueue.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/MpmcQueue.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/OptionParser.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/OptionParser.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/PathView.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/PathView.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/Random.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/Random.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/SharedSlice.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/SharedSlice.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/Slice.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/Slice.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/StackAllocator.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/StackAllocator.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/Status.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/Status.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/StringBuilder.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/StringBuilder.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/Time.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/Time.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/Timer.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/Timer.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/TlObjectArena.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/TlObjectArena.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/TsCerr.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/TsCerr.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/TsFileLog.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/TsFileLog.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/TsLog.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/TsLog.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/base64.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/base64.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/buffer.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/buffer.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/check.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/check.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/crypto.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/crypto.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/emoji.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/emoji.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/filesystem.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/filesystem.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/find_boundary.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/find_boundary.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/logging.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/logging.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/misc.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/misc.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/port/Clocks.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/port/Clocks.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/port/FileFd.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/port/FileFd.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/port/IPAddress.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/port/IPAddress.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/port/MemoryMapping.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/port/MemoryMapping.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/port/PollFlags.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/port/PollFlags.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/port/ServerSocketFd.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/port/ServerSocketFd.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/port/SocketFd.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/port/SocketFd.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/port/Stat.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/port/Stat.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/port/StdStreams.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/port/StdStreams.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/port/UdpSocketFd.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/port/UdpSocketFd.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/port/detail/Epoll.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/port/detail/Epoll.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/port/detail/EventFdBsd.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/port/detail/EventFdBsd.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/port/detail/EventFdLinux.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/port/detail/EventFdLinux.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/port/detail/EventFdWindows.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/port/detail/EventFdWindows.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/port/detail/Iocp.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/port/detail/Iocp.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/port/detail/KQueue.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/port/detail/KQueue.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/port/detail/NativeFd.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/port/detail/NativeFd.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/port/detail/Poll.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/port/detail/Poll.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/port/detail/Select.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/port/detail/Select.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/port/detail/ThreadIdGuard.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/port/detail/ThreadIdGuard.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/port/detail/ThreadPthread.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/port/detail/ThreadPthread.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/port/detail/WineventPoll.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/port/detail/WineventPoll.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/port/path.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/port/path.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/port/platform.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/port/platform.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/port/rlimit.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/port/rlimit.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/port/signals.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/port/signals.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/port/sleep.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/port/sleep.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/port/stacktrace.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/port/stacktrace.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/port/thread_local.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/port/thread_local.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/port/uname.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/port/uname.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/port/user.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/port/user.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/port/wstring_convert.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/port/wstring_convert.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/tests.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/tests.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/tl_parsers.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/tl_parsers.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/translit.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/translit.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/unicode.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/unicode.cpp.o.d"
+  "CMakeFiles/tdutils.dir/td/utils/utf8.cpp.o"
+  "CMakeFiles/tdutils.dir/td/utils/utf8.cpp.o.d"
+  "libtdutils.a"
+  "libtdutils.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/tdutils.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,9 @@
+#pragma once
+
+#define TD_HAVE_OPENSSL 1
+#define TD_HAVE_ZLIB 1
+#define TD_HAVE_CRC32C 0
+#define TD_HAVE_COROUTINES 0
+#define TD_HAVE_ABSL 0
+#define TD_FLAT_HASH_TABLE_SWISS 1
+#define TD_FD_DEBUG 0
@@ -6,8 +6,13 @@
 //
 #include "td/utils/benchmark.h"
 
+#include "td/utils/BufferedFd.h"
 #include "td/utils/common.h"
 #include "td/utils/crypto.h"
+#include "td/utils/filesystem.h"
+#include "td/utils/port/FileFd.h"
+#include "td/utils/port/path.h"
+#include "td/utils/port/PollFlags.h"
 #include "td/utils/port/thread.h"
 #include "td/utils/Random.h"
 #include "td/utils/Slice.h"
@@ -92,6 +97,59 @@ class SHA256ShortBench final : public td::Benchmark {
   }
 };
 
+template <bool use_buffered_fd>
+class SHA256FileBench final : public td::Benchmark {
+ public:
+  static constexpr int FILE_SIZE = 32 << 20;
+  td::CSlice path_ = "bench_crypto_sha256_file.tmp";
+
+  std::string get_description() const final {
+    return PSTRING() << "SHA256 file " << (use_buffered_fd ? "BufferedFd" : "sha256_feed_file") << " ["
+                     << (FILE_SIZE >> 20) << "MB]";
+  }
+
+  void start_up() final {
+    td::write_file(path_, std::string(FILE_SIZE, 'a')).ensure();
+  }
+
+  void tear_down() final {
+    td::unlink(path_).ignore();
+  }
+
+  void run(int n) final {
+    for (int i = 0; i < n; i++) {
+      auto fd = td::FileFd::open(path_, td::FileFd::Read).move_as_ok();
+      td::Sha256State state;
+      state.init();
+      if (use_buffered_fd) {
+        td::BufferedFd<td::FileFd> buffered_fd(std::move(fd));
+        buffered_fd.get_poll_info().add_flags(td::PollFlags::Read());
+        td::int64 left = FILE_SIZE;
+        while (left > 0) {
+          auto read_size = buffered_fd.flush_read(static_cast<size_t>(td::min(left, static_cast<td::int64>(1 << 20))))
+                               .move_as_ok();
+          CHECK(read_size > 0);
+          while (true) {
+            auto ready = buffered_fd.input_buffer().prepare_read();
+            if (ready.empty()) {
+              break;
+            }
+            state.feed(ready);
+            buffered_fd.input_buffer().confirm_read(ready.size());
+          }
+          left -= static_cast<td::int64>(read_size);
+        }
+        buffered_fd.close();
+      } else {
+        td::sha256_feed_file(state, fd, 0, FILE_SIZE).ensure();
+        fd.close();
+      }
+      unsigned char md[32];
+      state.extract(td::MutableSlice(md, 32), true);
+    }
+  }
+};
+
 class SHA512ShortBench final : public td::Benchmark {
  public:
   alignas(64) unsigned char data[SHORT_DATA_SIZE];
@@ -517,6 +575,8 @@ int main() {
 #endif
   td::bench(SHA1ShortBench());
   td::bench(SHA256ShortBench());
+  td::bench(SHA256FileBench<true>());
+  td::bench(SHA256FileBench<false>());
   td::bench(SHA512ShortBench());
   td::bench(HmacSha256ShortBench());
   td::bench(HmacSha512ShortBench());
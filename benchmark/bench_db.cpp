@@ -5,14 +5,18 @@
 // file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 //
 #include "td/db/binlog/Binlog.h"
+#include "td/db/binlog/BinlogEvent.h"
 #include "td/db/binlog/ConcurrentBinlog.h"
 #include "td/db/BinlogKeyValue.h"
 #include "td/db/DbKey.h"
 #include "td/db/SeqKeyValue.h"
 #include "td/db/SqliteConnectionSafe.h"
 #include "td/db/SqliteDb.h"
+#include "td/db/SqliteKeyValue.h"
 #include "td/db/SqliteKeyValueAsync.h"
+#include "td/db/SqliteKeyValueFilter.h"
 #include "td/db/SqliteKeyValueSafe.h"
+#include "td/db/TQueue.h"
 
 #include "td/actor/actor.h"
 #include "td/actor/ConcurrentScheduler.h"
@@ -21,11 +25,14 @@
 #include "td/utils/common.h"
 #include "td/utils/format.h"
 #include "td/utils/logging.h"
+#include "td/utils/Random.h"
 #include "td/utils/SliceBuilder.h"
 #include "td/utils/Status.h"
 #include "td/utils/StringBuilder.h"
+#include "td/utils/VectorQueue.h"
 
 #include <memory>
+#include <utility>
 
 template <class KeyValueT>
 class TdKvBench final : public td::Benchmark {
@@ -199,6 +206,217 @@ class SqliteKeyValueAsyncBench final : public td::Benchmark {
   }
 };
 
+template <bool use_get_many>
+class SqliteKeyValueGetManyBench final : public td::Benchmark {
+  static constexpr int KEY_COUNT = 10000;
+  static constexpr int KEYS_PER_QUERY = 100;
+
+  td::SqliteKeyValue kv_;
+
+  td::string get_description() const final {
+    return PSTRING() << "SqliteKeyValue load of " << KEYS_PER_QUERY << " keys " << td::tag("use_get_many", use_get_many);
+  }
+
+  void start_up() final {
+    td::string path = "testdb.sqlite";
+    td::SqliteDb::destroy(path).ignore();
+    auto db = td::SqliteDb::open_with_key(path, true, td::DbKey::empty()).move_as_ok();
+    init_db(db).ensure();
+    kv_.init_with_connection(std::move(db), "common").ensure();
+    kv_.begin_write_transaction().ensure();
+    for (int i = 0; i < KEY_COUNT; i++) {
+      kv_.set(PSLICE() << "us" << i, td::string(200, 'a'));
+    }
+    kv_.commit_transaction().ensure();
+  }
+
+  void run(int n) final {
+    size_t total_size = 0;
+    for (int i = 0; i < n; i++) {
+      td::vector<td::string> keys;
+      for (int j = 0; j < KEYS_PER_QUERY; j++) {
+        keys.push_back(PSTRING() << "us" << td::Random::fast(0, KEY_COUNT - 1));
+      }
+      if (use_get_many) {
+        for (auto &value : kv_.get_many(keys)) {
+          total_size += value.size();
+        }
+      } else {
+        for (auto &key : keys) {
+          total_size += kv_.get(key).size();
+        }
+      }
+    }
+    CHECK(total_size == static_cast<size_t>(n) * KEYS_PER_QUERY * 200);
+  }
+
+  void tear_down() final {
+    kv_.close();
+    td::SqliteDb::destroy("testdb.sqlite").ignore();
+  }
+};
+
+template <bool use_filter>
+class SqliteKeyValueFilterBench final : public td::Benchmark {
+  static constexpr int KEY_COUNT = 10000;
+
+  td::SqliteKeyValue kv_;
+
+  td::string get_description() const final {
+    return PSTRING() << "SqliteKeyValue get of present and absent keys " << td::tag("use_filter", use_filter);
+  }
+
+  void start_up() final {
+    td::string path = "testdb.sqlite";
+    td::SqliteDb::destroy(path).ignore();
+    auto db = td::SqliteDb::open_with_key(path, true, td::DbKey::empty()).move_as_ok();
+    init_db(db).ensure();
+    std::shared_ptr<td::SqliteKeyValueFilter> filter;
+    if (use_filter) {
+      filter = std::make_shared<td::SqliteKeyValueFilter>();
+    }
+    kv_.init_with_connection(std::move(db), "common", std::move(filter)).ensure();
+    kv_.begin_write_transaction().ensure();
+    for (int i = 0; i < KEY_COUNT; i++) {
+      kv_.set(PSLICE() << "us" << i, td::string(200, 'a'));
+    }
+    kv_.commit_transaction().ensure();
+  }
+
+  void run(int n) final {
+    int found_count = 0;
+    for (int i = 0; i < n; i++) {
+      // a half of requested keys are absent
+      if (!kv_.get(PSLICE() << "us" << td::Random::fast(0, 2 * KEY_COUNT - 1)).empty()) {
+        found_count++;
+      }
+    }
+    CHECK(found_count <= n);
+  }
+
+  void tear_down() final {
+    kv_.close();
+    td::SqliteDb::destroy("testdb.sqlite").ignore();
+  }
+};
+
+template <bool use_set_many>
+class SqliteKeyValueSetManyBench final : public td::Benchmark {
+  static constexpr int KEY_COUNT = 10000;
+  static constexpr int KEYS_PER_QUERY = 100;
+
+  td::SqliteKeyValue kv_;
+
+  td::string get_description() const final {
+    return PSTRING() << "SqliteKeyValue store and erase of " << KEYS_PER_QUERY << " keys "
+                     << td::tag("use_set_many", use_set_many);
+  }
+
+  void start_up() final {
+    td::string path = "testdb.sqlite";
+    td::SqliteDb::destroy(path).ignore();
+    auto db = td::SqliteDb::open_with_key(path, true, td::DbKey::empty()).move_as_ok();
+    init_db(db).ensure();
+    kv_.init_with_connection(std::move(db), "common").ensure();
+  }
+
+  void run(int n) final {
+    for (int i = 0; i < n; i++) {
+      td::vector<std::pair<td::string, td::string>> key_values;
+      for (int j = 0; j < KEYS_PER_QUERY; j++) {
+        key_values.emplace_back(PSTRING() << "us" << td::Random::fast(0, KEY_COUNT - 1), td::string(200, 'a'));
+      }
+      td::vector<td::string> erased_keys;
+      for (int j = 0; j < KEYS_PER_QUERY; j++) {
+        erased_keys.push_back(PSTRING() << "us" << td::Random::fast(0, KEY_COUNT - 1));
+      }
+      if (use_set_many) {
+        kv_.set_many(key_values);
+        kv_.erase_many(erased_keys);
+      } else {
+        kv_.begin_write_transaction().ensure();
+        for (auto &key_value : key_values) {
+          kv_.set(key_value.first, key_value.second);
+        }
+        kv_.commit_transaction().ensure();
+        kv_.begin_write_transaction().ensure();
+        for (auto &key : erased_keys) {
+          kv_.erase(key);
+        }
+        kv_.commit_transaction().ensure();
+      }
+    }
+  }
+
+  void tear_down() final {
+    kv_.close();
+    td::SqliteDb::destroy("testdb.sqlite").ignore();
+  }
+};
+
+class SqliteKeyValueAsyncGetBench final : public td::Benchmark {
+  static constexpr int KEY_COUNT = 10000;
+
+ public:
+  td::string get_description() const final {
+    return "SqliteKeyValueAsync get";
+  }
+
+  void start_up() final {
+    scheduler_ = td::make_unique<td::ConcurrentScheduler>(1, 0);
+    auto guard = scheduler_->get_main_guard();
+
+    td::string sql_db_name = "testdb.sqlite";
+    td::SqliteDb::destroy(sql_db_name).ignore();
+    td::SqliteDb::open_with_key(sql_db_name, true, td::DbKey::empty()).move_as_ok();
+
+    sql_connection_ = std::make_shared<td::SqliteConnectionSafe>(sql_db_name, td::DbKey::empty());
+    init_db(sql_connection_->get()).ensure();
+    auto kv_safe = std::make_shared<td::SqliteKeyValueSafe>("common", sql_connection_);
+    auto &kv = kv_safe->get();
+    kv.begin_write_transaction().ensure();
+    for (int i = 0; i < KEY_COUNT; i++) {
+      kv.set(PSLICE() << "us" << i, td::string(200, 'a'));
+    }
+    kv.commit_transaction().ensure();
+    sqlite_kv_async_ = create_sqlite_key_value_async(std::move(kv_safe), 0);
+    scheduler_->start();
+  }
+
+  void run(int n) final {
+    int left = n;
+    {
+      auto guard = scheduler_->get_main_guard();
+      for (int i = 0; i < n; i++) {
+        // concurrent single-key requests are merged into batches
+        sqlite_kv_async_->get(PSTRING() << "us" << td::Random::fast(0, KEY_COUNT - 1),
+                              td::PromiseCreator::lambda([&left](td::string value) {
+                                CHECK(value.size() == 200);
+                                left--;
+                              }));
+      }
+    }
+    while (left > 0) {
+      scheduler_->run_main(0);
+    }
+  }
+
+  void tear_down() final {
+    {
+      auto guard = scheduler_->get_main_guard();
+      sqlite_kv_async_.reset();
+      sql_connection_->close_and_destroy();
+    }
+    scheduler_->finish();
+    scheduler_.reset();
+  }
+
+ private:
+  td::unique_ptr<td::ConcurrentScheduler> scheduler_;
+  std::shared_ptr<td::SqliteConnectionSafe> sql_connection_;
+  td::unique_ptr<td::SqliteKeyValueAsyncInterface> sqlite_kv_async_;
+};
+
 class SeqKvBench final : public td::Benchmark {
   td::string get_description() const final {
     return "SeqKvBench";
@@ -230,6 +448,62 @@ class BinlogKeyValueBench final : public td::Benchmark {
   }
 };
 
+template <bool use_segment_storage>
+class TQueueStorageBench final : public td::Benchmark {
+  static constexpr int QUEUE_COUNT = 100;
+  static constexpr int KEPT_EVENT_COUNT = 10000;
+
+  td::unique_ptr<td::TQueue> tqueue_;
+  td::TQueueSegmentStorage *segment_storage_ = nullptr;
+  td::VectorQueue<std::pair<td::TQueue::QueueId, td::TQueue::EventId>> events_;
+
+  td::string get_description() const final {
+    return PSTRING() << "TQueue sustained push and forget " << td::tag("use_segment_storage", use_segment_storage);
+  }
+
+  void start_up() final {
+    tqueue_ = td::TQueue::create();
+    if (use_segment_storage) {
+      td::TQueueSegmentStorage::destroy("test_tqueue_segments").ignore();
+      auto storage = td::make_unique<td::TQueueSegmentStorage>();
+      storage->init("test_tqueue_segments", *tqueue_).ensure();
+      segment_storage_ = storage.get();
+      tqueue_->set_callback(std::move(storage));
+    } else {
+      td::Binlog::destroy("test_tqueue_binlog").ignore();
+      auto binlog = std::make_shared<td::Binlog>();
+      binlog->init("test_tqueue_binlog", [](const td::BinlogEvent &event) { UNREACHABLE(); }).ensure();
+      auto storage = td::make_unique<td::TQueueBinlog<td::Binlog>>();
+      storage->set_binlog(std::move(binlog));
+      tqueue_->set_callback(std::move(storage));
+    }
+  }
+
+  void run(int n) final {
+    for (int i = 0; i < n; i++) {
+      td::TQueue::QueueId queue_id = td::Random::fast(1, QUEUE_COUNT);
+      auto event_id = tqueue_->push(queue_id, td::string(200, 'a'), 2000000000, 0, {}).move_as_ok();
+      events_.emplace(queue_id, event_id);
+      if (events_.size() > static_cast<size_t>(KEPT_EVENT_COUNT)) {
+        auto event = events_.pop();
+        tqueue_->forget(event.first, event.second);
+      }
+      if (segment_storage_ != nullptr && i % 100 == 0) {
+        segment_storage_->flush();
+      }
+    }
+  }
+
+  void tear_down() final {
+    tqueue_->close(td::Promise<td::Unit>());
+    tqueue_ = nullptr;
+    segment_storage_ = nullptr;
+    events_ = {};
+    td::TQueueSegmentStorage::destroy("test_tqueue_segments").ignore();
+    td::Binlog::destroy("test_tqueue_binlog").ignore();
+  }
+};
+
 int main() {
   SET_VERBOSITY_LEVEL(VERBOSITY_NAME(WARNING));
   bench(TdKvBench<td::BinlogKeyValue<td::Binlog>>("BinlogKeyValue<Binlog>"));
@@ -240,5 +514,14 @@ int main() {
   bench(SqliteKVBench<false>());
   bench(SqliteKVBench<true>());
   bench(SqliteKeyValueAsyncBench());
+  bench(SqliteKeyValueGetManyBench<false>());
+  bench(SqliteKeyValueGetManyBench<true>());
+  bench(SqliteKeyValueSetManyBench<false>());
+  bench(SqliteKeyValueSetManyBench<true>());
+  bench(SqliteKeyValueAsyncGetBench());
+  bench(SqliteKeyValueFilterBench<false>());
+  bench(SqliteKeyValueFilterBench<true>());
   bench(SeqKvBench());
+  bench(TQueueStorageBench<false>());
+  bench(TQueueStorageBench<true>());
 }
@@ -0,0 +1,332 @@
+//
+// Copyright Aliaksei Levin (levlam@telegram.org), Arseny Smirnov (arseny30@gmail.com) 2014-2024
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+#include "td/db/binlog/Binlog.h"
+#include "td/db/binlog/BinlogEvent.h"
+#include "td/db/DbKey.h"
+#include "td/db/DbTrace.h"
+#include "td/db/SqliteDb.h"
+#include "td/db/SqliteStatement.h"
+
+#include "td/utils/common.h"
+#include "td/utils/FlatHashMap.h"
+#include "td/utils/format.h"
+#include "td/utils/logging.h"
+#include "td/utils/misc.h"
+#include "td/utils/port/Stat.h"
+#include "td/utils/Random.h"
+#include "td/utils/Slice.h"
+#include "td/utils/SliceBuilder.h"
+#include "td/utils/Status.h"
+#include "td/utils/Storer.h"
+#include "td/utils/Time.h"
+
+#include <algorithm>
+#include <map>
+#include <utility>
+
+// Replays a trace, recorded by a client with the option "database_trace_path", against a fresh database
+// and compares latencies of the operations with the recorded ones.
+// Operations of each recorded SQLite connection are replayed on a separate connection, but sequentially.
+// Usage: bench_db_replay <trace_path> [<database_directory>]
+class DbReplayer {
+ public:
+  explicit DbReplayer(td::string directory)
+      : sqlite_path_(directory + "replay_db.sqlite"), binlog_path_(directory + "replay_td.binlog") {
+  }
+
+  td::Status init() {
+    td::SqliteDb::destroy(sqlite_path_).ignore();
+    td::Binlog::destroy(binlog_path_).ignore();
+    return binlog_.init(binlog_path_, [](const td::BinlogEvent &event) {});
+  }
+
+  void replay(const td::DbTraceEvent &event) {
+    auto &stats = get_operation_stats(event);
+    stats.recorded_durations.push_back(event.duration);
+    double duration = 0.0;
+    bool is_ok = true;
+    switch (event.type) {
+      case td::DbTraceEvent::Type::Exec: {
+        auto *connection = get_connection(event.connection_id);
+        if (connection == nullptr) {
+          is_ok = false;
+          break;
+        }
+        auto start_time = td::Time::now();
+        is_ok = connection->db.exec(event.query).is_ok();
+        duration = td::Time::now() - start_time;
+        break;
+      }
+      case td::DbTraceEvent::Type::Query: {
+        auto *connection = get_connection(event.connection_id);
+        is_ok = connection != nullptr && replay_query(*connection, event, duration);
+        break;
+      }
+      case td::DbTraceEvent::Type::BinlogEvent:
+        replay_binlog_event(event, duration);
+        break;
+      case td::DbTraceEvent::Type::BinlogSync: {
+        auto start_time = td::Time::now();
+        binlog_.sync("replay");
+        duration = td::Time::now() - start_time;
+        break;
+      }
+      default:
+        UNREACHABLE();
+    }
+    if (!is_ok) {
+      stats.error_count++;
+    }
+    stats.durations.push_back(duration);
+    total_duration_ += duration;
+  }
+
+  void close() {
+    connections_.clear();
+    binlog_.close().ensure();
+  }
+
+  td::int64 get_sqlite_size() const {
+    return get_file_size(sqlite_path_) + get_file_size(sqlite_path_ + "-wal");
+  }
+
+  td::int64 get_binlog_size() const {
+    return get_file_size(binlog_path_);
+  }
+
+  void print_stats(size_t max_operation_count) {
+    td::vector<std::pair<td::string, OperationStats *>> operations;
+    for (auto &it : operation_stats_) {
+      operations.emplace_back(it.first, &it.second);
+    }
+    std::sort(operations.begin(), operations.end(), [](const auto &lhs, const auto &rhs) {
+      return lhs.second->get_total_duration() > rhs.second->get_total_duration();
+    });
+    if (operations.size() > max_operation_count) {
+      operations.resize(max_operation_count);
+    }
+    for (auto &operation : operations) {
+      auto &stats = *operation.second;
+      LOG(PLAIN) << operation.first;
+      LOG(PLAIN) << "    count: " << stats.durations.size() << ", errors: " << stats.error_count
+                 << ", total: " << td::format::as_time(stats.get_total_duration());
+      LOG(PLAIN) << "    replayed: " << get_percentiles(stats.durations);
+      LOG(PLAIN) << "    recorded: " << get_percentiles(stats.recorded_durations);
+    }
+  }
+
+  double get_total_duration() const {
+    return total_duration_;
+  }
+
+ private:
+  struct Connection {
+    td::SqliteDb db;
+    std::map<td::string, td::SqliteStatement> statements;  // must be destroyed before the connection
+  };
+
+  struct OperationStats {
+    td::vector<double> durations;
+    td::vector<double> recorded_durations;
+    size_t error_count = 0;
+
+    double get_total_duration() const {
+      double result = 0.0;
+      for (auto duration : durations) {
+        result += duration;
+      }
+      return result;
+    }
+  };
+
+  static constexpr size_t MAX_OPERATION_NAME_LENGTH = 100;
+
+  td::string sqlite_path_;
+  td::string binlog_path_;
+  std::map<td::int32, td::unique_ptr<Connection>> connections_;
+  td::Binlog binlog_;
+  td::FlatHashMap<td::uint64, td::uint64> binlog_event_ids_;
+  std::map<td::string, OperationStats> operation_stats_;
+  td::Random::Xorshift128plus rnd_{123};
+  double total_duration_ = 0.0;
+
+  Connection *get_connection(td::int32 connection_id) {
+    auto &connection = connections_[connection_id];
+    if (connection == nullptr) {
+      auto r_db = td::SqliteDb::open_with_key(sqlite_path_, true, td::DbKey::empty());
+      if (r_db.is_error()) {
+        LOG(ERROR) << "Failed to open connection " << connection_id << ": " << r_db.error();
+        connections_.erase(connection_id);
+        return nullptr;
+      }
+      connection = td::make_unique<Connection>();
+      connection->db = r_db.move_as_ok();
+    }
+    return connection.get();
+  }
+
+  static td::int64 get_file_size(td::CSlice path) {
+    auto r_stat = td::stat(path);
+    return r_stat.is_ok() ? r_stat.ok().size_ : 0;
+  }
+
+  static td::string get_percentiles(td::vector<double> &durations) {
+    if (durations.empty()) {
+      return td::string();
+    }
+    std::sort(durations.begin(), durations.end());
+    auto get_percentile = [&durations](size_t percent) {
+      return td::format::as_time(durations[(durations.size() - 1) * percent / 100]);
+    };
+    return PSTRING() << "p50 " << get_percentile(50) << ", p90 " << get_percentile(90) << ", p99 "
+                     << get_percentile(99) << ", max " << get_percentile(100);
+  }
+
+  OperationStats &get_operation_stats(const td::DbTraceEvent &event) {
+    switch (event.type) {
+      case td::DbTraceEvent::Type::Exec:
+      case td::DbTraceEvent::Type::Query:
+        return operation_stats_[td::Slice(event.query).truncate(MAX_OPERATION_NAME_LENGTH).str()];
+      case td::DbTraceEvent::Type::BinlogEvent:
+        return operation_stats_["binlog event"];
+      case td::DbTraceEvent::Type::BinlogSync:
+        return operation_stats_["binlog sync"];
+      default:
+        UNREACHABLE();
+        return operation_stats_[td::string()];
+    }
+  }
+
+  // values are replaced with values of the same size; values with a recorded hash are derived from the hash,
+  // so equal values stay equal, and other values are random
+  td::string get_value_data(const td::DbTraceValue &value) {
+    td::string result(static_cast<size_t>(value.integer), '\0');
+    for (size_t i = 0; i < result.size(); i++) {
+      auto random_value = value.data.empty() ? rnd_() : static_cast<unsigned char>(value.data[i % value.data.size()]);
+      result[i] = value.type == td::DbTraceValue::Type::Text ? static_cast<char>('a' + random_value % 26)
+                                                              : static_cast<char>(random_value & 255);
+    }
+    return result;
+  }
+
+  bool replay_query(Connection &connection, const td::DbTraceEvent &event, double &duration) {
+    auto &statements = connection.statements;
+    auto it = statements.find(event.query);
+    if (it == statements.end()) {
+      auto r_stmt = connection.db.get_statement(event.query);
+      if (r_stmt.is_error()) {
+        LOG(ERROR) << "Failed to prepare query: " << r_stmt.error();
+        return false;
+      }
+      it = statements.emplace(event.query, r_stmt.move_as_ok()).first;
+    }
+    auto &stmt = it->second;
+
+    td::vector<td::string> data(event.values.size());
+    for (size_t i = 0; i < event.values.size(); i++) {
+      auto &value = event.values[i];
+      if (value.type == td::DbTraceValue::Type::Text || value.type == td::DbTraceValue::Type::Blob) {
+        data[i] = get_value_data(value);
+      }
+    }
+
+    auto start_time = td::Time::now();
+    auto status = [&] {
+      for (size_t i = 0; i < event.values.size(); i++) {
+        auto id = static_cast<int>(i + 1);
+        auto &value = event.values[i];
+        switch (value.type) {
+          case td::DbTraceValue::Type::Null:
+            TRY_STATUS(stmt.bind_null(id));
+            break;
+          case td::DbTraceValue::Type::Integer:
+            TRY_STATUS(stmt.bind_int64(id, value.integer));
+            break;
+          case td::DbTraceValue::Type::Text:
+            TRY_STATUS(stmt.bind_string(id, data[i]));
+            break;
+          case td::DbTraceValue::Type::Blob:
+            TRY_STATUS(stmt.bind_blob(id, data[i]));
+            break;
+          default:
+            UNREACHABLE();
+        }
+      }
+      TRY_STATUS(stmt.step());
+      while (stmt.has_row()) {
+        TRY_STATUS(stmt.step());
+      }
+      return td::Status::OK();
+    }();
+    stmt.reset();
+    duration = td::Time::now() - start_time;
+    return status.is_ok();
+  }
+
+  void replay_binlog_event(const td::DbTraceEvent &event, double &duration) {
+    td::string payload(static_cast<size_t>(td::max(event.size - static_cast<td::int64>(td::BinlogEvent::MIN_SIZE),
+                                                   static_cast<td::int64>(0))),
+                       '\0');
+    auto storer = td::create_storer(payload);
+
+    // identifiers of events are assigned anew, because the trace can begin after creation of rewritten events
+    auto start_time = td::Time::now();
+    if ((event.binlog_event_flags & td::BinlogEvent::Flags::Rewrite) != 0) {
+      auto it = binlog_event_ids_.find(event.binlog_event_id);
+      if (it != binlog_event_ids_.end()) {
+        if (event.binlog_event_type == td::BinlogEvent::ServiceTypes::Empty) {
+          binlog_.erase(it->second);
+          binlog_event_ids_.erase(it);
+        } else {
+          binlog_.rewrite(it->second, event.binlog_event_type, storer);
+        }
+      } else if (event.binlog_event_type != td::BinlogEvent::ServiceTypes::Empty) {
+        binlog_event_ids_[event.binlog_event_id] = binlog_.add(event.binlog_event_type, storer);
+      }
+    } else {
+      binlog_event_ids_[event.binlog_event_id] = binlog_.add(event.binlog_event_type, storer);
+    }
+    duration = td::Time::now() - start_time;
+  }
+};
+
+int main(int argc, char *argv[]) {
+  SET_VERBOSITY_LEVEL(VERBOSITY_NAME(WARNING));
+  if (argc < 2) {
+    LOG(PLAIN) << "Usage: bench_db_replay <trace_path> [<database_directory>]";
+    return 1;
+  }
+
+  auto r_events = td::DbTrace::read(td::CSlice(argv[1]));
+  if (r_events.is_error()) {
+    LOG(ERROR) << "Failed to read trace: " << r_events.error();
+    return 1;
+  }
+  auto events = r_events.move_as_ok();
+
+  DbReplayer replayer(argc > 2 ? td::string(argv[2]) : td::string());
+  replayer.init().ensure();
+
+  auto start_time = td::Time::now();
+  for (auto &event : events) {
+    replayer.replay(event);
+  }
+  auto wall_duration = td::Time::now() - start_time;
+  auto sqlite_size = replayer.get_sqlite_size();
+  auto binlog_size = replayer.get_binlog_size();
+
+  auto recorded_duration = events.empty() ? 0.0 : events.back().time + events.back().duration;
+  LOG(PLAIN) << "Replayed " << events.size() << " operations recorded during "
+             << td::format::as_time(recorded_duration) << " in " << td::format::as_time(wall_duration) << ": "
+             << static_cast<td::int64>(static_cast<double>(events.size()) / td::max(wall_duration, 1e-9))
+             << " operations per second, " << td::format::as_time(replayer.get_total_duration())
+             << " in database operations";
+  LOG(PLAIN) << "SQLite database size: " << td::format::as_size(sqlite_size)
+             << ", binlog size: " << td::format::as_size(binlog_size);
+  replayer.print_stats(30);
+  replayer.close();
+}
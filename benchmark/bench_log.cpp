@@ -4,16 +4,22 @@
 // Distributed under the Boost Software License, Version 1.0. (See accompanying
 // file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 //
+#include "td/utils/AsyncFileLog.h"
 #include "td/utils/benchmark.h"
+#include "td/utils/BinaryFileLog.h"
 #include "td/utils/common.h"
 #include "td/utils/logging.h"
+#include "td/utils/port/path.h"
 
 #include <cstdio>
 #include <fstream>
+#include <functional>
 #include <iostream>
+#include <limits>
 #include <ostream>
 #include <streambuf>
 #include <string>
+#include <utility>
 
 #include <unistd.h>
 
@@ -150,6 +156,75 @@ class LogWriteBench final : public td::Benchmark {
   }
 };
 
+#if !TD_THREAD_UNSUPPORTED
+// compares cost of LOG(ERROR) for the calling thread and total logging throughput
+template <class LogT>
+class AsyncLogWriteBench final : public td::Benchmark {
+ public:
+  AsyncLogWriteBench(std::string name, bool end_to_end, std::function<td::unique_ptr<LogT>()> creator)
+      : name_(std::move(name)), end_to_end_(end_to_end), creator_(std::move(creator)) {
+  }
+
+  std::string get_description() const final {
+    return name_ + (end_to_end_ ? " (including write to file)" : " (caller-side)");
+  }
+
+  void start_up() final {
+    if (!end_to_end_) {
+      open_log();
+    }
+  }
+
+  void run(int n) final {
+    if (end_to_end_) {
+      open_log();
+    }
+    for (int i = 0; i < n; i++) {
+      LOG(ERROR) << "This is just for test" << 987654321 << ' ' << i;
+    }
+    if (end_to_end_) {
+      close_log();
+    }
+  }
+
+  void tear_down() final {
+    close_log();
+  }
+
+ private:
+  std::string name_;
+  bool end_to_end_;
+  std::function<td::unique_ptr<LogT>()> creator_;
+  td::unique_ptr<td::LogInterface> log_;
+  td::LogInterface *old_log_interface_ = nullptr;
+
+  void open_log() {
+    log_ = creator_();
+    old_log_interface_ = td::log_interface;
+    td::log_interface = log_.get();
+  }
+
+  void close_log() {
+    if (log_ == nullptr) {
+      return;
+    }
+    td::log_interface = old_log_interface_;
+    auto paths = log_->get_file_paths();
+    log_.reset();  // waits until all messages are written
+    for (const auto &path : paths) {
+      td::unlink(path).ignore();
+    }
+  }
+};
+
+template <class F>
+static void bench_async_log(std::string name, F &&f) {
+  for (auto end_to_end : {false, true}) {
+    td::bench(AsyncLogWriteBench<typename decltype(f())::element_type>(name, end_to_end, f));
+  }
+}
+#endif
+
 int main() {
   td::bench(LogWriteBench());
 #if TD_ANDROID
@@ -157,4 +232,20 @@ int main() {
 #endif
   td::bench(IostreamWriteBench());
   td::bench(FILEWriteBench());
+
+#if !TD_THREAD_UNSUPPORTED
+#if !TD_EVENTFD_UNSUPPORTED
+  bench_async_log("AsyncFileLog", [] {
+    auto log = td::make_unique<td::AsyncFileLog>();
+    log->init(create_tmp_file(), std::numeric_limits<td::int64>::max(), false).ensure();
+    return log;
+  });
+#endif
+  bench_async_log("BinaryFileLog", [] {
+    auto log = td::make_unique<td::BinaryFileLog>();
+    // the buffer must be big enough to not drop messages in the benchmark
+    log->init(create_tmp_file(), std::numeric_limits<td::int64>::max(), 0, 64 << 20).ensure();
+    return log;
+  });
+#endif
 }
@@ -4,13 +4,17 @@
 // Distributed under the Boost Software License, Version 1.0. (See accompanying
 // file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 //
+#include "td/telegram/files/FilePartsWriter.h"
+#include "td/telegram/ObjectSnapshotCache.h"
 #include "td/telegram/td_api.h"
 #include "td/telegram/telegram_api.h"
 #include "td/telegram/telegram_api.hpp"
 
 #include "td/utils/algorithm.h"
 #include "td/utils/benchmark.h"
+#include "td/utils/buffer.h"
 #include "td/utils/common.h"
+#include "td/utils/format.h"
 #include "td/utils/logging.h"
 #include "td/utils/port/Clocks.h"
 #include "td/utils/port/EventFd.h"
@@ -26,6 +30,9 @@
 #include "td/utils/Status.h"
 #include "td/utils/StringBuilder.h"
 #include "td/utils/ThreadSafeCounter.h"
+#include "td/utils/Time.h"
+#include "td/utils/tl_parsers.h"
+#include "td/utils/tl_storers.h"
 
 #if !TD_WINDOWS
 #include <unistd.h>
@@ -39,7 +46,12 @@
 #include <algorithm>
 #include <array>
 #include <atomic>
+#include <condition_variable>
 #include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <set>
 
 class F {
@@ -126,6 +138,58 @@ BENCH(TlToStringMessage, "TL to_string message") {
   td::do_not_optimize_away(res);
 }
 
+template <class StorerT>
+static void store_messages_messages(StorerT &s) {
+  constexpr td::int32 VECTOR_ID = 481674261;
+  constexpr td::int32 MESSAGE_COUNT = 100;
+  s.store_int(td::telegram_api::messages_messages::ID);
+  s.store_int(VECTOR_ID);
+  s.store_int(MESSAGE_COUNT);
+  for (td::int32 i = 0; i < MESSAGE_COUNT; i++) {
+    s.store_int(td::telegram_api::message::ID);
+    s.store_int(128 | 256 | 1024);  // entities, from_id, views and forwards
+    s.store_int(0);
+    s.store_int(1000000 + i);
+    s.store_int(td::telegram_api::peerUser::ID);
+    s.store_long(123456000112);
+    s.store_int(td::telegram_api::peerChannel::ID);
+    s.store_long(1234567890);
+    s.store_int(1699999999 + i);
+    s.store_string(td::Slice("Some message text with a few formatted words"));
+    s.store_int(VECTOR_ID);
+    s.store_int(3);
+    for (td::int32 j = 0; j < 3; j++) {
+      s.store_int(td::telegram_api::messageEntityBold::ID);
+      s.store_int(j * 5);
+      s.store_int(4);
+    }
+    s.store_int(1000 + i);
+    s.store_int(i);
+  }
+  s.store_int(VECTOR_ID);
+  s.store_int(0);
+  s.store_int(VECTOR_ID);
+  s.store_int(0);
+}
+
+BENCH(TlParseMessagesMessages, "TL parse messages.messages") {
+  td::TlStorerCalcLength calc_length;
+  store_messages_messages(calc_length);
+  td::BufferSlice buffer(calc_length.get_length());
+  td::TlStorerUnsafe storer(buffer.as_mutable_slice().ubegin());
+  store_messages_messages(storer);
+
+  std::size_t res = 0;
+  for (int i = 0; i < n; i++) {
+    td::TlBufferParser parser(&buffer);
+    auto result = td::telegram_api::messages_getHistory::fetch_result(parser);
+    parser.fetch_end();
+    CHECK(parser.get_error() == nullptr);
+    res += static_cast<const td::telegram_api::messages_messages *>(result.get())->messages_.size();
+  }
+  td::do_not_optimize_away(res);
+}
+
 #if !TD_EVENTFD_UNSUPPORTED
 BENCH(EventFd, "EventFd") {
   td::EventFd fd;
@@ -280,6 +344,269 @@ BENCH(Pwrite, "pwrite") {
   fd.close();
 }
 
+template <bool use_buffer_slice>
+class BufferAllocationTraceBench final : public td::Benchmark {
+  static constexpr size_t TRACE_SIZE = 1 << 12;
+  static constexpr size_t LIVE_BUFFER_COUNT = 16;
+
+  td::vector<size_t> sizes_;
+
+  td::string get_description() const final {
+    return PSTRING() << "allocate buffers for file download/upload using "
+                     << (use_buffer_slice ? "BufferSlice" : "new char[]");
+  }
+
+  void start_up() final {
+    // file parts, gzipped and big network packets and small network packets
+    sizes_.clear();
+    for (size_t i = 0; i < TRACE_SIZE; i++) {
+      auto type = td::Random::fast(0, 9);
+      if (type < 4) {
+        sizes_.push_back(512 << 10);
+      } else if (type < 6) {
+        sizes_.push_back(128 << 10);
+      } else if (type < 8) {
+        sizes_.push_back(td::Random::fast(64 << 10, 1 << 20));
+      } else {
+        sizes_.push_back(td::Random::fast(1 << 10, 64 << 10));
+      }
+    }
+  }
+
+  template <class T>
+  static void touch(T &&data, size_t size) {
+    for (size_t i = 0; i < size; i += 4096) {
+      data[i] = 'a';
+    }
+  }
+
+  void run(int n) final {
+    std::array<td::BufferSlice, LIVE_BUFFER_COUNT> buffer_slices;
+    std::array<std::unique_ptr<char[]>, LIVE_BUFFER_COUNT> buffers;
+    for (int i = 0; i < n; i++) {
+      auto size = sizes_[i % TRACE_SIZE];
+      if (use_buffer_slice) {
+        td::BufferSlice buffer_slice(size);
+        touch(buffer_slice.as_mutable_slice(), size);
+        buffer_slices[i % LIVE_BUFFER_COUNT] = std::move(buffer_slice);
+      } else {
+        auto buffer = std::unique_ptr<char[]>(new char[size]);
+        touch(buffer, size);
+        buffers[i % LIVE_BUFFER_COUNT] = std::move(buffer);
+      }
+    }
+  }
+
+  void tear_down() final {
+    LOG(PLAIN) << get_description() << ": " << td::tag("buffer_mem", td::BufferAllocator::get_buffer_mem())
+               << td::tag("buffer_pool_mem", td::BufferAllocator::get_buffer_pool_mem());
+  }
+};
+
+template <bool use_parts_writer>
+class FileDownloadWriteBench final : public td::Benchmark {
+  static constexpr int PART_SIZE = 128 << 10;
+  static constexpr int PART_COUNT = 256;
+
+  td::FilePartsWriter::Stats stats_;
+
+  td::string get_description() const final {
+    return PSTRING() << "download " << (PART_COUNT * PART_SIZE >> 20) << "MB file by " << (PART_SIZE >> 10)
+                     << "KB parts using " << (use_parts_writer ? "FilePartsWriter" : "pwrite");
+  }
+
+  void start_up() final {
+    stats_ = td::FilePartsWriter::Stats();
+  }
+
+  void run(int n) final {
+    td::string part(PART_SIZE, 'a');
+    for (int i = 0; i < n; i++) {
+      auto fd = td::FileFd::open("download_test", td::FileFd::Create | td::FileFd::Truncate | td::FileFd::Write)
+                    .move_as_ok();
+      td::FilePartsWriter writer;
+      if (use_parts_writer) {
+        fd.reserve_space(static_cast<td::int64>(PART_COUNT) * PART_SIZE).ignore();
+        fd.advise_sequential_access();
+      }
+      // parts are received mostly in order, but each fourth pair of parts is swapped
+      for (int j = 0; j < PART_COUNT; j++) {
+        int part_id = j % 8 == 6 ? j + 1 : (j % 8 == 7 ? j - 1 : j);
+        auto offset = static_cast<td::int64>(part_id) * PART_SIZE;
+        if (use_parts_writer) {
+          writer.add_part(fd, offset, td::BufferSlice(part)).ensure();
+        } else {
+          auto start_time = td::Time::now();
+          CHECK(fd.pwrite(part, offset).move_as_ok() == part.size());
+          stats_.write_time += td::Time::now() - start_time;
+          stats_.part_count++;
+          stats_.write_count++;
+          stats_.written_size += PART_SIZE;
+        }
+      }
+      if (use_parts_writer) {
+        writer.flush(fd).ensure();
+        auto &stats = writer.get_stats();
+        stats_.part_count += stats.part_count;
+        stats_.write_count += stats.write_count;
+        stats_.written_size += stats.written_size;
+        stats_.write_time += stats.write_time;
+      }
+      fd.close();
+    }
+  }
+
+  void tear_down() final {
+    td::unlink("download_test").ignore();
+    auto throughput = stats_.write_time == 0.0 ? 0.0 : static_cast<double>(stats_.written_size >> 20) / stats_.write_time;
+    LOG(PLAIN) << get_description() << ':' << stats_ << td::tag("MB/s", throughput);
+  }
+};
+
+#if !TD_THREAD_UNSUPPORTED
+// getUser requests from the caller thread, while the thread of Td is busy with an update storm;
+// without snapshots each request waits in the queue of Td behind all pending updates
+template <bool use_snapshots>
+class GetUserUnderUpdateStormBench final : public td::Benchmark {
+  static constexpr td::int64 USER_COUNT = 1000;
+  static constexpr std::size_t MAX_PENDING_UPDATE_COUNT = 1000;
+
+  td::vector<double> latencies_;
+  std::size_t hit_count_ = 0;
+
+  static td::td_api::object_ptr<td::td_api::user> get_user_object(td::int64 user_id) {
+    auto user = td::td_api::make_object<td::td_api::user>();
+    user->id_ = user_id;
+    user->first_name_ = "First name";
+    user->last_name_ = "Last name";
+    user->status_ = td::td_api::make_object<td::td_api::userStatusOffline>(1699999999);
+    user->profile_photo_ = td::td_api::make_object<td::td_api::profilePhoto>(user_id, get_file_object(),
+                                                                             get_file_object(), nullptr, false, false);
+    user->type_ = td::td_api::make_object<td::td_api::userTypeRegular>();
+    return user;
+  }
+
+  td::string get_description() const final {
+    return PSTRING() << "getUser under update storm " << (use_snapshots ? "with" : "without") << " snapshots";
+  }
+
+  void start_up() final {
+    latencies_.clear();
+    hit_count_ = 0;
+  }
+
+  void run(int n) final {
+    td::ObjectSnapshotCache cache;
+    cache.set_is_enabled(true);
+    cache.on_update(td::td_api::updateAuthorizationState(td::td_api::make_object<td::td_api::authorizationStateReady>()));
+    for (td::int64 user_id = 1; user_id <= USER_COUNT; user_id++) {
+      cache.on_update(td::td_api::updateUser(get_user_object(user_id)));
+      cache.on_object_sent();
+    }
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::condition_variable result_cv;
+    std::deque<std::function<void()>> queue;
+    std::atomic<bool> is_stopped{false};
+
+    auto push_task = [&](std::function<void()> task) {
+      std::lock_guard<std::mutex> lock(mutex);
+      queue.push_back(std::move(task));
+      cv.notify_one();
+    };
+
+    td::thread td_thread([&] {
+      while (true) {
+        std::function<void()> task;
+        {
+          std::unique_lock<std::mutex> lock(mutex);
+          cv.wait(lock, [&] { return !queue.empty() || is_stopped.load(); });
+          if (queue.empty()) {
+            return;
+          }
+          task = std::move(queue.front());
+          queue.pop_front();
+        }
+        task();
+      }
+    });
+    td::thread storm_thread([&] {
+      while (!is_stopped.load(std::memory_order_relaxed)) {
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+          if (queue.size() >= MAX_PENDING_UPDATE_COUNT) {
+            continue;
+          }
+        }
+        auto user_id = td::Random::fast(1, static_cast<int>(USER_COUNT));
+        bool is_status_update = td::Random::fast(0, 4) == 0;
+        push_task([&cache, user_id, is_status_update] {
+          td::td_api::object_ptr<td::td_api::Update> update;
+          if (is_status_update) {
+            update = td::td_api::make_object<td::td_api::updateUserStatus>(
+                user_id, td::td_api::make_object<td::td_api::userStatusOnline>(1699999999));
+          } else {
+            update = td::td_api::make_object<td::td_api::updateUser>(get_user_object(user_id));
+          }
+          td::do_not_optimize_away(to_string(update).size());
+          cache.on_update(*update);
+          cache.on_object_sent();
+        });
+      }
+    });
+
+    for (int i = 0; i < n; i++) {
+      auto user_id = td::Random::fast(1, static_cast<int>(USER_COUNT));
+      td::td_api::getUser request(user_id);
+      auto start_time = td::Clocks::monotonic();
+      td::td_api::object_ptr<td::td_api::Object> result;
+      if (use_snapshots) {
+        result = cache.get_object(request);
+      }
+      if (result == nullptr) {
+        bool is_ready = false;
+        push_task([&, user_id] {
+          auto user = get_user_object(user_id);
+          std::lock_guard<std::mutex> lock(mutex);
+          result = std::move(user);
+          is_ready = true;
+          result_cv.notify_one();
+        });
+        std::unique_lock<std::mutex> lock(mutex);
+        result_cv.wait(lock, [&] { return is_ready; });
+      } else {
+        hit_count_++;
+      }
+      latencies_.push_back(td::Clocks::monotonic() - start_time);
+      CHECK(result != nullptr);
+    }
+
+    is_stopped = true;
+    storm_thread.join();
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      cv.notify_one();
+    }
+    td_thread.join();
+  }
+
+  void tear_down() final {
+    if (latencies_.empty()) {
+      return;
+    }
+    std::sort(latencies_.begin(), latencies_.end());
+    auto get_percentile = [&](double percentile) {
+      auto pos = static_cast<std::size_t>(percentile * static_cast<double>(latencies_.size() - 1) / 100.0);
+      return td::format::as_time(latencies_[pos]);
+    };
+    LOG(PLAIN) << get_description() << ": requests = " << latencies_.size() << ", hits = " << hit_count_
+               << ", p50 = " << get_percentile(50) << ", p99 = " << get_percentile(99)
+               << ", p99.9 = " << get_percentile(99.9) << ", max = " << get_percentile(100);
+  }
+};
+#endif
+
 class CreateFileBench final : public td::Benchmark {
   td::string get_description() const final {
     return "create_file";
@@ -766,6 +1093,7 @@ int main() {
 
   td::bench(TlToStringUpdateFileBench());
   td::bench(TlToStringMessageBench());
+  td::bench(TlParseMessagesMessagesBench());
 
   td::bench(DuplicateCheckerBenchEvenOdd<IdDuplicateCheckerNew<1000>>());
   td::bench(DuplicateCheckerBenchEvenOdd<IdDuplicateCheckerNew<300>>());
@@ -822,6 +1150,16 @@ int main() {
   td::bench(WalkPathBench());
   td::bench(CreateFileBench());
   td::bench(PwriteBench());
+  td::bench(BufferAllocationTraceBench<false>());
+  td::bench(BufferAllocationTraceBench<true>());
+
+  td::bench(FileDownloadWriteBench<false>());
+  td::bench(FileDownloadWriteBench<true>());
+
+#if !TD_THREAD_UNSUPPORTED
+  td::bench(GetUserUnderUpdateStormBench<false>());
+  td::bench(GetUserUnderUpdateStormBench<true>());
+#endif
 
   td::bench(TlCallBench());
 #if !TD_THREAD_UNSUPPORTED
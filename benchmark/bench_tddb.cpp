@@ -20,12 +20,19 @@
 #include "td/utils/benchmark.h"
 #include "td/utils/buffer.h"
 #include "td/utils/common.h"
+#include "td/utils/format.h"
 #include "td/utils/logging.h"
+#include "td/utils/misc.h"
+#include "td/utils/port/Stat.h"
 #include "td/utils/Promise.h"
 #include "td/utils/Random.h"
+#include "td/utils/SliceBuilder.h"
 #include "td/utils/Status.h"
+#include "td/utils/Time.h"
 
+#include <cmath>
 #include <memory>
+#include <utility>
 
 static td::Status init_db(td::SqliteDb &db) {
   TRY_STATUS(db.exec("PRAGMA encoding=\"UTF-8\""));
@@ -107,7 +114,119 @@ class MessageDbBench final : public td::Benchmark {
   }
 };
 
-int main() {
+// searches for messages by a prefix of a word in a corpus of random texts; the corpus is created during start up
+// and its indexing speed and size are logged
+class MessageDbFtsBench final : public td::Benchmark {
+ public:
+  explicit MessageDbFtsBench(int message_count) : message_count_(message_count) {
+  }
+
+  td::string get_description() const final {
+    return PSTRING() << "MessageDb full-text search in " << message_count_ << " messages";
+  }
+  void start_up() final {
+    do_start_up().ensure();
+  }
+  void run(int n) final {
+    auto guard = scheduler_->get_main_guard();
+    auto &db = message_db_sync_safe_->get();
+    for (int i = 0; i < n; i++) {
+      td::MessageDbFtsQuery query;
+      auto &word = rand_word();
+      query.query = word.substr(0, td::max(static_cast<size_t>(2), word.size() - 1)) + '*';
+      if (i % 2 == 1) {
+        query.dialog_id = rand_dialog_id();
+      }
+      db.get_messages_fts(std::move(query));
+    }
+  }
+  void tear_down() final {
+    {
+      auto guard = scheduler_->get_main_guard();
+      sql_connection_->close_and_destroy();
+      sql_connection_.reset();
+      message_db_sync_safe_.reset();
+    }
+    scheduler_->finish();
+    scheduler_.reset();
+  }
+
+ private:
+  int message_count_;
+  td::vector<td::string> words_;
+  td::unique_ptr<td::ConcurrentScheduler> scheduler_;
+  std::shared_ptr<td::SqliteConnectionSafe> sql_connection_;
+  std::shared_ptr<td::MessageDbSyncSafeInterface> message_db_sync_safe_;
+
+  static constexpr int WORD_COUNT = 50000;
+  static constexpr int DIALOG_COUNT = 1000;
+
+  const td::string &rand_word() const {
+    // frequencies of words decrease exponentially like in natural languages
+    auto power = static_cast<double>(td::Random::fast(0, 1000000)) / 1000000.0;
+    auto index = static_cast<size_t>(std::pow(static_cast<double>(words_.size()), power)) - 1;
+    return words_[td::min(index, words_.size() - 1)];
+  }
+
+  static td::DialogId rand_dialog_id() {
+    return td::DialogId(td::UserId(static_cast<td::int64>(td::Random::fast(1, DIALOG_COUNT))));
+  }
+
+  td::Status do_start_up() {
+    for (int i = 0; i < WORD_COUNT; i++) {
+      td::string word(static_cast<size_t>(td::Random::fast(2, 10)), ' ');
+      for (auto &c : word) {
+        c = static_cast<char>(td::Random::fast('a', 'z'));
+      }
+      words_.push_back(std::move(word));
+    }
+
+    scheduler_ = td::make_unique<td::ConcurrentScheduler>(1, 0);
+    auto guard = scheduler_->get_main_guard();
+
+    td::string sql_db_name = "testdb_fts.sqlite";
+    td::SqliteDb::destroy(sql_db_name).ignore();
+    sql_connection_ = std::make_shared<td::SqliteConnectionSafe>(sql_db_name, td::DbKey::empty());
+    auto &db = sql_connection_->get();
+    TRY_STATUS(init_db(db));
+
+    db.exec("BEGIN TRANSACTION").ensure();
+    TRY_STATUS(init_message_db(db, 0));
+    db.exec("COMMIT TRANSACTION").ensure();
+
+    message_db_sync_safe_ = td::create_message_db_sync(sql_connection_);
+    auto &message_db = message_db_sync_safe_->get();
+
+    auto add_time = 0.0;
+    for (int i = 0; i < message_count_; i += 1000) {
+      auto start_time = td::Time::now();
+      TRY_STATUS(message_db.begin_write_transaction());
+      for (int j = i; j < td::min(i + 1000, message_count_); j++) {
+        td::string text;
+        for (int k = td::Random::fast(3, 20); k > 0; k--) {
+          text += rand_word();
+          text += ' ';
+        }
+        auto message_id = td::MessageId{td::ServerMessageId{j + 1}};
+        message_db.add_message({rand_dialog_id(), message_id}, td::ServerMessageId(), td::DialogId(), 0, 0, 0, j + 1,
+                               std::move(text), td::NotificationId(), td::MessageId(),
+                               td::BufferSlice(td::Random::fast(100, 299)));
+      }
+      // the messages are added to the full-text index on commit
+      TRY_STATUS(message_db.commit_transaction());
+      add_time += td::Time::now() - start_time;
+    }
+    db.checkpoint(td::SqliteDb::CheckpointMode::Truncate).ensure();
+
+    TRY_RESULT(database_stat, td::stat(sql_db_name));
+    LOG(ERROR) << "Add and index " << message_count_ << " messages in " << td::format::as_time(add_time)
+               << "; database size is " << td::format::as_size(database_stat.size_);
+    return td::Status::OK();
+  }
+};
+
+int main(int argc, char *argv[]) {
   SET_VERBOSITY_LEVEL(VERBOSITY_NAME(WARNING));
   td::bench(MessageDbBench());
+  td::bench(MessageDbFtsBench(argc > 1 ? td::to_integer<int>(td::Slice(argv[1])) : 1000000));
 }
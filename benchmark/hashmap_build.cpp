@@ -5,6 +5,7 @@
 // file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 //
 #include "td/utils/FlatHashMap.h"
+#include "td/utils/FlatHashMapSwiss.h"
 
 #ifdef SCOPE_EXIT
 #undef SCOPE_EXIT
@@ -16,14 +17,24 @@
 #include <map>
 #include <unordered_map>
 
+// the hashmap-build-* targets compare build time and code size of the maps
+#ifdef HASHMAP_BUILD_MAP
+#define test_map HASHMAP_BUILD_MAP
+#else
 #define test_map td::FlatHashMap
+//#define test_map td::FlatHashMapSwiss
 //#define test_map folly::F14FastMap
 //#define test_map absl::flat_hash_map
 //#define test_map std::map
 //#define test_map std::unordered_map
+#endif
 
+#if HASHMAP_BUILD_CREATE_MAPS
+#define CREATE_MAP(num) CREATE_MAP_IMPL(num)
+#else
 //#define CREATE_MAP(num) CREATE_MAP_IMPL(num)
 #define CREATE_MAP(num)
+#endif
 
 #define CREATE_MAP_IMPL(num)                      \
   int f_##num() {                                 \
@@ -4,6 +4,7 @@
 // Distributed under the Boost Software License, Version 1.0. (See accompanying
 // file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 //
+#include "tl_object_copier.h"
 #include "tl_writer_cpp.h"
 #include "tl_writer_h.h"
 #include "tl_writer_hpp.h"
@@ -34,7 +35,8 @@ static void generate_cpp(const std::string &directory, const std::string &tl_nam
 
 int main() {
   generate_cpp<>("td/telegram", "telegram_api", "std::string", "BufferSlice",
-                 {"\"td/tl/tl_object_parse.h\"", "\"td/tl/tl_object_store.h\""}, {"\"td/utils/buffer.h\""});
+                 {"\"td/tl/tl_object_parse.h\"", "\"td/tl/tl_object_store.h\""},
+                 {"\"td/utils/buffer.h\"", "\"td/utils/TlObjectArena.h\""});
 
   generate_cpp<>("td/telegram", "secret_api", "std::string", "BufferSlice",
                  {"\"td/tl/tl_object_parse.h\"", "\"td/tl/tl_object_store.h\""}, {"\"td/utils/buffer.h\""});
@@ -49,4 +51,6 @@ int main() {
 #else
   generate_cpp<>("td/telegram", "td_api", "std::string", "std::string", {}, {"<string>"});
 #endif
+
+  td::gen_object_copier(td::tl::read_tl_config_from_file("tlo/td_api.tlo"), "td/telegram/td_api_copy");
 }
@@ -0,0 +1,191 @@
+//
+// Copyright Aliaksei Levin (levlam@telegram.org), Arseny Smirnov (arseny30@gmail.com) 2014-2024
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+#include "tl_object_copier.h"
+
+#include "td/tl/tl_file_utils.h"
+#include "td/tl/tl_simple.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+namespace td {
+
+static bool has_nested_objects(const tl::simple::Type *type) {
+  if (type->type == tl::simple::Type::Vector) {
+    return has_nested_objects(type->vector_value_type);
+  }
+  return type->type == tl::simple::Type::Custom;
+}
+
+static void gen_copy_constructor(std::string &out, const tl::simple::Constructor *constructor, bool is_header) {
+  auto class_name = tl::simple::gen_cpp_name(constructor->name);
+  out += "object_ptr<" + class_name + "> copy_object(const " + class_name + " &";
+  if (is_header) {
+    out += "object);\n\n";
+    return;
+  }
+  if (!constructor->args.empty()) {
+    out += "object";
+  }
+  out += ") {\n  return make_object<" + class_name + ">(";
+  bool is_first = true;
+  for (auto &arg : constructor->args) {
+    if (!is_first) {
+      out += ", ";
+    }
+    is_first = false;
+    auto field = "object." + tl::simple::gen_cpp_field_name(arg.name);
+    if (arg.type->type == tl::simple::Type::Custom || arg.type->type == tl::simple::Type::Vector) {
+      out += "copy_value(" + field + ")";
+    } else {
+      out += field;
+    }
+  }
+  out += ");\n}\n\n";
+}
+
+static void gen_for_each_nested_object_constructor(std::string &out, const tl::simple::Constructor *constructor) {
+  bool has_nested = false;
+  for (auto &arg : constructor->args) {
+    if (has_nested_objects(arg.type)) {
+      has_nested = true;
+    }
+  }
+  if (!has_nested) {
+    return;
+  }
+
+  out += "static void for_each_nested_object_impl(const " + tl::simple::gen_cpp_name(constructor->name) +
+         " &object, const std::function<void(const Object &)> &callback) {\n";
+  for (auto &arg : constructor->args) {
+    if (has_nested_objects(arg.type)) {
+      out += "  visit_nested_objects(object." + tl::simple::gen_cpp_field_name(arg.name) + ", callback);\n";
+    }
+  }
+  out += "}\n\n";
+}
+
+static void gen_object_copier_file(const tl::simple::Schema &schema, const std::string &file_name_base,
+                                   bool is_header) {
+  std::string out;
+  if (is_header) {
+    out += "#pragma once\n\n";
+    out += "#include \"td/telegram/td_api.h\"\n\n";
+    out += "#include <functional>\n\n";
+  } else {
+    out += "#include \"" + file_name_base + ".h\"\n\n";
+    out += "#include \"td/telegram/td_api.h\"\n";
+    out += "#include \"td/telegram/td_api.hpp\"\n\n";
+    out += "#include <functional>\n";
+    out += "#include <vector>\n\n";
+  }
+  out += "namespace td {\n";
+  out += "namespace td_api {\n\n";
+  if (is_header) {
+    out += "// returns a deep copy of the object\n";
+    out += "object_ptr<Object> copy_object(const Object &object);\n\n";
+    out += "// calls the callback for every object, recursively contained in the object\n";
+    out += "void for_each_nested_object(const Object &object, const std::function<void(const Object &)> &callback);\n\n";
+  } else {
+    out += R"ABCD(template <class T>
+static T copy_value(const T &value) {
+  return value;
+}
+
+template <class T>
+static object_ptr<T> copy_value(const object_ptr<T> &value) {
+  if (value == nullptr) {
+    return nullptr;
+  }
+  return copy_object(*value);
+}
+
+template <class T>
+static std::vector<T> copy_value(const std::vector<T> &values) {
+  std::vector<T> result;
+  result.reserve(values.size());
+  for (const auto &value : values) {
+    result.push_back(copy_value(value));
+  }
+  return result;
+}
+
+template <class T>
+static void visit_nested_objects(const object_ptr<T> &value, const std::function<void(const Object &)> &callback) {
+  if (value != nullptr) {
+    callback(*value);
+    for_each_nested_object(*value, callback);
+  }
+}
+
+template <class T>
+static void visit_nested_objects(const std::vector<T> &values, const std::function<void(const Object &)> &callback) {
+  for (const auto &value : values) {
+    visit_nested_objects(value, callback);
+  }
+}
+
+template <class T>
+static void for_each_nested_object_impl(const T &, const std::function<void(const Object &)> &) {
+}
+
+object_ptr<Object> copy_object(const Object &object) {
+  object_ptr<Object> result;
+  downcast_call(const_cast<Object &>(object), [&result](const auto &object) { result = copy_object(object); });
+  return result;
+}
+
+)ABCD";
+  }
+
+  for (auto *custom_type : schema.custom_types) {
+    if (custom_type->constructors.size() > 1) {
+      auto type_name = tl::simple::gen_cpp_name(custom_type->name);
+      out += "object_ptr<" + type_name + "> copy_object(const " + type_name + " &object)";
+      if (is_header) {
+        out += ";\n\n";
+      } else {
+        out += " {\n  object_ptr<" + type_name + "> result;\n";
+        out += "  downcast_call(const_cast<" + type_name +
+               " &>(object), [&result](const auto &object) { result = copy_object(object); });\n";
+        out += "  return result;\n}\n\n";
+      }
+    }
+    for (auto *constructor : custom_type->constructors) {
+      gen_copy_constructor(out, constructor, is_header);
+    }
+  }
+
+  if (!is_header) {
+    for (auto *custom_type : schema.custom_types) {
+      for (auto *constructor : custom_type->constructors) {
+        gen_for_each_nested_object_constructor(out, constructor);
+      }
+    }
+    out += "void for_each_nested_object(const Object &object, const std::function<void(const Object &)> &callback) {\n";
+    out += "  downcast_call(const_cast<Object &>(object),\n";
+    out += "                [&callback](const auto &object) { for_each_nested_object_impl(object, callback); });\n";
+    out += "}\n\n";
+  }
+
+  out += "}  // namespace td_api\n";
+  out += "}  // namespace td\n";
+
+  auto file_name = file_name_base + (is_header ? ".h" : ".cpp");
+  if (!tl::put_file_contents(file_name, out, true)) {
+    std::fprintf(stderr, "Can't write file %s\n", file_name.c_str());
+    std::abort();
+  }
+}
+
+void gen_object_copier(const tl::tl_config &config, const std::string &file_name_base) {
+  tl::simple::Schema schema(config);
+  gen_object_copier_file(schema, file_name_base, true);
+  gen_object_copier_file(schema, file_name_base, false);
+}
+
+}  // namespace td
@@ -209,6 +209,41 @@ std::string TD_TL_writer_cpp::gen_type_fetch(const std::string &field_name, cons
 
 std::string TD_TL_writer_cpp::gen_field_fetch(int field_num, const tl::arg &a, std::vector<tl::var_description> &vars,
                                               bool flat, int parser_type) const {
+  return gen_field_fetch_impl(field_num, a, vars, flat, parser_type, 0);
+}
+
+int TD_TL_writer_cpp::get_fixed_field_size(const tl::arg &a, int parser_type) const {
+  if (a.exist_var_num != -1 || a.type->get_type() != tl::NODE_TYPE_TYPE) {
+    return 0;
+  }
+
+  const tl::tl_tree_type *tree_type = static_cast<tl::tl_tree_type *>(a.type);
+  std::string fetch_class_name = gen_full_fetch_class_name(tree_type);
+  if (fetch_class_name == "TlFetchInt") {
+    return 4;
+  }
+  if (fetch_class_name == "TlFetchLong" || fetch_class_name == "TlFetchDouble") {
+    return 8;
+  }
+  if (fetch_class_name == "TlFetchInt128") {
+    return 16;
+  }
+  if (fetch_class_name == "TlFetchInt256") {
+    return 32;
+  }
+  return 0;
+}
+
+std::string TD_TL_writer_cpp::gen_fixed_size_field_fetch(int field_num, const tl::arg &a,
+                                                         std::vector<tl::var_description> &vars, int parser_type,
+                                                         int checked_length) const {
+  assert(checked_length != 0);
+  return gen_field_fetch_impl(field_num, a, vars, false, parser_type, checked_length);
+}
+
+std::string TD_TL_writer_cpp::gen_field_fetch_impl(int field_num, const tl::arg &a,
+                                                   std::vector<tl::var_description> &vars, bool flat, int parser_type,
+                                                   int checked_length) const {
   assert(parser_type >= 0);
   std::string field_name = (parser_type == 0 ? (field_num == 0 ? ": " : ", ") : "res->") + gen_field_name(a.name);
 
@@ -275,7 +310,15 @@ std::string TD_TL_writer_cpp::gen_field_fetch(int field_num, const tl::arg &a, s
 
   assert(a.type->get_type() == tl::NODE_TYPE_TYPE);
   const tl::tl_tree_type *tree_type = static_cast<tl::tl_tree_type *>(a.type);
-  res += gen_type_fetch(field_name, tree_type, vars, parser_type);
+  if (checked_length == 0) {
+    res += gen_type_fetch(field_name, tree_type, vars, parser_type);
+  } else {
+    std::string fetch = gen_full_fetch_class_name(tree_type) + "::parse_unsafe(p)";
+    if (checked_length > 0) {
+      fetch = "(p.check_len(" + int_to_string(checked_length) + "), " + fetch + ")";
+    }
+    res += fetch;
+  }
   if (store_to_var_num) {
     res += ") < 0) { FAIL(\"Variable of type # can't be negative\"); }";
   } else {
@@ -27,6 +27,9 @@ class TD_TL_writer_cpp : public TD_TL_writer {
 
   std::vector<std::string> ext_include;
 
+  std::string gen_field_fetch_impl(int field_num, const tl::arg &a, std::vector<tl::var_description> &vars, bool flat,
+                                   int parser_type, int checked_length) const;
+
  protected:
   std::string gen_vector_store(const std::string &field_name, const tl::tl_tree_type *t,
                                const std::vector<tl::var_description> &vars, int storer_type) const;
@@ -65,6 +68,9 @@ class TD_TL_writer_cpp : public TD_TL_writer {
 
   std::string gen_field_fetch(int field_num, const tl::arg &a, std::vector<tl::var_description> &vars, bool flat,
                               int parser_type) const override;
+  int get_fixed_field_size(const tl::arg &a, int parser_type) const override;
+  std::string gen_fixed_size_field_fetch(int field_num, const tl::arg &a, std::vector<tl::var_description> &vars,
+                                         int parser_type, int checked_length) const override;
   std::string gen_field_store(const tl::arg &a, std::vector<tl::var_description> &vars, bool flat,
                               int storer_type) const override;
   std::string gen_type_fetch(const std::string &field_name, const tl::tl_tree_type *tree_type,
@@ -265,9 +265,20 @@ std::string TD_TL_writer_h::gen_forward_class_declaration(const std::string &cla
 std::string TD_TL_writer_h::gen_class_begin(const std::string &class_name, const std::string &base_class_name,
                                             bool is_proxy, const tl::tl_tree *result) const {
   if (is_proxy) {
-    return "class " + class_name + ": public " + base_class_name +
-           " {\n"
-           " public:\n";
+    std::string res = "class " + class_name + ": public " + base_class_name +
+                      " {\n"
+                      " public:\n";
+    if (tl_name == "telegram_api" && class_name == gen_base_type_class_name(0)) {
+      // received objects can be allocated in an arena
+      res +=
+          "  static void *operator new(std::size_t size) {\n"
+          "    return TlObjectArena::allocate(size);\n"
+          "  }\n\n"
+          "  static void operator delete(void *ptr) {\n"
+          "    TlObjectArena::deallocate(ptr);\n"
+          "  }\n\n";
+    }
+    return res;
   }
   return "class " + class_name + " final : public " + base_class_name +
          " {\n"
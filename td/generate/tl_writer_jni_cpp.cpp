@@ -232,6 +232,11 @@ std::string TD_TL_writer_jni_cpp::gen_field_fetch(int field_num, const tl::arg &
   return "  " + gen_type_fetch(field_name, tree_type, vars, parser_type) + ";\n";
 }
 
+int TD_TL_writer_jni_cpp::get_fixed_field_size(const tl::arg &a, int parser_type) const {
+  // fields are fetched from Java objects
+  return 0;
+}
+
 std::string TD_TL_writer_jni_cpp::get_pretty_field_name(std::string field_name) const {
   return gen_java_field_name(TD_TL_writer_cpp::get_pretty_field_name(field_name));
 }
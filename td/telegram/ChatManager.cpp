@@ -22,6 +22,7 @@
 #include "td/telegram/InputGroupCallId.h"
 #include "td/telegram/logevent/LogEvent.h"
 #include "td/telegram/logevent/LogEventHelper.h"
+#include "td/telegram/MemoryStatistics.h"
 #include "td/telegram/MessageSender.h"
 #include "td/telegram/MessagesManager.h"
 #include "td/telegram/MessageTtl.h"
@@ -1624,6 +1625,25 @@ ChatManager::~ChatManager() {
                                               unavailable_channel_fulls_, linked_channel_ids_, restricted_channel_ids_);
 }
 
+void ChatManager::start_up() {
+  if (G()->use_chat_info_database()) {
+    set_timeout_in(COLD_OBJECT_EVICTION_PERIOD);
+  }
+}
+
+void ChatManager::timeout_expired() {
+  if (G()->close_flag()) {
+    return;
+  }
+
+  auto max_count = td_->option_manager_->get_option_integer("chat_info_cache_size");
+  if (max_count > 0) {
+    evict_cold_chats(static_cast<size_t>(max_count));
+    evict_cold_channels(static_cast<size_t>(max_count));
+  }
+  set_timeout_in(COLD_OBJECT_EVICTION_PERIOD);
+}
+
 void ChatManager::tear_down() {
   parent_.reset();
 
@@ -4127,10 +4147,33 @@ void ChatManager::load_chat_from_database_impl(ChatId chat_id, Promise<Unit> pro
   auto &load_chat_queries = load_chat_from_database_queries_[chat_id];
   load_chat_queries.push_back(std::move(promise));
   if (load_chat_queries.size() == 1u) {
-    G()->td_db()->get_sqlite_pmc()->get(get_chat_database_key(chat_id), PromiseCreator::lambda([chat_id](string value) {
-                                          send_closure(G()->chat_manager(), &ChatManager::on_load_chat_from_database,
-                                                       chat_id, std::move(value), false);
-                                        }));
+    // chats requested during the same event are loaded by a single database query
+    pending_load_chat_ids_.push_back(chat_id);
+    if (pending_load_chat_ids_.size() == 1u) {
+      send_closure_later(actor_id(this), &ChatManager::load_pending_chats_from_database);
+    }
+  }
+}
+
+void ChatManager::load_pending_chats_from_database() {
+  auto chat_ids = std::move(pending_load_chat_ids_);
+  pending_load_chat_ids_.clear();
+  if (chat_ids.empty()) {
+    return;
+  }
+  LOG(INFO) << "Load " << chat_ids.size() << " basic groups from database";
+  auto keys = transform(chat_ids, get_chat_database_key);
+  G()->td_db()->get_sqlite_pmc()->get_many(
+      std::move(keys), PromiseCreator::lambda([chat_ids = std::move(chat_ids)](vector<string> values) mutable {
+        send_closure(G()->chat_manager(), &ChatManager::on_load_chats_from_database, std::move(chat_ids),
+                     std::move(values));
+      }));
+}
+
+void ChatManager::on_load_chats_from_database(vector<ChatId> chat_ids, vector<string> values) {
+  CHECK(chat_ids.size() == values.size());
+  for (size_t i = 0; i < chat_ids.size(); i++) {
+    on_load_chat_from_database(chat_ids[i], std::move(values[i]), false);
   }
 }
 
@@ -4157,6 +4200,16 @@ void ChatManager::on_load_chat_from_database(ChatId chat_id, string value, bool
   //  G()->td_db()->get_sqlite_pmc()->erase(get_chat_database_key(chat_id), Auto());
   //  return;
 
+  if (chat_evictor_.is_evicted(chat_id)) {
+    auto chat = chat_evictor_.take_object(chat_id);
+    if (chat == nullptr) {
+      chat = parse_evicted_chat(chat_id, value);
+    }
+    return_evicted_chat(chat_id, std::move(chat));
+    set_promises(promises);
+    return;
+  }
+
   Chat *c = get_chat(chat_id);
   if (c == nullptr) {
     if (!value.empty()) {
@@ -4190,6 +4243,23 @@ void ChatManager::on_load_chat_from_database(ChatId chat_id, string value, bool
   set_promises(promises);
 }
 
+void ChatManager::load_chats_from_database(const vector<ChatId> &chat_ids, Promise<Unit> &&promise) {
+  if (!G()->use_chat_info_database()) {
+    return promise.set_value(Unit());
+  }
+
+  MultiPromiseActorSafe mpas{"LoadChatsFromDatabaseMultiPromiseActor"};
+  mpas.add_promise(std::move(promise));
+  auto lock = mpas.get_promise();
+  for (auto chat_id : chat_ids) {
+    // evicted basic groups are loaded back together with unknown basic groups
+    if (chat_id.is_valid() && chats_.count(chat_id) == 0) {
+      load_chat_from_database(nullptr, chat_id, mpas.get_promise());
+    }
+  }
+  lock.set_value(Unit());
+}
+
 bool ChatManager::have_chat_force(ChatId chat_id, const char *source) {
   return get_chat_force(chat_id, source) != nullptr;
 }
@@ -4373,11 +4443,33 @@ void ChatManager::load_channel_from_database_impl(ChannelId channel_id, Promise<
   auto &load_channel_queries = load_channel_from_database_queries_[channel_id];
   load_channel_queries.push_back(std::move(promise));
   if (load_channel_queries.size() == 1u) {
-    G()->td_db()->get_sqlite_pmc()->get(get_channel_database_key(channel_id),
-                                        PromiseCreator::lambda([channel_id](string value) {
-                                          send_closure(G()->chat_manager(), &ChatManager::on_load_channel_from_database,
-                                                       channel_id, std::move(value), false);
-                                        }));
+    // supergroups requested during the same event are loaded by a single database query
+    pending_load_channel_ids_.push_back(channel_id);
+    if (pending_load_channel_ids_.size() == 1u) {
+      send_closure_later(actor_id(this), &ChatManager::load_pending_channels_from_database);
+    }
+  }
+}
+
+void ChatManager::load_pending_channels_from_database() {
+  auto channel_ids = std::move(pending_load_channel_ids_);
+  pending_load_channel_ids_.clear();
+  if (channel_ids.empty()) {
+    return;
+  }
+  LOG(INFO) << "Load " << channel_ids.size() << " supergroups from database";
+  auto keys = transform(channel_ids, get_channel_database_key);
+  G()->td_db()->get_sqlite_pmc()->get_many(
+      std::move(keys), PromiseCreator::lambda([channel_ids = std::move(channel_ids)](vector<string> values) mutable {
+        send_closure(G()->chat_manager(), &ChatManager::on_load_channels_from_database, std::move(channel_ids),
+                     std::move(values));
+      }));
+}
+
+void ChatManager::on_load_channels_from_database(vector<ChannelId> channel_ids, vector<string> values) {
+  CHECK(channel_ids.size() == values.size());
+  for (size_t i = 0; i < channel_ids.size(); i++) {
+    on_load_channel_from_database(channel_ids[i], std::move(values[i]), false);
   }
 }
 
@@ -4404,6 +4496,16 @@ void ChatManager::on_load_channel_from_database(ChannelId channel_id, string val
   //  G()->td_db()->get_sqlite_pmc()->erase(get_channel_database_key(channel_id), Auto());
   //  return;
 
+  if (channel_evictor_.is_evicted(channel_id)) {
+    auto channel = channel_evictor_.take_object(channel_id);
+    if (channel == nullptr) {
+      channel = parse_evicted_channel(channel_id, value);
+    }
+    return_evicted_channel(channel_id, std::move(channel));
+    set_promises(promises);
+    return;
+  }
+
   Channel *c = get_channel(channel_id);
   if (c == nullptr) {
     if (!value.empty()) {
@@ -4454,6 +4556,23 @@ void ChatManager::on_load_channel_from_database(ChannelId channel_id, string val
   set_promises(promises);
 }
 
+void ChatManager::load_channels_from_database(const vector<ChannelId> &channel_ids, Promise<Unit> &&promise) {
+  if (!G()->use_chat_info_database()) {
+    return promise.set_value(Unit());
+  }
+
+  MultiPromiseActorSafe mpas{"LoadChannelsFromDatabaseMultiPromiseActor"};
+  mpas.add_promise(std::move(promise));
+  auto lock = mpas.get_promise();
+  for (auto channel_id : channel_ids) {
+    // evicted supergroups are loaded back together with unknown supergroups
+    if (channel_id.is_valid() && channels_.count(channel_id) == 0) {
+      load_channel_from_database(nullptr, channel_id, mpas.get_promise());
+    }
+  }
+  lock.set_value(Unit());
+}
+
 bool ChatManager::have_channel_force(ChannelId channel_id, const char *source) {
   return get_channel_force(channel_id, source) != nullptr;
 }
@@ -7490,26 +7609,119 @@ void ChatManager::create_new_channel(const string &title, bool is_forum, bool is
 }
 
 bool ChatManager::have_chat(ChatId chat_id) const {
-  return chats_.count(chat_id) > 0;
+  return chats_.count(chat_id) > 0 || chat_evictor_.is_evicted(chat_id);
 }
 
 const ChatManager::Chat *ChatManager::get_chat(ChatId chat_id) const {
-  return chats_.get_pointer(chat_id);
+  auto c = chats_.get_pointer(chat_id);
+  if (c == nullptr) {
+    return get_evicted_chat(chat_id);
+  }
+  c->was_accessed = true;
+  return c;
 }
 
 ChatManager::Chat *ChatManager::get_chat(ChatId chat_id) {
-  return chats_.get_pointer(chat_id);
+  auto c = chats_.get_pointer(chat_id);
+  if (c == nullptr) {
+    return get_evicted_chat(chat_id);
+  }
+  c->was_accessed = true;
+  return c;
 }
 
 ChatManager::Chat *ChatManager::add_chat(ChatId chat_id) {
   CHECK(chat_id.is_valid());
   auto &chat_ptr = chats_[chat_id];
   if (chat_ptr == nullptr) {
-    chat_ptr = make_unique<Chat>();
+    chat_ptr = chat_evictor_.take_object(chat_id);
+    if (chat_ptr == nullptr) {
+      chat_ptr = make_unique<Chat>();
+    } else {
+      loaded_from_database_chats_.insert(chat_id);
+    }
   }
   return chat_ptr.get();
 }
 
+ChatManager::Chat *ChatManager::get_evicted_chat(ChatId chat_id) const {
+  if (!chat_evictor_.is_evicted(chat_id)) {
+    return nullptr;
+  }
+
+  return chat_evictor_.get_evicted_object(chat_id, [&] {
+    if (!chat_evictor_.has_restored_objects()) {
+      send_closure_later(G()->chat_manager(), &ChatManager::return_restored_chats);
+    }
+    LOG(INFO) << "Load evicted " << chat_id << " from database";
+    return parse_evicted_chat(chat_id, G()->td_db()->get_sqlite_sync_pmc()->get(get_chat_database_key(chat_id)));
+  });
+}
+
+unique_ptr<ChatManager::Chat> ChatManager::parse_evicted_chat(ChatId chat_id, const string &value) const {
+  auto chat = make_unique<Chat>();
+  if (value.empty() || log_event_parse(*chat, value).is_error()) {
+    LOG(ERROR) << "Failed to load evicted " << chat_id << " from database";
+    return nullptr;
+  }
+
+  // the chat was saved to the database before eviction, and the client already has the same version of the chat,
+  // so there is no need to send updates about it or to save it again
+  auto c = chat.get();
+  c->is_title_changed = false;
+  c->is_photo_changed = false;
+  c->is_default_permissions_changed = false;
+  c->is_status_changed = false;
+  c->is_is_active_changed = false;
+  c->is_noforwards_changed = false;
+  c->is_changed = false;
+  c->need_save_to_database = false;
+  c->is_update_basic_group_sent = true;
+  c->is_saved = true;
+  return chat;
+}
+
+void ChatManager::return_evicted_chat(ChatId chat_id, unique_ptr<Chat> chat) {
+  CHECK(!chat_evictor_.is_evicted(chat_id));
+  if (chat == nullptr) {
+    return;
+  }
+  CHECK(chats_.get_pointer(chat_id) == nullptr);
+  chats_.set(chat_id, std::move(chat));
+  loaded_from_database_chats_.insert(chat_id);
+}
+
+void ChatManager::return_restored_chats() {
+  for (auto chat_id : chat_evictor_.get_restored_object_keys()) {
+    return_evicted_chat(chat_id, chat_evictor_.take_object(chat_id));
+  }
+}
+
+bool ChatManager::can_evict_chat(ChatId chat_id, const Chat *c) const {
+  return c->is_saved && !c->is_being_saved && !c->is_being_updated && !c->is_changed && !c->need_save_to_database &&
+         c->is_update_basic_group_sent && c->log_event_id == 0 && chats_full_.count(chat_id) == 0 &&
+         load_chat_from_database_queries_.count(chat_id) == 0;
+}
+
+void ChatManager::evict_cold_chats(size_t max_count) {
+  auto chat_count = chats_.calc_size();
+  if (chat_count <= max_count) {
+    return;
+  }
+
+  // evict a bit more chats than needed to avoid eviction during each pass
+  auto evict_count = chat_count - max_count / 10 * 9;
+  auto chat_ids = chat_evictor_.get_cold_objects(
+      chats_, evict_count, [&](ChatId chat_id, const Chat *c) { return can_evict_chat(chat_id, c); });
+
+  LOG(INFO) << "Evict " << chat_ids.size() << " cold basic groups out of " << chat_count;
+  for (auto chat_id : chat_ids) {
+    chats_.erase(chat_id);
+    loaded_from_database_chats_.erase(chat_id);
+    chat_evictor_.on_object_evicted(chat_id);
+  }
+}
+
 bool ChatManager::get_chat(ChatId chat_id, int left_tries, Promise<Unit> &&promise) {
   if (!chat_id.is_valid()) {
     promise.set_error(Status::Error(400, "Invalid basic group identifier"));
@@ -7932,7 +8144,7 @@ int32 ChatManager::get_channel_my_boost_count(ChannelId channel_id) {
 }
 
 bool ChatManager::have_channel(ChannelId channel_id) const {
-  return channels_.count(channel_id) > 0;
+  return channels_.count(channel_id) > 0 || channel_evictor_.is_evicted(channel_id);
 }
 
 bool ChatManager::have_min_channel(ChannelId channel_id) const {
@@ -7951,23 +8163,122 @@ void ChatManager::add_min_channel(ChannelId channel_id, const MinChannel &min_ch
 }
 
 const ChatManager::Channel *ChatManager::get_channel(ChannelId channel_id) const {
-  return channels_.get_pointer(channel_id);
+  auto c = channels_.get_pointer(channel_id);
+  if (c == nullptr) {
+    return get_evicted_channel(channel_id);
+  }
+  c->was_accessed = true;
+  return c;
 }
 
 ChatManager::Channel *ChatManager::get_channel(ChannelId channel_id) {
-  return channels_.get_pointer(channel_id);
+  auto c = channels_.get_pointer(channel_id);
+  if (c == nullptr) {
+    return get_evicted_channel(channel_id);
+  }
+  c->was_accessed = true;
+  return c;
 }
 
 ChatManager::Channel *ChatManager::add_channel(ChannelId channel_id, const char *source) {
   CHECK(channel_id.is_valid());
   auto &channel_ptr = channels_[channel_id];
   if (channel_ptr == nullptr) {
-    channel_ptr = make_unique<Channel>();
+    channel_ptr = channel_evictor_.take_object(channel_id);
+    if (channel_ptr == nullptr) {
+      channel_ptr = make_unique<Channel>();
+    } else {
+      loaded_from_database_channels_.insert(channel_id);
+    }
     min_channels_.erase(channel_id);
   }
   return channel_ptr.get();
 }
 
+ChatManager::Channel *ChatManager::get_evicted_channel(ChannelId channel_id) const {
+  if (!channel_evictor_.is_evicted(channel_id)) {
+    return nullptr;
+  }
+
+  return channel_evictor_.get_evicted_object(channel_id, [&] {
+    if (!channel_evictor_.has_restored_objects()) {
+      send_closure_later(G()->chat_manager(), &ChatManager::return_restored_channels);
+    }
+    LOG(INFO) << "Load evicted " << channel_id << " from database";
+    return parse_evicted_channel(channel_id,
+                                 G()->td_db()->get_sqlite_sync_pmc()->get(get_channel_database_key(channel_id)));
+  });
+}
+
+unique_ptr<ChatManager::Channel> ChatManager::parse_evicted_channel(ChannelId channel_id, const string &value) const {
+  auto channel = make_unique<Channel>();
+  if (value.empty() || log_event_parse(*channel, value).is_error()) {
+    LOG(ERROR) << "Failed to load evicted " << channel_id << " from database";
+    return nullptr;
+  }
+
+  // the channel was saved to the database before eviction, and the client already has the same version of the channel,
+  // so there is no need to send updates about it or to save it again
+  auto c = channel.get();
+  c->last_sent_emoji_status = c->emoji_status.get_effective_emoji_status(true, G()->unix_time());
+  c->is_title_changed = false;
+  c->is_username_changed = false;
+  c->is_photo_changed = false;
+  c->is_emoji_status_changed = false;
+  c->is_accent_color_changed = false;
+  c->is_default_permissions_changed = false;
+  c->is_status_changed = false;
+  c->is_stories_hidden_changed = false;
+  c->is_has_location_changed = false;
+  c->is_noforwards_changed = false;
+  c->is_creator_changed = false;
+  c->is_changed = false;
+  c->need_save_to_database = false;
+  c->is_update_supergroup_sent = true;
+  c->is_saved = true;
+  return channel;
+}
+
+void ChatManager::return_evicted_channel(ChannelId channel_id, unique_ptr<Channel> channel) {
+  CHECK(!channel_evictor_.is_evicted(channel_id));
+  if (channel == nullptr) {
+    return;
+  }
+  CHECK(channels_.get_pointer(channel_id) == nullptr);
+  channels_.set(channel_id, std::move(channel));
+  loaded_from_database_channels_.insert(channel_id);
+}
+
+void ChatManager::return_restored_channels() {
+  for (auto channel_id : channel_evictor_.get_restored_object_keys()) {
+    return_evicted_channel(channel_id, channel_evictor_.take_object(channel_id));
+  }
+}
+
+bool ChatManager::can_evict_channel(ChannelId channel_id, const Channel *c) const {
+  return c->is_saved && !c->is_being_saved && !c->is_being_updated && !c->is_changed && !c->need_save_to_database &&
+         c->is_update_supergroup_sent && c->log_event_id == 0 && channels_full_.count(channel_id) == 0 &&
+         load_channel_from_database_queries_.count(channel_id) == 0;
+}
+
+void ChatManager::evict_cold_channels(size_t max_count) {
+  auto channel_count = channels_.calc_size();
+  if (channel_count <= max_count) {
+    return;
+  }
+
+  auto evict_count = channel_count - max_count / 10 * 9;
+  auto channel_ids = channel_evictor_.get_cold_objects(
+      channels_, evict_count, [&](ChannelId channel_id, const Channel *c) { return can_evict_channel(channel_id, c); });
+
+  LOG(INFO) << "Evict " << channel_ids.size() << " cold supergroups out of " << channel_count;
+  for (auto channel_id : channel_ids) {
+    channels_.erase(channel_id);
+    loaded_from_database_channels_.erase(channel_id);
+    channel_evictor_.on_object_evicted(channel_id);
+  }
+}
+
 bool ChatManager::get_channel(ChannelId channel_id, int left_tries, Promise<Unit> &&promise) {
   if (!channel_id.is_valid()) {
     promise.set_error(Status::Error(400, "Invalid supergroup identifier"));
@@ -8922,4 +9233,14 @@ void ChatManager::get_current_state(vector<td_api::object_ptr<td_api::Update>> &
   });
 }
 
+void ChatManager::get_memory_statistics(MemoryStatistics &statistics) const {
+  statistics.add("basic_groups", chats_);
+  statistics.add("evicted_basic_groups", chat_evictor_);
+  statistics.add("basic_groups_full", chats_full_);
+  statistics.add("min_supergroups", min_channels_);
+  statistics.add("supergroups", channels_);
+  statistics.add("evicted_supergroups", channel_evictor_);
+  statistics.add("supergroups_full", channels_full_);
+}
+
 }  // namespace td
@@ -10,6 +10,7 @@
 #include "td/telegram/AccessRights.h"
 #include "td/telegram/BotCommand.h"
 #include "td/telegram/ChannelId.h"
+#include "td/telegram/ColdObjectEvictor.h"
 #include "td/telegram/ChannelType.h"
 #include "td/telegram/ChatId.h"
 #include "td/telegram/CustomEmojiId.h"
@@ -54,6 +55,7 @@
 namespace td {
 
 struct BinlogEvent;
+class MemoryStatistics;
 struct MinChannel;
 class Td;
 
@@ -307,6 +309,7 @@ class ChatManager final : public Actor {
   bool have_chat_force(ChatId chat_id, const char *source);
   bool get_chat(ChatId chat_id, int left_tries, Promise<Unit> &&promise);
   void reload_chat(ChatId chat_id, Promise<Unit> &&promise, const char *source);
+  void load_chats_from_database(const vector<ChatId> &chat_ids, Promise<Unit> &&promise);
   void load_chat_full(ChatId chat_id, bool force, Promise<Unit> &&promise, const char *source);
   FileSourceId get_chat_full_file_source_id(ChatId chat_id);
   void reload_chat_full(ChatId chat_id, Promise<Unit> &&promise, const char *source);
@@ -333,6 +336,7 @@ class ChatManager final : public Actor {
   bool have_channel_force(ChannelId channel_id, const char *source);
   bool get_channel(ChannelId channel_id, int left_tries, Promise<Unit> &&promise);
   void reload_channel(ChannelId channel_id, Promise<Unit> &&promise, const char *source);
+  void load_channels_from_database(const vector<ChannelId> &channel_ids, Promise<Unit> &&promise);
   void load_channel_full(ChannelId channel_id, bool force, Promise<Unit> &&promise, const char *source);
   FileSourceId get_channel_full_file_source_id(ChannelId channel_id);
   void reload_channel_full(ChannelId channel_id, Promise<Unit> &&promise, const char *source);
@@ -383,6 +387,8 @@ class ChatManager final : public Actor {
 
   void get_current_state(vector<td_api::object_ptr<td_api::Update>> &updates) const;
 
+  void get_memory_statistics(MemoryStatistics &statistics) const;
+
  private:
   struct Chat {
     string title;
@@ -422,6 +428,8 @@ class ChatManager final : public Actor {
 
     bool is_received_from_server = false;  // true, if the chat was received from the server and not the database
 
+    mutable bool was_accessed = true;  // whether the chat was accessed since the last eviction pass
+
     uint64 log_event_id = 0;
 
     template <class StorerT>
@@ -529,6 +537,8 @@ class ChatManager final : public Actor {
 
     bool is_received_from_server = false;  // true, if the channel was received from the server and not the database
 
+    mutable bool was_accessed = true;  // whether the channel was accessed since the last eviction pass
+
     uint64 log_event_id = 0;
 
     template <class StorerT>
@@ -617,6 +627,8 @@ class ChatManager final : public Actor {
 
   static constexpr int32 MAX_ACTIVE_STORY_ID_RELOAD_TIME = 3600;  // some reasonable limit
 
+  static constexpr int32 COLD_OBJECT_EVICTION_PERIOD = 60;  // period of checks for cold chats to remove from memory
+
   static constexpr int32 CHAT_FLAG_USER_IS_CREATOR = 1 << 0;
   static constexpr int32 CHAT_FLAG_USER_HAS_LEFT = 1 << 2;
   // static constexpr int32 CHAT_FLAG_ADMINISTRATORS_ENABLED = 1 << 3;
@@ -669,6 +681,14 @@ class ChatManager final : public Actor {
 
   Chat *add_chat(ChatId chat_id);
 
+  Chat *get_evicted_chat(ChatId chat_id) const;
+
+  unique_ptr<Chat> parse_evicted_chat(ChatId chat_id, const string &value) const;
+
+  void return_evicted_chat(ChatId chat_id, unique_ptr<Chat> chat);
+
+  void return_restored_chats();
+
   const ChatFull *get_chat_full(ChatId chat_id) const;
   ChatFull *get_chat_full(ChatId chat_id);
   ChatFull *get_chat_full_force(ChatId chat_id, const char *source);
@@ -683,6 +703,22 @@ class ChatManager final : public Actor {
 
   Channel *add_channel(ChannelId channel_id, const char *source);
 
+  Channel *get_evicted_channel(ChannelId channel_id) const;
+
+  unique_ptr<Channel> parse_evicted_channel(ChannelId channel_id, const string &value) const;
+
+  void return_evicted_channel(ChannelId channel_id, unique_ptr<Channel> channel);
+
+  void return_restored_channels();
+
+  bool can_evict_chat(ChatId chat_id, const Chat *c) const;
+
+  bool can_evict_channel(ChannelId channel_id, const Channel *c) const;
+
+  void evict_cold_chats(size_t max_count);
+
+  void evict_cold_channels(size_t max_count);
+
   const ChannelFull *get_channel_full(ChannelId channel_id) const;
   const ChannelFull *get_channel_full_const(ChannelId channel_id) const;
   ChannelFull *get_channel_full(ChannelId channel_id, bool only_local, const char *source);
@@ -792,6 +828,8 @@ class ChatManager final : public Actor {
   void on_save_chat_to_database(ChatId chat_id, bool success);
   void load_chat_from_database(Chat *c, ChatId chat_id, Promise<Unit> promise);
   void load_chat_from_database_impl(ChatId chat_id, Promise<Unit> promise);
+  void load_pending_chats_from_database();
+  void on_load_chats_from_database(vector<ChatId> chat_ids, vector<string> values);
   void on_load_chat_from_database(ChatId chat_id, string value, bool force);
 
   void save_channel(Channel *c, ChannelId channel_id, bool from_binlog);
@@ -802,6 +840,8 @@ class ChatManager final : public Actor {
   void on_save_channel_to_database(ChannelId channel_id, bool success);
   void load_channel_from_database(Channel *c, ChannelId channel_id, Promise<Unit> promise);
   void load_channel_from_database_impl(ChannelId channel_id, Promise<Unit> promise);
+  void load_pending_channels_from_database();
+  void on_load_channels_from_database(vector<ChannelId> channel_ids, vector<string> values);
   void on_load_channel_from_database(ChannelId channel_id, string value, bool force);
 
   static void save_chat_full(const ChatFull *chat_full, ChatId chat_id);
@@ -895,6 +935,10 @@ class ChatManager final : public Actor {
 
   void on_slow_mode_delay_timeout(ChannelId channel_id);
 
+  void start_up() final;
+
+  void timeout_expired() final;
+
   void tear_down() final;
 
   Td *td_;
@@ -923,12 +967,16 @@ class ChatManager final : public Actor {
   vector<ChannelId> inactive_channel_ids_;
 
   FlatHashMap<ChatId, vector<Promise<Unit>>, ChatIdHash> load_chat_from_database_queries_;
+  vector<ChatId> pending_load_chat_ids_;
   FlatHashSet<ChatId, ChatIdHash> loaded_from_database_chats_;
   FlatHashSet<ChatId, ChatIdHash> unavailable_chat_fulls_;
+  ColdObjectEvictor<ChatId, Chat, ChatIdHash> chat_evictor_;
 
   FlatHashMap<ChannelId, vector<Promise<Unit>>, ChannelIdHash> load_channel_from_database_queries_;
+  vector<ChannelId> pending_load_channel_ids_;
   FlatHashSet<ChannelId, ChannelIdHash> loaded_from_database_channels_;
   FlatHashSet<ChannelId, ChannelIdHash> unavailable_channel_fulls_;
+  ColdObjectEvictor<ChannelId, Channel, ChannelIdHash> channel_evictor_;
 
   QueryMerger get_chat_queries_{"GetChatMerger", 3, 50};
   QueryMerger get_channel_queries_{"GetChannelMerger", 100, 1};  // can't merge getChannel queries without access hash
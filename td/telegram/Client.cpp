@@ -6,6 +6,7 @@
 //
 #include "td/telegram/Client.h"
 
+#include "td/telegram/ObjectSnapshotCache.h"
 #include "td/telegram/Td.h"
 #include "td/telegram/TdCallback.h"
 
@@ -239,7 +240,8 @@ class MultiTd final : public Actor {
  public:
   explicit MultiTd(Td::Options options) : options_(std::move(options)) {
   }
-  void create(int32 td_id, unique_ptr<TdCallback> callback) {
+  void create(int32 td_id, unique_ptr<TdCallback> callback,
+              std::shared_ptr<ObjectSnapshotCache> object_snapshot_cache) {
     auto &td = tds_[td_id];
     CHECK(td.empty());
 
@@ -247,7 +249,9 @@ class MultiTd final : public Actor {
     auto context = std::make_shared<ActorContext>();
     auto old_context = set_context(context);
     auto old_tag = set_tag(to_string(td_id));
-    td = create_actor<Td>("Td", std::move(callback), options_);
+    auto options = options_;
+    options.object_snapshot_cache = std::move(object_snapshot_cache);
+    td = create_actor<Td>("Td", std::move(callback), std::move(options));
     set_context(std::move(old_context));
     set_tag(std::move(old_tag));
   }
@@ -295,17 +299,23 @@ class TdReceiver {
     return response;
   }
 
-  unique_ptr<TdCallback> create_callback(ClientManager::ClientId client_id) {
+  unique_ptr<TdCallback> create_callback(ClientManager::ClientId client_id,
+                                         std::shared_ptr<ObjectSnapshotCache> object_snapshot_cache = nullptr) {
     class Callback final : public TdCallback {
      public:
-      explicit Callback(ClientManager::ClientId client_id, std::shared_ptr<OutputQueue> output_queue)
-          : client_id_(client_id), output_queue_(std::move(output_queue)) {
+      Callback(ClientManager::ClientId client_id, std::shared_ptr<OutputQueue> output_queue,
+               std::shared_ptr<ObjectSnapshotCache> object_snapshot_cache)
+          : client_id_(client_id)
+          , output_queue_(std::move(output_queue))
+          , object_snapshot_cache_(std::move(object_snapshot_cache)) {
       }
       void on_result(uint64 id, td_api::object_ptr<td_api::Object> result) final {
         output_queue_->writer_put({client_id_, id, std::move(result)});
+        on_response_sent(id);
       }
       void on_error(uint64 id, td_api::object_ptr<td_api::error> error) final {
         output_queue_->writer_put({client_id_, id, std::move(error)});
+        on_response_sent(id);
       }
       Callback(const Callback &) = delete;
       Callback &operator=(const Callback &) = delete;
@@ -318,8 +328,15 @@ class TdReceiver {
      private:
       ClientManager::ClientId client_id_;
       std::shared_ptr<OutputQueue> output_queue_;
+      std::shared_ptr<ObjectSnapshotCache> object_snapshot_cache_;
+
+      void on_response_sent(uint64 id) {
+        if (id != 0 && object_snapshot_cache_ != nullptr) {
+          object_snapshot_cache_->on_response_sent();
+        }
+      }
     };
-    return td::make_unique<Callback>(client_id, output_queue_);
+    return td::make_unique<Callback>(client_id, output_queue_, std::move(object_snapshot_cache));
   }
 
   void add_response(ClientManager::ClientId client_id, uint64 id, td_api::object_ptr<td_api::Object> result) {
@@ -352,8 +369,10 @@ class MultiImpl {
  public:
   static constexpr int32 ADDITIONAL_THREAD_COUNT = 3;
 
-  explicit MultiImpl(std::shared_ptr<NetQueryStats> net_query_stats) {
-    concurrent_scheduler_ = std::make_shared<ConcurrentScheduler>(ADDITIONAL_THREAD_COUNT, 0);
+  // the thread of the database reader scheduler is started only if the scheduler is used
+  MultiImpl(std::shared_ptr<NetQueryStats> net_query_stats, bool has_database_read_scheduler) {
+    concurrent_scheduler_ = std::make_shared<ConcurrentScheduler>(ADDITIONAL_THREAD_COUNT, 0,
+                                                                  has_database_read_scheduler ? 1 : 0);
     concurrent_scheduler_->start();
 
     {
@@ -379,10 +398,11 @@ class MultiImpl {
     return static_cast<int32>(result);
   }
 
-  void create(int32 td_id, unique_ptr<TdCallback> callback) {
+  void create(int32 td_id, unique_ptr<TdCallback> callback,
+              std::shared_ptr<ObjectSnapshotCache> object_snapshot_cache = nullptr) {
     LOG(INFO) << "Initialize client " << td_id;
     auto guard = concurrent_scheduler_->get_send_guard();
-    send_closure(multi_td_, &MultiTd::create, td_id, std::move(callback));
+    send_closure(multi_td_, &MultiTd::create, td_id, std::move(callback), std::move(object_snapshot_cache));
   }
 
   static bool is_valid_client_id(int32 client_id) {
@@ -446,7 +466,12 @@ class MultiImplPool {
                                    [](auto &a, auto &b) { return a.lock().use_count() < b.lock().use_count(); });
     auto result = impl.lock();
     if (!result) {
-      result = std::make_shared<MultiImpl>(net_query_stats_);
+      // database reader threads are added only while the total number of threads fits in the thread limit
+      auto impl_index = static_cast<int32>(&impl - &impls_[0]);
+      auto max_reader_thread_count =
+          127 - static_cast<int32>(impls_.size()) * (1 + MultiImpl::ADDITIONAL_THREAD_COUNT + 1 /* IOCP */);
+      bool has_database_read_scheduler = impl_index < max_reader_thread_count;
+      result = std::make_shared<MultiImpl>(net_query_stats_, has_database_read_scheduler);
       impl = result;
     }
     return result;
@@ -483,7 +508,7 @@ class ClientManager::Impl final {
     LOG(INFO) << "Created managed client " << client_id;
     {
       auto lock = impls_mutex_.lock_write().move_as_ok();
-      impls_[client_id];  // create empty MultiImplInfo
+      impls_[client_id].object_snapshot_cache = std::make_shared<ObjectSnapshotCache>();
     }
     return client_id;
   }
@@ -504,7 +529,8 @@ class ClientManager::Impl final {
       it = impls_.find(client_id);
       if (it != impls_.end() && it->second.impl == nullptr) {
         it->second.impl = pool_.get();
-        it->second.impl->create(client_id, receiver_.create_callback(client_id));
+        it->second.impl->create(client_id, receiver_.create_callback(client_id, it->second.object_snapshot_cache),
+                                it->second.object_snapshot_cache);
       }
       write_lock.reset();
 
@@ -515,6 +541,18 @@ class ClientManager::Impl final {
       receiver_.add_response(client_id, request_id, td_api::make_object<td_api::error>(500, "Request aborted"));
       return;
     }
+    auto &object_snapshot_cache = it->second.object_snapshot_cache;
+    if (request != nullptr && request_id != 0 && ObjectSnapshotCache::is_cacheable_request(*request)) {
+      // answer side-effect-free getters on the caller thread if the object is cached and no request is pending
+      auto object = object_snapshot_cache->get_object(*request);
+      if (object != nullptr) {
+        receiver_.add_response(client_id, request_id, std::move(object));
+        return;
+      }
+    }
+    if (request_id != 0) {
+      object_snapshot_cache->on_request_sent();
+    }
     it->second.impl->send(client_id, request_id, std::move(request));
   }
 
@@ -585,6 +623,7 @@ class ClientManager::Impl final {
   RwMutex impls_mutex_;
   struct MultiImplInfo {
     std::shared_ptr<MultiImpl> impl;
+    std::shared_ptr<ObjectSnapshotCache> object_snapshot_cache;
     bool is_closed = false;
   };
   FlatHashMap<ClientId, MultiImplInfo> impls_;
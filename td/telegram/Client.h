@@ -80,6 +80,8 @@ class ClientManager final {
 
   /**
    * Sends request to TDLib. May be called from any thread.
+   * If the option "use_fast_getters" is enabled, then getUser, getChat, getMessage and getFile can be answered
+   * from an in-memory snapshot of the object on the calling thread, without waiting for other requests.
    * \param[in] client_id TDLib client instance identifier.
    * \param[in] request_id Request identifier. Must be non-zero.
    * \param[in] request Request to TDLib.
@@ -0,0 +1,120 @@
+//
+// Copyright Aliaksei Levin (levlam@telegram.org), Arseny Smirnov (arseny30@gmail.com) 2014-2024
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+#pragma once
+
+#include "td/utils/common.h"
+#include "td/utils/FlatHashMap.h"
+#include "td/utils/FlatHashSet.h"
+#include "td/utils/logging.h"
+#include "td/utils/WaitFreeHashMap.h"
+
+#include <algorithm>
+
+namespace td {
+
+// Chooses cold objects to be removed from memory using the clock (second chance) algorithm and remembers
+// identifiers of the removed objects, so that they can be loaded back from the database when they are needed again.
+// ObjectT must have a mutable boolean field was_accessed, which is set whenever the object is accessed.
+// KeyT must have the method get(), which returns a unique identifier of the object.
+template <class KeyT, class ObjectT, class HashT>
+class ColdObjectEvictor {
+ public:
+  using Objects = WaitFreeHashMap<KeyT, unique_ptr<ObjectT>, HashT>;
+
+  // moves the clock hand over at most all the objects and returns identifiers of at most max_count objects,
+  // which weren't accessed since the previous visit of the hand and for which can_evict returns true;
+  // the hand visits objects in the order of their identifiers and continues from the place where it has stopped
+  template <class F>
+  vector<KeyT> get_cold_objects(Objects &objects, size_t max_count, const F &can_evict) {
+    vector<KeyT> keys;
+    keys.reserve(objects.calc_size());
+    objects.foreach([&](const KeyT &key, unique_ptr<ObjectT> &) { keys.push_back(key); });
+    std::sort(keys.begin(), keys.end(), [](const KeyT &lhs, const KeyT &rhs) { return lhs.get() < rhs.get(); });
+    // the hand continues from the first object after the last visited one
+    auto start_it =
+        std::upper_bound(keys.begin(), keys.end(), hand_, [](int64 hand, const KeyT &key) { return hand < key.get(); });
+    auto start = static_cast<size_t>(start_it - keys.begin());
+
+    vector<KeyT> result;
+    for (size_t i = 0; i < keys.size() && result.size() < max_count; i++) {
+      const auto &key = keys[(start + i) % keys.size()];
+      hand_ = key.get();
+      auto object = objects.get_pointer(key);
+      CHECK(object != nullptr);
+      if (object->was_accessed) {
+        // give the object a second chance
+        object->was_accessed = false;
+        continue;
+      }
+      if (can_evict(key, static_cast<const ObjectT *>(object))) {
+        result.push_back(key);
+      }
+    }
+    return result;
+  }
+
+  void on_object_evicted(KeyT key) {
+    evicted_keys_.insert(key);
+  }
+
+  bool is_evicted(KeyT key) const {
+    return evicted_keys_.count(key) != 0;
+  }
+
+  // returns the evicted object, which is loaded back through load_object at most once;
+  // the object is kept aside until it is returned with take_object, so that containers,
+  // which can be iterated at the moment, aren't changed
+  template <class F>
+  ObjectT *get_evicted_object(KeyT key, const F &load_object) const {
+    CHECK(is_evicted(key));
+    auto it = restored_objects_.find(key);
+    if (it != restored_objects_.end()) {
+      return it->second.get();
+    }
+    auto object = load_object();
+    auto result = object.get();
+    restored_objects_.emplace(key, std::move(object));
+    return result;
+  }
+
+  bool has_restored_objects() const {
+    return !restored_objects_.empty();
+  }
+
+  vector<KeyT> get_restored_object_keys() const {
+    vector<KeyT> result;
+    for (auto &it : restored_objects_) {
+      result.push_back(it.first);
+    }
+    return result;
+  }
+
+  // forgets about the evicted object; returns the object if it was already loaded back
+  unique_ptr<ObjectT> take_object(KeyT key) {
+    if (evicted_keys_.erase(key) == 0) {
+      return nullptr;
+    }
+    auto it = restored_objects_.find(key);
+    if (it == restored_objects_.end()) {
+      return nullptr;
+    }
+    auto object = std::move(it->second);
+    restored_objects_.erase(it);
+    return object;
+  }
+
+  size_t get_evicted_object_count() const {
+    return evicted_keys_.size();
+  }
+
+ private:
+  int64 hand_ = 0;  // the identifier of the last visited object
+  FlatHashSet<KeyT, HashT> evicted_keys_;
+  mutable FlatHashMap<KeyT, unique_ptr<ObjectT>, HashT> restored_objects_;
+};
+
+}  // namespace td
@@ -50,6 +50,18 @@ class Dependencies {
 
   bool resolve_force(Td *td, const char *source, bool ignore_errors = false) const;
 
+  const FlatHashSet<UserId, UserIdHash> &get_user_ids() const {
+    return user_ids;
+  }
+
+  const FlatHashSet<ChatId, ChatIdHash> &get_chat_ids() const {
+    return chat_ids;
+  }
+
+  const FlatHashSet<ChannelId, ChannelIdHash> &get_channel_ids() const {
+    return channel_ids;
+  }
+
   const FlatHashSet<DialogId, DialogIdHash> &get_dialog_ids() const {
     return dialog_ids;
   }
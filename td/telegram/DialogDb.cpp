@@ -8,8 +8,10 @@
 
 #include "td/telegram/Version.h"
 
+#include "td/db/SqliteBlobCompressor.h"
 #include "td/db/SqliteConnectionSafe.h"
 #include "td/db/SqliteDb.h"
+#include "td/db/SqliteReadQueryPool.h"
 #include "td/db/SqliteStatement.h"
 
 #include "td/actor/actor.h"
@@ -23,6 +25,8 @@
 #include "td/utils/SliceBuilder.h"
 #include "td/utils/Time.h"
 
+#include <atomic>
+
 namespace td {
 // NB: must happen inside a transaction
 Status init_dialog_db(SqliteDb &db, int32 version, KeyValueSyncInterface &binlog_pmc, bool &was_created) {
@@ -111,7 +115,8 @@ Status drop_dialog_db(SqliteDb &db, int version) {
 
 class DialogDbImpl final : public DialogDbSyncInterface {
  public:
-  explicit DialogDbImpl(SqliteDb db) : db_(std::move(db)) {
+  DialogDbImpl(SqliteDb db, const std::atomic<bool> *use_compression)
+      : db_(std::move(db)), use_compression_(use_compression) {
     init().ensure();
   }
 
@@ -150,7 +155,7 @@ class DialogDbImpl final : public DialogDbSyncInterface {
     // LOG(ERROR) << get_notification_group_stmt_.explain().ok();
     // LOG(FATAL) << "EXPLAINED";
 
-    return Status::OK();
+    return compressor_.init(db_.clone(), "dialogs", use_compression_);
   }
 
   void add_dialog(DialogId dialog_id, FolderId folder_id, int64 order, BufferSlice data,
@@ -160,7 +165,7 @@ class DialogDbImpl final : public DialogDbSyncInterface {
     };
     add_dialog_stmt_.bind_int64(1, dialog_id.get()).ensure();
     add_dialog_stmt_.bind_int64(2, order).ensure();
-    add_dialog_stmt_.bind_blob(3, data.as_slice()).ensure();
+    add_dialog_stmt_.bind_blob(3, compressor_.compress(data.as_slice())).ensure();
     if (order > 0) {
       add_dialog_stmt_.bind_int32(4, folder_id.get()).ensure();
     } else {
@@ -202,7 +207,7 @@ class DialogDbImpl final : public DialogDbSyncInterface {
     if (!get_dialog_stmt_.has_row()) {
       return Status::Error("Not found");
     }
-    return BufferSlice(get_dialog_stmt_.view_blob(0));
+    return compressor_.decompress(get_dialog_stmt_.view_blob(0));
   }
 
   Result<NotificationGroupKey> get_notification_group(NotificationGroupId notification_group_id) final {
@@ -243,7 +248,7 @@ class DialogDbImpl final : public DialogDbSyncInterface {
     result.next_order = order;
     get_dialogs_stmt_.step().ensure();
     while (get_dialogs_stmt_.has_row()) {
-      BufferSlice data(get_dialogs_stmt_.view_blob(0));
+      auto data = compressor_.decompress(get_dialogs_stmt_.view_blob(0));
       result.next_dialog_id = DialogId(get_dialogs_stmt_.view_int64(1));
       result.next_order = get_dialogs_stmt_.view_int64(2);
       LOG(INFO) << "Load " << result.next_dialog_id << " with order " << result.next_order;
@@ -289,6 +294,8 @@ class DialogDbImpl final : public DialogDbSyncInterface {
 
  private:
   SqliteDb db_;
+  const std::atomic<bool> *use_compression_;
+  SqliteBlobCompressor compressor_;
 
   SqliteStatement add_dialog_stmt_;
   SqliteStatement add_notification_group_stmt_;
@@ -313,7 +320,8 @@ std::shared_ptr<DialogDbSyncSafeInterface> create_dialog_db_sync(
    public:
     explicit DialogDbSyncSafe(std::shared_ptr<SqliteConnectionSafe> sqlite_connection)
         : lsls_db_([safe_connection = std::move(sqlite_connection)] {
-          return make_unique<DialogDbImpl>(safe_connection->get().clone());
+          return td::make_unique<DialogDbImpl>(safe_connection->get().clone(),
+                                               safe_connection->get_use_blob_compression_flag());
         }) {
     }
     DialogDbSyncInterface &get() final {
@@ -328,12 +336,17 @@ std::shared_ptr<DialogDbSyncSafeInterface> create_dialog_db_sync(
 
 class DialogDbAsync final : public DialogDbAsyncInterface {
  public:
-  DialogDbAsync(std::shared_ptr<DialogDbSyncSafeInterface> sync_db, int32 scheduler_id) {
-    impl_ = create_actor_on_scheduler<Impl>("DialogDbActor", scheduler_id, std::move(sync_db));
+  DialogDbAsync(std::shared_ptr<DialogDbSyncSafeInterface> sync_db, int32 scheduler_id,
+                std::shared_ptr<SqliteConnectionSafe> read_connection, vector<int32> read_scheduler_ids)
+      : sync_db_safe_(sync_db)
+      , read_query_pool_(
+            std::make_shared<SqliteReadQueryPool>(std::move(read_connection), std::move(read_scheduler_ids))) {
+    impl_ = create_actor_on_scheduler<Impl>("DialogDbActor", scheduler_id, std::move(sync_db), read_query_pool_);
   }
 
   void add_dialog(DialogId dialog_id, FolderId folder_id, int64 order, BufferSlice data,
                   vector<NotificationGroupKey> notification_groups, Promise<Unit> promise) final {
+    read_query_pool_->on_write_query_sent();
     send_closure(impl_, &Impl::add_dialog, dialog_id, folder_id, order, std::move(data), std::move(notification_groups),
                  std::move(promise));
   }
@@ -358,11 +371,20 @@ class DialogDbAsync final : public DialogDbAsyncInterface {
 
   void get_dialogs(FolderId folder_id, int64 order, DialogId dialog_id, int32 limit,
                    Promise<DialogDbGetDialogsResult> promise) final {
+    if (read_query_pool_->can_run_query()) {
+      return read_query_pool_->run_query([sync_db_safe = sync_db_safe_, folder_id, order, dialog_id, limit,
+                                          promise = std::move(promise)](Unit) mutable {
+        promise.set_value(sync_db_safe->get().get_dialogs(folder_id, order, dialog_id, limit));
+      });
+    }
     send_closure_later(impl_, &Impl::get_dialogs, folder_id, order, dialog_id, limit, std::move(promise));
   }
 
   void close(Promise<Unit> promise) final {
-    send_closure_later(impl_, &Impl::close, std::move(promise));
+    read_query_pool_->close(
+        PromiseCreator::lambda([impl = impl_.get(), promise = std::move(promise)](Unit) mutable {
+          send_closure_later(impl, &Impl::close, std::move(promise));
+        }));
   }
 
   void force_flush() final {
@@ -372,7 +394,8 @@ class DialogDbAsync final : public DialogDbAsyncInterface {
  private:
   class Impl final : public Actor {
    public:
-    explicit Impl(std::shared_ptr<DialogDbSyncSafeInterface> sync_db_safe) : sync_db_safe_(std::move(sync_db_safe)) {
+    Impl(std::shared_ptr<DialogDbSyncSafeInterface> sync_db_safe, std::shared_ptr<SqliteReadQueryPool> read_query_pool)
+        : sync_db_safe_(std::move(sync_db_safe)), read_query_pool_(std::move(read_query_pool)) {
     }
 
     void add_dialog(DialogId dialog_id, FolderId folder_id, int64 order, BufferSlice data,
@@ -432,6 +455,7 @@ class DialogDbAsync final : public DialogDbAsyncInterface {
    private:
     std::shared_ptr<DialogDbSyncSafeInterface> sync_db_safe_;
     DialogDbSyncInterface *sync_db_ = nullptr;
+    std::shared_ptr<SqliteReadQueryPool> read_query_pool_;
 
     static constexpr size_t MAX_PENDING_QUERIES_COUNT{50};
     static constexpr double MAX_PENDING_QUERIES_DELAY{0.01};
@@ -463,9 +487,11 @@ class DialogDbAsync final : public DialogDbAsyncInterface {
       if (pending_writes_.empty()) {
         return;
       }
+      auto write_query_count = pending_writes_.size();
       sync_db_->begin_write_transaction().ensure();
       set_promises(pending_writes_);
       sync_db_->commit_transaction().ensure();
+      read_query_pool_->on_write_queries_committed(write_query_count);
       set_promises(finished_writes_);
       cancel_timeout();
     }
@@ -478,12 +504,17 @@ class DialogDbAsync final : public DialogDbAsyncInterface {
       sync_db_ = &sync_db_safe_->get();
     }
   };
+  std::shared_ptr<DialogDbSyncSafeInterface> sync_db_safe_;
+  std::shared_ptr<SqliteReadQueryPool> read_query_pool_;
   ActorOwn<Impl> impl_;
 };
 
 std::shared_ptr<DialogDbAsyncInterface> create_dialog_db_async(std::shared_ptr<DialogDbSyncSafeInterface> sync_db,
-                                                               int32 scheduler_id) {
-  return std::make_shared<DialogDbAsync>(std::move(sync_db), scheduler_id);
+                                                               int32 scheduler_id,
+                                                               std::shared_ptr<SqliteConnectionSafe> read_connection,
+                                                               vector<int32> read_scheduler_ids) {
+  return std::make_shared<DialogDbAsync>(std::move(sync_db), scheduler_id, std::move(read_connection),
+                                         std::move(read_scheduler_ids));
 }
 
 }  // namespace td
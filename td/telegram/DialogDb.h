@@ -104,7 +104,9 @@ Status drop_dialog_db(SqliteDb &db, int version) TD_WARN_UNUSED_RESULT;
 std::shared_ptr<DialogDbSyncSafeInterface> create_dialog_db_sync(
     std::shared_ptr<SqliteConnectionSafe> sqlite_connection);
 
-std::shared_ptr<DialogDbAsyncInterface> create_dialog_db_async(std::shared_ptr<DialogDbSyncSafeInterface> sync_db,
-                                                               int32 scheduler_id = -1);
+// get_dialogs is run in parallel on read_scheduler_ids using read_connection if possible
+std::shared_ptr<DialogDbAsyncInterface> create_dialog_db_async(
+    std::shared_ptr<DialogDbSyncSafeInterface> sync_db, int32 scheduler_id = -1,
+    std::shared_ptr<SqliteConnectionSafe> read_connection = nullptr, vector<int32> read_scheduler_ids = {});
 
 }  // namespace td
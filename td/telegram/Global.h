@@ -549,6 +549,11 @@ class Global final : public ActorContext {
     return slow_net_scheduler_id_;
   }
 
+  // returns -1 if there is no scheduler for database reads; the scheduler can be run on demand
+  int32 get_database_read_scheduler_id() const {
+    return database_read_scheduler_id_;
+  }
+
   DcId get_webfile_dc_id() const;
 
   std::shared_ptr<DhConfig> get_dh_config() {
@@ -626,6 +631,14 @@ class Global final : public ActorContext {
     store_all_files_in_files_directory_ = flag;
   }
 
+  void set_use_tl_object_arena(bool flag) {
+    use_tl_object_arena_ = flag;
+  }
+
+  bool use_tl_object_arena() const {
+    return use_tl_object_arena_;
+  }
+
   void notify_speed_limited(bool is_upload);
 
  private:
@@ -690,8 +703,10 @@ class Global final : public ActorContext {
   int32 database_scheduler_id_ = 0;
   int32 gc_scheduler_id_ = 0;
   int32 slow_net_scheduler_id_ = 0;
+  int32 database_read_scheduler_id_ = 0;
 
   std::atomic<bool> store_all_files_in_files_directory_{false};
+  std::atomic<bool> use_tl_object_arena_{false};
 
   std::atomic<double> server_time_difference_{0.0};
   std::atomic<bool> server_time_difference_was_updated_{false};
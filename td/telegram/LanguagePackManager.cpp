@@ -766,22 +766,30 @@ bool LanguagePackManager::load_language_strings(LanguageDatabase *database, Lang
     return true;
   }
 
-  bool have_all = true;
+  vector<string> database_keys;
   for (auto &key : keys) {
     if (!language_has_string_unsafe(language, key)) {
-      auto value = language->kv_.get(key);
-      if (value.empty()) {
-        if (language->version_ == -1) {
-          LOG(DEBUG) << "Have no string with key " << key << " in the database";
-          have_all = false;
-          continue;
-        }
+      database_keys.push_back(key);
+    }
+  }
+  auto values = language->kv_.get_many(database_keys);
+  CHECK(values.size() == database_keys.size());
 
-        // have full language in the database, so this string is just deleted
+  bool have_all = true;
+  for (size_t i = 0; i < database_keys.size(); i++) {
+    const auto &key = database_keys[i];
+    const auto &value = values[i];
+    if (value.empty()) {
+      if (language->version_ == -1) {
+        LOG(DEBUG) << "Have no string with key " << key << " in the database";
+        have_all = false;
+        continue;
       }
-      LOG(DEBUG) << "Load string with key " << key << " from database";
-      load_language_string_unsafe(language, key, value);
+
+      // have full language in the database, so this string is just deleted
     }
+    LOG(DEBUG) << "Load string with key " << key << " from database";
+    load_language_string_unsafe(language, key, value);
   }
   return have_all;
 }
@@ -1319,20 +1327,25 @@ void LanguagePackManager::save_strings_to_database(SqliteKeyValue *kv, int32 new
     return;
   }
 
-  kv->begin_write_transaction().ensure();
-  for (const auto &str : strings) {
+  vector<std::pair<string, string>> set_strings;
+  vector<string> erased_keys;
+  for (auto &str : strings) {
     if (!is_valid_key(str.first)) {
       LOG(ERROR) << "Have invalid key \"" << str.first << '"';
       continue;
     }
 
+    LOG(DEBUG) << "Save language pack string with key " << str.first << " to database";
     if (new_is_full && str.second == "3") {
-      kv->erase(str.first);
+      erased_keys.push_back(std::move(str.first));
     } else {
-      kv->set(str.first, str.second);
+      set_strings.push_back(std::move(str));
     }
-    LOG(DEBUG) << "Save language pack string with key " << str.first << " to database";
   }
+
+  kv->begin_write_transaction().ensure();
+  kv->set_many(set_strings);
+  kv->erase_many(erased_keys);
   if (old_version != new_version) {
     LOG(DEBUG) << "Set language pack version in database to " << new_version;
     kv->set("!version", to_string(new_version));
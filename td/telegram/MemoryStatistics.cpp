@@ -0,0 +1,40 @@
+//
+// Copyright Aliaksei Levin (levlam@telegram.org), Arseny Smirnov (arseny30@gmail.com) 2014-2024
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+#include "td/telegram/MemoryStatistics.h"
+
+#include "td/utils/algorithm.h"
+
+namespace td {
+
+constexpr size_t MemoryStatistics::HASH_TABLE_NODE_OVERHEAD;
+constexpr size_t MemoryStatistics::TREE_NODE_OVERHEAD;
+constexpr size_t MemoryStatistics::HINTS_KEY_SIZE;
+
+void MemoryStatistics::add(Slice name, size_t object_count, size_t size) {
+  Entry entry;
+  entry.name = name.str();
+  entry.object_count = object_count;
+  entry.size = size;
+  entries_.push_back(std::move(entry));
+}
+
+void MemoryStatistics::add(Slice name, const Hints &hints) {
+  auto key_count = hints.size();
+  add(name, key_count, key_count * HINTS_KEY_SIZE);
+}
+
+td_api::object_ptr<td_api::memoryStatistics> MemoryStatistics::get_memory_statistics_object() const {
+  int64 total_size = 0;
+  auto entries = transform(entries_, [&total_size](const Entry &entry) {
+    total_size += static_cast<int64>(entry.size);
+    return td_api::make_object<td_api::memoryStatisticsEntry>(entry.name, static_cast<int64>(entry.object_count),
+                                                              static_cast<int64>(entry.size));
+  });
+  return td_api::make_object<td_api::memoryStatistics>(std::move(entries), total_size);
+}
+
+}  // namespace td
@@ -0,0 +1,92 @@
+//
+// Copyright Aliaksei Levin (levlam@telegram.org), Arseny Smirnov (arseny30@gmail.com) 2014-2024
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+#pragma once
+
+#include "td/telegram/ColdObjectEvictor.h"
+#include "td/telegram/td_api.h"
+
+#include "td/utils/common.h"
+#include "td/utils/Hints.h"
+#include "td/utils/Slice.h"
+#include "td/utils/WaitFreeHashMap.h"
+#include "td/utils/WaitFreeVector.h"
+
+#include <map>
+
+namespace td {
+
+// Collects approximate numbers and sizes of objects, owned by managers.
+// Sizes are estimated from the number of elements in the main containers and the shallow sizes of their elements,
+// so memory owned by strings and vectors inside of the objects isn't taken into account.
+// Collection must be cheap, so the containers must not be traversed unless it is unavoidable.
+class MemoryStatistics {
+ public:
+  void add(Slice name, size_t object_count, size_t size);
+
+  template <class KeyT, class ValueT, class HashT, class EqT>
+  void add(Slice name, const WaitFreeHashMap<KeyT, ValueT, HashT, EqT> &map) {
+    auto object_count = map.calc_size();
+    add(name, object_count, object_count * (HASH_TABLE_NODE_OVERHEAD + sizeof(KeyT) + get_value_size<ValueT>()));
+  }
+
+  template <class ValueT>
+  void add(Slice name, const WaitFreeVector<ValueT> &vector) {
+    auto object_count = vector.size();
+    add(name, object_count, object_count * get_value_size<ValueT>());
+  }
+
+  template <class KeyT, class ValueT, class CompareT>
+  void add(Slice name, const std::map<KeyT, ValueT, CompareT> &map) {
+    auto object_count = map.size();
+    add(name, object_count, object_count * (TREE_NODE_OVERHEAD + sizeof(KeyT) + get_value_size<ValueT>()));
+  }
+
+  void add(Slice name, const Hints &hints);
+
+  // only identifiers of evicted objects are kept in memory
+  template <class KeyT, class ObjectT, class HashT>
+  void add(Slice name, const ColdObjectEvictor<KeyT, ObjectT, HashT> &evictor) {
+    auto object_count = evictor.get_evicted_object_count();
+    add(name, object_count, object_count * (HASH_TABLE_NODE_OVERHEAD + sizeof(KeyT)));
+  }
+
+  td_api::object_ptr<td_api::memoryStatistics> get_memory_statistics_object() const;
+
+ private:
+  // an approximate per-element size of empty buckets in FlatHashMap
+  static constexpr size_t HASH_TABLE_NODE_OVERHEAD = 8;
+
+  // parent and child pointers and color of a std::map node
+  static constexpr size_t TREE_NODE_OVERHEAD = 4 * sizeof(void *);
+
+  // an average word list and name of a key in Hints
+  static constexpr size_t HINTS_KEY_SIZE = 200;
+
+  template <class T>
+  struct ValueSize {
+    static constexpr size_t value = sizeof(T);
+  };
+
+  template <class T>
+  struct ValueSize<unique_ptr<T>> {
+    static constexpr size_t value = sizeof(unique_ptr<T>) + sizeof(T);
+  };
+
+  template <class T>
+  static constexpr size_t get_value_size() {
+    return ValueSize<T>::value;
+  }
+
+  struct Entry {
+    string name;
+    size_t object_count = 0;
+    size_t size = 0;
+  };
+  vector<Entry> entries_;
+};
+
+}  // namespace td
@@ -10,8 +10,10 @@
 #include "td/telegram/UserId.h"
 #include "td/telegram/Version.h"
 
+#include "td/db/SqliteBlobCompressor.h"
 #include "td/db/SqliteConnectionSafe.h"
 #include "td/db/SqliteDb.h"
+#include "td/db/SqliteReadQueryPool.h"
 #include "td/db/SqliteStatement.h"
 
 #include "td/actor/actor.h"
@@ -19,6 +21,7 @@
 
 #include "td/utils/format.h"
 #include "td/utils/logging.h"
+#include "td/utils/misc.h"
 #include "td/utils/ScopeGuard.h"
 #include "td/utils/Slice.h"
 #include "td/utils/SliceBuilder.h"
@@ -31,6 +34,7 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <iterator>
 #include <limits>
 #include <tuple>
@@ -68,15 +72,23 @@ Status init_message_db(SqliteDb &db, int32 version) {
         db.exec("CREATE INDEX IF NOT EXISTS message_by_search_id ON messages "
                 "(search_id) WHERE search_id IS NOT NULL"));
 
+    // messages are added to the full-text index messages_fts_td in batches when the write transaction is committed,
+    // because an insertion into the index is much slower than an insertion into the table;
+    // there are no positional queries, so positions and column sizes aren't stored
     TRY_STATUS(
-        db.exec("CREATE VIRTUAL TABLE IF NOT EXISTS messages_fts USING fts5(text, content='messages', "
-                "content_rowid='search_id', tokenize = \"unicode61 remove_diacritics 0 tokenchars '\a'\")"));
+        db.exec("CREATE VIRTUAL TABLE IF NOT EXISTS messages_fts_td USING fts5(text, content='messages', "
+                "content_rowid='search_id', tokenize='td', prefix='2 3', detail=none, columnsize=0)"));
+    TRY_STATUS(db.exec("CREATE TABLE IF NOT EXISTS messages_fts_queue (search_id INTEGER PRIMARY KEY)"));
     TRY_STATUS(db.exec(
-        "CREATE TRIGGER IF NOT EXISTS trigger_fts_delete BEFORE DELETE ON messages WHEN OLD.search_id IS NOT NULL"
-        " BEGIN INSERT INTO messages_fts(messages_fts, rowid, text) VALUES(\'delete\', OLD.search_id, OLD.text); END"));
+        "CREATE TRIGGER IF NOT EXISTS trigger_fts_td_delete BEFORE DELETE ON messages WHEN OLD.search_id IS NOT NULL"
+        " AND OLD.search_id NOT IN (SELECT search_id FROM messages_fts_queue) BEGIN INSERT INTO"
+        " messages_fts_td(messages_fts_td, rowid, text) VALUES(\'delete\', OLD.search_id, OLD.text); END"));
     TRY_STATUS(db.exec(
-        "CREATE TRIGGER IF NOT EXISTS trigger_fts_insert AFTER INSERT ON messages WHEN NEW.search_id IS NOT NULL"
-        " BEGIN INSERT INTO messages_fts(rowid, text) VALUES(NEW.search_id, NEW.text); END"));
+        "CREATE TRIGGER IF NOT EXISTS trigger_fts_queue_delete AFTER DELETE ON messages WHEN OLD.search_id IS NOT NULL"
+        " BEGIN DELETE FROM messages_fts_queue WHERE search_id = OLD.search_id; END"));
+    TRY_STATUS(db.exec(
+        "CREATE TRIGGER IF NOT EXISTS trigger_fts_td_insert AFTER INSERT ON messages WHEN NEW.search_id IS NOT NULL"
+        " BEGIN INSERT OR IGNORE INTO messages_fts_queue VALUES(NEW.search_id); END"));
     //TRY_STATUS(db.exec(
     //"CREATE TRIGGER IF NOT EXISTS trigger_fts_update AFTER UPDATE ON messages WHEN NEW.search_id IS NOT NULL OR "
     //"OLD.search_id IS NOT NULL"
@@ -167,6 +179,13 @@ Status init_message_db(SqliteDb &db, int32 version) {
   if (version < static_cast<int32>(DbVersion::AddMessageThreadSupport)) {
     TRY_STATUS(db.exec("ALTER TABLE messages ADD COLUMN top_thread_message_id INT8"));
   }
+  if (version < static_cast<int32>(DbVersion::AddMessageDbFtsTokenizer)) {
+    TRY_STATUS(add_fts());
+    // all messages will be reindexed in background; the old index messages_fts is kept up to date by its triggers
+    // and is used for search until the reindex is finished
+    TRY_STATUS(
+        db.exec("INSERT OR IGNORE INTO messages_fts_queue SELECT search_id FROM messages WHERE search_id IS NOT NULL"));
+  }
   return Status::OK();
 }
 
@@ -174,12 +193,16 @@ Status init_message_db(SqliteDb &db, int32 version) {
 Status drop_message_db(SqliteDb &db, int32 version) {
   LOG(WARNING) << "Drop message database " << tag("version", version)
                << tag("current_db_version", current_db_version());
+  TRY_STATUS(db.exec("DROP TABLE IF EXISTS messages_fts"));
+  TRY_STATUS(db.exec("DROP TABLE IF EXISTS messages_fts_td"));
+  TRY_STATUS(db.exec("DROP TABLE IF EXISTS messages_fts_queue"));
   return db.exec("DROP TABLE IF EXISTS messages");
 }
 
 class MessageDbImpl final : public MessageDbSyncInterface {
  public:
-  explicit MessageDbImpl(SqliteDb db) : db_(std::move(db)) {
+  MessageDbImpl(SqliteDb db, const std::atomic<bool> *use_compression)
+      : db_(std::move(db)), use_compression_(use_compression) {
     init().ensure();
   }
 
@@ -222,8 +245,31 @@ class MessageDbImpl final : public MessageDbSyncInterface {
                                         "notification_id < ?2 ORDER BY notification_id DESC LIMIT ?3"));
     TRY_RESULT_ASSIGN(get_messages_fts_stmt_,
                       db_.get_statement("SELECT dialog_id, message_id, data, search_id FROM messages WHERE search_id "
-                                        "IN (SELECT rowid FROM messages_fts WHERE messages_fts MATCH ?1 AND rowid < ?2 "
-                                        "ORDER BY rowid DESC LIMIT ?3) ORDER BY search_id DESC"));
+                                        "IN (SELECT rowid FROM messages_fts_td WHERE messages_fts_td MATCH ?1 AND "
+                                        "rowid < ?2 ORDER BY rowid DESC LIMIT ?3) ORDER BY search_id DESC"));
+    // the old index is used until all messages are reindexed after an upgrade
+    TRY_RESULT_ASSIGN(has_old_fts_, db_.has_table("messages_fts"));
+    if (has_old_fts_) {
+      TRY_RESULT_ASSIGN(get_messages_old_fts_stmt_,
+                        db_.get_statement("SELECT dialog_id, message_id, data, search_id FROM messages WHERE search_id "
+                                          "IN (SELECT rowid FROM messages_fts WHERE messages_fts MATCH ?1 AND rowid < "
+                                          "?2 ORDER BY rowid DESC LIMIT ?3) ORDER BY search_id DESC"));
+    }
+    TRY_RESULT_ASSIGN(get_fts_queue_stmt_,
+                      db_.get_statement("SELECT MIN(search_id), COUNT(*) FROM (SELECT search_id FROM "
+                                        "messages_fts_queue ORDER BY search_id DESC LIMIT ?1)"));
+    TRY_RESULT_ASSIGN(index_messages_fts_stmt_,
+                      db_.get_statement("INSERT INTO messages_fts_td(rowid, text) SELECT search_id, text FROM "
+                                        "messages WHERE search_id IN (SELECT search_id FROM messages_fts_queue WHERE "
+                                        "search_id >= ?1)"));
+    TRY_RESULT_ASSIGN(delete_fts_queue_stmt_,
+                      db_.get_statement("DELETE FROM messages_fts_queue WHERE search_id >= ?1"));
+    TRY_RESULT_ASSIGN(index_message_fts_stmt_,
+                      db_.get_statement("INSERT INTO messages_fts_td(rowid, text) SELECT search_id, text FROM "
+                                        "messages WHERE search_id = ?1 AND search_id IN (SELECT search_id FROM "
+                                        "messages_fts_queue)"));
+    TRY_RESULT_ASSIGN(delete_message_fts_queue_stmt_,
+                      db_.get_statement("DELETE FROM messages_fts_queue WHERE search_id = ?1"));
 
     for (int32 i = 0; i < MESSAGE_DB_INDEX_COUNT; i++) {
       TRY_RESULT_ASSIGN(
@@ -284,7 +330,7 @@ class MessageDbImpl final : public MessageDbSyncInterface {
 
     // LOG(FATAL) << "EXPLAINED";
 
-    return Status::OK();
+    return compressor_.init(db_.clone(), "messages", use_compression_);
   }
 
   void add_message(MessageFullId message_full_id, ServerMessageId unique_message_id, DialogId sender_dialog_id,
@@ -319,7 +365,7 @@ class MessageDbImpl final : public MessageDbSyncInterface {
       add_message_stmt_.bind_null(5).ensure();
     }
 
-    add_message_stmt_.bind_blob(6, data.as_slice()).ensure();
+    add_message_stmt_.bind_blob(6, compressor_.compress(data.as_slice())).ensure();
 
     if (ttl_expires_at != 0) {
       add_message_stmt_.bind_int32(7, ttl_expires_at).ensure();
@@ -343,6 +389,7 @@ class MessageDbImpl final : public MessageDbSyncInterface {
         }
       }
       add_message_stmt_.bind_int64(9, search_id).ensure();
+      added_search_ids_.push_back(search_id);
     } else {
       text = "";
       add_message_stmt_.bind_null(9).ensure();
@@ -384,7 +431,7 @@ class MessageDbImpl final : public MessageDbSyncInterface {
       add_scheduled_message_stmt_.bind_null(3).ensure();
     }
 
-    add_scheduled_message_stmt_.bind_blob(4, data.as_slice()).ensure();
+    add_scheduled_message_stmt_.bind_blob(4, compressor_.compress(data.as_slice())).ensure();
 
     add_scheduled_message_stmt_.step().ensure();
   }
@@ -463,16 +510,16 @@ class MessageDbImpl final : public MessageDbSyncInterface {
       return Status::Error("Not found");
     }
     MessageId received_message_id(stmt.view_int64(0));
-    Slice data = stmt.view_blob(1);
+    auto data = compressor_.decompress(stmt.view_blob(1));
     if (is_scheduled_server) {
       CHECK(received_message_id.is_scheduled());
       CHECK(received_message_id.is_scheduled_server());
       CHECK(received_message_id.get_scheduled_server_message_id() == message_id.get_scheduled_server_message_id());
     } else {
       LOG_CHECK(received_message_id == message_id)
-          << received_message_id << ' ' << message_id << ' ' << get_message_info(received_message_id, data, true).first;
+          << received_message_id << ' ' << message_id << ' ' << get_message_info(received_message_id, data.as_slice(), true).first;
     }
-    return MessageDbDialogMessage{received_message_id, BufferSlice(data)};
+    return MessageDbDialogMessage{received_message_id, std::move(data)};
   }
 
   Result<MessageDbMessage> get_message_by_unique_message_id(ServerMessageId unique_message_id) final {
@@ -489,7 +536,8 @@ class MessageDbImpl final : public MessageDbSyncInterface {
     }
     DialogId dialog_id(get_message_by_unique_message_id_stmt_.view_int64(0));
     MessageId message_id(get_message_by_unique_message_id_stmt_.view_int64(1));
-    return MessageDbMessage{dialog_id, message_id, BufferSlice(get_message_by_unique_message_id_stmt_.view_blob(2))};
+    return MessageDbMessage{dialog_id, message_id,
+                            compressor_.decompress(get_message_by_unique_message_id_stmt_.view_blob(2))};
   }
 
   Result<MessageDbDialogMessage> get_message_by_random_id(DialogId dialog_id, int64 random_id) final {
@@ -503,7 +551,7 @@ class MessageDbImpl final : public MessageDbSyncInterface {
       return Status::Error("Not found");
     }
     MessageId message_id(get_message_by_random_id_stmt_.view_int64(0));
-    return MessageDbDialogMessage{message_id, BufferSlice(get_message_by_random_id_stmt_.view_blob(1))};
+    return MessageDbDialogMessage{message_id, compressor_.decompress(get_message_by_random_id_stmt_.view_blob(1))};
   }
 
   Result<MessageDbDialogMessage> get_dialog_message_by_date(DialogId dialog_id, MessageId first_message_id,
@@ -581,7 +629,7 @@ class MessageDbImpl final : public MessageDbSyncInterface {
     while (get_expiring_messages_stmt_.has_row()) {
       DialogId dialog_id(get_expiring_messages_stmt_.view_int64(0));
       MessageId message_id(get_expiring_messages_stmt_.view_int64(1));
-      BufferSlice data(get_expiring_messages_stmt_.view_blob(2));
+      auto data = compressor_.decompress(get_expiring_messages_stmt_.view_blob(2));
       messages.push_back(MessageDbMessage{dialog_id, message_id, std::move(data)});
       get_expiring_messages_stmt_.step().ensure();
     }
@@ -604,16 +652,16 @@ class MessageDbImpl final : public MessageDbSyncInterface {
     stmt.step().ensure();
     int32 current_day = std::numeric_limits<int32>::max();
     while (stmt.has_row()) {
-      auto data_slice = stmt.view_blob(0);
+      auto data = compressor_.decompress(stmt.view_blob(0));
       MessageId message_id(stmt.view_int64(1));
-      auto info = get_message_info(message_id, data_slice, false);
+      auto info = get_message_info(message_id, data.as_slice(), false);
       auto day = (query.tz_offset + info.second) / 86400;
       if (day >= current_day) {
         CHECK(!total_counts.empty());
         total_counts.back()++;
       } else {
         current_day = day;
-        messages.push_back(MessageDbDialogMessage{message_id, BufferSlice(data_slice)});
+        messages.push_back(MessageDbDialogMessage{message_id, std::move(data)});
         total_counts.push_back(1);
       }
       stmt.step().ensure();
@@ -679,16 +727,32 @@ class MessageDbImpl final : public MessageDbSyncInterface {
     vector<MessageDbDialogMessage> result;
     stmt.step().ensure();
     while (stmt.has_row()) {
-      auto data_slice = stmt.view_blob(0);
+      auto data = compressor_.decompress(stmt.view_blob(0));
       MessageId message_id(stmt.view_int64(1));
-      result.push_back(MessageDbDialogMessage{message_id, BufferSlice(data_slice)});
+      result.push_back(MessageDbDialogMessage{message_id, std::move(data)});
       LOG(INFO) << "Load " << message_id << " in " << dialog_id << " from database";
       stmt.step().ensure();
     }
     return result;
   }
 
+  // words are prepared like in the tokenizer and are matched as whole words;
+  // a word directly followed by '*' is matched as a prefix of message words
   static string prepare_query(Slice query) {
+    const size_t MAX_QUERY_SIZE = 1024;
+    string result;
+    for (auto part : full_split(utf8_truncate(query, MAX_QUERY_SIZE), ' ')) {
+      auto words = utf8_get_search_words(part);
+      auto is_prefix = ends_with(part, "*");
+      for (size_t i = 0; i < words.size(); i++) {
+        result += PSTRING() << '"' << words[i] << (is_prefix && i + 1 == words.size() ? "\"* " : "\" ");
+      }
+    }
+    return result;
+  }
+
+  // prepares the query for the old index, which uses unicode61 tokenizer
+  static string prepare_old_query(Slice query) {
     auto is_word_character = [](uint32 a) {
       switch (get_unicode_simple_category(a)) {
         case UnicodeSimpleCategory::Letter:
@@ -736,13 +800,40 @@ class MessageDbImpl final : public MessageDbSyncInterface {
   }
 
   MessageDbFtsResult get_messages_fts(MessageDbFtsQuery query) final {
+    LOG(INFO) << tag("query", query.query) << query.dialog_id << tag("filter", query.filter)
+              << tag("from_search_id", query.from_search_id) << tag("limit", query.limit);
+    if (query.from_search_id == 0) {
+      query.from_search_id = std::numeric_limits<int64>::max();
+    }
+
+    if (has_old_fts_) {
+      auto r_result = do_get_messages_fts(get_messages_old_fts_stmt_, prepare_old_query(query.query), query);
+      if (r_result.is_ok()) {
+        return r_result.move_as_ok();
+      }
+      // the old index could have been dropped after the reindex was finished
+      auto r_has_old_fts = db_.has_table("messages_fts");
+      if (r_has_old_fts.is_error() || r_has_old_fts.ok()) {
+        LOG(ERROR) << r_result.error();
+        return {};
+      }
+      has_old_fts_ = false;
+      get_messages_old_fts_stmt_ = SqliteStatement();
+    }
+
+    auto r_result = do_get_messages_fts(get_messages_fts_stmt_, prepare_query(query.query), query);
+    if (r_result.is_error()) {
+      LOG(ERROR) << r_result.error();
+      return {};
+    }
+    return r_result.move_as_ok();
+  }
+
+  Result<MessageDbFtsResult> do_get_messages_fts(SqliteStatement &stmt, string words, const MessageDbFtsQuery &query) {
     SCOPE_EXIT {
-      get_messages_fts_stmt_.reset();
+      stmt.reset();
     };
 
-    LOG(INFO) << tag("query", query.query) << query.dialog_id << tag("filter", query.filter)
-              << tag("from_search_id", query.from_search_id) << tag("limit", query.limit);
-    string words = prepare_query(query.query);
     LOG(INFO) << tag("from", query.query) << tag("to", words);
 
     // dialog_id kludge
@@ -755,29 +846,83 @@ class MessageDbImpl final : public MessageDbSyncInterface {
       words += PSTRING() << " \"\a\a" << message_search_filter_index(query.filter) << "\"";
     }
 
-    auto &stmt = get_messages_fts_stmt_;
     stmt.bind_string(1, words).ensure();
-    if (query.from_search_id == 0) {
-      query.from_search_id = std::numeric_limits<int64>::max();
-    }
     stmt.bind_int64(2, query.from_search_id).ensure();
     stmt.bind_int32(3, query.limit).ensure();
     MessageDbFtsResult result;
-    auto status = stmt.step();
-    if (status.is_error()) {
-      LOG(ERROR) << status;
-      return result;
-    }
+    TRY_STATUS(stmt.step());
     while (stmt.has_row()) {
       DialogId dialog_id(stmt.view_int64(0));
       MessageId message_id(stmt.view_int64(1));
-      auto data_slice = stmt.view_blob(2);
+      auto data = compressor_.decompress(stmt.view_blob(2));
       auto search_id = stmt.view_int64(3);
       result.next_search_id = search_id;
-      result.messages.push_back(MessageDbMessage{dialog_id, message_id, BufferSlice(data_slice)});
+      result.messages.push_back(MessageDbMessage{dialog_id, message_id, std::move(data)});
       stmt.step().ensure();
     }
-    return result;
+    return std::move(result);
+  }
+
+  bool index_messages_fts(int32 limit) final {
+    SCOPE_EXIT {
+      get_fts_queue_stmt_.reset();
+      index_messages_fts_stmt_.reset();
+      delete_fts_queue_stmt_.reset();
+    };
+
+    // the newest messages are indexed first, because they are most likely to be found
+    get_fts_queue_stmt_.bind_int32(1, limit).ensure();
+    get_fts_queue_stmt_.step().ensure();
+    CHECK(get_fts_queue_stmt_.has_row());
+    auto count = get_fts_queue_stmt_.view_int32(1);
+    if (count > 0) {
+      auto min_search_id = get_fts_queue_stmt_.view_int64(0);
+
+      LOG(INFO) << "Add " << count << " messages to the full-text index";
+      index_messages_fts_stmt_.bind_int64(1, min_search_id).ensure();
+      auto status = index_messages_fts_stmt_.step();
+      if (status.is_error()) {
+        LOG(ERROR) << "Failed to index messages: " << status;
+      }
+      delete_fts_queue_stmt_.bind_int64(1, min_search_id).ensure();
+      delete_fts_queue_stmt_.step().ensure();
+    }
+    if (count == limit) {
+      return true;
+    }
+
+    if (has_old_fts_) {
+      LOG(INFO) << "Finish reindexing of messages";
+      get_messages_old_fts_stmt_ = SqliteStatement();
+      db_.exec("DROP TRIGGER IF EXISTS trigger_fts_delete").ensure();
+      db_.exec("DROP TRIGGER IF EXISTS trigger_fts_insert").ensure();
+      db_.exec("DROP TABLE IF EXISTS messages_fts").ensure();
+      has_old_fts_ = false;
+    }
+    return false;
+  }
+
+  void index_added_messages_fts() {
+    if (added_search_ids_.empty()) {
+      return;
+    }
+
+    LOG(INFO) << "Add " << added_search_ids_.size() << " new messages to the full-text index";
+    for (auto search_id : added_search_ids_) {
+      SCOPE_EXIT {
+        index_message_fts_stmt_.reset();
+        delete_message_fts_queue_stmt_.reset();
+      };
+      // the message could have been already deleted or indexed
+      index_message_fts_stmt_.bind_int64(1, search_id).ensure();
+      auto status = index_message_fts_stmt_.step();
+      if (status.is_error()) {
+        LOG(ERROR) << "Failed to index a message: " << status;
+      }
+      delete_message_fts_queue_stmt_.bind_int64(1, search_id).ensure();
+      delete_message_fts_queue_stmt_.step().ensure();
+    }
+    added_search_ids_.clear();
   }
 
   vector<MessageDbDialogMessage> get_messages_from_index(DialogId dialog_id, MessageId from_message_id,
@@ -809,8 +954,8 @@ class MessageDbImpl final : public MessageDbSyncInterface {
     while (stmt.has_row()) {
       DialogId dialog_id(stmt.view_int64(0));
       MessageId message_id(stmt.view_int64(1));
-      auto data_slice = stmt.view_blob(2);
-      result.messages.push_back(MessageDbMessage{dialog_id, message_id, BufferSlice(data_slice)});
+      auto data = compressor_.decompress(stmt.view_blob(2));
+      result.messages.push_back(MessageDbMessage{dialog_id, message_id, std::move(data)});
       stmt.step().ensure();
     }
     return result;
@@ -820,11 +965,15 @@ class MessageDbImpl final : public MessageDbSyncInterface {
     return db_.begin_write_transaction();
   }
   Status commit_transaction() final {
+    // messages are added to the full-text index together, so they can be found as soon as they are committed
+    index_added_messages_fts();
     return db_.commit_transaction();
   }
 
  private:
   SqliteDb db_;
+  const std::atomic<bool> *use_compression_;
+  SqliteBlobCompressor compressor_;
 
   SqliteStatement add_message_stmt_;
 
@@ -850,6 +999,14 @@ class MessageDbImpl final : public MessageDbSyncInterface {
   std::array<SqliteStatement, 2> get_calls_stmts_;
 
   SqliteStatement get_messages_fts_stmt_;
+  SqliteStatement get_messages_old_fts_stmt_;
+  SqliteStatement get_fts_queue_stmt_;
+  SqliteStatement index_messages_fts_stmt_;
+  SqliteStatement delete_fts_queue_stmt_;
+  SqliteStatement index_message_fts_stmt_;
+  SqliteStatement delete_message_fts_queue_stmt_;
+  bool has_old_fts_ = false;
+  vector<int64> added_search_ids_;
 
   SqliteStatement add_scheduled_message_stmt_;
   SqliteStatement get_scheduled_message_stmt_;
@@ -857,8 +1014,8 @@ class MessageDbImpl final : public MessageDbSyncInterface {
   SqliteStatement delete_scheduled_message_stmt_;
   SqliteStatement delete_scheduled_server_message_stmt_;
 
-  static vector<MessageDbDialogMessage> get_messages_impl(GetMessagesStmt &stmt, DialogId dialog_id,
-                                                          MessageId from_message_id, int32 offset, int32 limit) {
+  vector<MessageDbDialogMessage> get_messages_impl(GetMessagesStmt &stmt, DialogId dialog_id, MessageId from_message_id,
+                                                   int32 offset, int32 limit) {
     LOG_CHECK(dialog_id.is_valid()) << dialog_id;
     CHECK(from_message_id.is_valid());
 
@@ -909,8 +1066,8 @@ class MessageDbImpl final : public MessageDbSyncInterface {
     return right;
   }
 
-  static vector<MessageDbDialogMessage> get_messages_inner(SqliteStatement &stmt, DialogId dialog_id,
-                                                           int64 from_message_id, int32 limit) {
+  vector<MessageDbDialogMessage> get_messages_inner(SqliteStatement &stmt, DialogId dialog_id, int64 from_message_id,
+                                                    int32 limit) {
     SCOPE_EXIT {
       stmt.reset();
     };
@@ -923,9 +1080,9 @@ class MessageDbImpl final : public MessageDbSyncInterface {
     vector<MessageDbDialogMessage> result;
     stmt.step().ensure();
     while (stmt.has_row()) {
-      auto data_slice = stmt.view_blob(0);
+      auto data = compressor_.decompress(stmt.view_blob(0));
       MessageId message_id(stmt.view_int64(1));
-      result.push_back(MessageDbDialogMessage{message_id, BufferSlice(data_slice)});
+      result.push_back(MessageDbDialogMessage{message_id, std::move(data)});
       LOG(INFO) << "Loaded " << message_id << " in " << dialog_id << " from database";
       stmt.step().ensure();
     }
@@ -969,7 +1126,8 @@ std::shared_ptr<MessageDbSyncSafeInterface> create_message_db_sync(
    public:
     explicit MessageDbSyncSafe(std::shared_ptr<SqliteConnectionSafe> sqlite_connection)
         : lsls_db_([safe_connection = std::move(sqlite_connection)] {
-          return make_unique<MessageDbImpl>(safe_connection->get().clone());
+          return td::make_unique<MessageDbImpl>(safe_connection->get().clone(),
+                                                safe_connection->get_use_blob_compression_flag());
         }) {
     }
     MessageDbSyncInterface &get() final {
@@ -984,29 +1142,38 @@ std::shared_ptr<MessageDbSyncSafeInterface> create_message_db_sync(
 
 class MessageDbAsync final : public MessageDbAsyncInterface {
  public:
-  MessageDbAsync(std::shared_ptr<MessageDbSyncSafeInterface> sync_db, int32 scheduler_id) {
-    impl_ = create_actor_on_scheduler<Impl>("MessageDbActor", scheduler_id, std::move(sync_db));
+  MessageDbAsync(std::shared_ptr<MessageDbSyncSafeInterface> sync_db, int32 scheduler_id,
+                 std::shared_ptr<SqliteConnectionSafe> read_connection, vector<int32> read_scheduler_ids)
+      : sync_db_safe_(sync_db)
+      , read_query_pool_(
+            std::make_shared<SqliteReadQueryPool>(std::move(read_connection), std::move(read_scheduler_ids))) {
+    impl_ = create_actor_on_scheduler<Impl>("MessageDbActor", scheduler_id, std::move(sync_db), read_query_pool_);
   }
 
   void add_message(MessageFullId message_full_id, ServerMessageId unique_message_id, DialogId sender_dialog_id,
                    int64 random_id, int32 ttl_expires_at, int32 index_mask, int64 search_id, string text,
                    NotificationId notification_id, MessageId top_thread_message_id, BufferSlice data,
                    Promise<> promise) final {
+    read_query_pool_->on_write_query_sent();
     send_closure_later(impl_, &Impl::add_message, message_full_id, unique_message_id, sender_dialog_id, random_id,
                        ttl_expires_at, index_mask, search_id, std::move(text), notification_id, top_thread_message_id,
                        std::move(data), std::move(promise));
   }
   void add_scheduled_message(MessageFullId message_full_id, BufferSlice data, Promise<> promise) final {
+    read_query_pool_->on_write_query_sent();
     send_closure_later(impl_, &Impl::add_scheduled_message, message_full_id, std::move(data), std::move(promise));
   }
 
   void delete_message(MessageFullId message_full_id, Promise<> promise) final {
+    read_query_pool_->on_write_query_sent();
     send_closure_later(impl_, &Impl::delete_message, message_full_id, std::move(promise));
   }
   void delete_all_dialog_messages(DialogId dialog_id, MessageId from_message_id, Promise<> promise) final {
+    read_query_pool_->on_write_query_sent();
     send_closure_later(impl_, &Impl::delete_all_dialog_messages, dialog_id, from_message_id, std::move(promise));
   }
   void delete_dialog_messages_by_sender(DialogId dialog_id, DialogId sender_dialog_id, Promise<> promise) final {
+    read_query_pool_->on_write_query_sent();
     send_closure_later(impl_, &Impl::delete_dialog_messages_by_sender, dialog_id, sender_dialog_id, std::move(promise));
   }
 
@@ -1026,6 +1193,12 @@ class MessageDbAsync final : public MessageDbAsyncInterface {
   }
 
   void get_dialog_message_calendar(MessageDbDialogCalendarQuery query, Promise<MessageDbCalendar> promise) final {
+    if (read_query_pool_->can_run_query()) {
+      return read_query_pool_->run_query([sync_db_safe = sync_db_safe_, query = std::move(query),
+                                          promise = std::move(promise)](Unit) mutable {
+        promise.set_value(sync_db_safe->get().get_dialog_message_calendar(std::move(query)));
+      });
+    }
     send_closure_later(impl_, &Impl::get_dialog_message_calendar, std::move(query), std::move(promise));
   }
 
@@ -1035,6 +1208,12 @@ class MessageDbAsync final : public MessageDbAsyncInterface {
   }
 
   void get_messages(MessageDbMessagesQuery query, Promise<vector<MessageDbDialogMessage>> promise) final {
+    if (read_query_pool_->can_run_query()) {
+      return read_query_pool_->run_query([sync_db_safe = sync_db_safe_, query = std::move(query),
+                                          promise = std::move(promise)](Unit) mutable {
+        promise.set_value(sync_db_safe->get().get_messages(std::move(query)));
+      });
+    }
     send_closure_later(impl_, &Impl::get_messages, std::move(query), std::move(promise));
   }
   void get_scheduled_messages(DialogId dialog_id, int32 limit, Promise<vector<MessageDbDialogMessage>> promise) final {
@@ -1049,6 +1228,12 @@ class MessageDbAsync final : public MessageDbAsyncInterface {
     send_closure_later(impl_, &Impl::get_calls, std::move(query), std::move(promise));
   }
   void get_messages_fts(MessageDbFtsQuery query, Promise<MessageDbFtsResult> promise) final {
+    if (read_query_pool_->can_run_query()) {
+      return read_query_pool_->run_query([sync_db_safe = sync_db_safe_, query = std::move(query),
+                                          promise = std::move(promise)](Unit) mutable {
+        promise.set_value(sync_db_safe->get().get_messages_fts(std::move(query)));
+      });
+    }
     send_closure_later(impl_, &Impl::get_messages_fts, std::move(query), std::move(promise));
   }
   void get_expiring_messages(int32 expires_till, int32 limit, Promise<vector<MessageDbMessage>> promise) final {
@@ -1056,7 +1241,10 @@ class MessageDbAsync final : public MessageDbAsyncInterface {
   }
 
   void close(Promise<> promise) final {
-    send_closure_later(impl_, &Impl::close, std::move(promise));
+    read_query_pool_->close(
+        PromiseCreator::lambda([impl = impl_.get(), promise = std::move(promise)](Unit) mutable {
+          send_closure_later(impl, &Impl::close, std::move(promise));
+        }));
   }
 
   void force_flush() final {
@@ -1066,7 +1254,9 @@ class MessageDbAsync final : public MessageDbAsyncInterface {
  private:
   class Impl final : public Actor {
    public:
-    explicit Impl(std::shared_ptr<MessageDbSyncSafeInterface> sync_db_safe) : sync_db_safe_(std::move(sync_db_safe)) {
+    Impl(std::shared_ptr<MessageDbSyncSafeInterface> sync_db_safe,
+         std::shared_ptr<SqliteReadQueryPool> read_query_pool)
+        : sync_db_safe_(std::move(sync_db_safe)), read_query_pool_(std::move(read_query_pool)) {
     }
     void add_message(MessageFullId message_full_id, ServerMessageId unique_message_id, DialogId sender_dialog_id,
                      int64 random_id, int32 ttl_expires_at, int32 index_mask, int64 search_id, string text,
@@ -1103,12 +1293,14 @@ class MessageDbAsync final : public MessageDbAsyncInterface {
     void delete_all_dialog_messages(DialogId dialog_id, MessageId from_message_id, Promise<> promise) {
       add_read_query();
       sync_db_->delete_all_dialog_messages(dialog_id, from_message_id);
+      read_query_pool_->on_write_queries_committed(1);
       promise.set_value(Unit());
     }
 
     void delete_dialog_messages_by_sender(DialogId dialog_id, DialogId sender_dialog_id, Promise<> promise) {
       add_read_query();
       sync_db_->delete_dialog_messages_by_sender(dialog_id, sender_dialog_id);
+      read_query_pool_->on_write_queries_committed(1);
       promise.set_value(Unit());
     }
 
@@ -1183,14 +1375,20 @@ class MessageDbAsync final : public MessageDbAsyncInterface {
    private:
     std::shared_ptr<MessageDbSyncSafeInterface> sync_db_safe_;
     MessageDbSyncInterface *sync_db_ = nullptr;
+    std::shared_ptr<SqliteReadQueryPool> read_query_pool_;
 
     static constexpr size_t MAX_PENDING_QUERIES_COUNT{50};
     static constexpr double MAX_PENDING_QUERIES_DELAY{0.01};
 
+    static constexpr int32 FTS_INDEX_BATCH_SIZE{1000};
+    static constexpr double FTS_INDEX_DELAY{1.0};
+    static constexpr double FTS_INDEX_BATCH_DELAY{0.01};
+
     //NB: order is important, destructor of pending_writes_ will change finished_writes_
     vector<Promise<Unit>> finished_writes_;
     vector<Promise<Unit>> pending_writes_;  // TODO use Action
     double wakeup_at_ = 0;
+    double index_fts_at_ = 0;
 
     template <class F>
     void add_write_query(F &&f) {
@@ -1201,8 +1399,17 @@ class MessageDbAsync final : public MessageDbAsyncInterface {
       } else if (wakeup_at_ == 0) {
         wakeup_at_ = Time::now_cached() + MAX_PENDING_QUERIES_DELAY;
       }
-      if (wakeup_at_ != 0) {
-        set_timeout_at(wakeup_at_);
+      update_timeout();
+    }
+    void update_timeout() {
+      auto timeout_at = wakeup_at_;
+      if (index_fts_at_ != 0 && (timeout_at == 0 || index_fts_at_ < timeout_at)) {
+        timeout_at = index_fts_at_;
+      }
+      if (timeout_at == 0) {
+        cancel_timeout();
+      } else {
+        set_timeout_at(timeout_at);
       }
     }
     void add_read_query() {
@@ -1212,26 +1419,53 @@ class MessageDbAsync final : public MessageDbAsyncInterface {
       if (pending_writes_.empty()) {
         return;
       }
+      auto write_query_count = pending_writes_.size();
       sync_db_->begin_write_transaction().ensure();
       set_promises(pending_writes_);
       sync_db_->commit_transaction().ensure();
+      read_query_pool_->on_write_queries_committed(write_query_count);
       set_promises(finished_writes_);
-      cancel_timeout();
+      wakeup_at_ = 0;
+      update_timeout();
+    }
+    void index_messages_fts() {
+      index_fts_at_ = 0;
+      sync_db_->begin_write_transaction().ensure();
+      auto has_more = sync_db_->index_messages_fts(FTS_INDEX_BATCH_SIZE);
+      sync_db_->commit_transaction().ensure();
+      if (has_more) {
+        // let other queries run between batches
+        index_fts_at_ = Time::now() + FTS_INDEX_BATCH_DELAY;
+      }
     }
     void timeout_expired() final {
       do_flush();
+      if (index_fts_at_ != 0 && index_fts_at_ <= Time::now()) {
+        index_messages_fts();
+      }
+      update_timeout();
     }
 
     void start_up() final {
       sync_db_ = &sync_db_safe_->get();
+
+      // new messages are indexed when they are committed, so only messages, which are reindexed after an upgrade,
+      // are indexed in background
+      index_fts_at_ = Time::now() + FTS_INDEX_DELAY;
+      update_timeout();
     }
   };
+  std::shared_ptr<MessageDbSyncSafeInterface> sync_db_safe_;
+  std::shared_ptr<SqliteReadQueryPool> read_query_pool_;
   ActorOwn<Impl> impl_;
 };
 
 std::shared_ptr<MessageDbAsyncInterface> create_message_db_async(std::shared_ptr<MessageDbSyncSafeInterface> sync_db,
-                                                                 int32 scheduler_id) {
-  return std::make_shared<MessageDbAsync>(std::move(sync_db), scheduler_id);
+                                                                 int32 scheduler_id,
+                                                                 std::shared_ptr<SqliteConnectionSafe> read_connection,
+                                                                 vector<int32> read_scheduler_ids) {
+  return std::make_shared<MessageDbAsync>(std::move(sync_db), scheduler_id, std::move(read_connection),
+                                          std::move(read_scheduler_ids));
 }
 
 }  // namespace td
@@ -134,7 +134,12 @@ class MessageDbSyncInterface {
   virtual MessageDbCallsResult get_calls(MessageDbCallsQuery query) = 0;
   virtual MessageDbFtsResult get_messages_fts(MessageDbFtsQuery query) = 0;
 
+  // adds up to limit newest not indexed messages to the full-text index; returns true if there are more such messages;
+  // after all messages are indexed, drops the old full-text index
+  virtual bool index_messages_fts(int32 limit) = 0;
+
   virtual Status begin_write_transaction() = 0;
+  // adds messages, which were added in the transaction, to the full-text index and commits the transaction
   virtual Status commit_transaction() = 0;
 };
 
@@ -199,7 +204,10 @@ Status drop_message_db(SqliteDb &db, int version) TD_WARN_UNUSED_RESULT;
 std::shared_ptr<MessageDbSyncSafeInterface> create_message_db_sync(
     std::shared_ptr<SqliteConnectionSafe> sqlite_connection);
 
-std::shared_ptr<MessageDbAsyncInterface> create_message_db_async(std::shared_ptr<MessageDbSyncSafeInterface> sync_db,
-                                                                 int32 scheduler_id = -1);
+// get_messages, get_messages_fts and get_dialog_message_calendar are run in parallel on read_scheduler_ids
+// using read_connection if possible
+std::shared_ptr<MessageDbAsyncInterface> create_message_db_async(
+    std::shared_ptr<MessageDbSyncSafeInterface> sync_db, int32 scheduler_id = -1,
+    std::shared_ptr<SqliteConnectionSafe> read_connection = nullptr, vector<int32> read_scheduler_ids = {});
 
 }  // namespace td
@@ -42,6 +42,7 @@
 #include "td/telegram/LinkManager.h"
 #include "td/telegram/Location.h"
 #include "td/telegram/logevent/LogEvent.h"
+#include "td/telegram/MemoryStatistics.h"
 #include "td/telegram/MessageContent.h"
 #include "td/telegram/MessageDb.h"
 #include "td/telegram/MessageEntity.h"
@@ -99,6 +100,7 @@
 #include "td/actor/SleepActor.h"
 
 #include "td/utils/algorithm.h"
+#include "td/utils/crypto.h"
 #include "td/utils/format.h"
 #include "td/utils/logging.h"
 #include "td/utils/misc.h"
@@ -5387,6 +5389,9 @@ MessagesManager::MessagesManager(Td *td, ActorShared<> parent)
 
   send_update_chat_read_inbox_timeout_.set_callback(on_send_update_chat_read_inbox_timeout_callback);
   send_update_chat_read_inbox_timeout_.set_callback_data(static_cast<void *>(this));
+
+  save_dialog_list_snapshot_timeout_.set_callback(on_save_dialog_list_snapshot_timeout_callback);
+  save_dialog_list_snapshot_timeout_.set_callback_data(static_cast<void *>(this));
 }
 
 MessagesManager::~MessagesManager() {
@@ -5510,6 +5515,15 @@ void MessagesManager::on_preload_folder_dialog_list_timeout_callback(void *messa
                      FolderId(narrow_cast<int32>(folder_id_int)));
 }
 
+void MessagesManager::on_save_dialog_list_snapshot_timeout_callback(void *messages_manager_ptr) {
+  if (G()->close_flag()) {
+    return;
+  }
+
+  auto messages_manager = static_cast<MessagesManager *>(messages_manager_ptr);
+  send_closure_later(messages_manager->actor_id(messages_manager), &MessagesManager::save_dialog_list_snapshot);
+}
+
 void MessagesManager::on_update_viewed_messages_timeout_callback(void *messages_manager_ptr, int64 dialog_id_int) {
   if (G()->close_flag()) {
     return;
@@ -8072,7 +8086,7 @@ void MessagesManager::load_secret_thumbnail(FileId thumbnail_file_id) {
       });
 
   send_closure(G()->file_manager(), &FileManager::download, thumbnail_file_id,
-               std::make_shared<Callback>(std::move(download_promise)), 1, -1, -1,
+               std::make_shared<Callback>(std::move(download_promise)), 1, -1, -1, false,
                Promise<td_api::object_ptr<td_api::file>>());
 }
 
@@ -12255,6 +12269,9 @@ void MessagesManager::init() {
     G()->td_db()->get_binlog_pmc()->erase("unread_message_count");
     G()->td_db()->get_binlog_pmc()->erase("unread_dialog_count");
 
+    // the snapshot is requested first to receive it before any chat list is requested from the database
+    load_dialog_list_snapshot();
+
     auto last_database_server_dialog_dates = G()->td_db()->get_binlog_pmc()->prefix_get("last_server_dialog_date");
     for (auto &it : last_database_server_dialog_dates) {
       auto r_folder_id = to_integer_safe<int32>(it.first);
@@ -12422,6 +12439,9 @@ void MessagesManager::init() {
     G()->td_db()->get_binlog_pmc()->erase_by_prefix("unread_dialog_count");
     G()->td_db()->get_binlog_pmc()->erase("sponsored_dialog_id");
     G()->td_db()->get_binlog_pmc()->erase("fetched_marks_as_unread");
+    if (G()->use_sqlite_pmc()) {
+      G()->td_db()->get_sqlite_pmc()->erase("dialog_list_snapshot", Auto());
+    }
   }
   G()->td_db()->get_binlog_pmc()->erase("dialog_pinned_current_order");
 
@@ -12465,6 +12485,10 @@ void MessagesManager::on_authorization_success() {
   }
 
   create_folders(20);
+
+  if (G()->use_message_database()) {
+    save_dialog_list_snapshot_timeout_.set_timeout_in(DIALOG_LIST_SNAPSHOT_SAVE_PERIOD);
+  }
 }
 
 void MessagesManager::ttl_db_loop() {
@@ -15833,6 +15857,182 @@ void MessagesManager::preload_folder_dialog_list(FolderId folder_id) {
   }
 }
 
+class MessagesManager::DialogListSnapshot {
+ public:
+  vector<UserId> user_ids_;
+  vector<ChatId> chat_ids_;
+  vector<ChannelId> channel_ids_;
+  vector<DialogId> dialog_ids_;
+
+  template <class StorerT>
+  void store(StorerT &storer) const {
+    td::store(user_ids_, storer);
+    td::store(chat_ids_, storer);
+    td::store(channel_ids_, storer);
+    td::store(dialog_ids_, storer);
+  }
+
+  template <class ParserT>
+  void parse(ParserT &parser) {
+    td::parse(user_ids_, parser);
+    td::parse(chat_ids_, parser);
+    td::parse(channel_ids_, parser);
+    td::parse(dialog_ids_, parser);
+  }
+};
+
+void MessagesManager::load_dialog_list_snapshot() {
+  CHECK(G()->use_message_database());
+  G()->td_db()->get_sqlite_pmc()->get(
+      "dialog_list_snapshot", PromiseCreator::lambda([actor_id = actor_id(this)](string value) {
+        send_closure(actor_id, &MessagesManager::on_load_dialog_list_snapshot, std::move(value));
+      }));
+}
+
+void MessagesManager::on_load_dialog_list_snapshot(string value) {
+  if (G()->close_flag()) {
+    return;
+  }
+  CHECK(!td_->auth_manager_->is_bot());
+
+  save_dialog_list_snapshot_timeout_.set_timeout_in(DIALOG_LIST_SNAPSHOT_SAVE_PERIOD);
+  if (value.empty()) {
+    return;
+  }
+  dialog_list_snapshot_hash_ = crc64(value);
+
+  DialogListSnapshot snapshot;
+  auto status = log_event_parse(snapshot, value);
+  if (status.is_error()) {
+    LOG(ERROR) << "Failed to parse chat list snapshot: " << status;
+    G()->td_db()->get_sqlite_pmc()->erase("dialog_list_snapshot", Auto());
+    return;
+  }
+  LOG(INFO) << "Load snapshot with " << snapshot.dialog_ids_.size() << " chats, " << snapshot.user_ids_.size()
+            << " users, " << snapshot.chat_ids_.size() << " basic groups and " << snapshot.channel_ids_.size()
+            << " supergroups";
+
+  // the snapshot contains only identifiers, and everything is loaded from the databases, so it can't be stale;
+  // users and chats are loaded first to avoid their loading from the database one by one during parsing of the chats
+  MultiPromiseActorSafe mpas{"LoadDialogListSnapshotMultiPromiseActor"};
+  mpas.add_promise(PromiseCreator::lambda(
+      [actor_id = actor_id(this), dialog_ids = std::move(snapshot.dialog_ids_)](Result<Unit> result) mutable {
+        send_closure(actor_id, &MessagesManager::load_dialog_list_snapshot_dialogs, std::move(dialog_ids));
+      }));
+  mpas.set_ignore_errors(true);
+  auto lock = mpas.get_promise();
+  td_->user_manager_->load_users_from_database(snapshot.user_ids_, mpas.get_promise());
+  td_->chat_manager_->load_chats_from_database(snapshot.chat_ids_, mpas.get_promise());
+  td_->chat_manager_->load_channels_from_database(snapshot.channel_ids_, mpas.get_promise());
+  lock.set_value(Unit());
+}
+
+void MessagesManager::load_dialog_list_snapshot_dialogs(vector<DialogId> dialog_ids) {
+  if (G()->close_flag()) {
+    return;
+  }
+
+  for (auto dialog_id : dialog_ids) {
+    if (!dialog_id.is_valid() || dialog_id.get_type() == DialogType::SecretChat || have_dialog(dialog_id) ||
+        loaded_dialogs_.count(dialog_id) != 0 || failed_to_load_dialogs_.count(dialog_id) != 0) {
+      continue;
+    }
+    G()->td_db()->get_dialog_db_async()->get_dialog(
+        dialog_id, PromiseCreator::lambda([actor_id = actor_id(this), dialog_id](Result<BufferSlice> r_value) {
+          send_closure(actor_id, &MessagesManager::on_load_dialog_list_snapshot_dialog, dialog_id,
+                       std::move(r_value));
+        }));
+  }
+}
+
+void MessagesManager::on_load_dialog_list_snapshot_dialog(DialogId dialog_id, Result<BufferSlice> r_value) {
+  if (G()->close_flag() || r_value.is_error()) {
+    return;
+  }
+  if (have_dialog(dialog_id) || loaded_dialogs_.count(dialog_id) != 0 ||
+      failed_to_load_dialogs_.count(dialog_id) != 0) {
+    // the chat was loaded synchronously in the meantime
+    return;
+  }
+
+  on_load_dialog_from_database(dialog_id, r_value.move_as_ok(), "on_load_dialog_list_snapshot_dialog");
+}
+
+void MessagesManager::save_dialog_list_snapshot() {
+  if (G()->close_flag()) {
+    return;
+  }
+  CHECK(!td_->auth_manager_->is_bot());
+  CHECK(G()->use_message_database());
+
+  save_dialog_list_snapshot_timeout_.set_timeout_in(DIALOG_LIST_SNAPSHOT_SAVE_PERIOD);
+
+  vector<DialogId> dialog_ids;
+  FlatHashSet<DialogId, DialogIdHash> added_dialog_ids;
+  auto add_dialog_id = [&dialog_ids, &added_dialog_ids](DialogId dialog_id) {
+    if (added_dialog_ids.insert(dialog_id).second) {
+      dialog_ids.push_back(dialog_id);
+    }
+  };
+  for (const auto &list_it : dialog_lists_) {
+    auto dialog_list_id = list_it.first;
+    const auto &list = list_it.second;
+    int32 dialog_count = 0;
+    for (const auto &pinned_dialog : list.pinned_dialogs_) {
+      if (dialog_count == DIALOG_LIST_SNAPSHOT_SIZE) {
+        break;
+      }
+      add_dialog_id(pinned_dialog.get_dialog_id());
+      dialog_count++;
+    }
+    for (auto folder_id : get_dialog_list_folder_ids(list)) {
+      const auto *folder = get_dialog_folder(folder_id);
+      CHECK(folder != nullptr);
+      for (const auto &dialog_date : folder->ordered_dialogs_) {
+        if (dialog_count >= DIALOG_LIST_SNAPSHOT_SIZE || dialog_date.get_order() == DEFAULT_ORDER) {
+          break;
+        }
+        if (is_dialog_in_list(get_dialog(dialog_date.get_dialog_id()), dialog_list_id)) {
+          add_dialog_id(dialog_date.get_dialog_id());
+          dialog_count++;
+        }
+      }
+    }
+  }
+
+  DialogListSnapshot snapshot;
+  Dependencies dependencies;
+  for (auto dialog_id : dialog_ids) {
+    const Dialog *d = get_dialog(dialog_id);
+    if (d == nullptr || dialog_id.get_type() == DialogType::SecretChat) {
+      continue;
+    }
+    add_dialog_dependencies(dependencies, d);
+    snapshot.dialog_ids_.push_back(dialog_id);
+  }
+
+  for (auto user_id : dependencies.get_user_ids()) {
+    snapshot.user_ids_.push_back(user_id);
+  }
+  for (auto chat_id : dependencies.get_chat_ids()) {
+    snapshot.chat_ids_.push_back(chat_id);
+  }
+  for (auto channel_id : dependencies.get_channel_ids()) {
+    snapshot.channel_ids_.push_back(channel_id);
+  }
+
+  auto value = log_event_store(snapshot).as_slice().str();
+  auto hash = crc64(value);
+  if (hash == dialog_list_snapshot_hash_) {
+    LOG(INFO) << "Chat list snapshot hasn't changed";
+    return;
+  }
+  dialog_list_snapshot_hash_ = hash;
+
+  LOG(INFO) << "Save snapshot with " << snapshot.dialog_ids_.size() << " chats of size " << value.size();
+  G()->td_db()->get_sqlite_pmc()->set("dialog_list_snapshot", std::move(value), Auto());
+}
+
 void MessagesManager::get_dialogs_from_list(DialogListId dialog_list_id, int32 limit,
                                             Promise<td_api::object_ptr<td_api::chats>> &&promise) {
   CHECK(!td_->auth_manager_->is_bot());
@@ -35388,23 +35588,7 @@ unique_ptr<MessagesManager::Dialog> MessagesManager::parse_dialog(DialogId dialo
   CHECK(dialog_id == d->dialog_id);
 
   Dependencies dependencies;
-  dependencies.add_dialog_dependencies(dialog_id);
-  if (d->default_join_group_call_as_dialog_id != dialog_id) {
-    dependencies.add_message_sender_dependencies(d->default_join_group_call_as_dialog_id);
-  }
-  if (d->default_send_message_as_dialog_id != dialog_id) {
-    dependencies.add_message_sender_dependencies(d->default_send_message_as_dialog_id);
-  }
-  d->messages.foreach([&](const MessageId &message_id, const unique_ptr<Message> &message) {
-    add_message_dependencies(dependencies, message.get());
-  });
-  add_draft_message_dependencies(dependencies, d->draft_message);
-  if (d->business_bot_manage_bar != nullptr) {
-    d->business_bot_manage_bar->add_dependencies(dependencies);
-  }
-  for (auto user_id : d->pending_join_request_user_ids) {
-    dependencies.add(user_id);
-  }
+  add_dialog_dependencies(dependencies, d);
   if (!dependencies.resolve_force(td_, source)) {
     send_get_dialog_query(dialog_id, Auto(), 0, source);
   }
@@ -35441,6 +35625,27 @@ unique_ptr<MessagesManager::Dialog> MessagesManager::parse_dialog(DialogId dialo
   return dialog;
 }
 
+void MessagesManager::add_dialog_dependencies(Dependencies &dependencies, const Dialog *d) {
+  auto dialog_id = d->dialog_id;
+  dependencies.add_dialog_dependencies(dialog_id);
+  if (d->default_join_group_call_as_dialog_id != dialog_id) {
+    dependencies.add_message_sender_dependencies(d->default_join_group_call_as_dialog_id);
+  }
+  if (d->default_send_message_as_dialog_id != dialog_id) {
+    dependencies.add_message_sender_dependencies(d->default_send_message_as_dialog_id);
+  }
+  d->messages.foreach([&](const MessageId &message_id, const unique_ptr<Message> &message) {
+    add_message_dependencies(dependencies, message.get());
+  });
+  add_draft_message_dependencies(dependencies, d->draft_message);
+  if (d->business_bot_manage_bar != nullptr) {
+    d->business_bot_manage_bar->add_dependencies(dependencies);
+  }
+  for (auto user_id : d->pending_join_request_user_ids) {
+    dependencies.add(user_id);
+  }
+}
+
 MessagesManager::Dialog *MessagesManager::on_load_dialog_from_database(DialogId dialog_id, BufferSlice &&value,
                                                                        const char *source) {
   CHECK(G()->use_message_database());
@@ -38264,6 +38469,19 @@ void MessagesManager::get_current_state(vector<td_api::object_ptr<td_api::Update
   append(updates, std::move(last_message_updates));
 }
 
+void MessagesManager::get_memory_statistics(MemoryStatistics &statistics) const {
+  statistics.add("chats", dialogs_);
+  statistics.add("chats_hints", dialogs_hints_);
+
+  size_t message_count = 0;
+  dialogs_.foreach([&message_count](const DialogId &, const unique_ptr<Dialog> &dialog) {
+    message_count += dialog->messages.calc_size();
+  });
+  statistics.add("messages", message_count,
+                 message_count * (sizeof(MessageId) + sizeof(unique_ptr<Message>) + sizeof(Message)));
+  statistics.add("message_id_to_chat_id", message_id_to_dialog_id_);
+}
+
 void MessagesManager::add_message_file_to_downloads(MessageFullId message_full_id, FileId file_id, int32 priority,
                                                     Promise<td_api::object_ptr<td_api::file>> promise) {
   auto m = get_message_force(message_full_id, "add_message_file_to_downloads");
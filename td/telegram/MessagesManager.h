@@ -75,6 +75,7 @@
 #include "td/actor/actor.h"
 #include "td/actor/MultiPromise.h"
 #include "td/actor/MultiTimeout.h"
+#include "td/actor/Timeout.h"
 #include "td/actor/SignalSlot.h"
 
 #include "td/utils/buffer.h"
@@ -112,6 +113,7 @@ class DialogActionBar;
 class DialogFilter;
 class DraftMessage;
 struct InputMessageContent;
+class MemoryStatistics;
 class MessageContent;
 class MessageForwardInfo;
 struct MessageReactions;
@@ -963,6 +965,8 @@ class MessagesManager final : public Actor {
 
   void get_current_state(vector<td_api::object_ptr<td_api::Update>> &updates) const;
 
+  void get_memory_statistics(MemoryStatistics &statistics) const;
+
   void add_message_file_to_downloads(MessageFullId message_full_id, FileId file_id, int32 priority,
                                      Promise<td_api::object_ptr<td_api::file>> promise);
 
@@ -1540,6 +1544,8 @@ class MessagesManager final : public Actor {
     }
   };
 
+  class DialogListSnapshot;
+
   class BlockMessageSenderFromRepliesOnServerLogEvent;
   class DeleteAllCallMessagesOnServerLogEvent;
   class DeleteAllChannelMessagesFromSenderOnServerLogEvent;
@@ -1606,6 +1612,9 @@ class MessagesManager final : public Actor {
   static constexpr int32 MIN_READ_HISTORY_DELAY = 3;  // seconds
   static constexpr int32 MAX_SAVE_DIALOG_DELAY = 0;   // seconds
 
+  static constexpr int32 DIALOG_LIST_SNAPSHOT_SIZE = 100;         // number of first chats of each saved chat list
+  static constexpr int32 DIALOG_LIST_SNAPSHOT_SAVE_PERIOD = 600;  // seconds
+
   static constexpr int32 DEFAULT_LOADED_EXPIRED_MESSAGES = 50;
 
   static constexpr int32 LIVE_LOCATION_VIEW_PERIOD = 60;      // seconds, server-side limit
@@ -2152,6 +2161,16 @@ class MessagesManager final : public Actor {
 
   void preload_folder_dialog_list(FolderId folder_id);
 
+  void load_dialog_list_snapshot();
+
+  void on_load_dialog_list_snapshot(string value);
+
+  void load_dialog_list_snapshot_dialogs(vector<DialogId> dialog_ids);
+
+  void on_load_dialog_list_snapshot_dialog(DialogId dialog_id, Result<BufferSlice> r_value);
+
+  void save_dialog_list_snapshot();
+
   void get_dialogs_from_list_impl(int64 task_id);
 
   void on_get_dialogs_from_list(int64 task_id, Result<Unit> &&result);
@@ -2993,6 +3012,8 @@ class MessagesManager final : public Actor {
 
   static void on_preload_folder_dialog_list_timeout_callback(void *messages_manager_ptr, int64 folder_id_int);
 
+  static void on_save_dialog_list_snapshot_timeout_callback(void *messages_manager_ptr);
+
   static void on_update_viewed_messages_timeout_callback(void *messages_manager_ptr, int64 dialog_id_int);
 
   static void on_send_update_chat_read_inbox_timeout_callback(void *messages_manager_ptr, int64 dialog_id_int);
@@ -3056,6 +3077,8 @@ class MessagesManager final : public Actor {
 
   void add_message_dependencies(Dependencies &dependencies, const Message *m);
 
+  void add_dialog_dependencies(Dependencies &dependencies, const Dialog *d);
+
   static void save_send_message_log_event(DialogId dialog_id, const Message *m);
 
   static uint64 save_toggle_dialog_report_spam_state_on_server_log_event(DialogId dialog_id, bool is_spam_dialog);
@@ -3319,6 +3342,9 @@ class MessagesManager final : public Actor {
   MultiTimeout update_viewed_messages_timeout_{"UpdateViewedMessagesTimeout"};
   MultiTimeout send_update_chat_read_inbox_timeout_{"SendUpdateChatReadInboxTimeout"};
 
+  Timeout save_dialog_list_snapshot_timeout_;
+  uint64 dialog_list_snapshot_hash_ = 0;
+
   Hints dialogs_hints_;  // search dialogs by title and usernames
 
   FlatHashSet<MessageFullId, MessageFullIdHash> active_live_location_message_full_ids_;
@@ -0,0 +1,387 @@
+//
+// Copyright Aliaksei Levin (levlam@telegram.org), Arseny Smirnov (arseny30@gmail.com) 2014-2024
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+#include "td/telegram/ObjectSnapshotCache.h"
+
+#include "td/telegram/td_api.hpp"
+#include "td/telegram/td_api_copy.h"
+
+#include "td/utils/logging.h"
+#include "td/utils/Time.h"
+
+namespace td {
+
+constexpr size_t ObjectSnapshotCache::MAX_OBJECT_COUNT;
+constexpr size_t ObjectSnapshotCache::SHARD_COUNT;
+
+namespace {
+
+template <class T>
+auto get_update_chat_id(const T &update, int) -> decltype(static_cast<int64>(update.chat_id_)) {
+  return update.chat_id_;
+}
+
+template <class T>
+int64 get_update_chat_id(const T &, long) {
+  return 0;
+}
+
+template <class T>
+auto get_update_message_chat_id(const T &update, int) -> decltype(static_cast<int64>(update.message_->chat_id_)) {
+  return update.message_ == nullptr ? 0 : update.message_->chat_id_;
+}
+
+template <class T>
+int64 get_update_message_chat_id(const T &, long) {
+  return 0;
+}
+
+template <class T>
+auto get_update_user_id(const T &update, int) -> decltype(static_cast<int64>(update.user_id_)) {
+  return update.user_id_;
+}
+
+template <class T>
+int64 get_update_user_id(const T &, long) {
+  return 0;
+}
+
+}  // namespace
+
+bool ObjectSnapshotCache::is_cacheable_request(const td_api::Function &function) {
+  return get_request_key(function).is_valid();
+}
+
+ObjectSnapshotCache::ObjectKey ObjectSnapshotCache::get_request_key(const td_api::Function &function) {
+  switch (function.get_id()) {
+    case td_api::getUser::ID:
+      return {td_api::user::ID, static_cast<const td_api::getUser &>(function).user_id_};
+    case td_api::getChat::ID:
+      return {td_api::chat::ID, static_cast<const td_api::getChat &>(function).chat_id_};
+    case td_api::getMessage::ID: {
+      const auto &request = static_cast<const td_api::getMessage &>(function);
+      return {td_api::message::ID, request.chat_id_, request.message_id_};
+    }
+    case td_api::getFile::ID:
+      return {td_api::file::ID, static_cast<const td_api::getFile &>(function).file_id_};
+    default:
+      return {};
+  }
+}
+
+ObjectSnapshotCache::ObjectKey ObjectSnapshotCache::get_object_key(const td_api::Object &object) {
+  switch (object.get_id()) {
+    case td_api::user::ID:
+      return {td_api::user::ID, static_cast<const td_api::user &>(object).id_};
+    case td_api::chat::ID:
+      return {td_api::chat::ID, static_cast<const td_api::chat &>(object).id_};
+    case td_api::message::ID: {
+      const auto &message = static_cast<const td_api::message &>(object);
+      return {td_api::message::ID, message.chat_id_, message.id_};
+    }
+    case td_api::file::ID:
+      return {td_api::file::ID, static_cast<const td_api::file &>(object).id_};
+    case td_api::poll::ID:
+      return {td_api::poll::ID, static_cast<const td_api::poll &>(object).id_};
+    default:
+      return {};
+  }
+}
+
+bool ObjectSnapshotCache::has_time_dependent_fields(const td_api::Object &object) {
+  if (object.get_id() != td_api::message::ID) {
+    return false;
+  }
+  // the flags become false after some time without any update, so they can't be returned from a snapshot;
+  // self_destruct_in and auto_delete_in are adjusted when the snapshot is copied
+  const auto &message = static_cast<const td_api::message &>(object);
+  return message.can_be_edited_ || message.can_be_deleted_for_all_users_ || message.can_get_read_date_ ||
+         message.can_get_viewers_;
+}
+
+td_api::object_ptr<td_api::Object> ObjectSnapshotCache::get_snapshot_copy(const Snapshot &snapshot) {
+  auto result = td_api::copy_object(*snapshot.object);
+  if (result->get_id() == td_api::message::ID) {
+    auto &message = static_cast<td_api::message &>(*result);
+    auto passed_time = Time::now() - snapshot.time;
+    for (auto *left_time : {&message.self_destruct_in_, &message.auto_delete_in_}) {
+      if (*left_time > 0.0) {
+        if (*left_time <= passed_time) {
+          // the message must have been deleted already
+          return nullptr;
+        }
+        *left_time -= passed_time;
+      }
+    }
+  }
+  return result;
+}
+
+ObjectSnapshotCache::Shard &ObjectSnapshotCache::get_shard(const ObjectKey &key) {
+  return shards_[ObjectKeyHash()(key) % SHARD_COUNT];
+}
+
+td_api::object_ptr<td_api::Object> ObjectSnapshotCache::get_object(const td_api::Function &function) {
+  auto key = get_request_key(function);
+  if (!key.is_valid()) {
+    return nullptr;
+  }
+  if (pending_request_count_.load(std::memory_order_acquire) != 0) {
+    // the request must not overtake previous requests, which can change the object
+    return nullptr;
+  }
+
+  Snapshot snapshot;
+  {
+    auto &shard = get_shard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.objects.find(key);
+    if (it == shard.objects.end()) {
+      shard.miss_count++;
+      return nullptr;
+    }
+    shard.hit_count++;
+    snapshot = it->second;
+  }
+  // the snapshot is immutable, so it can be copied without the lock
+  return get_snapshot_copy(snapshot);
+}
+
+void ObjectSnapshotCache::on_request_sent() {
+  pending_request_count_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void ObjectSnapshotCache::on_response_sent() {
+  auto old_count = pending_request_count_.fetch_sub(1, std::memory_order_release);
+  CHECK(old_count > 0);
+}
+
+ObjectSnapshotCache::Stats ObjectSnapshotCache::get_stats() const {
+  Stats stats;
+  for (auto &shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    stats.object_count += shard.objects.size();
+    stats.hit_count += shard.hit_count;
+    stats.miss_count += shard.miss_count;
+  }
+  return stats;
+}
+
+void ObjectSnapshotCache::set_is_enabled(bool is_enabled) {
+  if (is_enabled_ == is_enabled) {
+    return;
+  }
+  is_enabled_ = is_enabled;
+  if (!is_enabled) {
+    clear();
+  }
+}
+
+void ObjectSnapshotCache::on_request(uint64 id, const td_api::Function &function) {
+  if (!is_enabled_ || !is_authorized_) {
+    return;
+  }
+  auto key = get_request_key(function);
+  if (!key.is_valid() || key.type == td_api::file::ID) {
+    // getFile can return an object with a different identifier, so files are cached only from updateFile
+    return;
+  }
+  pending_requests_[id] = key;
+}
+
+void ObjectSnapshotCache::on_result(uint64 id, const td_api::Object &object) {
+  auto it = pending_requests_.find(id);
+  if (it == pending_requests_.end()) {
+    return;
+  }
+  auto key = it->second;
+  pending_requests_.erase(it);
+
+  if (get_object_key(object) == key) {
+    add_object(object);
+  }
+}
+
+void ObjectSnapshotCache::on_error(uint64 id) {
+  pending_requests_.erase(id);
+}
+
+void ObjectSnapshotCache::on_update(const td_api::Update &update) {
+  switch (update.get_id()) {
+    case td_api::updateAuthorizationState::ID: {
+      const auto &state = static_cast<const td_api::updateAuthorizationState &>(update).authorization_state_;
+      is_authorized_ = state != nullptr && state->get_id() == td_api::authorizationStateReady::ID;
+      if (!is_authorized_) {
+        clear();
+      }
+      return;
+    }
+    case td_api::updateUser::ID: {
+      const auto &user = static_cast<const td_api::updateUser &>(update).user_;
+      if (user != nullptr) {
+        add_object(*user);
+      }
+      return;
+    }
+    case td_api::updateNewChat::ID: {
+      const auto &chat = static_cast<const td_api::updateNewChat &>(update).chat_;
+      if (chat != nullptr) {
+        add_object(*chat);
+      }
+      return;
+    }
+    case td_api::updateNewMessage::ID: {
+      const auto &message = static_cast<const td_api::updateNewMessage &>(update).message_;
+      if (message != nullptr) {
+        add_object(*message);
+      }
+      return;
+    }
+    case td_api::updateFile::ID: {
+      const auto &file = static_cast<const td_api::updateFile &>(update).file_;
+      if (file != nullptr) {
+        auto key = get_object_key(*file);
+        remove_dependent_objects(key);
+        add_object(*file);
+      }
+      return;
+    }
+    case td_api::updatePoll::ID: {
+      const auto &poll = static_cast<const td_api::updatePoll &>(update).poll_;
+      if (poll != nullptr) {
+        remove_dependent_objects(get_object_key(*poll));
+      }
+      return;
+    }
+    default:
+      break;
+  }
+
+  if (object_count_ == 0) {
+    return;
+  }
+
+  // any other update about a chat, a message or a user can change the corresponding object
+  int64 chat_id = 0;
+  int64 message_chat_id = 0;
+  int64 user_id = 0;
+  downcast_call(const_cast<td_api::Update &>(update), [&](const auto &update) {
+    chat_id = get_update_chat_id(update, 0);
+    message_chat_id = get_update_message_chat_id(update, 0);
+    user_id = get_update_user_id(update, 0);
+  });
+  if (chat_id != 0) {
+    remove_chat(chat_id);
+  }
+  if (message_chat_id != 0 && message_chat_id != chat_id) {
+    remove_chat(message_chat_id);
+  }
+  if (user_id != 0) {
+    remove_object({td_api::user::ID, user_id});
+  }
+}
+
+void ObjectSnapshotCache::add_object(const td_api::Object &object) {
+  if (!is_enabled_ || !is_authorized_) {
+    return;
+  }
+  auto key = get_object_key(object);
+  CHECK(key.is_valid());
+  if (has_time_dependent_fields(object)) {
+    remove_object(key);
+    return;
+  }
+
+  // the object must not be returned from the cache before the client receives it
+  pending_snapshot_key_ = key;
+  pending_snapshot_.object = std::shared_ptr<const td_api::Object>(td_api::copy_object(object).release());
+  pending_snapshot_.time = Time::now();
+}
+
+void ObjectSnapshotCache::on_object_sent() {
+  if (pending_snapshot_.object != nullptr) {
+    publish_pending_snapshot();
+  }
+}
+
+void ObjectSnapshotCache::publish_pending_snapshot() {
+  auto key = pending_snapshot_key_;
+  Snapshot snapshot = std::move(pending_snapshot_);
+  pending_snapshot_ = Snapshot();
+  if (!is_enabled_ || !is_authorized_) {
+    return;
+  }
+  if (object_count_ >= MAX_OBJECT_COUNT) {
+    LOG(INFO) << "Clear object snapshot cache with " << object_count_ << " objects";
+    clear();
+  }
+
+  td_api::for_each_nested_object(*snapshot.object, [&](const td_api::Object &nested_object) {
+    switch (nested_object.get_id()) {
+      case td_api::file::ID:
+      case td_api::poll::ID:
+        dependent_objects_[get_object_key(nested_object)].insert(key);
+        break;
+      default:
+        break;
+    }
+  });
+  if (key.type == td_api::message::ID) {
+    chat_message_ids_[key.first].insert(key.second);
+  }
+
+  auto &shard = get_shard(key);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  auto &stored_snapshot = shard.objects[key];
+  if (stored_snapshot.object == nullptr) {
+    object_count_++;
+  }
+  stored_snapshot = std::move(snapshot);
+}
+
+void ObjectSnapshotCache::remove_object(const ObjectKey &key) {
+  auto &shard = get_shard(key);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  object_count_ -= shard.objects.erase(key);
+}
+
+void ObjectSnapshotCache::remove_chat(int64 chat_id) {
+  remove_object({td_api::chat::ID, chat_id});
+
+  auto it = chat_message_ids_.find(chat_id);
+  if (it == chat_message_ids_.end()) {
+    return;
+  }
+  for (auto message_id : it->second) {
+    remove_object({td_api::message::ID, chat_id, message_id});
+  }
+  chat_message_ids_.erase(it);
+}
+
+void ObjectSnapshotCache::remove_dependent_objects(const ObjectKey &key) {
+  auto it = dependent_objects_.find(key);
+  if (it == dependent_objects_.end()) {
+    return;
+  }
+  for (auto &dependent_key : it->second) {
+    remove_object(dependent_key);
+  }
+  dependent_objects_.erase(it);
+}
+
+void ObjectSnapshotCache::clear() {
+  for (auto &shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.objects.clear();
+  }
+  object_count_ = 0;
+  pending_requests_.clear();
+  pending_snapshot_ = Snapshot();
+  chat_message_ids_.clear();
+  dependent_objects_.clear();
+}
+
+}  // namespace td
@@ -0,0 +1,152 @@
+//
+// Copyright Aliaksei Levin (levlam@telegram.org), Arseny Smirnov (arseny30@gmail.com) 2014-2024
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+#pragma once
+
+#include "td/telegram/td_api.h"
+
+#include "td/utils/common.h"
+#include "td/utils/FlatHashMap.h"
+#include "td/utils/FlatHashSet.h"
+#include "td/utils/HashTableUtils.h"
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+namespace td {
+
+// Keeps immutable copies of users, chats, messages and files, which were sent to the client,
+// so that getUser, getChat, getMessage and getFile can be answered from any thread without waiting for Td.
+// The cache is filled and invalidated only by Td in the order in which responses and updates are sent,
+// so a cached object is never older than the last update about it, which was sent to the client.
+// A new object is published only after the update or the response with it was sent, so the client can't receive
+// the object from the cache before the update about it.
+// Requests are answered from the cache only while Td has no unanswered requests from the client,
+// so a getter sent after a request changing the object can't overtake it.
+class ObjectSnapshotCache {
+ public:
+  static constexpr size_t MAX_OBJECT_COUNT = 100000;
+
+  struct Stats {
+    size_t object_count = 0;
+    uint64 hit_count = 0;
+    uint64 miss_count = 0;
+  };
+
+  ObjectSnapshotCache() = default;
+  ObjectSnapshotCache(const ObjectSnapshotCache &) = delete;
+  ObjectSnapshotCache &operator=(const ObjectSnapshotCache &) = delete;
+  ObjectSnapshotCache(ObjectSnapshotCache &&) = delete;
+  ObjectSnapshotCache &operator=(ObjectSnapshotCache &&) = delete;
+  ~ObjectSnapshotCache() = default;
+
+  static bool is_cacheable_request(const td_api::Function &function);
+
+  // can be called from any thread; returns nullptr if there is no cached answer to the request
+  // or if there are requests, which weren't answered by Td yet
+  td_api::object_ptr<td_api::Object> get_object(const td_api::Function &function);
+
+  // must be called before a request is sent to Td
+  void on_request_sent();
+
+  // must be called after Td has sent a response to a request, passed to on_request_sent
+  void on_response_sent();
+
+  Stats get_stats() const;
+
+  // the following methods must be called only by Td
+  void set_is_enabled(bool is_enabled);
+
+  void on_request(uint64 id, const td_api::Function &function);
+
+  void on_result(uint64 id, const td_api::Object &object);
+
+  void on_error(uint64 id);
+
+  void on_update(const td_api::Update &update);
+
+  // must be called after each response and update, passed to on_result and on_update, was sent to the client
+  void on_object_sent();
+
+  void clear();
+
+ private:
+  struct ObjectKey {
+    int32 type = 0;
+    int64 first = 0;
+    int64 second = 0;
+
+    ObjectKey() = default;
+    ObjectKey(int32 type, int64 first, int64 second = 0) : type(type), first(first), second(second) {
+    }
+
+    bool is_valid() const {
+      return type != 0;
+    }
+
+    bool operator==(const ObjectKey &other) const {
+      return type == other.type && first == other.first && second == other.second;
+    }
+  };
+
+  struct ObjectKeyHash {
+    uint32 operator()(const ObjectKey &key) const {
+      return combine_hashes(combine_hashes(Hash<int32>()(key.type), Hash<int64>()(key.first)),
+                            Hash<int64>()(key.second));
+    }
+  };
+
+  static constexpr size_t SHARD_COUNT = 16;
+
+  struct Snapshot {
+    std::shared_ptr<const td_api::Object> object;
+    double time = 0.0;
+  };
+
+  struct Shard {
+    mutable std::mutex mutex;
+    FlatHashMap<ObjectKey, Snapshot, ObjectKeyHash> objects;
+    uint64 hit_count = 0;
+    uint64 miss_count = 0;
+  };
+  std::array<Shard, SHARD_COUNT> shards_;
+
+  std::atomic<int64> pending_request_count_{0};
+
+  // the following fields are accessed only by Td
+  bool is_enabled_ = false;
+  bool is_authorized_ = false;
+  size_t object_count_ = 0;
+  FlatHashMap<uint64, ObjectKey> pending_requests_;
+  ObjectKey pending_snapshot_key_;
+  Snapshot pending_snapshot_;
+  FlatHashMap<int64, FlatHashSet<int64>> chat_message_ids_;
+  FlatHashMap<ObjectKey, FlatHashSet<ObjectKey, ObjectKeyHash>, ObjectKeyHash> dependent_objects_;
+
+  static ObjectKey get_request_key(const td_api::Function &function);
+
+  static ObjectKey get_object_key(const td_api::Object &object);
+
+  static bool has_time_dependent_fields(const td_api::Object &object);
+
+  static td_api::object_ptr<td_api::Object> get_snapshot_copy(const Snapshot &snapshot);
+
+  Shard &get_shard(const ObjectKey &key);
+
+  void add_object(const td_api::Object &object);
+
+  void publish_pending_snapshot();
+
+  void remove_object(const ObjectKey &key);
+
+  void remove_chat(int64 chat_id);
+
+  void remove_dependent_objects(const ObjectKey &key);
+};
+
+}  // namespace td
@@ -620,12 +620,21 @@ void OptionManager::on_option_updated(Slice name) {
       }
       break;
     case 'u':
+      if (name == "use_database_compression") {
+        G()->td_db()->set_use_database_compression(get_option_boolean(name));
+      }
+      if (name == "use_fast_getters") {
+        td_->update_use_fast_getters();
+      }
       if (name == "use_pfs") {
         G()->net_query_dispatcher().update_use_pfs();
       }
       if (name == "use_storage_optimizer") {
         send_closure(td_->storage_manager_, &StorageManager::update_use_storage_optimizer);
       }
+      if (name == "use_tl_object_arena") {
+        G()->set_use_tl_object_arena(get_option_boolean(name));
+      }
       if (name == "utc_time_offset") {
         if (G()->mtproto_header().set_tz_offset(static_cast<int32>(get_option_integer(name)))) {
           G()->net_query_dispatcher().update_mtproto_header();
@@ -799,6 +808,9 @@ void OptionManager::set_option(const string &name, td_api::object_ptr<td_api::Op
       */
       break;
     case 'c':
+      if (set_integer_option("chat_info_cache_size", 0, 1000000000)) {
+        return;
+      }
       if (!is_bot && set_string_option("connection_parameters", [](Slice value) {
             string value_copy = value.str();
             auto r_json_value = get_json_value(value_copy);
@@ -811,6 +823,23 @@ void OptionManager::set_option(const string &name, td_api::object_ptr<td_api::Op
       }
       break;
     case 'd':
+      // the database cache size is applied after the next restart
+      if (set_integer_option("database_cache_size_max", 1 << 20, 1 << 30)) {
+        return;
+      }
+      if (name == "database_trace_path") {
+        string path;
+        if (value_constructor_id == td_api::optionValueString::ID) {
+          path = static_cast<td_api::optionValueString *>(value.get())->value_;
+        } else if (value_constructor_id != td_api::optionValueEmpty::ID) {
+          return promise.set_error(Status::Error(400, "Option \"database_trace_path\" must have string value"));
+        }
+        auto status = G()->td_db()->set_trace_path(path);
+        if (status.is_error()) {
+          return promise.set_error(Status::Error(400, status.message()));
+        }
+        return promise.set_value(Unit());
+      }
       if (!is_bot && set_boolean_option("disable_animated_emoji")) {
         return;
       }
@@ -961,6 +990,15 @@ void OptionManager::set_option(const string &name, td_api::object_ptr<td_api::Op
       }
       break;
     case 'u':
+      if (set_boolean_option("use_file_content_store")) {
+        return;
+      }
+      if (set_boolean_option("use_database_compression")) {
+        return;
+      }
+      if (set_boolean_option("use_fast_getters")) {
+        return;
+      }
       if (set_boolean_option("use_pfs")) {
         return;
       }
@@ -970,6 +1008,9 @@ void OptionManager::set_option(const string &name, td_api::object_ptr<td_api::Op
       if (set_boolean_option("use_storage_optimizer")) {
         return;
       }
+      if (set_boolean_option("use_tl_object_arena")) {
+        return;
+      }
       if (set_integer_option("utc_time_offset", -12 * 60 * 60, 14 * 60 * 60)) {
         return;
       }
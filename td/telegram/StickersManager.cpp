@@ -23,6 +23,7 @@
 #include "td/telegram/LanguagePackManager.h"
 #include "td/telegram/logevent/LogEvent.h"
 #include "td/telegram/logevent/LogEventHelper.h"
+#include "td/telegram/MemoryStatistics.h"
 #include "td/telegram/MessagesManager.h"
 #include "td/telegram/misc.h"
 #include "td/telegram/net/DcId.h"
@@ -9911,11 +9912,33 @@ void StickersManager::on_get_emoji_keywords_difference(
   key_values.emplace(get_emoji_language_code_version_database_key(language_code), to_string(version));
   key_values.emplace(get_emoji_language_code_last_difference_time_database_key(language_code),
                      to_string(G()->unix_time()));
+
+  // load current emojis for all changed keywords at once
+  vector<string> texts;
+  vector<string> database_keys;
   for (auto &keyword_ptr : keywords->keywords_) {
+    switch (keyword_ptr->get_id()) {
+      case telegram_api::emojiKeyword::ID:
+        texts.push_back(utf8_to_lower(static_cast<const telegram_api::emojiKeyword *>(keyword_ptr.get())->keyword_));
+        break;
+      case telegram_api::emojiKeywordDeleted::ID:
+        texts.push_back(
+            utf8_to_lower(static_cast<const telegram_api::emojiKeywordDeleted *>(keyword_ptr.get())->keyword_));
+        break;
+      default:
+        UNREACHABLE();
+    }
+    database_keys.push_back(get_language_emojis_database_key(language_code, texts.back()));
+  }
+  auto database_values = G()->td_db()->get_sqlite_sync_pmc()->get_many(database_keys);
+  CHECK(database_values.size() == texts.size());
+
+  for (size_t i = 0; i < keywords->keywords_.size(); i++) {
+    auto &keyword_ptr = keywords->keywords_[i];
+    const auto &text = texts[i];
     switch (keyword_ptr->get_id()) {
       case telegram_api::emojiKeyword::ID: {
         auto keyword = telegram_api::move_object_as<telegram_api::emojiKeyword>(keyword_ptr);
-        auto text = utf8_to_lower(keyword->keyword_);
         bool is_good = true;
         for (auto &emoji : keyword->emoticons_) {
           if (emoji.find('$') != string::npos) {
@@ -9924,7 +9947,7 @@ void StickersManager::on_get_emoji_keywords_difference(
           }
         }
         if (is_good) {
-          vector<string> emojis = get_keyword_language_emojis(language_code, text);
+          vector<string> emojis = full_split(database_values[i], '$');
           bool is_changed = false;
           for (auto &emoji : keyword->emoticons_) {
             if (!td::contains(emojis, emoji)) {
@@ -9943,8 +9966,7 @@ void StickersManager::on_get_emoji_keywords_difference(
       }
       case telegram_api::emojiKeywordDeleted::ID: {
         auto keyword = telegram_api::move_object_as<telegram_api::emojiKeywordDeleted>(keyword_ptr);
-        auto text = utf8_to_lower(keyword->keyword_);
-        vector<string> emojis = get_keyword_language_emojis(language_code, text);
+        vector<string> emojis = full_split(database_values[i], '$');
         bool is_changed = false;
         for (auto &emoji : keyword->emoticons_) {
           if (td::remove(emojis, emoji)) {
@@ -10282,4 +10304,9 @@ void StickersManager::get_current_state(vector<td_api::object_ptr<td_api::Update
   }
 }
 
+void StickersManager::get_memory_statistics(MemoryStatistics &statistics) const {
+  statistics.add("stickers", stickers_);
+  statistics.add("sticker_sets", sticker_sets_);
+}
+
 }  // namespace td
@@ -51,6 +51,7 @@
 
 namespace td {
 
+class MemoryStatistics;
 class Td;
 
 class StickersManager final : public Actor {
@@ -433,6 +434,8 @@ class StickersManager final : public Actor {
 
   void get_current_state(vector<td_api::object_ptr<td_api::Update>> &updates) const;
 
+  void get_memory_statistics(MemoryStatistics &statistics) const;
+
   template <class StorerT>
   void store_sticker_set_id(StickerSetId sticker_set_id, StorerT &storer) const;
 
@@ -7,7 +7,9 @@
 #include "td/telegram/StorageManager.h"
 
 #include "td/telegram/DialogId.h"
+#include "td/telegram/files/FileContentCache.h"
 #include "td/telegram/files/FileGcWorker.h"
+#include "td/telegram/files/FileManager.h"
 #include "td/telegram/files/FileStatsWorker.h"
 #include "td/telegram/Global.h"
 #include "td/telegram/logevent/LogEvent.h"
@@ -23,6 +25,7 @@
 #include "td/utils/port/Stat.h"
 #include "td/utils/Random.h"
 #include "td/utils/Slice.h"
+#include "td/utils/SliceBuilder.h"
 #include "td/utils/Time.h"
 
 namespace td {
@@ -96,10 +99,16 @@ void StorageManager::get_database_stats(Promise<DatabaseStats> promise) {
   //TODO: use another thread
   auto r_stats = G()->td_db()->get_stats();
   if (r_stats.is_error()) {
-    promise.set_error(r_stats.move_as_error());
-  } else {
-    promise.set_value(DatabaseStats(r_stats.move_as_ok()));
+    return promise.set_error(r_stats.move_as_error());
   }
+  send_closure(G()->file_manager(), &FileManager::get_content_cache_stats,
+               PromiseCreator::lambda([stats = r_stats.move_as_ok(), promise = std::move(promise)](
+                                          Result<FileContentCache::Stats> r_cache_stats) mutable {
+                 if (r_cache_stats.is_ok()) {
+                   stats += PSTRING() << '\n' << r_cache_stats.ok();
+                 }
+                 promise.set_value(DatabaseStats(std::move(stats)));
+               }));
 }
 
 void StorageManager::update_use_storage_optimizer() {
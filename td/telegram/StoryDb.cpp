@@ -9,6 +9,7 @@
 #include "td/telegram/StoryId.h"
 #include "td/telegram/Version.h"
 
+#include "td/db/SqliteBlobCompressor.h"
 #include "td/db/SqliteConnectionSafe.h"
 #include "td/db/SqliteDb.h"
 #include "td/db/SqliteStatement.h"
@@ -22,6 +23,7 @@
 #include "td/utils/StringBuilder.h"
 #include "td/utils/Time.h"
 
+#include <atomic>
 #include <utility>
 
 namespace td {
@@ -80,7 +82,8 @@ Status drop_story_db(SqliteDb &db, int32 version) {
 
 class StoryDbImpl final : public StoryDbSyncInterface {
  public:
-  explicit StoryDbImpl(SqliteDb db) : db_(std::move(db)) {
+  StoryDbImpl(SqliteDb db, const std::atomic<bool> *use_compression)
+      : db_(std::move(db)), use_compression_(use_compression) {
     init().ensure();
   }
 
@@ -122,7 +125,7 @@ class StoryDbImpl final : public StoryDbSyncInterface {
     TRY_RESULT_ASSIGN(get_active_story_list_state_stmt_,
                       db_.get_statement("SELECT data FROM active_story_lists WHERE story_list_id = ?1"));
 
-    return Status::OK();
+    return compressor_.init(db_.clone(), "stories", use_compression_);
   }
 
   void add_story(StoryFullId story_full_id, int32 expires_at, NotificationId notification_id, BufferSlice data) final {
@@ -146,7 +149,7 @@ class StoryDbImpl final : public StoryDbSyncInterface {
     } else {
       add_story_stmt_.bind_null(4).ensure();
     }
-    add_story_stmt_.bind_blob(5, data.as_slice()).ensure();
+    add_story_stmt_.bind_blob(5, compressor_.compress(data.as_slice())).ensure();
 
     add_story_stmt_.step().ensure();
   }
@@ -178,7 +181,7 @@ class StoryDbImpl final : public StoryDbSyncInterface {
     if (!get_story_stmt_.has_row()) {
       return Status::Error("Not found");
     }
-    return BufferSlice(get_story_stmt_.view_blob(0));
+    return compressor_.decompress(get_story_stmt_.view_blob(0));
   }
 
   vector<StoryDbStory> get_expiring_stories(int32 expires_till, int32 limit) final {
@@ -195,7 +198,7 @@ class StoryDbImpl final : public StoryDbSyncInterface {
     while (stmt.has_row()) {
       DialogId dialog_id(stmt.view_int64(0));
       StoryId story_id(stmt.view_int32(1));
-      BufferSlice data(stmt.view_blob(2));
+      auto data = compressor_.decompress(stmt.view_blob(2));
       stories.emplace_back(StoryFullId{dialog_id, story_id}, std::move(data));
       stmt.step().ensure();
     }
@@ -217,7 +220,7 @@ class StoryDbImpl final : public StoryDbSyncInterface {
     vector<StoryDbStory> stories;
     while (stmt.has_row()) {
       StoryId story_id(stmt.view_int32(0));
-      BufferSlice data(stmt.view_blob(1));
+      auto data = compressor_.decompress(stmt.view_blob(1));
       stories.emplace_back(StoryFullId{dialog_id, story_id}, std::move(data));
       stmt.step().ensure();
     }
@@ -235,7 +238,7 @@ class StoryDbImpl final : public StoryDbSyncInterface {
       add_active_stories_stmt_.bind_null(2).ensure();
     }
     add_active_stories_stmt_.bind_int64(3, dialog_order).ensure();
-    add_active_stories_stmt_.bind_blob(4, data.as_slice()).ensure();
+    add_active_stories_stmt_.bind_blob(4, compressor_.compress(data.as_slice())).ensure();
     add_active_stories_stmt_.step().ensure();
   }
 
@@ -257,7 +260,7 @@ class StoryDbImpl final : public StoryDbSyncInterface {
     if (!get_active_stories_stmt_.has_row()) {
       return Status::Error("Not found");
     }
-    return BufferSlice(get_active_stories_stmt_.view_blob(0));
+    return compressor_.decompress(get_active_stories_stmt_.view_blob(0));
   }
 
   StoryDbGetActiveStoryListResult get_active_story_list(StoryListId story_list_id, int64 order, DialogId dialog_id,
@@ -276,7 +279,7 @@ class StoryDbImpl final : public StoryDbSyncInterface {
     result.next_order_ = order;
     get_active_story_list_stmt_.step().ensure();
     while (get_active_story_list_stmt_.has_row()) {
-      BufferSlice data(get_active_story_list_stmt_.view_blob(0));
+      auto data = compressor_.decompress(get_active_story_list_stmt_.view_blob(0));
       result.next_dialog_id_ = DialogId(get_active_story_list_stmt_.view_int64(1));
       result.next_order_ = get_active_story_list_stmt_.view_int64(2);
       LOG(INFO) << "Load active stories in " << result.next_dialog_id_ << " with order " << result.next_order_;
@@ -318,6 +321,8 @@ class StoryDbImpl final : public StoryDbSyncInterface {
 
  private:
   SqliteDb db_;
+  const std::atomic<bool> *use_compression_;
+  SqliteBlobCompressor compressor_;
 
   SqliteStatement add_story_stmt_;
   SqliteStatement delete_story_stmt_;
@@ -340,7 +345,8 @@ std::shared_ptr<StoryDbSyncSafeInterface> create_story_db_sync(
    public:
     explicit StoryDbSyncSafe(std::shared_ptr<SqliteConnectionSafe> sqlite_connection)
         : lsls_db_([safe_connection = std::move(sqlite_connection)] {
-          return make_unique<StoryDbImpl>(safe_connection->get().clone());
+          return td::make_unique<StoryDbImpl>(safe_connection->get().clone(),
+                                              safe_connection->get_use_blob_compression_flag());
         }) {
     }
     StoryDbSyncInterface &get() final {
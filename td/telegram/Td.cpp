@@ -86,6 +86,7 @@
 #include "td/telegram/LinkManager.h"
 #include "td/telegram/Location.h"
 #include "td/telegram/Logging.h"
+#include "td/telegram/MemoryStatistics.h"
 #include "td/telegram/MessageCopyOptions.h"
 #include "td/telegram/MessageEntity.h"
 #include "td/telegram/MessageFullId.h"
@@ -116,6 +117,7 @@
 #include "td/telegram/NotificationManager.h"
 #include "td/telegram/NotificationObjectId.h"
 #include "td/telegram/NotificationSettingsManager.h"
+#include "td/telegram/ObjectSnapshotCache.h"
 #include "td/telegram/NotificationSettingsScope.h"
 #include "td/telegram/OptionManager.h"
 #include "td/telegram/PasswordManager.h"
@@ -200,6 +202,7 @@
 #include "td/utils/SliceBuilder.h"
 #include "td/utils/Status.h"
 #include "td/utils/Timer.h"
+#include "td/utils/TlObjectArena.h"
 #include "td/utils/utf8.h"
 
 #include <limits>
@@ -2659,6 +2662,13 @@ bool Td::ignore_background_updates() const {
   return can_ignore_background_updates_ && option_manager_->get_option_boolean("ignore_background_updates");
 }
 
+void Td::update_use_fast_getters() {
+  if (td_options_.object_snapshot_cache != nullptr) {
+    td_options_.object_snapshot_cache->set_is_enabled(close_flag_ == 0 &&
+                                                      option_manager_->get_option_boolean("use_fast_getters"));
+  }
+}
+
 bool Td::is_authentication_request(int32 id) {
   switch (id) {
     case td_api::setTdlibParameters::ID:
@@ -2764,6 +2774,7 @@ bool Td::is_preauthentication_request(int32 id) {
     case td_api::getStorageStatistics::ID:
     case td_api::getStorageStatisticsFast::ID:
     case td_api::getDatabaseStatistics::ID:
+    case td_api::getMemoryStatistics::ID:
     case td_api::setNetworkType::ID:
     case td_api::getNetworkStatistics::ID:
     case td_api::addNetworkStatistics::ID:
@@ -2839,6 +2850,9 @@ void Td::request(uint64 id, tl_object_ptr<td_api::Function> function) {
 
   VLOG(td_requests) << "Receive request " << id << ": " << to_string(function);
   request_set_.emplace(id, function->get_id());
+  if (td_options_.object_snapshot_cache != nullptr) {
+    td_options_.object_snapshot_cache->on_request(id, *function);
+  }
   if (is_synchronous_request(function.get())) {
     // send response synchronously
     return send_result(id, static_request(std::move(function)));
@@ -3374,6 +3388,7 @@ void Td::close_impl(bool destroy_flag) {
   state_ = State::Close;
   close_flag_ = 1;
   G()->set_close_flag();
+  update_use_fast_getters();
   send_closure(auth_manager_actor_, &AuthManager::on_closing, destroy_flag);
   updates_manager_->timeout_expired();  // save PTS and QTS
 
@@ -3666,6 +3681,9 @@ void Td::init_options_and_network() {
   VLOG(td_init) << "Create OptionManager";
   option_manager_ = make_unique<OptionManager>(this);
   G()->set_option_manager(option_manager_.get());
+  update_use_fast_getters();
+  G()->set_use_tl_object_arena(option_manager_->get_option_boolean("use_tl_object_arena"));
+  G()->td_db()->set_use_database_compression(option_manager_->get_option_boolean("use_database_compression"));
 
   VLOG(td_init) << "Create ConnectionCreator";
   G()->set_connection_creator(create_actor<ConnectionCreator>("ConnectionCreator", create_reference()));
@@ -3965,7 +3983,14 @@ void Td::send_update(tl_object_ptr<td_api::Update> &&object) {
       VLOG(td_requests) << "Sending update: " << to_string(object);
   }
 
+  auto *object_snapshot_cache = td_options_.object_snapshot_cache.get();
+  if (object_snapshot_cache != nullptr) {
+    object_snapshot_cache->on_update(*object);
+  }
   callback_->on_result(0, std::move(object));
+  if (object_snapshot_cache != nullptr) {
+    object_snapshot_cache->on_object_sent();
+  }
 }
 
 void Td::send_result(uint64 id, tl_object_ptr<td_api::Object> object) {
@@ -3981,7 +4006,14 @@ void Td::send_result(uint64 id, tl_object_ptr<td_api::Object> object) {
     }
     VLOG(td_requests) << "Sending result for request " << id << ": " << to_string(object);
     request_set_.erase(it);
+    auto *object_snapshot_cache = td_options_.object_snapshot_cache.get();
+    if (object_snapshot_cache != nullptr) {
+      object_snapshot_cache->on_result(id, *object);
+    }
     callback_->on_result(id, std::move(object));
+    if (object_snapshot_cache != nullptr) {
+      object_snapshot_cache->on_object_sent();
+    }
   }
 }
 
@@ -3995,6 +4027,9 @@ void Td::send_error_impl(uint64 id, tl_object_ptr<td_api::error> error) {
     }
     VLOG(td_requests) << "Sending error for request " << id << ": " << oneline(to_string(error));
     request_set_.erase(it);
+    if (td_options_.object_snapshot_cache != nullptr) {
+      td_options_.object_snapshot_cache->on_error(id);
+    }
     callback_->on_error(id, std::move(error));
   }
 }
@@ -4840,6 +4875,18 @@ void Td::on_request(uint64 id, td_api::getDatabaseStatistics &request) {
   send_closure(storage_manager_, &StorageManager::get_database_stats, std::move(query_promise));
 }
 
+void Td::on_request(uint64 id, const td_api::getMemoryStatistics &request) {
+  MemoryStatistics statistics;
+  user_manager_->get_memory_statistics(statistics);
+  chat_manager_->get_memory_statistics(statistics);
+  messages_manager_->get_memory_statistics(statistics);
+  stickers_manager_->get_memory_statistics(statistics);
+  file_manager_->get_memory_statistics(statistics);
+  auto arena_stats = TlObjectArena::get_stats();
+  statistics.add("tl_object_arena_chunks", arena_stats.chunk_count, arena_stats.chunk_memory_size);
+  send_result(id, statistics.get_memory_statistics_object());
+}
+
 void Td::on_request(uint64 id, td_api::optimizeStorage &request) {
   std::vector<FileType> file_types;
   for (auto &file_type : request.file_types_) {
@@ -7331,7 +7378,8 @@ void Td::on_request(uint64 id, const td_api::downloadFile &request) {
     CREATE_REQUEST_PROMISE();
     download_promise = std::move(promise);
   }
-  file_manager_->download(file_id, download_file_callback_, priority, offset, limit, std::move(download_promise));
+  file_manager_->download(file_id, download_file_callback_, priority, offset, limit, request.use_read_ahead_,
+                          std::move(download_promise));
 }
 
 void Td::on_file_download_finished(FileId file_id) {
@@ -7376,7 +7424,7 @@ void Td::on_request(uint64 id, const td_api::getFileDownloadedPrefixSize &reques
 
 void Td::on_request(uint64 id, const td_api::cancelDownloadFile &request) {
   file_manager_->download(FileId(request.file_id_, 0), nullptr, request.only_if_pending_ ? -1 : 0,
-                          FileManager::KEEP_DOWNLOAD_OFFSET, FileManager::KEEP_DOWNLOAD_LIMIT,
+                          FileManager::KEEP_DOWNLOAD_OFFSET, FileManager::KEEP_DOWNLOAD_LIMIT, false,
                           Promise<td_api::object_ptr<td_api::file>>());
   send_closure(actor_id(this), &Td::send_result, id, make_tl_object<td_api::ok>());
 }
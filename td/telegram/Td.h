@@ -77,6 +77,7 @@ class MessagesManager;
 class NetStatsManager;
 class NotificationManager;
 class NotificationSettingsManager;
+class ObjectSnapshotCache;
 class OptionManager;
 class PasswordManager;
 class PeopleNearbyManager;
@@ -128,6 +129,7 @@ class Td final : public Actor {
 
   struct Options {
     std::shared_ptr<NetQueryStats> net_query_stats;
+    std::shared_ptr<ObjectSnapshotCache> object_snapshot_cache;
   };
 
   Td(unique_ptr<TdCallback> callback, Options options);
@@ -160,6 +162,8 @@ class Td final : public Actor {
 
   bool ignore_background_updates() const;
 
+  void update_use_fast_getters();
+
   unique_ptr<AudiosManager> audios_manager_;
   unique_ptr<CallbackQueriesManager> callback_queries_manager_;
   unique_ptr<DocumentsManager> documents_manager_;
@@ -669,6 +673,8 @@ class Td final : public Actor {
 
   void on_request(uint64 id, td_api::getDatabaseStatistics &request);
 
+  void on_request(uint64 id, const td_api::getMemoryStatistics &request);
+
   void on_request(uint64 id, td_api::optimizeStorage &request);
 
   void on_request(uint64 id, td_api::getNetworkStatistics &request);
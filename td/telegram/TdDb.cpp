@@ -20,11 +20,15 @@
 #include "td/db/binlog/Binlog.h"
 #include "td/db/binlog/ConcurrentBinlog.h"
 #include "td/db/BinlogKeyValue.h"
+#include "td/db/DbTrace.h"
+#include "td/db/SqliteBlobCompressor.h"
 #include "td/db/SqliteConnectionSafe.h"
 #include "td/db/SqliteDb.h"
 #include "td/db/SqliteKeyValue.h"
 #include "td/db/SqliteKeyValueAsync.h"
+#include "td/db/SqliteKeyValueFilter.h"
 #include "td/db/SqliteKeyValueSafe.h"
+#include "td/db/SqliteWalCheckpointer.h"
 
 #include "td/actor/actor.h"
 #include "td/actor/MultiPromise.h"
@@ -39,6 +43,7 @@
 #include "td/utils/Random.h"
 #include "td/utils/SliceBuilder.h"
 #include "td/utils/StringBuilder.h"
+#include "td/utils/Time.h"
 
 #include <algorithm>
 
@@ -46,6 +51,20 @@ namespace td {
 
 namespace {
 
+// default memory budget of the SQLite page cache of each connection; can be changed with the option
+// "database_cache_size_max"; memory-mapped I/O is limited to 8 times the budget
+constexpr int64 SQLITE_MIN_CACHE_SIZE = 2 << 20;
+constexpr int64 SQLITE_DEFAULT_MAX_CACHE_SIZE = 32 << 20;
+
+int64 get_sqlite_max_cache_size(BinlogKeyValue<Binlog> &config_pmc) {
+  // options are stored with a type prefix
+  auto value = config_pmc.get("database_cache_size_max");
+  if (value.size() < 2 || value[0] != 'I') {
+    return SQLITE_DEFAULT_MAX_CACHE_SIZE;
+  }
+  return to_integer<int64>(Slice(value).substr(1));
+}
+
 std::string get_binlog_path(const TdDb::Parameters &parameters) {
   return PSTRING() << parameters.database_directory_ << "td" << (parameters.is_test_dc_ ? "_test" : "") << ".binlog";
 }
@@ -189,6 +208,12 @@ std::shared_ptr<SqliteConnectionSafe> &TdDb::get_sqlite_connection_safe() {
   return sql_connection_;
 }
 
+void TdDb::set_use_database_compression(bool use_database_compression) {
+  if (sql_connection_ != nullptr) {
+    sql_connection_->set_use_blob_compression(use_database_compression);
+  }
+}
+
 BinlogInterface *TdDb::get_binlog_impl(const char *file, int line) {
   LOG_CHECK(binlog_) << G()->close_flag() << " " << file << " " << line;
   return binlog_.get();
@@ -333,6 +358,11 @@ void TdDb::do_close(bool destroy_flag, Promise<Unit> on_finished) {
     story_db_async_->close(mpas.get_promise());
   }
 
+  if (wal_checkpointer_) {
+    wal_checkpointer_->close(mpas.get_promise());
+    wal_checkpointer_.reset();
+  }
+
   // binlog_pmc is dependent on binlog_ and anyway it doesn't support close_and_destroy
   CHECK(binlog_pmc_.unique());
   binlog_pmc_.reset();
@@ -352,7 +382,7 @@ void TdDb::do_close(bool destroy_flag, Promise<Unit> on_finished) {
 }
 
 Status TdDb::init_sqlite(const Parameters &parameters, const DbKey &key, const DbKey &old_key,
-                         BinlogKeyValue<Binlog> &binlog_pmc) {
+                         BinlogKeyValue<Binlog> &binlog_pmc, int64 max_cache_size) {
   CHECK(!parameters.use_message_database_ || parameters.use_chat_info_database_);
   CHECK(!parameters.use_chat_info_database_ || parameters.use_file_database_);
 
@@ -373,11 +403,30 @@ Status TdDb::init_sqlite(const Parameters &parameters, const DbKey &key, const D
   }
 
   TRY_RESULT(db_instance, SqliteDb::change_key(sql_database_path, true, key, old_key));
-  sql_connection_ = std::make_shared<SqliteConnectionSafe>(sql_database_path, key, db_instance.get_cipher_version());
+
+  SqliteConnectionSettings settings;
+  // checkpoints are run by wal_checkpointer_ instead of the writers, so commits don't wait for them
+  settings.disable_auto_checkpoint = true;
+  settings.journal_size_limit = SqliteWalCheckpointer::WAL_SIZE_LIMIT;
+  settings.trace = trace_;
+  // the page cache and memory-mapped I/O grow with the database, but stay within the memory budget;
+  // the budget is used by the writer and readers, while wal_checkpointer_ uses only a small page cache
+  auto r_stat = stat(sql_database_path);
+  auto database_size = r_stat.is_ok() ? r_stat.ok().size_ : 0;
+  max_cache_size = max(max_cache_size, SQLITE_MIN_CACHE_SIZE);
+  settings.cache_size = clamp(database_size / 8, SQLITE_MIN_CACHE_SIZE, max_cache_size);
+  // SQLCipher doesn't use memory-mapped I/O for encrypted databases
+  settings.mmap_size = key.is_empty() ? min(database_size, max_cache_size * 8) : 0;
+  sqlite_cache_size_ = settings.cache_size;
+  sqlite_mmap_size_ = settings.mmap_size;
+
+  sql_connection_ =
+      std::make_shared<SqliteConnectionSafe>(sql_database_path, key, db_instance.get_cipher_version(), settings);
   sql_connection_->set(std::move(db_instance));
   auto &db = sql_connection_->get();
   TRY_STATUS(db.exec("PRAGMA journal_mode=WAL"));
   TRY_STATUS(db.exec("PRAGMA secure_delete=1"));
+  TRY_STATUS(SqliteConnectionSafe::init_connection(db, settings));
 
   // Init databases
   // Do initialization once and before everything else to avoid "database is locked" error.
@@ -390,6 +439,12 @@ Status TdDb::init_sqlite(const Parameters &parameters, const DbKey &key, const D
   TRY_RESULT(user_version, db.user_version());
   LOG(INFO) << "Have PRAGMA user_version = " << user_version;
 
+  // init dictionaries for compressed blobs, which are shared by all databases;
+  // previous versions can't read compressed blobs, so they drop chat, message and story databases of newer versions
+  if (user_version < static_cast<int32>(DbVersion::AddBlobCompression)) {
+    TRY_STATUS(SqliteBlobCompressor::init_db(db));
+  }
+
   // init DialogDb
   if (use_dialog_db) {
     TRY_STATUS(init_dialog_db(db, user_version, binlog_pmc, was_dialog_db_created_));
@@ -469,9 +524,21 @@ Status TdDb::init_sqlite(const Parameters &parameters, const DbKey &key, const D
     sqlite_pmc->erase_by_prefix("channel_recommendations");
   }
 
+  // heavy read-only queries are run on a dedicated scheduler if there is one; its thread is started only if
+  // a database, which uses it, is enabled
+  vector<int32> read_scheduler_ids;
+  auto read_scheduler_id = G()->get_database_read_scheduler_id();
+  if ((use_dialog_db || use_message_database) && read_scheduler_id != -1 &&
+      read_scheduler_id != Scheduler::instance()->sched_id() && read_scheduler_id != G()->get_database_scheduler_id() &&
+      Scheduler::instance()->start_on_demand_scheduler(read_scheduler_id)) {
+    read_scheduler_ids.push_back(read_scheduler_id);
+  }
+
+  wal_checkpointer_ = td::make_unique<SqliteWalCheckpointer>(sql_connection_, G()->get_gc_scheduler_id());
+
   if (use_dialog_db) {
     dialog_db_sync_safe_ = create_dialog_db_sync(sql_connection_);
-    dialog_db_async_ = create_dialog_db_async(dialog_db_sync_safe_);
+    dialog_db_async_ = create_dialog_db_async(dialog_db_sync_safe_, -1, sql_connection_, read_scheduler_ids);
   }
 
   if (use_message_thread_db) {
@@ -481,7 +548,7 @@ Status TdDb::init_sqlite(const Parameters &parameters, const DbKey &key, const D
 
   if (use_message_database) {
     message_db_sync_safe_ = create_message_db_sync(sql_connection_);
-    message_db_async_ = create_message_db_async(message_db_sync_safe_);
+    message_db_async_ = create_message_db_async(message_db_sync_safe_, -1, sql_connection_, std::move(read_scheduler_ids));
   }
 
   if (use_story_database) {
@@ -507,6 +574,8 @@ void TdDb::open_impl(Parameters parameters, Promise<OpenedDatabase> &&promise) {
   // Init pmc
   Binlog *binlog_ptr = nullptr;
   auto binlog = std::shared_ptr<Binlog>(new Binlog, [&](Binlog *ptr) { binlog_ptr = ptr; });
+  auto trace = std::make_shared<DbTrace>();
+  binlog->set_trace(trace);
 
   auto binlog_pmc = make_unique<BinlogKeyValue<Binlog>>();
   auto config_pmc = make_unique<BinlogKeyValue<Binlog>>();
@@ -551,8 +620,11 @@ void TdDb::open_impl(Parameters parameters, Promise<OpenedDatabase> &&promise) {
     }
   }
   VLOG(td_init) << "Start to init database";
+  auto max_sqlite_cache_size = get_sqlite_max_cache_size(*config_pmc);
   auto db = make_unique<TdDb>();
-  auto init_sqlite_status = db->init_sqlite(parameters, new_sqlite_key, old_sqlite_key, *binlog_pmc);
+  db->trace_ = std::move(trace);
+  auto init_sqlite_status =
+      db->init_sqlite(parameters, new_sqlite_key, old_sqlite_key, *binlog_pmc, max_sqlite_cache_size);
   VLOG(td_init) << "Finish to init database";
   if (init_sqlite_status.is_error()) {
     LOG(ERROR) << "Destroy bad SQLite database because of " << init_sqlite_status;
@@ -560,7 +632,8 @@ void TdDb::open_impl(Parameters parameters, Promise<OpenedDatabase> &&promise) {
       db->sql_connection_->get().close();
     }
     SqliteDb::destroy(get_sqlite_path(parameters)).ignore();
-    init_sqlite_status = db->init_sqlite(parameters, new_sqlite_key, old_sqlite_key, *binlog_pmc);
+    init_sqlite_status =
+        db->init_sqlite(parameters, new_sqlite_key, old_sqlite_key, *binlog_pmc, max_sqlite_cache_size);
     if (init_sqlite_status.is_error()) {
       return promise.set_error(Status::Error(400, init_sqlite_status.message()));
     }
@@ -751,9 +824,75 @@ Result<string> TdDb::get_stats() {
   }
   sb << "Max file database depth out of " << prev.size() << '/' << count
      << " elements: " << *std::max_element(prev.begin(), prev.end()) << "\n";
-  sb << "Have " << bad_count << " forward references with maximum reference to " << max_bad_to;
+  sb << "Have " << bad_count << " forward references with maximum reference to " << max_bad_to << "\n";
+
+  auto print_filter_stats = [&](Slice table, const SqliteKeyValueFilter::Stats &stats) {
+    sb << "Key filter of " << table << ": " << stats.key_count << " keys in " << format::as_size(stats.bit_count / 8)
+       << ", lookups: " << stats.lookup_count << ", skipped lookups: " << stats.skipped_lookup_count
+       << ", false positives: " << stats.false_positive_count << ", rebuilds: " << stats.rebuild_count << "\n";
+  };
+  print_filter_stats("common", get_sqlite_sync_pmc()->get_filter_stats());
+  print_filter_stats("files", file_db_->pmc().get_filter_stats());
+
+  sb << "SQLite cache size: " << format::as_size(sqlite_cache_size_)
+     << ", mmap size: " << format::as_size(sqlite_mmap_size_) << "\n";
+  if (wal_checkpointer_ != nullptr) {
+    auto stats = wal_checkpointer_->get_stats();
+    sb << "WAL size: " << format::as_size(stats.wal_size) << ", checkpoints: " << stats.checkpoint_count
+       << ", restart checkpoints: " << stats.restart_checkpoint_count
+       << ", busy checkpoints: " << stats.busy_checkpoint_count
+       << ", last checkpoint time: " << format::as_time(stats.last_checkpoint_duration)
+       << ", max checkpoint time: " << format::as_time(stats.max_checkpoint_duration)
+       << ", total checkpoint time: " << format::as_time(stats.total_checkpoint_duration);
+  }
 
   return sb.as_cslice().str();
 }
 
+Status TdDb::set_trace_path(CSlice path) {
+  CHECK(trace_ != nullptr);
+  if (path.empty()) {
+    trace_->stop();
+    return Status::OK();
+  }
+
+  // the trace begins with the database schema, so it can be replayed against an empty database
+  vector<string> queries;
+  if (sql_connection_ != nullptr) {
+    queries.push_back("PRAGMA journal_mode=WAL");
+    queries.push_back("PRAGMA secure_delete=1");
+
+    auto &db = sql_connection_->get();
+    TRY_RESULT(stmt, db.get_statement("SELECT name, sql FROM sqlite_master WHERE sql IS NOT NULL ORDER BY rowid"));
+    vector<string> virtual_table_names;
+    TRY_STATUS(stmt.step());
+    while (stmt.has_row()) {
+      auto name = stmt.view_string(0).str();
+      auto query = stmt.view_string(1).str();
+      bool is_shadow_table = any_of(virtual_table_names, [&name](const string &virtual_table_name) {
+        return begins_with(name, virtual_table_name + '_');
+      });
+      if (!is_shadow_table) {
+        if (begins_with(query, "CREATE VIRTUAL TABLE")) {
+          virtual_table_names.push_back(std::move(name));
+        }
+        queries.push_back(std::move(query));
+      }
+      TRY_STATUS(stmt.step());
+    }
+  }
+
+  TRY_STATUS(trace_->start(path));
+  auto connection_id = trace_->add_connection();
+  for (auto &query : queries) {
+    DbTraceEvent event;
+    event.type = DbTraceEvent::Type::Exec;
+    event.time = Time::now();
+    event.connection_id = connection_id;
+    event.query = std::move(query);
+    trace_->add_event(std::move(event));
+  }
+  return Status::OK();
+}
+
 }  // namespace td
@@ -25,6 +25,7 @@ class Binlog;
 template <class BinlogT>
 class BinlogKeyValue;
 class ConcurrentBinlog;
+class DbTrace;
 class DialogDbSyncInterface;
 class DialogDbSyncSafeInterface;
 class DialogDbAsyncInterface;
@@ -39,6 +40,7 @@ class SqliteConnectionSafe;
 class SqliteKeyValueSafe;
 class SqliteKeyValueAsyncInterface;
 class SqliteKeyValue;
+class SqliteWalCheckpointer;
 class StoryDbSyncInterface;
 class StoryDbSyncSafeInterface;
 class StoryDbAsyncInterface;
@@ -119,6 +121,9 @@ class TdDb {
 
   std::shared_ptr<FileDbInterface> get_file_db_shared();
   std::shared_ptr<SqliteConnectionSafe> &get_sqlite_connection_safe();
+
+  void set_use_database_compression(bool use_database_compression);
+
 #define get_binlog() get_binlog_impl(__FILE__, __LINE__)
   BinlogInterface *get_binlog_impl(const char *file, int line);
 
@@ -154,12 +159,21 @@ class TdDb {
 
   Result<string> get_stats();
 
+  // starts recording of operations with the databases to the file; stops recording if the path is empty
+  Status set_trace_path(CSlice path);
+
  private:
   Parameters parameters_;
 
   bool was_dialog_db_created_ = false;
 
   std::shared_ptr<SqliteConnectionSafe> sql_connection_;
+  unique_ptr<SqliteWalCheckpointer> wal_checkpointer_;
+  int64 sqlite_cache_size_ = 0;
+  int64 sqlite_mmap_size_ = 0;
+
+  // shared by the binlog and all SQLite connections of the instance
+  std::shared_ptr<DbTrace> trace_;
 
   std::shared_ptr<FileDbInterface> file_db_;
 
@@ -187,7 +201,7 @@ class TdDb {
   static Status check_parameters(Parameters &parameters);
 
   Status init_sqlite(const Parameters &parameters, const DbKey &key, const DbKey &old_key,
-                     BinlogKeyValue<Binlog> &binlog_pmc);
+                     BinlogKeyValue<Binlog> &binlog_pmc, int64 max_cache_size);
 
   void do_close(bool destroy_flag, Promise<Unit> on_finished);
 };
@@ -37,6 +37,7 @@
 #include "td/telegram/LinkManager.h"
 #include "td/telegram/logevent/LogEvent.h"
 #include "td/telegram/logevent/LogEventHelper.h"
+#include "td/telegram/MemoryStatistics.h"
 #include "td/telegram/MessageId.h"
 #include "td/telegram/MessagesManager.h"
 #include "td/telegram/MessageTtl.h"
@@ -2048,6 +2049,25 @@ UserManager::~UserManager() {
                                               resolved_phone_numbers_, all_imported_contacts_, restricted_user_ids_);
 }
 
+void UserManager::start_up() {
+  if (G()->use_chat_info_database()) {
+    set_timeout_in(COLD_OBJECT_EVICTION_PERIOD);
+  }
+}
+
+void UserManager::timeout_expired() {
+  if (G()->close_flag()) {
+    return;
+  }
+
+  auto max_count = td_->option_manager_->get_option_integer("chat_info_cache_size");
+  if (max_count > 0) {
+    evict_cold_user_fulls(static_cast<size_t>(max_count));
+    evict_cold_users(static_cast<size_t>(max_count));
+  }
+  set_timeout_in(COLD_OBJECT_EVICTION_PERIOD);
+}
+
 void UserManager::tear_down() {
   parent_.reset();
 
@@ -3573,26 +3593,135 @@ bool UserManager::have_user(UserId user_id) const {
 }
 
 bool UserManager::have_min_user(UserId user_id) const {
-  return users_.count(user_id) > 0;
+  return users_.count(user_id) > 0 || user_evictor_.is_evicted(user_id);
 }
 
 const UserManager::User *UserManager::get_user(UserId user_id) const {
-  return users_.get_pointer(user_id);
+  auto u = users_.get_pointer(user_id);
+  if (u == nullptr) {
+    return get_evicted_user(user_id);
+  }
+  u->was_accessed = true;
+  return u;
 }
 
 UserManager::User *UserManager::get_user(UserId user_id) {
-  return users_.get_pointer(user_id);
+  auto u = users_.get_pointer(user_id);
+  if (u == nullptr) {
+    return get_evicted_user(user_id);
+  }
+  u->was_accessed = true;
+  return u;
 }
 
 UserManager::User *UserManager::add_user(UserId user_id) {
   CHECK(user_id.is_valid());
   auto &user_ptr = users_[user_id];
   if (user_ptr == nullptr) {
-    user_ptr = make_unique<User>();
+    user_ptr = user_evictor_.take_object(user_id);
+    if (user_ptr == nullptr) {
+      user_ptr = make_unique<User>();
+    } else {
+      loaded_from_database_users_.insert(user_id);
+    }
   }
   return user_ptr.get();
 }
 
+UserManager::User *UserManager::get_evicted_user(UserId user_id) const {
+  if (!user_evictor_.is_evicted(user_id)) {
+    return nullptr;
+  }
+
+  return user_evictor_.get_evicted_object(user_id, [&] {
+    if (!user_evictor_.has_restored_objects()) {
+      send_closure_later(G()->user_manager(), &UserManager::return_restored_users);
+    }
+    LOG(INFO) << "Load evicted " << user_id << " from database";
+    return parse_evicted_user(user_id, G()->td_db()->get_sqlite_sync_pmc()->get(get_user_database_key(user_id)));
+  });
+}
+
+unique_ptr<UserManager::User> UserManager::parse_evicted_user(UserId user_id, const string &value) const {
+  auto user = make_unique<User>();
+  if (value.empty() || log_event_parse(*user, value).is_error()) {
+    LOG(ERROR) << "Failed to load evicted " << user_id << " from database";
+    return nullptr;
+  }
+
+  // the user was saved to the database before eviction, and the client already has the same version of the user,
+  // so there is no need to send updates about it or to save it again
+  auto u = user.get();
+  u->last_sent_emoji_status = u->emoji_status.get_effective_emoji_status(u->is_premium, G()->unix_time());
+  u->is_name_changed = false;
+  u->is_username_changed = false;
+  u->is_photo_changed = false;
+  u->is_accent_color_changed = false;
+  u->is_phone_number_changed = false;
+  u->is_emoji_status_changed = false;
+  u->is_is_contact_changed = false;
+  u->is_is_mutual_contact_changed = false;
+  u->is_is_deleted_changed = false;
+  u->is_is_premium_changed = false;
+  u->is_stories_hidden_changed = false;
+  u->is_changed = false;
+  u->need_save_to_database = false;
+  u->is_status_changed = false;
+  u->is_online_status_changed = false;
+  u->is_update_user_sent = true;
+  u->is_saved = true;
+  u->is_status_saved = true;
+  return user;
+}
+
+void UserManager::return_evicted_user(UserId user_id, unique_ptr<User> user) {
+  CHECK(!user_evictor_.is_evicted(user_id));
+  if (user == nullptr) {
+    return;
+  }
+  CHECK(users_.get_pointer(user_id) == nullptr);
+  users_.set(user_id, std::move(user));
+  loaded_from_database_users_.insert(user_id);
+}
+
+void UserManager::return_restored_users() {
+  for (auto user_id : user_evictor_.get_restored_object_keys()) {
+    return_evicted_user(user_id, user_evictor_.take_object(user_id));
+  }
+}
+
+bool UserManager::can_evict_user(UserId user_id, const User *u) const {
+  if (!(u->is_received && u->is_saved && u->is_status_saved && !u->is_being_saved && !u->is_being_updated &&
+        !u->is_changed && !u->need_save_to_database && !u->is_status_changed && u->is_update_user_sent &&
+        u->log_event_id == 0 && !u->is_contact && user_id != get_my_id() && users_full_.count(user_id) == 0 &&
+        secret_chats_with_user_.count(user_id) == 0 && load_user_from_database_queries_.count(user_id) == 0)) {
+    return false;
+  }
+  auto user_photos = user_photos_.get_pointer(user_id);
+  return user_photos == nullptr || user_photos->pending_requests.empty();
+}
+
+void UserManager::evict_cold_users(size_t max_count) {
+  auto user_count = users_.calc_size();
+  if (user_count <= max_count) {
+    return;
+  }
+
+  // evict a bit more users than needed to avoid eviction during each pass
+  auto evict_count = user_count - max_count / 10 * 9;
+  auto user_ids = user_evictor_.get_cold_objects(
+      users_, evict_count, [&](UserId user_id, const User *u) { return can_evict_user(user_id, u); });
+
+  LOG(INFO) << "Evict " << user_ids.size() << " cold users out of " << user_count;
+  for (auto user_id : user_ids) {
+    users_.erase(user_id);
+    loaded_from_database_users_.erase(user_id);
+    // the list of profile photos will be received again from the server if needed
+    user_photos_.erase(user_id);
+    user_evictor_.on_object_evicted(user_id);
+  }
+}
+
 void UserManager::save_user(User *u, UserId user_id, bool from_binlog) {
   if (!G()->use_chat_info_database()) {
     return;
@@ -3700,10 +3829,33 @@ void UserManager::load_user_from_database_impl(UserId user_id, Promise<Unit> pro
   auto &load_user_queries = load_user_from_database_queries_[user_id];
   load_user_queries.push_back(std::move(promise));
   if (load_user_queries.size() == 1u) {
-    G()->td_db()->get_sqlite_pmc()->get(get_user_database_key(user_id), PromiseCreator::lambda([user_id](string value) {
-                                          send_closure(G()->user_manager(), &UserManager::on_load_user_from_database,
-                                                       user_id, std::move(value), false);
-                                        }));
+    // users requested during the same event are loaded by a single database query
+    pending_load_user_ids_.push_back(user_id);
+    if (pending_load_user_ids_.size() == 1u) {
+      send_closure_later(actor_id(this), &UserManager::load_pending_users_from_database);
+    }
+  }
+}
+
+void UserManager::load_pending_users_from_database() {
+  auto user_ids = std::move(pending_load_user_ids_);
+  pending_load_user_ids_.clear();
+  if (user_ids.empty()) {
+    return;
+  }
+  LOG(INFO) << "Load " << user_ids.size() << " users from database";
+  auto keys = transform(user_ids, get_user_database_key);
+  G()->td_db()->get_sqlite_pmc()->get_many(
+      std::move(keys), PromiseCreator::lambda([user_ids = std::move(user_ids)](vector<string> values) mutable {
+        send_closure(G()->user_manager(), &UserManager::on_load_users_from_database, std::move(user_ids),
+                     std::move(values));
+      }));
+}
+
+void UserManager::on_load_users_from_database(vector<UserId> user_ids, vector<string> values) {
+  CHECK(user_ids.size() == values.size());
+  for (size_t i = 0; i < user_ids.size(); i++) {
+    on_load_user_from_database(user_ids[i], std::move(values[i]), false);
   }
 }
 
@@ -3730,6 +3882,16 @@ void UserManager::on_load_user_from_database(UserId user_id, string value, bool
   //  G()->td_db()->get_sqlite_pmc()->erase(get_user_database_key(user_id), Auto());
   //  return;
 
+  if (user_evictor_.is_evicted(user_id)) {
+    auto user = user_evictor_.take_object(user_id);
+    if (user == nullptr) {
+      user = parse_evicted_user(user_id, value);
+    }
+    return_evicted_user(user_id, std::move(user));
+    set_promises(promises);
+    return;
+  }
+
   User *u = get_user(user_id);
   if (u == nullptr) {
     if (!value.empty()) {
@@ -3759,6 +3921,23 @@ void UserManager::on_load_user_from_database(UserId user_id, string value, bool
   set_promises(promises);
 }
 
+void UserManager::load_users_from_database(const vector<UserId> &user_ids, Promise<Unit> &&promise) {
+  if (!G()->use_chat_info_database()) {
+    return promise.set_value(Unit());
+  }
+
+  MultiPromiseActorSafe mpas{"LoadUsersFromDatabaseMultiPromiseActor"};
+  mpas.add_promise(std::move(promise));
+  auto lock = mpas.get_promise();
+  for (auto user_id : user_ids) {
+    // evicted users are loaded back together with unknown users
+    if (user_id.is_valid() && users_.count(user_id) == 0) {
+      load_user_from_database(nullptr, user_id, mpas.get_promise());
+    }
+  }
+  lock.set_value(Unit());
+}
+
 bool UserManager::have_user_force(UserId user_id, const char *source) {
   return get_user_force(user_id, source) != nullptr;
 }
@@ -6691,11 +6870,19 @@ void UserManager::on_resolved_phone_number(const string &phone_number, UserId us
 }
 
 const UserManager::UserFull *UserManager::get_user_full(UserId user_id) const {
-  return users_full_.get_pointer(user_id);
+  auto user_full = users_full_.get_pointer(user_id);
+  if (user_full != nullptr) {
+    user_full->was_accessed = true;
+  }
+  return user_full;
 }
 
 UserManager::UserFull *UserManager::get_user_full(UserId user_id) {
-  return users_full_.get_pointer(user_id);
+  auto user_full = users_full_.get_pointer(user_id);
+  if (user_full != nullptr) {
+    user_full->was_accessed = true;
+  }
+  return user_full;
 }
 
 UserManager::UserFull *UserManager::add_user_full(UserId user_id) {
@@ -6708,6 +6895,35 @@ UserManager::UserFull *UserManager::add_user_full(UserId user_id) {
   return user_full_ptr.get();
 }
 
+bool UserManager::can_evict_user_full(UserId user_id, const UserFull *user_full) const {
+  return !user_full->is_being_updated && !user_full->is_changed && !user_full->need_send_update &&
+         !user_full->need_save_to_database && user_full->is_update_user_full_sent && user_id != get_my_id();
+}
+
+void UserManager::evict_cold_user_fulls(size_t max_count) {
+  auto user_full_count = users_full_.calc_size();
+  if (user_full_count <= max_count) {
+    return;
+  }
+
+  auto evict_count = user_full_count - max_count / 10 * 9;
+  auto user_ids = user_full_evictor_.get_cold_objects(
+      users_full_, evict_count,
+      [&](UserId user_id, const UserFull *user_full) { return can_evict_user_full(user_id, user_full); });
+
+  LOG(INFO) << "Evict " << user_ids.size() << " cold full users out of " << user_full_count;
+  for (auto user_id : user_ids) {
+    auto user_full = users_full_.get_pointer(user_id);
+    if (user_full->file_source_id.is_valid()) {
+      // keep the file source for files, which were registered with it
+      user_full_file_source_ids_[user_id] = user_full->file_source_id;
+    }
+    users_full_.erase(user_id);
+    // the full user can be loaded back through get_user_full_force
+    unavailable_user_fulls_.erase(user_id);
+  }
+}
+
 UserManager::UserFull *UserManager::get_user_full_force(UserId user_id, const char *source) {
   if (!have_user_force(user_id, source)) {
     return nullptr;
@@ -7363,11 +7579,34 @@ void UserManager::load_secret_chat_from_database_impl(SecretChatId secret_chat_i
   auto &load_secret_chat_queries = load_secret_chat_from_database_queries_[secret_chat_id];
   load_secret_chat_queries.push_back(std::move(promise));
   if (load_secret_chat_queries.size() == 1u) {
-    G()->td_db()->get_sqlite_pmc()->get(
-        get_secret_chat_database_key(secret_chat_id), PromiseCreator::lambda([secret_chat_id](string value) {
-          send_closure(G()->user_manager(), &UserManager::on_load_secret_chat_from_database, secret_chat_id,
-                       std::move(value), false);
-        }));
+    // secret chats requested during the same event are loaded by a single database query
+    pending_load_secret_chat_ids_.push_back(secret_chat_id);
+    if (pending_load_secret_chat_ids_.size() == 1u) {
+      send_closure_later(actor_id(this), &UserManager::load_pending_secret_chats_from_database);
+    }
+  }
+}
+
+void UserManager::load_pending_secret_chats_from_database() {
+  auto secret_chat_ids = std::move(pending_load_secret_chat_ids_);
+  pending_load_secret_chat_ids_.clear();
+  if (secret_chat_ids.empty()) {
+    return;
+  }
+  LOG(INFO) << "Load " << secret_chat_ids.size() << " secret chats from database";
+  auto keys = transform(secret_chat_ids, get_secret_chat_database_key);
+  G()->td_db()->get_sqlite_pmc()->get_many(
+      std::move(keys),
+      PromiseCreator::lambda([secret_chat_ids = std::move(secret_chat_ids)](vector<string> values) mutable {
+        send_closure(G()->user_manager(), &UserManager::on_load_secret_chats_from_database, std::move(secret_chat_ids),
+                     std::move(values));
+      }));
+}
+
+void UserManager::on_load_secret_chats_from_database(vector<SecretChatId> secret_chat_ids, vector<string> values) {
+  CHECK(secret_chat_ids.size() == values.size());
+  for (size_t i = 0; i < secret_chat_ids.size(); i++) {
+    on_load_secret_chat_from_database(secret_chat_ids[i], std::move(values[i]), false);
   }
 }
 
@@ -8071,4 +8310,13 @@ void UserManager::get_current_state(vector<td_api::object_ptr<td_api::Update>> &
   }
 }
 
+void UserManager::get_memory_statistics(MemoryStatistics &statistics) const {
+  statistics.add("users", users_);
+  statistics.add("evicted_users", user_evictor_);
+  statistics.add("users_full", users_full_);
+  statistics.add("user_photos", user_photos_);
+  statistics.add("secret_chats", secret_chats_);
+  statistics.add("contacts_hints", contacts_hints_);
+}
+
 }  // namespace td
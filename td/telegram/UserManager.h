@@ -12,6 +12,7 @@
 #include "td/telegram/BotCommand.h"
 #include "td/telegram/BotMenuButton.h"
 #include "td/telegram/ChannelId.h"
+#include "td/telegram/ColdObjectEvictor.h"
 #include "td/telegram/Contact.h"
 #include "td/telegram/CustomEmojiId.h"
 #include "td/telegram/DialogId.h"
@@ -62,6 +63,7 @@ class BusinessGreetingMessage;
 class BusinessInfo;
 class BusinessIntro;
 class BusinessWorkHours;
+class MemoryStatistics;
 class Td;
 
 class UserManager final : public Actor {
@@ -184,6 +186,9 @@ class UserManager final : public Actor {
 
   void reload_user(UserId user_id, Promise<Unit> &&promise, const char *source);
 
+  // loads the users, which aren't in memory, from the database using a single query
+  void load_users_from_database(const vector<UserId> &user_ids, Promise<Unit> &&promise);
+
   Result<telegram_api::object_ptr<telegram_api::InputUser>> get_input_user(UserId user_id) const;
 
   telegram_api::object_ptr<telegram_api::InputUser> get_input_user_force(UserId user_id) const;
@@ -465,6 +470,8 @@ class UserManager final : public Actor {
 
   void get_current_state(vector<td_api::object_ptr<td_api::Update>> &updates) const;
 
+  void get_memory_statistics(MemoryStatistics &statistics) const;
+
  private:
   struct User {
     string first_name;
@@ -553,6 +560,8 @@ class UserManager final : public Actor {
 
     bool is_received_from_server = false;  // true, if the user was received from the server and not the database
 
+    mutable bool was_accessed = true;  // whether the user was accessed since the last eviction pass
+
     uint64 log_event_id = 0;
 
     template <class StorerT>
@@ -611,6 +620,8 @@ class UserManager final : public Actor {
     bool need_save_to_database = true;  // have new changes that need only to be saved to the database
     bool is_update_user_full_sent = false;
 
+    mutable bool was_accessed = true;  // whether the full user was accessed since the last eviction pass
+
     double expires_at = 0.0;
 
     bool is_expired() const {
@@ -677,6 +688,8 @@ class UserManager final : public Actor {
 
   static constexpr int32 MAX_ACTIVE_STORY_ID_RELOAD_TIME = 3600;  // some reasonable limit
 
+  static constexpr int32 COLD_OBJECT_EVICTION_PERIOD = 60;  // period of checks for cold users to remove from memory
+
   // the True fields aren't set for manually created telegram_api::user objects, therefore the flags must be used
   static constexpr int32 USER_FLAG_HAS_ACCESS_HASH = 1 << 0;
   static constexpr int32 USER_FLAG_HAS_FIRST_NAME = 1 << 1;
@@ -717,6 +730,10 @@ class UserManager final : public Actor {
   static constexpr int32 ACCOUNT_UPDATE_LAST_NAME = 1 << 1;
   static constexpr int32 ACCOUNT_UPDATE_ABOUT = 1 << 2;
 
+  void start_up() final;
+
+  void timeout_expired() final;
+
   void tear_down() final;
 
   static void on_user_online_timeout_callback(void *user_manager_ptr, int64 user_id_long);
@@ -751,12 +768,32 @@ class UserManager final : public Actor {
 
   void load_user_from_database_impl(UserId user_id, Promise<Unit> promise);
 
+  void load_pending_users_from_database();
+
+  void on_load_users_from_database(vector<UserId> user_ids, vector<string> values);
+
   void on_load_user_from_database(UserId user_id, string value, bool force);
 
   User *get_user_force(UserId user_id, const char *source);
 
   User *get_user_force_impl(UserId user_id, const char *source);
 
+  User *get_evicted_user(UserId user_id) const;
+
+  unique_ptr<User> parse_evicted_user(UserId user_id, const string &value) const;
+
+  void return_evicted_user(UserId user_id, unique_ptr<User> user);
+
+  void return_restored_users();
+
+  bool can_evict_user(UserId user_id, const User *u) const;
+
+  bool can_evict_user_full(UserId user_id, const UserFull *user_full) const;
+
+  void evict_cold_users(size_t max_count);
+
+  void evict_cold_user_fulls(size_t max_count);
+
   bool is_user_contact(const User *u, UserId user_id, bool is_mutual) const;
 
   static bool is_user_premium(const User *u);
@@ -961,6 +998,10 @@ class UserManager final : public Actor {
 
   void load_secret_chat_from_database_impl(SecretChatId secret_chat_id, Promise<Unit> promise);
 
+  void load_pending_secret_chats_from_database();
+
+  void on_load_secret_chats_from_database(vector<SecretChatId> secret_chat_ids, vector<string> values);
+
   void on_load_secret_chat_from_database(SecretChatId secret_chat_id, string value, bool force);
 
   void on_create_new_secret_chat(SecretChatId secret_chat_id, Promise<td_api::object_ptr<td_api::chat>> &&promise);
@@ -1026,10 +1067,14 @@ class UserManager final : public Actor {
   FlatHashMap<UserId, vector<SecretChatId>, UserIdHash> secret_chats_with_user_;
 
   FlatHashMap<UserId, vector<Promise<Unit>>, UserIdHash> load_user_from_database_queries_;
+  vector<UserId> pending_load_user_ids_;
   FlatHashSet<UserId, UserIdHash> loaded_from_database_users_;
   FlatHashSet<UserId, UserIdHash> unavailable_user_fulls_;
+  ColdObjectEvictor<UserId, User, UserIdHash> user_evictor_;
+  ColdObjectEvictor<UserId, UserFull, UserIdHash> user_full_evictor_;
 
   FlatHashMap<SecretChatId, vector<Promise<Unit>>, SecretChatIdHash> load_secret_chat_from_database_queries_;
+  vector<SecretChatId> pending_load_secret_chat_ids_;
   FlatHashSet<SecretChatId, SecretChatIdHash> loaded_from_database_secret_chats_;
 
   QueryMerger get_user_queries_{"GetUserMerger", 3, 50};
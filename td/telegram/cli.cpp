@@ -3471,6 +3471,8 @@ class CliClient final : public Actor {
       send_request(td_api::make_object<td_api::getStorageStatisticsFast>());
     } else if (op == "database") {
       send_request(td_api::make_object<td_api::getDatabaseStatistics>());
+    } else if (op == "memory") {
+      send_request(td_api::make_object<td_api::getMemoryStatistics>());
     } else if (op == "optimize_storage" || op == "optimize_storage_all") {
       string chat_ids;
       string exclude_chat_ids;
@@ -3878,7 +3880,7 @@ class CliClient final : public Actor {
       int32 max_file_id = file_id.file_id;
       int32 min_file_id = (op == "dff" ? 1 : max_file_id);
       for (int32 i = min_file_id; i <= max_file_id; i++) {
-        send_request(td_api::make_object<td_api::downloadFile>(i, priority, offset, limit, op == "dfs"));
+        send_request(td_api::make_object<td_api::downloadFile>(i, priority, offset, limit, false, op == "dfs"));
       }
     } else if (op == "cdf") {
       FileId file_id;
@@ -7131,7 +7133,7 @@ void main(int argc, char **argv) {
   }
 
   {
-    ConcurrentScheduler scheduler(3, 0);
+    ConcurrentScheduler scheduler(3, 0, 1);
 
     class CreateClient final : public Actor {
      public:
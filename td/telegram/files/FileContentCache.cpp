@@ -0,0 +1,184 @@
+//
+// Copyright Aliaksei Levin (levlam@telegram.org), Arseny Smirnov (arseny30@gmail.com) 2014-2024
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+#include "td/telegram/files/FileContentCache.h"
+
+#include "td/utils/filesystem.h"
+#include "td/utils/format.h"
+#include "td/utils/logging.h"
+#include "td/utils/misc.h"
+#include "td/utils/port/FileFd.h"
+#include "td/utils/port/Stat.h"
+
+namespace td {
+
+FileContentCache::FileContentCache(int64 max_size, int64 max_file_size)
+    : max_size_(max_size), max_file_size_(max_file_size) {
+  stats_.max_size = max_size;
+}
+
+FileContentCache::~FileContentCache() {
+  clear();
+}
+
+FileContentCache::Entry *FileContentCache::get_entry(CSlice path) {
+  auto it = entries_.find(path.str());
+  if (it == entries_.end()) {
+    stats_.miss_count++;
+    return nullptr;
+  }
+
+  auto *entry = it->second.get();
+  auto r_stat = stat(path);
+  if (r_stat.is_error() || !r_stat.ok().is_reg_ || r_stat.ok().mtime_nsec_ != entry->mtime_nsec_ ||
+      r_stat.ok().size_ != static_cast<int64>(entry->content_.size())) {
+    LOG(INFO) << "Cached file " << path << " was changed";
+    stats_.invalidate_count++;
+    stats_.miss_count++;
+    remove_entry(entry);
+    return nullptr;
+  }
+
+  stats_.hit_count++;
+  entry->remove();
+  lru_list_.put_back(entry);
+  return entry;
+}
+
+Result<BufferSlice> FileContentCache::load_file(CSlice path) {
+  TRY_RESULT(fd, FileFd::open(path, FileFd::Read));
+  TRY_RESULT(file_stat, fd.stat());
+  if (file_stat.size_ > max_file_size_ || file_stat.size_ == 0) {
+    fd.close();
+    return read_file(path);
+  }
+
+  BufferSlice content(narrow_cast<size_t>(file_stat.size_));
+  TRY_RESULT(read_size, fd.pread(content.as_mutable_slice(), 0));
+  fd.close();
+  if (read_size != content.size()) {
+    return Status::Error("Failed to read file");
+  }
+  add_entry(path.str(), content.clone(), file_stat.mtime_nsec_);
+  return std::move(content);
+}
+
+Result<BufferSlice> FileContentCache::get_content(CSlice path) {
+  auto *entry = get_entry(path);
+  if (entry != nullptr) {
+    return entry->content_.clone();
+  }
+  return load_file(path);
+}
+
+Result<string> FileContentCache::get_part(CSlice path, int64 offset, int64 count, bool is_partial) {
+  if (is_partial) {
+    return read_file_str(path, count, offset);
+  }
+
+  BufferSlice file_content;
+  auto *entry = get_entry(path);
+  if (entry != nullptr) {
+    file_content = entry->content_.clone();
+  } else {
+    auto r_stat = stat(path);
+    if (r_stat.is_error() || r_stat.ok().size_ > max_file_size_ || offset > r_stat.ok().size_) {
+      return read_file_str(path, count, offset);
+    }
+    TRY_RESULT_ASSIGN(file_content, load_file(path));
+  }
+
+  Slice content = file_content.as_slice();
+  if (offset < 0 || offset > static_cast<int64>(content.size())) {
+    return Status::Error("Failed to read file: invalid offset");
+  }
+  if (count < 0 || count > static_cast<int64>(content.size()) - offset) {
+    count = static_cast<int64>(content.size()) - offset;
+  }
+  return content.substr(static_cast<size_t>(offset), static_cast<size_t>(count)).str();
+}
+
+void FileContentCache::add(CSlice path, BufferSlice content) {
+  if (content.empty() || static_cast<int64>(content.size()) > max_file_size_) {
+    return;
+  }
+  auto r_stat = stat(path);
+  if (r_stat.is_error() || r_stat.ok().size_ != static_cast<int64>(content.size())) {
+    return;
+  }
+  add_entry(path.str(), std::move(content), r_stat.ok().mtime_nsec_);
+}
+
+void FileContentCache::add_entry(string path, BufferSlice content, uint64 mtime_nsec) {
+  auto size = static_cast<int64>(content.size());
+  if (size > max_file_size_ || size > max_size_) {
+    return;
+  }
+
+  auto it = entries_.find(path);
+  if (it != entries_.end()) {
+    remove_entry(it->second.get());
+  }
+  while (stats_.size + size > max_size_ && !lru_list_.empty()) {
+    stats_.evict_count++;
+    remove_entry(static_cast<Entry *>(lru_list_.get_next()));
+  }
+
+  auto entry = make_unique<Entry>();
+  entry->path_ = path;
+  entry->content_ = std::move(content);
+  entry->mtime_nsec_ = mtime_nsec;
+  lru_list_.put_back(entry.get());
+  entries_.emplace(std::move(path), std::move(entry));
+  stats_.size += size;
+  stats_.add_count++;
+}
+
+void FileContentCache::remove_entry(Entry *entry) {
+  CHECK(entry != nullptr);
+  stats_.size -= static_cast<int64>(entry->content_.size());
+  entry->remove();
+  auto it = entries_.find(entry->path_);
+  CHECK(it != entries_.end());
+  entries_.erase(it);
+}
+
+void FileContentCache::invalidate(const string &path) {
+  auto it = entries_.find(path);
+  if (it == entries_.end()) {
+    return;
+  }
+  stats_.invalidate_count++;
+  remove_entry(it->second.get());
+}
+
+void FileContentCache::clear() {
+  while (!lru_list_.empty()) {
+    remove_entry(static_cast<Entry *>(lru_list_.get_next()));
+  }
+  CHECK(entries_.empty());
+  CHECK(stats_.size == 0);
+}
+
+FileContentCache::Stats FileContentCache::get_stats() const {
+  auto result = stats_;
+  result.file_count = entries_.size();
+  return result;
+}
+
+StringBuilder &operator<<(StringBuilder &string_builder, const FileContentCache::Stats &stats) {
+  auto request_count = stats.hit_count + stats.miss_count;
+  auto hit_rate =
+      request_count == 0 ? 0.0 : 100.0 * static_cast<double>(stats.hit_count) / static_cast<double>(request_count);
+  return string_builder << "FileContentCache[" << tag("files", stats.file_count)
+                        << tag("size", format::as_size(stats.size)) << tag("max_size", format::as_size(stats.max_size))
+                        << tag("hits", stats.hit_count) << tag("misses", stats.miss_count)
+                        << tag("hit_rate", hit_rate)
+                        << tag("added", stats.add_count) << tag("evicted", stats.evict_count)
+                        << tag("invalidated", stats.invalidate_count) << "]";
+}
+
+}  // namespace td
@@ -0,0 +1,84 @@
+//
+// Copyright Aliaksei Levin (levlam@telegram.org), Arseny Smirnov (arseny30@gmail.com) 2014-2024
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+#pragma once
+
+#include "td/utils/buffer.h"
+#include "td/utils/common.h"
+#include "td/utils/FlatHashMap.h"
+#include "td/utils/List.h"
+#include "td/utils/Slice.h"
+#include "td/utils/Status.h"
+#include "td/utils/StringBuilder.h"
+
+namespace td {
+
+// in-memory LRU cache of small complete files, which are frequently read, like stickers and thumbnails
+// must be used from a single thread
+class FileContentCache {
+ public:
+  static constexpr int64 DEFAULT_MAX_SIZE = 32 << 20;
+  static constexpr int64 DEFAULT_MAX_FILE_SIZE = 512 << 10;
+
+  struct Stats {
+    int64 hit_count = 0;
+    int64 miss_count = 0;
+    int64 add_count = 0;
+    int64 evict_count = 0;
+    int64 invalidate_count = 0;
+    int64 size = 0;
+    int64 max_size = 0;
+    size_t file_count = 0;
+  };
+
+  explicit FileContentCache(int64 max_size = DEFAULT_MAX_SIZE, int64 max_file_size = DEFAULT_MAX_FILE_SIZE);
+  FileContentCache(const FileContentCache &) = delete;
+  FileContentCache &operator=(const FileContentCache &) = delete;
+  FileContentCache(FileContentCache &&) = delete;
+  FileContentCache &operator=(FileContentCache &&) = delete;
+  ~FileContentCache();
+
+  // returns content of the whole file without copying; reads the file and caches it if it isn't cached yet
+  Result<BufferSlice> get_content(CSlice path);
+
+  // returns a part of the file; partial files are never cached, because they can be changed concurrently
+  Result<string> get_part(CSlice path, int64 offset, int64 count, bool is_partial);
+
+  // adds content of a just written file
+  void add(CSlice path, BufferSlice content);
+
+  // must be called whenever the file is changed or deleted
+  void invalidate(const string &path);
+
+  void clear();
+
+  Stats get_stats() const;
+
+ private:
+  struct Entry final : public ListNode {
+    string path_;
+    BufferSlice content_;
+    uint64 mtime_nsec_ = 0;
+  };
+
+  FlatHashMap<string, unique_ptr<Entry>> entries_;
+  ListNode lru_list_;
+  int64 max_size_ = 0;
+  int64 max_file_size_ = 0;
+  Stats stats_;
+
+  Entry *get_entry(CSlice path);
+
+  Result<BufferSlice> load_file(CSlice path);
+
+  void add_entry(string path, BufferSlice content, uint64 mtime_nsec);
+
+  void remove_entry(Entry *entry);
+};
+
+StringBuilder &operator<<(StringBuilder &string_builder, const FileContentCache::Stats &stats);
+
+}  // namespace td
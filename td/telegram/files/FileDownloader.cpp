@@ -104,6 +104,25 @@ Result<FileLoader::FileInfo> FileDownloader::init() {
       }
     }
   }
+  if (need_search_file_ && fd_.empty() && encryption_key_.empty()) {
+    // the same document could have been already downloaded with another file type
+    auto r_path = link_from_content_store(remote_, size_, name_);
+    if (r_path.is_ok()) {
+      auto r_fd = FileFd::open(r_path.ok(), FileFd::Read);
+      if (r_fd.is_ok()) {
+        path_ = r_path.move_as_ok();
+        fd_ = r_fd.move_as_ok();
+        need_check_ = true;
+        only_check_ = true;
+        is_linked_from_store_ = true;
+        part_size = 128 * (1 << 10);
+        bitmask = Bitmask{Bitmask::Ones{}, (size_ + part_size - 1) / part_size};
+        LOG(INFO) << "Check hash of stored file " << path_;
+      } else {
+        unlink(r_path.ok()).ignore();
+      }
+    }
+  }
 
   FileInfo res;
   res.size = size_;
@@ -124,6 +143,11 @@ Result<FileLoader::FileInfo> FileDownloader::init() {
 }
 
 Status FileDownloader::on_ok(int64 size) {
+  TRY_STATUS(flush_parts());
+  has_pending_progress_ = false;
+  cancel_timeout();
+  LOG(INFO) << "Written parts of \"" << path_ << "\": " << parts_writer_.get_stats();
+
   std::string path;
   fd_.close();
   if (encryption_key_.is_secure()) {
@@ -141,12 +165,34 @@ Status FileDownloader::on_ok(int64 size) {
   } else {
     TRY_RESULT_ASSIGN(path, create_from_temp(remote_.file_type_, path_, name_));
   }
+  if (encryption_key_.empty()) {
+    auto status = add_to_content_store(remote_, size, path);
+    LOG_IF(WARNING, status.is_error()) << "Failed to add " << path << " to the content store: " << status;
+  }
   callback_->on_ok(FullLocalFileLocation(remote_.file_type_, std::move(path), 0), size, !only_check_);
   return Status::OK();
 }
 
 void FileDownloader::on_error(Status status) {
+  if (!is_linked_from_store_) {
+    // already downloaded parts are valid, for example, if the download limit was reached,
+    // so they must be written and reported to avoid their download in the next streaming window
+    auto flush_status = flush_parts();
+    if (flush_status.is_error()) {
+      LOG(WARNING) << "Failed to write downloaded parts of \"" << path_ << "\": " << flush_status;
+    } else if (has_pending_progress_) {
+      has_pending_progress_ = false;
+      on_progress(std::move(pending_progress_));
+    }
+  }
+  parts_writer_.clear();
+  has_pending_progress_ = false;
+  cancel_timeout();
   fd_.close();
+  if (is_linked_from_store_) {
+    // the link will be recreated if needed
+    unlink(path_).ignore();
+  }
   callback_->on_error(std::move(status));
 }
 
@@ -366,16 +412,37 @@ Result<size_t> FileDownloader::process_part(Part part, NetQueryPtr net_query) {
                     bytes.as_mutable_slice());
   }
 
-  auto slice = bytes.as_slice().substr(0, part.size);
-  TRY_STATUS(acquire_fd());
-  LOG(INFO) << "Receive " << slice.size() << " bytes at offset " << part.offset << " for \"" << path_ << '"';
-  TRY_RESULT(written, fd_.pwrite(slice, part.offset));
-  LOG(INFO) << "Written " << written << " bytes";
   // may write less than part.size, when size of downloadable file is unknown
-  if (written != slice.size()) {
-    return Status::Error("Failed to save file part to the file");
+  if (bytes.size() > part.size) {
+    bytes.truncate(part.size);
+  }
+  auto size = bytes.size();
+  TRY_STATUS(acquire_fd());
+  LOG(INFO) << "Receive " << size << " bytes at offset " << part.offset << " for \"" << path_ << '"';
+  TRY_STATUS(parts_writer_.add_part(fd_, part.offset, std::move(bytes)));
+  return size;
+}
+
+Status FileDownloader::flush_parts() {
+  if (parts_writer_.empty()) {
+    return Status::OK();
+  }
+  TRY_STATUS(acquire_fd());
+  return parts_writer_.flush(fd_);
+}
+
+void FileDownloader::timeout_expired() {
+  auto status = flush_parts();
+  try_release_fd();
+  if (status.is_error()) {
+    on_error(std::move(status));
+    stop();
+    return;
+  }
+  if (has_pending_progress_) {
+    has_pending_progress_ = false;
+    on_progress(std::move(pending_progress_));
   }
-  return written;
 }
 
 void FileDownloader::on_progress(Progress progress) {
@@ -386,6 +453,16 @@ void FileDownloader::on_progress(Progress progress) {
   if (progress.ready_size == 0 || path_.empty()) {
     return;
   }
+  if (!parts_writer_.empty()) {
+    // the progress can't be reported until all ready parts are written to the file
+    pending_progress_ = std::move(progress);
+    has_pending_progress_ = true;
+    if (!has_timeout()) {
+      set_timeout_in(MAX_PENDING_PARTS_DELAY);
+    }
+    return;
+  }
+  has_pending_progress_ = false;
   if (encryption_key_.empty() || encryption_key_.is_secure()) {
     callback_->on_partial_download(
         PartialLocalFileLocation{remote_.file_type_, progress.part_size, path_, "", std::move(progress.ready_bitmask)},
@@ -425,6 +502,7 @@ Result<FileLoader::CheckInfo> FileDownloader::check_loop(int64 checked_prefix_si
   SCOPE_EXIT {
     try_release_fd();
   };
+  TRY_STATUS(flush_parts());
   CheckInfo info;
   while (checked_prefix_size < ready_prefix_size) {
     //LOG(ERROR) << "NEED TO CHECK: " << checked_prefix_size << "->" << ready_prefix_size - checked_prefix_size;
@@ -456,6 +534,10 @@ Result<FileLoader::CheckInfo> FileDownloader::check_loop(int64 checked_prefix_si
 
       if (hash != it->hash) {
         if (only_check_) {
+          if (is_linked_from_store_) {
+            LOG(WARNING) << "Remove stored file with wrong content " << get_content_store_path(remote_, size_);
+            unlink(get_content_store_path(remote_, size_)).ignore();
+          }
           return Status::Error("FILE_DOWNLOAD_RESTART");
         }
         return Status::Error("Hash mismatch");
@@ -498,7 +580,7 @@ void FileDownloader::keep_fd_flag(bool keep_fd) {
 }
 
 void FileDownloader::try_release_fd() {
-  if (!keep_fd_ && !fd_.empty()) {
+  if (!keep_fd_ && !fd_.empty() && parts_writer_.empty()) {
     fd_.close();
   }
 }
@@ -507,9 +589,17 @@ Status FileDownloader::acquire_fd() {
   if (fd_.empty()) {
     if (path_.empty()) {
       TRY_RESULT_ASSIGN(std::tie(fd_, path_), open_temp_file(remote_.file_type_));
+      if (size_ >= MIN_RESERVED_FILE_SIZE) {
+        // allocate the whole file at once to avoid its fragmentation
+        auto status = fd_.reserve_space(size_);
+        LOG_IF(INFO, status.is_error()) << "Failed to reserve space for \"" << path_ << "\": " << status;
+      }
     } else {
       TRY_RESULT_ASSIGN(fd_, FileFd::open(path_, (only_check_ ? 0 : FileFd::Write) | FileFd::Read));
     }
+    if (!is_small_) {
+      fd_.advise_sequential_access();
+    }
   }
   return Status::OK();
 }
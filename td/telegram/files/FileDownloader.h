@@ -8,6 +8,7 @@
 
 #include "td/telegram/files/FileEncryptionKey.h"
 #include "td/telegram/files/FileLoader.h"
+#include "td/telegram/files/FilePartsWriter.h"
 #include "td/telegram/files/FileLocation.h"
 #include "td/telegram/net/DcId.h"
 #include "td/telegram/net/NetQuery.h"
@@ -40,6 +41,8 @@ class FileDownloader final : public FileLoader {
   // Must not call any of them...
  private:
   enum class QueryType : uint8 { Default = 1, CDN, ReuploadCDN };
+  static constexpr int64 MIN_RESERVED_FILE_SIZE = 1 << 20;
+  static constexpr double MAX_PENDING_PARTS_DELAY = 0.05;
   ResourceState resource_state_;
   FullRemoteFileLocation remote_;
   LocalFileLocation local_;
@@ -48,9 +51,13 @@ class FileDownloader final : public FileLoader {
   FileEncryptionKey encryption_key_;
   unique_ptr<Callback> callback_;
   bool only_check_{false};
+  bool is_linked_from_store_{false};
 
   string path_;
   FileFd fd_;
+  FilePartsWriter parts_writer_;
+  Progress pending_progress_;
+  bool has_pending_progress_ = false;
 
   int32 next_part_ = 0;
   bool next_part_stop_ = false;
@@ -99,5 +106,9 @@ class FileDownloader final : public FileLoader {
   Status acquire_fd() TD_WARN_UNUSED_RESULT;
 
   Status check_net_query(NetQueryPtr &net_query);
+
+  Status flush_parts() TD_WARN_UNUSED_RESULT;
+
+  void timeout_expired() final;
 };
 }  // namespace td
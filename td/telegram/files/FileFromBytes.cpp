@@ -19,11 +19,11 @@ FileFromBytes::FileFromBytes(FileType type, BufferSlice bytes, string name, uniq
 
 void FileFromBytes::wakeup() {
   auto size = narrow_cast<int64>(bytes_.size());
-  auto r_result = save_file_bytes(type_, std::move(bytes_), name_);
+  auto r_result = save_file_bytes(type_, bytes_.clone(), name_);
   if (r_result.is_error()) {
     callback_->on_error(r_result.move_as_error());
   } else {
-    callback_->on_ok(r_result.ok(), size);
+    callback_->on_ok(r_result.ok(), size, std::move(bytes_));
   }
 }
 
@@ -26,7 +26,7 @@ class FileFromBytes final : public FileLoaderActor {
     Callback(const Callback &) = delete;
     Callback &operator=(const Callback &) = delete;
     virtual ~Callback() = default;
-    virtual void on_ok(const FullLocalFileLocation &full_local, int64 size) = 0;
+    virtual void on_ok(const FullLocalFileLocation &full_local, int64 size, BufferSlice bytes) = 0;
     virtual void on_error(Status status) = 0;
   };
 
@@ -6,6 +6,7 @@
 //
 #include "td/telegram/files/FileGcWorker.h"
 
+#include "td/telegram/files/FileLoaderUtils.h"
 #include "td/telegram/files/FileLocation.h"
 #include "td/telegram/files/FileManager.h"
 #include "td/telegram/files/FileType.h"
@@ -17,6 +18,7 @@
 #include "td/utils/misc.h"
 #include "td/utils/port/Clocks.h"
 #include "td/utils/port/path.h"
+#include "td/utils/port/Stat.h"
 #include "td/utils/Time.h"
 
 #include <algorithm>
@@ -84,12 +86,19 @@ void FileGcWorker::run_gc(const FileGcParameters &parameters, std::vector<FullFi
   FileStats new_stats(false, parameters.dialog_limit_ != 0);
   FileStats removed_stats(false, parameters.dialog_limit_ != 0);
 
-  auto do_remove_file = [&removed_stats](const FullFileInfo &info) {
+  // returns size of the freed disk space; files from the content store are hard links to the same data,
+  // so the space is freed only with the last link except the link from the store, which is removed afterwards
+  auto do_remove_file = [&removed_stats](const FullFileInfo &info) -> int64 {
     removed_stats.add_copy(info);
+    auto r_stat = stat(info.path);
     auto status = unlink(info.path);
     LOG_IF(WARNING, status.is_error()) << "Failed to unlink file \"" << info.path << "\" during files GC: " << status;
     send_closure(G()->file_manager(), &FileManager::on_file_unlink,
                  FullLocalFileLocation(info.file_type, info.path, info.mtime_nsec));
+    if (r_stat.is_ok() && r_stat.ok().link_count_ > 2) {
+      return 0;
+    }
+    return info.size;
   };
 
   double now = Clocks::system();
@@ -122,8 +131,7 @@ void FileGcWorker::run_gc(const FileGcParameters &parameters, std::vector<FullFi
     }
 
     if (static_cast<double>(info.atime_nsec) * 1e-9 < now - parameters.max_time_from_last_access_) {
-      do_remove_file(info);
-      total_removed_size += info.size;
+      total_removed_size += do_remove_file(info);
       remove_by_atime_cnt++;
       return true;
     }
@@ -161,10 +169,9 @@ void FileGcWorker::run_gc(const FileGcParameters &parameters, std::vector<FullFi
     if (remove_count > 0) {
       remove_count--;
     }
-    remove_size -= files[pos].size;
-
-    total_removed_size += files[pos].size;
-    do_remove_file(files[pos]);
+    auto removed_size = do_remove_file(files[pos]);
+    remove_size -= removed_size;
+    total_removed_size += removed_size;
     pos++;
   }
 
@@ -173,12 +180,16 @@ void FileGcWorker::run_gc(const FileGcParameters &parameters, std::vector<FullFi
     pos++;
   }
 
+  // the space has already been accounted when the last file linked to the stored file was removed
+  auto removed_stored_size = clean_content_store();
+
   auto end_time = Time::now();
 
   VLOG(file_gc) << "Finish files GC: " << tag("time", end_time - begin_time) << tag("total", file_cnt)
                 << tag("removed", remove_by_atime_cnt + remove_by_count_cnt + remove_by_size_cnt)
                 << tag("total_size", format::as_size(total_size))
                 << tag("total_removed_size", format::as_size(total_removed_size))
+                << tag("removed_stored_size", format::as_size(removed_stored_size))
                 << tag("by_atime", remove_by_atime_cnt) << tag("by_count", remove_by_count_cnt)
                 << tag("by_size", remove_by_size_cnt) << tag("type_immunity", type_immunity_ignored_cnt)
                 << tag("time_immunity", time_immunity_ignored_cnt)
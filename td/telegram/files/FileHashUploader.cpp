@@ -20,7 +20,6 @@
 #include "td/utils/misc.h"
 #include "td/utils/PathView.h"
 #include "td/utils/port/FileFd.h"
-#include "td/utils/port/PollFlags.h"
 #include "td/utils/Status.h"
 
 namespace td {
@@ -40,7 +39,7 @@ Status FileHashUploader::init() {
   if (file_size != size_) {
     return Status::Error("Size mismatch");
   }
-  fd_ = BufferedFd<FileFd>(std::move(fd));
+  fd_ = std::move(fd);
   sha256_state_.init();
 
   resource_state_.set_unit_size(1024);
@@ -89,24 +88,13 @@ Status FileHashUploader::loop_sha() {
   }
   resource_state_.start_use(limit);
 
-  fd_.get_poll_info().add_flags(PollFlags::Read());
-  TRY_RESULT(read_size, fd_.flush_read(static_cast<size_t>(limit)));
-  if (read_size != static_cast<size_t>(limit)) {
-    return Status::Error("Unexpected end of file");
-  }
-  while (true) {
-    auto ready = fd_.input_buffer().prepare_read();
-    if (ready.empty()) {
-      break;
-    }
-    sha256_state_.feed(ready);
-    fd_.input_buffer().confirm_read(ready.size());
-  }
+  TRY_STATUS(sha256_feed_file(sha256_state_, fd_, size_ - size_left_, limit));
   resource_state_.stop_use(limit);
 
-  size_left_ -= narrow_cast<int64>(read_size);
+  size_left_ -= limit;
   CHECK(size_left_ >= 0);
   if (size_left_ == 0) {
+    fd_.close();
     state_ = State::NetRequest;
     return Status::OK();
   }
@@ -12,7 +12,6 @@
 
 #include "td/actor/actor.h"
 
-#include "td/utils/BufferedFd.h"
 #include "td/utils/crypto.h"
 #include "td/utils/port/FileFd.h"
 #include "td/utils/Status.h"
@@ -54,7 +53,7 @@ class FileHashUploader final : public FileLoaderActor {
 
  private:
   ResourceState resource_state_;
-  BufferedFd<FileFd> fd_;
+  FileFd fd_;
 
   FullLocalFileLocation local_;
   int64 size_;
@@ -10,8 +10,8 @@
 #include "td/telegram/net/DcId.h"
 
 #include "td/utils/common.h"
-#include "td/utils/filesystem.h"
 #include "td/utils/format.h"
+#include "td/utils/logging.h"
 #include "td/utils/port/path.h"
 #include "td/utils/SliceBuilder.h"
 
@@ -132,18 +132,28 @@ void FileLoadManager::from_bytes(QueryId query_id, FileType type, BufferSlice by
 }
 
 void FileLoadManager::get_content(string file_path, Promise<BufferSlice> promise) {
-  promise.set_result(read_file(file_path));
+  promise.set_result(content_cache_.get_content(file_path));
 }
 
-void FileLoadManager::read_file_part(string file_path, int64 offset, int64 count, Promise<string> promise) {
-  promise.set_result(read_file_str(file_path, count, offset));
+void FileLoadManager::read_file_part(string file_path, int64 offset, int64 count, bool is_partial,
+                                     Promise<string> promise) {
+  promise.set_result(content_cache_.get_part(file_path, offset, count, is_partial));
 }
 
 void FileLoadManager::unlink_file(string file_path, Promise<Unit> promise) {
+  content_cache_.invalidate(file_path);
   unlink(file_path).ignore();
   promise.set_value(Unit());
 }
 
+void FileLoadManager::on_file_unlink(string file_path) {
+  content_cache_.invalidate(file_path);
+}
+
+void FileLoadManager::get_content_cache_stats(Promise<FileContentCache::Stats> promise) {
+  promise.set_value(content_cache_.get_stats());
+}
+
 void FileLoadManager::check_full_local_location(FullLocalLocationInfo local_info, bool skip_file_size_checks,
                                                 Promise<FullLocalLocationInfo> promise) {
   promise.set_result(::td::check_full_local_location(std::move(local_info), skip_file_size_checks));
@@ -200,6 +210,8 @@ void FileLoadManager::update_downloaded_part(QueryId query_id, int64 offset, int
 }
 
 void FileLoadManager::hangup() {
+  LOG(INFO) << content_cache_.get_stats();
+  content_cache_.clear();
   nodes_container_.for_each([](auto query_id, auto &node) { node.loader_.reset(); });
   stop_flag_ = true;
   loop();
@@ -263,6 +275,11 @@ void FileLoadManager::on_ok_download(FullLocalFileLocation local, int64 size, bo
   loop();
 }
 
+void FileLoadManager::on_ok_from_bytes(FullLocalFileLocation local, int64 size, BufferSlice bytes) {
+  content_cache_.add(local.path_, std::move(bytes));
+  on_ok_download(std::move(local), size, true);
+}
+
 void FileLoadManager::on_ok_upload(FileType file_type, PartialRemoteFileLocation remote, int64 size) {
   auto node_id = get_link_token();
   auto node = nodes_container_.get(node_id);
@@ -6,6 +6,7 @@
 //
 #pragma once
 
+#include "td/telegram/files/FileContentCache.h"
 #include "td/telegram/files/FileDownloader.h"
 #include "td/telegram/files/FileEncryptionKey.h"
 #include "td/telegram/files/FileFromBytes.h"
@@ -61,10 +62,14 @@ class FileLoadManager final : public Actor {
 
   void get_content(string file_path, Promise<BufferSlice> promise);
 
-  void read_file_part(string file_path, int64 offset, int64 count, Promise<string> promise);
+  void read_file_part(string file_path, int64 offset, int64 count, bool is_partial, Promise<string> promise);
 
   void unlink_file(string file_path, Promise<Unit> promise);
 
+  void on_file_unlink(string file_path);
+
+  void get_content_cache_stats(Promise<FileContentCache::Stats> promise);
+
   void check_full_local_location(FullLocalLocationInfo local_info, bool skip_file_size_checks,
                                  Promise<FullLocalLocationInfo> promise);
 
@@ -86,6 +91,7 @@ class FileLoadManager final : public Actor {
   ActorShared<Callback> callback_;
   ActorShared<> parent_;
   std::map<QueryId, NodeId> query_id_to_node_id_;
+  FileContentCache content_cache_;
   int64 max_download_resource_limit_ = 1 << 21;
   bool stop_flag_ = false;
 
@@ -102,6 +108,7 @@ class FileLoadManager final : public Actor {
   void on_partial_upload(PartialRemoteFileLocation partial_remote, int64 ready_size);
   void on_hash(string hash);
   void on_ok_download(FullLocalFileLocation local, int64 size, bool is_new);
+  void on_ok_from_bytes(FullLocalFileLocation local, int64 size, BufferSlice bytes);
   void on_ok_upload(FileType file_type, PartialRemoteFileLocation remote, int64 size);
   void on_ok_upload_full(FullRemoteFileLocation remote);
   void on_error(Status status);
@@ -174,8 +181,8 @@ class FileLoadManager final : public Actor {
    private:
     ActorShared<FileLoadManager> actor_id_;
 
-    void on_ok(const FullLocalFileLocation &full_local, int64 size) final {
-      send_closure(std::move(actor_id_), &FileLoadManager::on_ok_download, full_local, size, true);
+    void on_ok(const FullLocalFileLocation &full_local, int64 size, BufferSlice bytes) final {
+      send_closure(std::move(actor_id_), &FileLoadManager::on_ok_from_bytes, full_local, size, std::move(bytes));
     }
     void on_error(Status status) final {
       send_closure(std::move(actor_id_), &FileLoadManager::on_error, std::move(status));
@@ -22,6 +22,10 @@
 
 namespace td {
 
+void FileLoader::Callback::send_query(NetQueryPtr query, ActorShared<NetQueryCallback> callback) {
+  G()->net_query_dispatcher().dispatch_with_callback(std::move(query), std::move(callback));
+}
+
 void FileLoader::set_resource_manager(ActorShared<ResourceManager> resource_manager) {
   resource_manager_ = std::move(resource_manager);
   send_closure(resource_manager_, &ResourceManager::update_resources, resource_state_);
@@ -169,8 +173,8 @@ Status FileLoader::do_loop() {
     on_progress_impl();
   }
   for (auto &query : check_info.queries) {
-    G()->net_query_dispatcher().dispatch_with_callback(
-        std::move(query), actor_shared(this, UniqueId::next(UniqueId::Type::Default, COMMON_QUERY_KEY)));
+    get_callback()->send_query(std::move(query),
+                               actor_shared(this, UniqueId::next(UniqueId::Type::Default, COMMON_QUERY_KEY)));
   }
   if (check_info.need_check) {
     parts_manager_.set_need_check();
@@ -220,7 +224,7 @@ Status FileLoader::do_loop() {
 
     auto callback = actor_shared(this, unique_id);
     if (delay_dispatcher_.empty()) {
-      G()->net_query_dispatcher().dispatch_with_callback(std::move(query), std::move(callback));
+      get_callback()->send_query(std::move(query), std::move(callback));
     } else {
       query->debug("sent to DelayDispatcher");
       send_closure(delay_dispatcher_, &DelayDispatcher::send_with_callback_and_delay, std::move(query),
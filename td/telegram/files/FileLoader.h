@@ -33,6 +33,9 @@ class FileLoader : public FileLoaderActor {
     Callback(const Callback &) = delete;
     Callback &operator=(const Callback &) = delete;
     virtual ~Callback() = default;
+
+    // sends queries for file parts without delay; the queries are sent through NetQueryDispatcher by default
+    virtual void send_query(NetQueryPtr query, ActorShared<NetQueryCallback> callback);
   };
   void set_resource_manager(ActorShared<ResourceManager> resource_manager) final;
   void update_priority(int8 priority) final;
@@ -257,6 +257,75 @@ string get_files_dir(FileType file_type) {
   return PSTRING() << get_files_base_dir(file_type) << get_file_type_name(file_type) << TD_DIR_SLASH;
 }
 
+static string get_content_store_dir() {
+  return PSTRING() << get_files_base_dir(FileType::Document) << "store" << TD_DIR_SLASH;
+}
+
+string get_content_store_path(const FullRemoteFileLocation &remote, int64 size) {
+  constexpr int64 MIN_STORED_FILE_SIZE = 1 << 20;
+  if (size < MIN_STORED_FILE_SIZE || remote.is_web() || !remote.is_common() ||
+      get_file_type_class(remote.file_type_) != FileTypeClass::Document ||
+      !G()->get_option_boolean("use_file_content_store")) {
+    return string();
+  }
+  // document identifiers are unique, so the file content is identified by the document and its size
+  return PSTRING() << get_content_store_dir() << static_cast<uint64>(remote.get_id()) << '_' << size;
+}
+
+Status add_to_content_store(const FullRemoteFileLocation &remote, int64 size, CSlice path) {
+  auto store_path = get_content_store_path(remote, size);
+  if (store_path.empty() || stat(store_path).is_ok()) {
+    return Status::OK();
+  }
+  auto status = link(path, store_path);
+  if (status.is_error()) {
+    mkdir(get_content_store_dir(), 0750).ignore();
+    TRY_STATUS(link(path, store_path));
+  }
+  LOG(INFO) << "Add " << path << " to the content store as " << store_path;
+  return Status::OK();
+}
+
+Result<string> link_from_content_store(const FullRemoteFileLocation &remote, int64 size, CSlice name) {
+  auto store_path = get_content_store_path(remote, size);
+  if (store_path.empty()) {
+    return Status::Error("File can't be stored");
+  }
+  TRY_RESULT(store_stat, stat(store_path));
+  if (!store_stat.is_reg_ || store_stat.size_ != size) {
+    unlink(store_path).ignore();
+    return Status::Error("Stored file is invalid");
+  }
+
+  auto dir = get_files_dir(remote.file_type_);
+  Result<std::pair<FileFd, string>> res = Status::Error(500, "Can't find suitable file name");
+  for_suggested_file_name(name, true, true, [&](CSlice suggested_name) {
+    res = try_create_new_file(dir, suggested_name);
+    return res.is_error();
+  });
+  TRY_RESULT(tmp, std::move(res));
+  tmp.first.close();
+  auto path = std::move(tmp.second);
+  TRY_STATUS(unlink(path));
+  TRY_STATUS(link(store_path, path));
+  LOG(INFO) << "Link " << path << " to stored file " << store_path;
+  return path;
+}
+
+int64 clean_content_store() {
+  int64 removed_size = 0;
+  walk_path(get_content_store_dir(), [&](CSlice path, WalkPath::Type type) {
+    if (type != WalkPath::Type::RegularFile) {
+      return;
+    }
+    auto r_stat = stat(path);
+    if (r_stat.is_ok() && r_stat.ok().link_count_ <= 1 && unlink(path).is_ok()) {
+      removed_size += r_stat.ok().size_;
+    }
+  }).ignore();
+  return removed_size;
+}
+
 bool are_modification_times_equal(int64 old_mtime, int64 new_mtime) {
   if (old_mtime == new_mtime) {
     return true;
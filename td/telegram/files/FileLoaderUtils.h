@@ -32,6 +32,19 @@ Result<string> get_suggested_file_name(CSlice dir, Slice file_name) TD_WARN_UNUS
 
 Result<FullLocalFileLocation> save_file_bytes(FileType file_type, BufferSlice bytes, CSlice file_name);
 
+// content-addressed store of downloaded documents, which are hard-linked from the directories of all file types
+// returns an empty string if the file can't be stored
+string get_content_store_path(const FullRemoteFileLocation &remote, int64 size);
+
+Status add_to_content_store(const FullRemoteFileLocation &remote, int64 size, CSlice path) TD_WARN_UNUSED_RESULT;
+
+// returns path to a new hard link to the stored file; its content must be checked before use
+Result<string> link_from_content_store(const FullRemoteFileLocation &remote, int64 size,
+                                       CSlice name) TD_WARN_UNUSED_RESULT;
+
+// removes stored files, which are no longer linked from other directories; returns total size of the removed files
+int64 clean_content_store();
+
 Slice get_files_base_dir(FileType file_type);
 
 string get_files_temp_dir(FileType file_type);
@@ -16,6 +16,7 @@
 #include "td/telegram/files/FileLocation.hpp"
 #include "td/telegram/Global.h"
 #include "td/telegram/logevent/LogEvent.h"
+#include "td/telegram/MemoryStatistics.h"
 #include "td/telegram/misc.h"
 #include "td/telegram/SecureStorage.h"
 #include "td/telegram/TdDb.h"
@@ -208,9 +209,16 @@ int64 FileNode::get_download_limit() const {
   if (ignore_download_limit_) {
     return 0;
   }
+  if (read_ahead_ != nullptr) {
+    return min(read_ahead_->get_download_limit(download_offset_, private_download_limit_), MAX_FILE_SIZE);
+  }
   return private_download_limit_;
 }
 
+bool FileNode::is_download_limited_by_read_ahead() const {
+  return private_download_limit_ == 0 && get_download_limit() != 0;
+}
+
 void FileNode::update_effective_download_limit(int64 old_download_limit) {
   if (get_download_limit() == old_download_limit) {
     return;
@@ -244,6 +252,44 @@ void FileNode::set_ignore_download_limit(bool ignore_download_limit) {
   update_effective_download_limit(old_download_limit);
 }
 
+void FileNode::set_use_read_ahead(bool use_read_ahead) {
+  if (use_read_ahead == (read_ahead_ != nullptr)) {
+    return;
+  }
+  VLOG(update_file) << (use_read_ahead ? "Enable" : "Disable") << " streaming read-ahead for file " << main_file_id_;
+  auto old_download_limit = get_download_limit();
+  if (use_read_ahead) {
+    read_ahead_ = make_unique<StreamingReadAhead>();
+  } else {
+    read_ahead_ = nullptr;
+  }
+  update_effective_download_limit(old_download_limit);
+}
+
+void FileNode::on_read_offset(int64 read_offset) {
+  if (read_ahead_ == nullptr) {
+    return;
+  }
+  auto old_download_limit = get_download_limit();
+  read_ahead_->on_read_offset(read_offset, Time::now());
+  update_effective_download_limit(old_download_limit);
+}
+
+void FileNode::on_download_progress() {
+  if (read_ahead_ == nullptr) {
+    return;
+  }
+  read_ahead_->on_download_progress(local_ready_size_, Time::now());
+  VLOG(update_file) << "File " << main_file_id_ << " has " << *read_ahead_;
+}
+
+void FileNode::on_download_start() {
+  if (read_ahead_ == nullptr) {
+    return;
+  }
+  read_ahead_->on_download_start(local_ready_size_, Time::now());
+}
+
 void FileNode::drop_local_location() {
   set_local_location(LocalFileLocation(), 0, -1, -1);
 }
@@ -1227,6 +1273,7 @@ FileId FileManager::register_empty(FileType type) {
 }
 
 void FileManager::on_file_unlink(const FullLocalFileLocation &location) {
+  send_closure(file_load_manager_, &FileLoadManager::on_file_unlink, location.path_);
   auto it = local_location_to_file_id_.find(location);
   if (it == local_location_to_file_id_.end()) {
     return;
@@ -2265,6 +2312,10 @@ void FileManager::get_content(FileId file_id, Promise<BufferSlice> promise) {
   send_closure(file_load_manager_, &FileLoadManager::get_content, node->local_.full().path_, std::move(promise));
 }
 
+void FileManager::get_content_cache_stats(Promise<FileContentCache::Stats> promise) {
+  send_closure(file_load_manager_, &FileLoadManager::get_content_cache_stats, std::move(promise));
+}
+
 void FileManager::read_file_part(FileId file_id, int64 offset, int64 count, int left_tries,
                                  Promise<td_api::object_ptr<td_api::filePart>> promise) {
   TRY_STATUS_PROMISE(promise, G()->close_status());
@@ -2298,6 +2349,11 @@ void FileManager::read_file_part(FileId file_id, int64 offset, int64 count, int
     return promise.set_error(Status::Error(400, "Part length is too big"));
   }
 
+  node->on_read_offset(offset);
+  if (node->is_download_limit_dirty_ && (node->download_priority_ != 0 || node->is_download_paused_by_read_ahead_)) {
+    run_download(node, false);
+  }
+
   const string *path = nullptr;
   bool is_partial = false;
   if (file_view.has_local_location()) {
@@ -2335,7 +2391,7 @@ void FileManager::read_file_part(FileId file_id, int64 offset, int64 count, int
           promise.set_value(std::move(result));
         }
       });
-  send_closure(file_load_manager_, &FileLoadManager::read_file_part, *path, offset, count,
+  send_closure(file_load_manager_, &FileLoadManager::read_file_part, *path, offset, count, is_partial,
                std::move(read_file_part_promise));
 }
 
@@ -2378,7 +2434,7 @@ void FileManager::delete_file(FileId file_id, Promise<Unit> promise, const char
 }
 
 void FileManager::download(FileId file_id, std::shared_ptr<DownloadCallback> callback, int32 new_priority, int64 offset,
-                           int64 limit, Promise<td_api::object_ptr<td_api::file>> promise) {
+                           int64 limit, bool use_read_ahead, Promise<td_api::object_ptr<td_api::file>> promise) {
   TRY_STATUS_PROMISE(promise, G()->close_status());
 
   auto node = get_sync_file_node(file_id);
@@ -2393,25 +2449,26 @@ void FileManager::download(FileId file_id, std::shared_ptr<DownloadCallback> cal
 
   if ((callback == nullptr && new_priority <= 0) || node->local_.type() == LocalFileLocation::Type::Empty) {
     // skip local location check if download is canceled or there is no local location
-    return download_impl(file_id, std::move(callback), new_priority, offset, limit, Status::OK(), std::move(promise));
+    return download_impl(file_id, std::move(callback), new_priority, offset, limit, use_read_ahead, Status::OK(),
+                         std::move(promise));
   }
 
   LOG(INFO) << "Asynchronously check location of file " << file_id << " before downloading";
   auto check_promise =
       PromiseCreator::lambda([actor_id = actor_id(this), file_id, callback = std::move(callback), new_priority, offset,
-                              limit, promise = std::move(promise)](Result<Unit> result) mutable {
+                              limit, use_read_ahead, promise = std::move(promise)](Result<Unit> result) mutable {
         Status check_status;
         if (result.is_error()) {
           check_status = result.move_as_error();
         }
         send_closure(actor_id, &FileManager::download_impl, file_id, std::move(callback), new_priority, offset, limit,
-                     std::move(check_status), std::move(promise));
+                     use_read_ahead, std::move(check_status), std::move(promise));
       });
   check_local_location_async(node, true, std::move(check_promise));
 }
 
 void FileManager::download_impl(FileId file_id, std::shared_ptr<DownloadCallback> callback, int32 new_priority,
-                                int64 offset, int64 limit, Status check_status,
+                                int64 offset, int64 limit, bool use_read_ahead, Status check_status,
                                 Promise<td_api::object_ptr<td_api::file>> promise) {
   TRY_STATUS_PROMISE(promise, G()->close_status());
 
@@ -2450,6 +2507,13 @@ void FileManager::download_impl(FileId file_id, std::shared_ptr<DownloadCallback
 
   LOG(INFO) << "Change download priority of file " << file_id << " to " << new_priority << " with callback "
             << callback.get();
+  if (limit >= 0) {
+    // read-ahead is used only if requested by the client; requests, which keep the limit, keep it too
+    node->set_use_read_ahead(use_read_ahead);
+  }
+  if (offset >= 0) {
+    node->on_read_offset(offset);
+  }
   node->set_download_offset(offset);
   node->set_download_limit(limit);
   auto *file_info = get_file_id_info(file_id);
@@ -2493,6 +2557,7 @@ void FileManager::run_download(FileNodePtr node, bool force_update_priority) {
   }
 
   auto old_priority = node->download_priority_;
+  node->is_download_paused_by_read_ahead_ = false;
 
   if (priority == 0) {
     node->set_download_priority(priority);
@@ -2596,6 +2661,7 @@ void FileManager::run_download(FileNodePtr node, bool force_update_priority) {
   QueryId query_id = queries_container_.create(Query{file_id, Query::Type::Download});
   node->download_id_ = query_id;
   node->is_download_started_ = false;
+  node->on_download_start();
   LOG(INFO) << "Run download of file " << file_id << " of size " << node->size_ << " from "
             << node->remote_.full.value() << " with suggested name " << node->suggested_path() << " and encyption key "
             << node->encryption_key_;
@@ -3241,6 +3307,15 @@ Result<FileId> FileManager::from_persistent_id_v3(Slice binary, FileType file_ty
   return from_persistent_id_v23(binary, file_type, version);
 }
 
+void FileManager::get_memory_statistics(MemoryStatistics &statistics) const {
+  statistics.add("file_ids", file_id_info_);
+  statistics.add("file_nodes", file_nodes_);
+  statistics.add("file_hashes", file_hash_to_file_id_);
+  statistics.add("remote_file_locations", remote_location_to_file_id_);
+  statistics.add("local_file_locations", local_location_to_file_id_);
+  statistics.add("generated_file_locations", generate_location_to_file_id_);
+}
+
 FileView FileManager::get_file_view(FileId file_id) const {
   auto file_node = get_file_node(file_id);
   if (!file_node) {
@@ -3733,6 +3808,7 @@ void FileManager::on_partial_download(QueryId query_id, PartialLocalFileLocation
     }
   }
   file_node->set_local_location(LocalFileLocation(std::move(partial_local)), ready_size, -1, -1 /* TODO */);
+  file_node->on_download_progress();
   try_flush_node(file_node, "on_partial_download");
 }
 
@@ -4091,6 +4167,15 @@ void FileManager::on_error_impl(FileNodePtr node, Query::Type type, bool was_act
     return;
   }
 
+  if (type == Query::Type::Download && begins_with(status.message(), "FILE_DOWNLOAD_LIMIT") &&
+      node->is_download_limited_by_read_ahead()) {
+    // the read-ahead window has been downloaded; the client hasn't set the limit, so the download isn't finished
+    // and will be resumed by read_file_part after the read offset moves forward
+    LOG(INFO) << "Pause download of file " << node->main_file_id_ << " at the end of read-ahead window";
+    node->is_download_paused_by_read_ahead_ = true;
+    return;
+  }
+
   if (G()->close_flag() && (status.code() < 400 || (status.code() == Global::request_aborted_error().code() &&
                                                     status.message() == Global::request_aborted_error().message()))) {
     status = Global::request_aborted_error();
@@ -7,6 +7,7 @@
 #pragma once
 
 #include "td/telegram/DialogId.h"
+#include "td/telegram/files/FileContentCache.h"
 #include "td/telegram/files/FileDbId.h"
 #include "td/telegram/files/FileEncryptionKey.h"
 #include "td/telegram/files/FileGenerateManager.h"
@@ -16,6 +17,7 @@
 #include "td/telegram/files/FileLocation.h"
 #include "td/telegram/files/FileSourceId.h"
 #include "td/telegram/files/FileType.h"
+#include "td/telegram/files/StreamingReadAhead.h"
 #include "td/telegram/Location.h"
 #include "td/telegram/PhotoSizeSource.h"
 #include "td/telegram/td_api.h"
@@ -48,6 +50,7 @@ extern int VERBOSITY_NAME(update_file);
 
 class FileData;
 class FileDbInterface;
+class MemoryStatistics;
 
 enum class FileLocationSource : int8 { None, FromUser, FromBinlog, FromDatabase, FromServer };
 
@@ -111,6 +114,11 @@ class FileNode {
   void set_download_limit(int64 download_limit);
   void set_ignore_download_limit(bool ignore_download_limit);
 
+  void set_use_read_ahead(bool use_read_ahead);
+  void on_read_offset(int64 read_offset);
+  void on_download_progress();
+  void on_download_start();
+
   void on_changed();
   void on_info_changed();
   void on_pmc_changed();
@@ -123,6 +131,8 @@ class FileNode {
 
   int64 get_download_limit() const;
 
+  bool is_download_limited_by_read_ahead() const;
+
   string suggested_path() const;
 
  private:
@@ -137,6 +147,7 @@ class FileNode {
   FileLoadManager::QueryId upload_id_ = 0;
   int64 download_offset_ = 0;
   int64 private_download_limit_ = 0;
+  unique_ptr<StreamingReadAhead> read_ahead_;
   int64 local_ready_size_ = 0;         // PartialLocal only
   int64 local_ready_prefix_size_ = 0;  // PartialLocal only
 
@@ -173,6 +184,7 @@ class FileNode {
 
   bool is_download_offset_dirty_ = false;
   bool is_download_limit_dirty_ = false;
+  bool is_download_paused_by_read_ahead_ = false;
 
   bool get_by_hash_{false};
   bool can_search_locally_{true};
@@ -491,7 +503,7 @@ class FileManager final : public FileLoadManager::Callback {
   void check_local_location_async(FileId file_id, bool skip_file_size_checks);
 
   void download(FileId file_id, std::shared_ptr<DownloadCallback> callback, int32 new_priority, int64 offset,
-                int64 limit, Promise<td_api::object_ptr<td_api::file>> promise);
+                int64 limit, bool use_read_ahead, Promise<td_api::object_ptr<td_api::file>> promise);
   void upload(FileId file_id, std::shared_ptr<UploadCallback> callback, int32 new_priority, uint64 upload_order);
   void resume_upload(FileId file_id, vector<int> bad_parts, std::shared_ptr<UploadCallback> callback,
                      int32 new_priority, uint64 upload_order, bool force = false, bool prefer_small = false);
@@ -501,6 +513,8 @@ class FileManager final : public FileLoadManager::Callback {
   void delete_file_reference(FileId file_id, Slice file_reference);
   void get_content(FileId file_id, Promise<BufferSlice> promise);
 
+  void get_content_cache_stats(Promise<FileContentCache::Stats> promise);
+
   Result<string> get_suggested_file_name(FileId file_id, const string &directory);
 
   void read_file_part(FileId file_id, int64 offset, int64 count, int left_tries,
@@ -514,6 +528,8 @@ class FileManager final : public FileLoadManager::Callback {
   void external_file_generate_finish(int64 generation_id, Status status, Promise<> promise);
 
   Result<FileId> from_persistent_id(CSlice persistent_id, FileType file_type) TD_WARN_UNUSED_RESULT;
+  void get_memory_statistics(MemoryStatistics &statistics) const;
+
   FileView get_file_view(FileId file_id) const;
   FileView get_sync_file_view(FileId file_id);
   td_api::object_ptr<td_api::file> get_file_object(FileId file_id, bool with_main_file_id = true);
@@ -660,7 +676,8 @@ class FileManager final : public FileLoadManager::Callback {
   FileId register_pmc_file_data(FileData &&data);
 
   void download_impl(FileId file_id, std::shared_ptr<DownloadCallback> callback, int32 new_priority, int64 offset,
-                     int64 limit, Status check_status, Promise<td_api::object_ptr<td_api::file>> promise);
+                     int64 limit, bool use_read_ahead, Status check_status,
+                     Promise<td_api::object_ptr<td_api::file>> promise);
 
   Status check_local_location(FileNodePtr node, bool skip_file_size_checks);
   void on_failed_check_local_location(FileNodePtr node);
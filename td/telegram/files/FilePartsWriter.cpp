@@ -0,0 +1,94 @@
+//
+// Copyright Aliaksei Levin (levlam@telegram.org), Arseny Smirnov (arseny30@gmail.com) 2014-2024
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+#include "td/telegram/files/FilePartsWriter.h"
+
+#include "td/telegram/files/FileLoaderUtils.h"
+
+#include "td/utils/format.h"
+#include "td/utils/logging.h"
+#include "td/utils/port/IoSlice.h"
+#include "td/utils/Span.h"
+#include "td/utils/Time.h"
+
+namespace td {
+
+Status FilePartsWriter::add_part(FileFd &fd, int64 offset, BufferSlice part) {
+  if (part.empty()) {
+    return Status::OK();
+  }
+  if (!parts_.empty() && offset_ + size_ != offset) {
+    TRY_STATUS(flush(fd));
+  }
+  if (parts_.empty()) {
+    offset_ = offset;
+  }
+  size_ += static_cast<int64>(part.size());
+  parts_.push_back(std::move(part));
+  stats_.part_count++;
+  if (size_ >= MAX_PENDING_SIZE) {
+    return flush(fd);
+  }
+  return Status::OK();
+}
+
+Status FilePartsWriter::flush(FileFd &fd) {
+  if (parts_.empty()) {
+    return Status::OK();
+  }
+
+  auto start_time = Time::now();
+  size_t written = 0;
+  if (parts_.size() == 1) {
+    TRY_RESULT_ASSIGN(written, fd.pwrite(parts_[0].as_slice(), offset_));
+  } else {
+    vector<IoSlice> io_slices;
+    io_slices.reserve(parts_.size());
+    for (auto &part : parts_) {
+      io_slices.push_back(as_io_slice(part.as_slice()));
+    }
+    TRY_STATUS(fd.seek(offset_));
+    TRY_RESULT_ASSIGN(written, fd.writev(Span<IoSlice>(io_slices)));
+  }
+  stats_.write_count++;
+
+  // write the rest of the parts one by one, if some of them weren't fully written
+  int64 offset = offset_;
+  for (auto &part : parts_) {
+    auto part_size = part.size();
+    if (written >= part_size) {
+      written -= part_size;
+    } else {
+      auto slice = part.as_slice().substr(written);
+      TRY_RESULT(part_written, fd.pwrite(slice, offset + static_cast<int64>(written)));
+      stats_.write_count++;
+      if (part_written != slice.size()) {
+        return Status::Error("Failed to save file part to the file");
+      }
+      written = 0;
+    }
+    offset += static_cast<int64>(part_size);
+  }
+  VLOG(file_loader) << "Written " << size_ << " bytes from " << parts_.size() << " parts at offset " << offset_;
+
+  stats_.written_size += size_;
+  stats_.write_time += Time::now() - start_time;
+  clear();
+  return Status::OK();
+}
+
+void FilePartsWriter::clear() {
+  parts_.clear();
+  offset_ = 0;
+  size_ = 0;
+}
+
+StringBuilder &operator<<(StringBuilder &string_builder, const FilePartsWriter::Stats &stats) {
+  return string_builder << tag("parts", stats.part_count) << tag("writes", stats.write_count)
+                        << tag("size", format::as_size(stats.written_size)) << tag("time", stats.write_time);
+}
+
+}  // namespace td
@@ -0,0 +1,53 @@
+//
+// Copyright Aliaksei Levin (levlam@telegram.org), Arseny Smirnov (arseny30@gmail.com) 2014-2024
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+#pragma once
+
+#include "td/utils/buffer.h"
+#include "td/utils/common.h"
+#include "td/utils/port/FileFd.h"
+#include "td/utils/Status.h"
+#include "td/utils/StringBuilder.h"
+
+namespace td {
+
+// accumulates adjacent file parts to write them to the file with a single system call
+class FilePartsWriter {
+ public:
+  static constexpr int64 MAX_PENDING_SIZE = 4 << 20;
+
+  struct Stats {
+    int64 part_count = 0;
+    int64 write_count = 0;
+    int64 written_size = 0;
+    double write_time = 0.0;
+  };
+
+  // the part will be written to the file not later than the next call to flush
+  Status add_part(FileFd &fd, int64 offset, BufferSlice part) TD_WARN_UNUSED_RESULT;
+
+  Status flush(FileFd &fd) TD_WARN_UNUSED_RESULT;
+
+  bool empty() const {
+    return parts_.empty();
+  }
+
+  void clear();
+
+  const Stats &get_stats() const {
+    return stats_;
+  }
+
+ private:
+  vector<BufferSlice> parts_;
+  int64 offset_ = 0;
+  int64 size_ = 0;
+  Stats stats_;
+};
+
+StringBuilder &operator<<(StringBuilder &string_builder, const FilePartsWriter::Stats &stats);
+
+}  // namespace td
@@ -0,0 +1,94 @@
+//
+// Copyright Aliaksei Levin (levlam@telegram.org), Arseny Smirnov (arseny30@gmail.com) 2014-2024
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+#include "td/telegram/files/StreamingReadAhead.h"
+
+#include "td/utils/format.h"
+
+namespace td {
+
+double StreamingReadAhead::update_rate(double old_rate, double new_rate) {
+  if (old_rate <= 0.0) {
+    return new_rate;
+  }
+  return old_rate * (1 - RATE_SMOOTHING) + new_rate * RATE_SMOOTHING;
+}
+
+void StreamingReadAhead::on_read_offset(int64 offset, double now) {
+  if (read_offset_ < 0 || offset < read_offset_ || offset - read_offset_ > MAX_READ_AHEAD_SIZE) {
+    // seek; the read rate is expected to be the same after it
+    read_offset_ = offset;
+    read_time_ = now;
+    return;
+  }
+  auto passed_time = now - read_time_;
+  if (passed_time < MIN_SAMPLE_TIME) {
+    return;
+  }
+  read_rate_ = update_rate(read_rate_, static_cast<double>(offset - read_offset_) / passed_time);
+  read_offset_ = offset;
+  read_time_ = now;
+}
+
+void StreamingReadAhead::on_download_progress(int64 ready_size, double now) {
+  if (ready_size_ < 0 || ready_size < ready_size_) {
+    return on_download_start(ready_size, now);
+  }
+  auto passed_time = now - download_time_;
+  if (passed_time < MIN_SAMPLE_TIME) {
+    return;
+  }
+  download_rate_ = update_rate(download_rate_, static_cast<double>(ready_size - ready_size_) / passed_time);
+  ready_size_ = ready_size;
+  download_time_ = now;
+}
+
+void StreamingReadAhead::on_download_start(int64 ready_size, double now) {
+  ready_size_ = ready_size;
+  download_time_ = now;
+}
+
+int64 StreamingReadAhead::get_read_ahead_size() const {
+  if (read_rate_ <= 0.0) {
+    return 0;
+  }
+
+  // if the file is downloaded slower than it is read, stalls are inevitable,
+  // so buffer more to make them less frequent
+  auto buffer_time = BUFFER_TIME;
+  if (download_rate_ > 0.0 && download_rate_ < read_rate_) {
+    buffer_time *= min(MAX_BUFFER_TIME_MULTIPLIER, read_rate_ / download_rate_);
+  }
+  // the window must not be exhausted by the downloader faster than in MIN_DOWNLOAD_TIME,
+  // otherwise most time will be spent on restarting of the download
+  auto size = max(read_rate_ * buffer_time, download_rate_ * MIN_DOWNLOAD_TIME);
+  if (size >= static_cast<double>(MAX_READ_AHEAD_SIZE)) {
+    return MAX_READ_AHEAD_SIZE;
+  }
+  // round up to avoid updating the download limit on every small change of the rates
+  auto result = (static_cast<int64>(size) + MIN_READ_AHEAD_SIZE - 1) / MIN_READ_AHEAD_SIZE * MIN_READ_AHEAD_SIZE;
+  return max(result, MIN_READ_AHEAD_SIZE);
+}
+
+int64 StreamingReadAhead::get_download_limit(int64 download_offset, int64 client_limit) const {
+  if (client_limit != 0) {
+    return client_limit;
+  }
+  auto read_ahead_size = get_read_ahead_size();
+  if (read_ahead_size == 0) {
+    return 0;
+  }
+  return max(read_offset_ - download_offset, static_cast<int64>(0)) + read_ahead_size;
+}
+
+StringBuilder &operator<<(StringBuilder &string_builder, const StreamingReadAhead &read_ahead) {
+  return string_builder << "StreamingReadAhead[" << tag("read_offset", read_ahead.read_offset_)
+                        << tag("read_rate", format::as_size(static_cast<int64>(read_ahead.read_rate_)))
+                        << tag("download_rate", format::as_size(static_cast<int64>(read_ahead.download_rate_)))
+                        << tag("read_ahead", format::as_size(read_ahead.get_read_ahead_size())) << "]";
+}
+
+}  // namespace td
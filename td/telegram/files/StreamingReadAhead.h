@@ -0,0 +1,67 @@
+//
+// Copyright Aliaksei Levin (levlam@telegram.org), Arseny Smirnov (arseny30@gmail.com) 2014-2024
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+#pragma once
+
+#include "td/utils/common.h"
+#include "td/utils/StringBuilder.h"
+
+namespace td {
+
+// estimates read rate of a streaming consumer and download bandwidth of the file
+// to choose how much data must be downloaded ahead of the current read offset
+class StreamingReadAhead {
+ public:
+  static constexpr int64 MIN_READ_AHEAD_SIZE = 1 << 20;
+  static constexpr int64 MAX_READ_AHEAD_SIZE = 64 << 20;
+
+  // the consumer has moved to the given offset
+  void on_read_offset(int64 offset, double now);
+
+  // total number of downloaded bytes has changed
+  void on_download_progress(int64 ready_size, double now);
+
+  // a new download has been started; time spent without active download mustn't be counted
+  void on_download_start(int64 ready_size, double now);
+
+  // returns 0 if read rate is unknown yet
+  int64 get_read_ahead_size() const;
+
+  // returns the limit for a download from the given offset; an explicit limit set by the client is never changed,
+  // otherwise the download is limited to the read-ahead window after the current read offset, if the read rate is known
+  int64 get_download_limit(int64 download_offset, int64 client_limit) const;
+
+  double get_read_rate() const {
+    return read_rate_;
+  }
+
+  double get_download_rate() const {
+    return download_rate_;
+  }
+
+ private:
+  static constexpr double MIN_SAMPLE_TIME = 0.5;
+  static constexpr double RATE_SMOOTHING = 0.3;
+  static constexpr double BUFFER_TIME = 8.0;
+  static constexpr double MAX_BUFFER_TIME_MULTIPLIER = 4.0;
+  static constexpr double MIN_DOWNLOAD_TIME = 1.0;
+
+  int64 read_offset_ = -1;
+  double read_time_ = 0.0;
+  double read_rate_ = 0.0;
+
+  int64 ready_size_ = -1;
+  double download_time_ = 0.0;
+  double download_rate_ = 0.0;
+
+  static double update_rate(double old_rate, double new_rate);
+
+  friend StringBuilder &operator<<(StringBuilder &string_builder, const StreamingReadAhead &read_ahead);
+};
+
+StringBuilder &operator<<(StringBuilder &string_builder, const StreamingReadAhead &read_ahead);
+
+}  // namespace td
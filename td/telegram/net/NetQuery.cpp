@@ -171,4 +171,8 @@ StringBuilder &operator<<(StringBuilder &stream, const NetQueryPtr &net_query_pt
   return stream << *net_query_ptr;
 }
 
+bool use_tl_object_arena() {
+  return G()->use_tl_object_arena();
+}
+
 }  // namespace td
@@ -24,6 +24,7 @@
 #include "td/utils/Status.h"
 #include "td/utils/StringBuilder.h"
 #include "td/utils/tl_parsers.h"
+#include "td/utils/TlObjectArena.h"
 #include "td/utils/TsList.h"
 
 #include <atomic>
@@ -306,6 +307,8 @@ StringBuilder &operator<<(StringBuilder &stream, const NetQuery &net_query);
 
 StringBuilder &operator<<(StringBuilder &stream, const NetQueryPtr &net_query_ptr);
 
+bool use_tl_object_arena();
+
 inline void cancel_query(NetQueryRef &ref) {
   if (ref.empty()) {
     return;
@@ -316,6 +319,7 @@ inline void cancel_query(NetQueryRef &ref) {
 template <class T>
 Result<typename T::ReturnType> fetch_result(const BufferSlice &message) {
   TlBufferParser parser(&message);
+  TlObjectArena::Guard arena_guard(message.size(), use_tl_object_arena());
   auto result = T::fetch_result(parser);
   parser.fetch_end();
 
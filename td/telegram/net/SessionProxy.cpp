@@ -28,6 +28,7 @@
 #include "td/utils/Time.h"
 #include "td/utils/tl_helpers.h"
 #include "td/utils/tl_parsers.h"
+#include "td/utils/TlObjectArena.h"
 
 namespace td {
 
@@ -67,6 +68,7 @@ class SessionCallback final : public Session::Callback {
 
   void on_update(BufferSlice &&update, uint64 auth_key_id) final {
     TlBufferParser parser(&update);
+    TlObjectArena::Guard arena_guard(update.size(), G()->use_tl_object_arena());
     auto updates = telegram_api::Updates::fetch(parser);
     parser.fetch_end();
     if (parser.get_error()) {
@@ -11,8 +11,10 @@
 #include "td/utils/SliceBuilder.h"
 #include "td/utils/UInt.h"
 
+#include <cstddef>
 #include <cstdint>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 namespace td {
@@ -56,6 +58,11 @@ class TlFetchInt {
   static std::int32_t parse(ParserT &parser) {
     return parser.fetch_int();
   }
+
+  template <class ParserT>
+  static std::int32_t parse_unsafe(ParserT &parser) {
+    return parser.fetch_int_unsafe();
+  }
 };
 
 class TlFetchLong {
@@ -64,6 +71,11 @@ class TlFetchLong {
   static std::int64_t parse(ParserT &parser) {
     return parser.fetch_long();
   }
+
+  template <class ParserT>
+  static std::int64_t parse_unsafe(ParserT &parser) {
+    return parser.fetch_long_unsafe();
+  }
 };
 
 class TlFetchDouble {
@@ -72,6 +84,11 @@ class TlFetchDouble {
   static double parse(ParserT &parser) {
     return parser.fetch_double();
   }
+
+  template <class ParserT>
+  static double parse_unsafe(ParserT &parser) {
+    return parser.fetch_double_unsafe();
+  }
 };
 
 class TlFetchInt128 {
@@ -80,6 +97,11 @@ class TlFetchInt128 {
   static UInt128 parse(ParserT &parser) {
     return parser.template fetch_binary<UInt128>();
   }
+
+  template <class ParserT>
+  static UInt128 parse_unsafe(ParserT &parser) {
+    return parser.template fetch_binary_unsafe<UInt128>();
+  }
 };
 
 class TlFetchInt256 {
@@ -88,6 +110,11 @@ class TlFetchInt256 {
   static UInt256 parse(ParserT &parser) {
     return parser.template fetch_binary<UInt256>();
   }
+
+  template <class ParserT>
+  static UInt256 parse_unsafe(ParserT &parser) {
+    return parser.template fetch_binary_unsafe<UInt256>();
+  }
 };
 
 template <class T>
@@ -108,21 +135,73 @@ class TlFetchBytes {
   }
 };
 
+// size of values of fixed size, which can be fetched by Func::parse_unsafe after a check of the remaining length
+template <class Func>
+struct TlFetchFixedSize {
+  static constexpr std::size_t value = 0;
+};
+
+template <>
+struct TlFetchFixedSize<TlFetchInt> {
+  static constexpr std::size_t value = sizeof(std::int32_t);
+};
+
+template <>
+struct TlFetchFixedSize<TlFetchLong> {
+  static constexpr std::size_t value = sizeof(std::int64_t);
+};
+
+template <>
+struct TlFetchFixedSize<TlFetchDouble> {
+  static constexpr std::size_t value = sizeof(double);
+};
+
+template <>
+struct TlFetchFixedSize<TlFetchInt128> {
+  static constexpr std::size_t value = sizeof(UInt128);
+};
+
+template <>
+struct TlFetchFixedSize<TlFetchInt256> {
+  static constexpr std::size_t value = sizeof(UInt256);
+};
+
 template <class Func>
 class TlFetchVector {
+  using FixedSize = TlFetchFixedSize<Func>;
+
+  template <class ParserT, class T>
+  static void parse_elements(ParserT &parser, std::vector<T> &v, std::uint32_t multiplicity, std::false_type) {
+    if (parser.get_left_len() < multiplicity) {
+      parser.set_error("Wrong vector length");
+      return;
+    }
+    v.reserve(multiplicity);
+    for (std::uint32_t i = 0; i < multiplicity; i++) {
+      v.push_back(Func::parse(parser));
+    }
+  }
+
+  template <class ParserT, class T>
+  static void parse_elements(ParserT &parser, std::vector<T> &v, std::uint32_t multiplicity, std::true_type) {
+    // the length is checked once for all elements
+    if (parser.get_left_len() / FixedSize::value < multiplicity) {
+      parser.set_error("Wrong vector length");
+      return;
+    }
+    parser.check_len(multiplicity * FixedSize::value);
+    v.resize(multiplicity);
+    for (auto &value : v) {
+      value = Func::parse_unsafe(parser);
+    }
+  }
+
  public:
   template <class ParserT>
   static auto parse(ParserT &parser) -> std::vector<decltype(Func::parse(parser))> {
     const std::uint32_t multiplicity = parser.fetch_int();
     std::vector<decltype(Func::parse(parser))> v;
-    if (parser.get_left_len() < multiplicity) {
-      parser.set_error("Wrong vector length");
-    } else {
-      v.reserve(multiplicity);
-      for (std::uint32_t i = 0; i < multiplicity; i++) {
-        v.push_back(Func::parse(parser));
-      }
-    }
+    parse_elements(parser, v, multiplicity, std::integral_constant<bool, (FixedSize::value > 0)>());
     return v;
   }
 };
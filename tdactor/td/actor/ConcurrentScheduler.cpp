@@ -15,11 +15,14 @@
 
 namespace td {
 
-ConcurrentScheduler::ConcurrentScheduler(int32 additional_thread_count, uint64 thread_affinity_mask) {
+ConcurrentScheduler::ConcurrentScheduler(int32 additional_thread_count, uint64 thread_affinity_mask,
+                                         int32 on_demand_thread_count) {
 #if TD_THREAD_UNSUPPORTED || TD_EVENTFD_UNSUPPORTED
   additional_thread_count = 0;
+  on_demand_thread_count = 0;
 #endif
-  additional_thread_count++;
+  on_demand_thread_count_ = on_demand_thread_count;
+  additional_thread_count += on_demand_thread_count + 1;
   std::vector<std::shared_ptr<MpscPollableQueue<EventFull>>> outbound(additional_thread_count);
 #if !TD_THREAD_UNSUPPORTED && !TD_EVENTFD_UNSUPPORTED
   for (int32 i = 0; i < additional_thread_count; i++) {
@@ -28,6 +31,7 @@ ConcurrentScheduler::ConcurrentScheduler(int32 additional_thread_count, uint64 t
     outbound[i] = queue;
   }
   thread_affinity_mask_ = thread_affinity_mask;
+  is_on_demand_scheduler_started_.resize(on_demand_thread_count, false);
 #endif
 
   // +1 for extra scheduler for IOCP and send_closure from unrelated threads
@@ -73,6 +77,7 @@ void ConcurrentScheduler::test_one_thread_run() {
 #if !TD_THREAD_UNSUPPORTED
 thread::id ConcurrentScheduler::get_scheduler_thread_id(int32 sched_id) {
   auto thread_pos = static_cast<size_t>(sched_id - 1);
+  CHECK(thread_pos + on_demand_thread_count_ + extra_scheduler_ + 1 < schedulers_.size());
   CHECK(thread_pos < threads_.size());
   return threads_[thread_pos].get_id();
 }
@@ -82,23 +87,11 @@ void ConcurrentScheduler::start() {
   CHECK(state_ == State::Start);
   is_finished_.store(false, std::memory_order_relaxed);
 #if !TD_THREAD_UNSUPPORTED && !TD_EVENTFD_UNSUPPORTED
-  for (size_t i = 1; i + extra_scheduler_ < schedulers_.size(); i++) {
-    auto &sched = schedulers_[i];
-    threads_.push_back(td::thread([&, thread_affinity_mask = thread_affinity_mask_] {
-#if TD_PORT_WINDOWS
-      detail::Iocp::Guard iocp_guard(iocp_.get());
-#endif
-#if TD_HAVE_THREAD_AFFINITY
-      if (thread_affinity_mask != 0) {
-        thread::set_affinity_mask(this_thread::get_id(), thread_affinity_mask).ignore();
-      }
-#else
-      (void)thread_affinity_mask;
-#endif
-      while (!is_finished()) {
-        sched->run(Timestamp::in(10));
-      }
-    }));
+  {
+    std::lock_guard<std::mutex> lock(threads_mutex_);
+    for (size_t i = 1; i + extra_scheduler_ + on_demand_thread_count_ < schedulers_.size(); i++) {
+      threads_.push_back(create_scheduler_thread(schedulers_[i].get()));
+    }
   }
 #if TD_PORT_WINDOWS
   iocp_thread_ = td::thread([this] {
@@ -111,6 +104,51 @@ void ConcurrentScheduler::start() {
   state_ = State::Run;
 }
 
+#if !TD_THREAD_UNSUPPORTED && !TD_EVENTFD_UNSUPPORTED
+td::thread ConcurrentScheduler::create_scheduler_thread(Scheduler *sched) {
+  return td::thread([this, sched, thread_affinity_mask = thread_affinity_mask_] {
+#if TD_PORT_WINDOWS
+    detail::Iocp::Guard iocp_guard(iocp_.get());
+#endif
+#if TD_HAVE_THREAD_AFFINITY
+    if (thread_affinity_mask != 0) {
+      thread::set_affinity_mask(this_thread::get_id(), thread_affinity_mask).ignore();
+    }
+#else
+    (void)thread_affinity_mask;
+#endif
+    while (!is_finished()) {
+      sched->run(Timestamp::in(10));
+    }
+  });
+}
+#endif
+
+bool ConcurrentScheduler::start_on_demand_scheduler(int32 sched_id) {
+#if TD_THREAD_UNSUPPORTED || TD_EVENTFD_UNSUPPORTED
+  return sched_id == 0;
+#else
+  auto first_on_demand_sched_id = static_cast<int32>(schedulers_.size()) - extra_scheduler_ - on_demand_thread_count_;
+  if (sched_id < first_on_demand_sched_id) {
+    return sched_id >= 0;
+  }
+  if (sched_id >= first_on_demand_sched_id + on_demand_thread_count_) {
+    return sched_id < static_cast<int32>(schedulers_.size());
+  }
+  std::lock_guard<std::mutex> lock(threads_mutex_);
+  // threads must not be started after finish began to join them
+  if (is_finished()) {
+    return false;
+  }
+  auto pos = static_cast<size_t>(sched_id - first_on_demand_sched_id);
+  if (!is_on_demand_scheduler_started_[pos]) {
+    is_on_demand_scheduler_started_[pos] = true;
+    threads_.push_back(create_scheduler_thread(schedulers_[sched_id].get()));
+  }
+  return true;
+#endif
+}
+
 static TD_THREAD_LOCAL double emscripten_timeout;
 
 bool ConcurrentScheduler::run_main(Timestamp timeout) {
@@ -157,6 +195,7 @@ void ConcurrentScheduler::finish() {
   if (ExitGuard::is_exited()) {
 #if !TD_THREAD_UNSUPPORTED && !TD_EVENTFD_UNSUPPORTED
     // prevent closing of schedulers from already killed by OS threads
+    std::lock_guard<std::mutex> lock(threads_mutex_);
     for (auto &thread : threads_) {
       thread.detach();
     }
@@ -170,10 +209,13 @@ void ConcurrentScheduler::finish() {
   }
 
 #if !TD_THREAD_UNSUPPORTED && !TD_EVENTFD_UNSUPPORTED
-  for (auto &thread : threads_) {
-    thread.join();
+  {
+    std::lock_guard<std::mutex> lock(threads_mutex_);
+    for (auto &thread : threads_) {
+      thread.join();
+    }
+    threads_.clear();
   }
-  threads_.clear();
 #endif
 
 #if TD_PORT_WINDOWS
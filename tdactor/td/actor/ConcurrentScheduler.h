@@ -26,7 +26,10 @@ namespace td {
 
 class ConcurrentScheduler final : private Scheduler::Callback {
  public:
-  explicit ConcurrentScheduler(int32 additional_thread_count, uint64 thread_affinity_mask = 0);
+  // threads of on_demand_thread_count schedulers after the additional ones are started only when
+  // Scheduler::start_on_demand_scheduler is called for them
+  explicit ConcurrentScheduler(int32 additional_thread_count, uint64 thread_affinity_mask = 0,
+                               int32 on_demand_thread_count = 0);
 
   void finish_async() {
     schedulers_[0]->finish();
@@ -99,7 +102,9 @@ class ConcurrentScheduler final : private Scheduler::Callback {
   vector<unique_ptr<Scheduler>> schedulers_;
   std::atomic<bool> is_finished_{false};
 #if !TD_THREAD_UNSUPPORTED && !TD_EVENTFD_UNSUPPORTED
-  vector<td::thread> threads_;
+  std::mutex threads_mutex_;
+  vector<td::thread> threads_;  // threads of on-demand schedulers follow threads of other schedulers
+  vector<bool> is_on_demand_scheduler_started_;
   uint64 thread_affinity_mask_ = 0;
 #endif
 #if TD_PORT_WINDOWS
@@ -107,10 +112,17 @@ class ConcurrentScheduler final : private Scheduler::Callback {
   td::thread iocp_thread_;
 #endif
   int32 extra_scheduler_ = 0;
+  int32 on_demand_thread_count_ = 0;
 
   void on_finish() final;
 
   void register_at_finish(std::function<void()> f) final;
+
+  bool start_on_demand_scheduler(int32 sched_id) final;
+
+#if !TD_THREAD_UNSUPPORTED && !TD_EVENTFD_UNSUPPORTED
+  td::thread create_scheduler_thread(Scheduler *sched);
+#endif
 };
 
 }  // namespace td
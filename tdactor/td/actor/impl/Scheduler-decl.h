@@ -68,6 +68,7 @@ class Scheduler {
     virtual ~Callback() = default;
     virtual void on_finish() = 0;
     virtual void register_at_finish(std::function<void()>) = 0;
+    virtual bool start_on_demand_scheduler(int32 sched_id) = 0;
   };
   Scheduler() = default;
   Scheduler(const Scheduler &) = delete;
@@ -81,6 +82,9 @@ class Scheduler {
   int32 sched_id() const;
   int32 sched_count() const;
 
+  // returns true if the scheduler sched_id is run, starting its thread if the scheduler is run on demand
+  bool start_on_demand_scheduler(int32 sched_id);
+
   template <class ActorT, class... Args>
   TD_WARN_UNUSED_RESULT ActorOwn<ActorT> create_actor(Slice name, Args &&...args);
   template <class ActorT, class... Args>
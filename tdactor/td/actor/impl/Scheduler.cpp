@@ -233,6 +233,13 @@ void Scheduler::init(int32 id, std::vector<std::shared_ptr<MpscPollableQueue<Eve
   register_actor(PSLICE() << "ServiceActor" << id, &service_actor_).release();
 }
 
+bool Scheduler::start_on_demand_scheduler(int32 sched_id) {
+  if (sched_id == sched_id_) {
+    return true;
+  }
+  return callback_ != nullptr && callback_->start_on_demand_scheduler(sched_id);
+}
+
 void Scheduler::clear() {
   if (service_actor_.empty()) {
     return;
@@ -0,0 +1,281 @@
+//
+// Copyright Aliaksei Levin (levlam@telegram.org), Arseny Smirnov (arseny30@gmail.com) 2014-2024
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+#include "td/db/DbTrace.h"
+
+#include "td/utils/crypto.h"
+#include "td/utils/filesystem.h"
+#include "td/utils/FlatHashMap.h"
+#include "td/utils/logging.h"
+#include "td/utils/misc.h"
+#include "td/utils/port/FileFd.h"
+#include "td/utils/port/Mutex.h"
+#include "td/utils/Random.h"
+#include "td/utils/Time.h"
+#include "td/utils/tl_parsers.h"
+
+namespace td {
+
+namespace {
+
+constexpr int32 TRACE_MAGIC = 0x32544244;
+constexpr size_t WRITE_BUFFER_SIZE = 1 << 16;
+
+// an event as it is stored in the trace file; a query text is stored only with the first event with the query
+struct DbTraceRecord {
+  DbTraceEvent event;
+  int32 query_id = 0;
+  bool has_query_text = false;
+
+  template <class StorerT>
+  void store(StorerT &storer) const {
+    td::store(event.type, storer);
+    td::store(event.time, storer);
+    td::store(event.duration, storer);
+    switch (event.type) {
+      case DbTraceEvent::Type::Exec:
+      case DbTraceEvent::Type::Query:
+        td::store(event.connection_id, storer);
+        td::store(query_id, storer);
+        td::store(has_query_text, storer);
+        if (has_query_text) {
+          td::store(event.query, storer);
+        }
+        if (event.type == DbTraceEvent::Type::Query) {
+          td::store(event.values, storer);
+          td::store(event.row_count, storer);
+        }
+        break;
+      case DbTraceEvent::Type::BinlogEvent:
+        td::store(event.binlog_event_id, storer);
+        td::store(event.binlog_event_type, storer);
+        td::store(event.binlog_event_flags, storer);
+        td::store(event.size, storer);
+        break;
+      case DbTraceEvent::Type::BinlogSync:
+        break;
+      default:
+        UNREACHABLE();
+    }
+  }
+
+  template <class ParserT>
+  void parse(ParserT &parser) {
+    td::parse(event.type, parser);
+    td::parse(event.time, parser);
+    td::parse(event.duration, parser);
+    switch (event.type) {
+      case DbTraceEvent::Type::Exec:
+      case DbTraceEvent::Type::Query:
+        td::parse(event.connection_id, parser);
+        td::parse(query_id, parser);
+        td::parse(has_query_text, parser);
+        if (has_query_text) {
+          td::parse(event.query, parser);
+        }
+        if (event.type == DbTraceEvent::Type::Query) {
+          td::parse(event.values, parser);
+          td::parse(event.row_count, parser);
+        }
+        break;
+      case DbTraceEvent::Type::BinlogEvent:
+        td::parse(event.binlog_event_id, parser);
+        td::parse(event.binlog_event_type, parser);
+        td::parse(event.binlog_event_flags, parser);
+        td::parse(event.size, parser);
+        break;
+      case DbTraceEvent::Type::BinlogSync:
+        break;
+      default:
+        parser.set_error("Invalid event type");
+    }
+  }
+};
+
+}  // namespace
+
+constexpr size_t DbTraceValue::MAX_DATA_SIZE;
+constexpr size_t DbTraceValue::HASH_SIZE;
+
+DbTraceValue DbTraceValue::integer_value(int64 value) {
+  DbTraceValue result;
+  result.type = Type::Integer;
+  result.integer = value;
+  return result;
+}
+
+DbTraceValue DbTraceValue::text_value(Slice text) {
+  DbTraceValue result;
+  result.type = Type::Text;
+  result.integer = static_cast<int64>(text.size());
+  if (text.size() <= MAX_DATA_SIZE) {
+    result.data = text.str();
+  }
+  return result;
+}
+
+DbTraceValue DbTraceValue::blob_value(Slice blob) {
+  auto result = text_value(blob);
+  result.type = Type::Blob;
+  return result;
+}
+
+class DbTrace::Writer {
+ public:
+  Status start(CSlice path) {
+    auto guard = mutex_.lock();
+    do_stop();
+    TRY_RESULT_ASSIGN(fd_, FileFd::open(path, FileFd::Create | FileFd::Truncate | FileFd::Write));
+    start_time_ = Time::now();
+    hash_key_ = string(32, '\0');
+    Random::secure_bytes(hash_key_);
+    buffer_ = serialize(TRACE_MAGIC);
+    return Status::OK();
+  }
+
+  void stop() {
+    auto guard = mutex_.lock();
+    do_stop();
+  }
+
+  void add_event(DbTraceEvent &&event) {
+    auto guard = mutex_.lock();
+    if (fd_.empty()) {
+      return;
+    }
+
+    DbTraceRecord record;
+    if (event.type == DbTraceEvent::Type::Exec || event.type == DbTraceEvent::Type::Query) {
+      auto &query_id = query_ids_[event.query];
+      if (query_id == 0) {
+        query_id = narrow_cast<int32>(query_ids_.size());
+        record.has_query_text = true;
+      }
+      record.query_id = query_id;
+    }
+    for (auto &value : event.values) {
+      if (!value.data.empty()) {
+        value.data = get_value_hash(value.data);
+      }
+    }
+    event.time -= start_time_;
+    record.event = std::move(event);
+
+    auto data = serialize(record);
+    buffer_ += serialize(narrow_cast<int32>(data.size()));
+    buffer_ += data;
+    if (buffer_.size() >= WRITE_BUFFER_SIZE) {
+      flush();
+    }
+  }
+
+ private:
+  Mutex mutex_;
+  FileFd fd_;
+  double start_time_ = 0.0;
+  FlatHashMap<string, int32> query_ids_;
+  string hash_key_;
+  string buffer_;
+
+  string get_value_hash(Slice value) const {
+    string hash(32, '\0');
+    hmac_sha256(hash_key_, value, hash);
+    hash.resize(DbTraceValue::HASH_SIZE);
+    return hash;
+  }
+
+  void flush() {
+    Slice data = buffer_;
+    while (!data.empty()) {
+      auto r_size = fd_.write(data);
+      if (r_size.is_error()) {
+        LOG(ERROR) << "Failed to write database trace: " << r_size.error();
+        break;
+      }
+      data.remove_prefix(r_size.ok());
+    }
+    buffer_.clear();
+  }
+
+  void do_stop() {
+    if (fd_.empty()) {
+      return;
+    }
+    flush();
+    fd_.close();
+    query_ids_.clear();
+    hash_key_.clear();
+  }
+};
+
+DbTrace::DbTrace() : writer_(make_unique<Writer>()) {
+}
+
+DbTrace::~DbTrace() {
+  stop();
+}
+
+Status DbTrace::start(CSlice path) {
+  TRY_STATUS(writer_->start(path));
+  is_enabled_.store(true, std::memory_order_relaxed);
+  return Status::OK();
+}
+
+void DbTrace::stop() {
+  is_enabled_.store(false, std::memory_order_relaxed);
+  writer_->stop();
+}
+
+int32 DbTrace::add_connection() {
+  return connection_count_.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+void DbTrace::add_event(DbTraceEvent &&event) {
+  writer_->add_event(std::move(event));
+}
+
+Result<vector<DbTraceEvent>> DbTrace::read(CSlice path) {
+  TRY_RESULT(data, read_file_str(path));
+  TlParser parser(data);
+  if (parser.fetch_int() != TRACE_MAGIC) {
+    return Status::Error("Wrong database trace file format");
+  }
+
+  vector<string> queries(1);
+  vector<DbTraceEvent> events;
+  while (parser.get_left_len() > 0 && parser.get_error() == nullptr) {
+    auto size = parser.fetch_int();
+    auto record_data = parser.fetch_string_raw<Slice>(static_cast<size_t>(max(size, 0)));
+    if (parser.get_error() != nullptr) {
+      break;
+    }
+
+    DbTraceRecord record;
+    TRY_STATUS(unserialize(record, record_data));
+    auto &event = record.event;
+    if (event.type == DbTraceEvent::Type::Exec || event.type == DbTraceEvent::Type::Query) {
+      if (record.has_query_text) {
+        if (static_cast<size_t>(record.query_id) != queries.size()) {
+          return Status::Error("Wrong query identifier in database trace");
+        }
+        queries.push_back(event.query);
+      } else {
+        if (record.query_id <= 0 || static_cast<size_t>(record.query_id) >= queries.size()) {
+          return Status::Error("Unknown query in database trace");
+        }
+        event.query = queries[record.query_id];
+      }
+    }
+    events.push_back(std::move(event));
+  }
+  if (parser.get_error() != nullptr) {
+    // the last event could be written partially if the process was killed
+    LOG(WARNING) << "Database trace is truncated: " << parser.get_status();
+  }
+  return std::move(events);
+}
+
+}  // namespace td
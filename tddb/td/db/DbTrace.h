@@ -0,0 +1,109 @@
+//
+// Copyright Aliaksei Levin (levlam@telegram.org), Arseny Smirnov (arseny30@gmail.com) 2014-2024
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+#pragma once
+
+#include "td/utils/common.h"
+#include "td/utils/Slice.h"
+#include "td/utils/Status.h"
+#include "td/utils/tl_helpers.h"
+
+#include <atomic>
+
+namespace td {
+
+struct DbTraceValue {
+  enum class Type : int32 { Null, Integer, Text, Blob };
+  Type type = Type::Null;
+  int64 integer = 0;  // the value of an integer or the size of a text or a blob
+  string data;        // a keyed hash of the text or the blob if it isn't empty or longer than MAX_DATA_SIZE
+
+  // longer values are likely to be data and not keys, so only their size is recorded
+  static constexpr size_t MAX_DATA_SIZE = 64;
+  static constexpr size_t HASH_SIZE = 8;
+
+  static DbTraceValue integer_value(int64 value);
+
+  static DbTraceValue text_value(Slice text);
+
+  static DbTraceValue blob_value(Slice blob);
+
+  template <class StorerT>
+  void store(StorerT &storer) const {
+    td::store(type, storer);
+    td::store(integer, storer);
+    td::store(data, storer);
+  }
+
+  template <class ParserT>
+  void parse(ParserT &parser) {
+    td::parse(type, parser);
+    td::parse(integer, parser);
+    td::parse(data, parser);
+  }
+};
+
+struct DbTraceEvent {
+  enum class Type : int32 { Exec, Query, BinlogEvent, BinlogSync };
+  Type type = Type::Exec;
+  double time = 0.0;  // the time since the start of the trace
+  double duration = 0.0;
+  int32 connection_id = 0;  // the SQLite connection, which executed the operation; 0 for binlog events
+
+  // SQLite commands and queries
+  string query;
+  vector<DbTraceValue> values;
+  int32 row_count = 0;
+
+  // binlog events
+  uint64 binlog_event_id = 0;
+  int32 binlog_event_type = 0;
+  int32 binlog_event_flags = 0;
+  int64 size = 0;
+};
+
+// Records database operations of a client to a trace file, which can be replayed by benchmark/bench_db_replay
+// against a fresh database. The trace is shared by the binlog and all SQLite connections of the client, which are
+// registered with it, so operations of other clients in the same process aren't recorded.
+// Texts and blobs are never recorded. Short values, which are likely to be keys, are replaced with their HMAC
+// with a random key, which is generated for each trace and is never saved, so equal values can be matched only within
+// the trace. Only sizes of longer values are recorded. Integers are recorded as is, because they are needed to replay
+// range queries.
+class DbTrace {
+ public:
+  DbTrace();
+  DbTrace(const DbTrace &) = delete;
+  DbTrace &operator=(const DbTrace &) = delete;
+  DbTrace(DbTrace &&) = delete;
+  DbTrace &operator=(DbTrace &&) = delete;
+  ~DbTrace();
+
+  bool is_enabled() const {
+    return is_enabled_.load(std::memory_order_relaxed);
+  }
+
+  Status start(CSlice path) TD_WARN_UNUSED_RESULT;
+
+  void stop();
+
+  // returns a new identifier for a SQLite connection; operations of different connections are replayed
+  // on different connections
+  int32 add_connection();
+
+  // time must be a value returned by Time::now(); it is replaced with the time since the start of the trace
+  void add_event(DbTraceEvent &&event);
+
+  static Result<vector<DbTraceEvent>> read(CSlice path) TD_WARN_UNUSED_RESULT;
+
+ private:
+  class Writer;
+
+  std::atomic<bool> is_enabled_{false};
+  std::atomic<int32> connection_count_{0};
+  unique_ptr<Writer> writer_;
+};
+
+}  // namespace td
@@ -0,0 +1,295 @@
+//
+// Copyright Aliaksei Levin (levlam@telegram.org), Arseny Smirnov (arseny30@gmail.com) 2014-2024
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+#include "td/db/SqliteBlobCompressor.h"
+
+#include "td/utils/algorithm.h"
+#include "td/utils/as.h"
+#include "td/utils/crypto.h"
+#include "td/utils/HashMap.h"
+#include "td/utils/logging.h"
+#include "td/utils/misc.h"
+#include "td/utils/ScopeGuard.h"
+
+#include <algorithm>
+#include <cstring>
+#include <queue>
+
+namespace td {
+
+namespace {
+
+// "TDZ2"; the last character is the version of the format
+constexpr int32 COMPRESSED_BLOB_MAGIC = 0x325a4454;
+
+// the magic, the dictionary identifier, the size and the CRC32 of the original blob
+constexpr size_t COMPRESSED_BLOB_HEADER_SIZE = 16;
+
+// decompression of smaller blobs costs more than their loading from the page cache, and they shrink less
+constexpr size_t MIN_COMPRESSED_BLOB_SIZE = 512;
+
+constexpr size_t DICTIONARY_KMER_SIZE = 8;
+constexpr size_t DICTIONARY_SEGMENT_SIZE = 64;
+constexpr size_t DICTIONARY_SEGMENT_STEP = 16;
+
+uint64 get_kmer(Slice data, size_t pos) {
+  uint64 kmer;
+  std::memcpy(&kmer, data.data() + pos, sizeof(kmer));
+  return kmer;
+}
+
+vector<uint64> get_distinct_kmers(Slice data) {
+  vector<uint64> kmers;
+  for (size_t pos = 0; pos + DICTIONARY_KMER_SIZE <= data.size(); pos++) {
+    kmers.push_back(get_kmer(data, pos));
+  }
+  std::sort(kmers.begin(), kmers.end());
+  kmers.erase(std::unique(kmers.begin(), kmers.end()), kmers.end());
+  return kmers;
+}
+
+}  // namespace
+
+constexpr size_t SqliteBlobCompressor::MAX_DICTIONARY_SIZE;
+constexpr size_t SqliteBlobCompressor::TRAINING_SAMPLE_COUNT;
+
+Status SqliteBlobCompressor::init_db(SqliteDb &db) {
+  return db.exec("CREATE TABLE IF NOT EXISTS blob_dictionaries (id INTEGER PRIMARY KEY, name TEXT, data BLOB)");
+}
+
+Status SqliteBlobCompressor::init(SqliteDb db, string name, const std::atomic<bool> *is_enabled) {
+  CHECK(is_enabled != nullptr);
+  is_enabled_ = is_enabled;
+  db_ = std::move(db);
+  name_ = std::move(name);
+  TRY_RESULT_ASSIGN(get_dictionaries_stmt_, db_.get_statement("SELECT id, name, data FROM blob_dictionaries"));
+  TRY_RESULT_ASSIGN(add_dictionary_stmt_,
+                    db_.get_statement("INSERT INTO blob_dictionaries (name, data) VALUES (?1, ?2)"));
+  return load_dictionaries();
+}
+
+Status SqliteBlobCompressor::load_dictionaries() {
+  SCOPE_EXIT {
+    get_dictionaries_stmt_.reset();
+  };
+  TRY_STATUS(get_dictionaries_stmt_.step());
+  while (get_dictionaries_stmt_.has_row()) {
+    auto id = get_dictionaries_stmt_.view_int32(0);
+    if (dictionaries_.count(id) == 0) {
+      dictionaries_[id] = get_dictionaries_stmt_.view_blob(2).str();
+    }
+    if (get_dictionaries_stmt_.view_string(1) == name_ && id > dictionary_id_) {
+      dictionary_id_ = id;
+    }
+    TRY_STATUS(get_dictionaries_stmt_.step());
+  }
+  return Status::OK();
+}
+
+#if TD_HAVE_ZLIB
+Status SqliteBlobCompressor::restart_gzip(Gzip &gzip, Gzip::Mode mode) {
+  if (gzip.reset().is_error()) {
+    gzip = Gzip();
+    gzip.set_is_reusable(true);
+    // the dictionary is specified in the blob header, so raw streams are used to avoid checking of its checksum;
+    // fixed codes are used, because building of code tables dominates decompression time of small blobs
+    gzip.set_is_raw(true);
+    gzip.set_use_fixed_codes(true);
+    TRY_STATUS(gzip.init(mode));
+  }
+  return Status::OK();
+}
+#endif
+
+Slice SqliteBlobCompressor::compress(Slice data) {
+#if TD_HAVE_ZLIB
+  if (!is_enabled_->load(std::memory_order_relaxed) || data.size() < MIN_COMPRESSED_BLOB_SIZE) {
+    return data;
+  }
+  if (dictionary_id_ == 0) {
+    on_sample(data);
+  }
+
+  // blobs are compressed without a dictionary until it is trained
+  Slice dictionary;
+  if (dictionary_id_ != 0) {
+    dictionary = dictionaries_[dictionary_id_];
+  }
+  if (restart_gzip(encoder_, Gzip::Mode::Encode).is_error() || encoder_.set_dictionary(dictionary).is_error()) {
+    return data;
+  }
+
+  // the compressed blob must be smaller than the original
+  buffer_.resize(data.size() - 1);
+  encoder_.set_input(data);
+  encoder_.close_input();
+  encoder_.set_output(MutableSlice(buffer_).substr(COMPRESSED_BLOB_HEADER_SIZE));
+  auto r_state = encoder_.run();
+  if (r_state.is_error() || r_state.ok() != Gzip::State::Done) {
+    return data;
+  }
+  buffer_.resize(COMPRESSED_BLOB_HEADER_SIZE + encoder_.used_output());
+
+  auto header = MutableSlice(buffer_);
+  as<int32>(header.begin()) = COMPRESSED_BLOB_MAGIC;
+  as<int32>(header.begin() + 4) = dictionary_id_;
+  as<int32>(header.begin() + 8) = narrow_cast<int32>(data.size());
+  as<uint32>(header.begin() + 12) = crc32(data);
+  return buffer_;
+#else
+  return data;
+#endif
+}
+
+BufferSlice SqliteBlobCompressor::decompress(Slice data) {
+#if TD_HAVE_ZLIB
+  if (data.size() <= COMPRESSED_BLOB_HEADER_SIZE || as<int32>(data.begin()) != COMPRESSED_BLOB_MAGIC) {
+    return BufferSlice(data);
+  }
+  auto dictionary_id = as<int32>(data.begin() + 4);
+  auto size = as<int32>(data.begin() + 8);
+  auto crc = as<uint32>(data.begin() + 12);
+  // deflate can't compress data more than 1032 times
+  if (size < static_cast<int32>(MIN_COMPRESSED_BLOB_SIZE) || static_cast<size_t>(size) / 1032 > data.size()) {
+    return BufferSlice(data);
+  }
+
+  Slice dictionary;
+  if (dictionary_id != 0) {
+    auto it = dictionaries_.find(dictionary_id);
+    if (it == dictionaries_.end()) {
+      // the dictionary could have been added by another connection
+      auto status = load_dictionaries();
+      if (status.is_error()) {
+        LOG(ERROR) << "Failed to load blob dictionaries: " << status;
+      }
+      it = dictionaries_.find(dictionary_id);
+    }
+    if (it == dictionaries_.end()) {
+      LOG(ERROR) << "Can't find blob dictionary " << dictionary_id;
+      return BufferSlice(data);
+    }
+    dictionary = it->second;
+  }
+
+  auto status = restart_gzip(decoder_, Gzip::Mode::Decode);
+  if (status.is_ok()) {
+    status = decoder_.set_dictionary(dictionary);
+  }
+  if (status.is_error()) {
+    LOG(ERROR) << "Failed to initialize blob decompression: " << status;
+    return BufferSlice(data);
+  }
+
+  BufferSlice result(static_cast<size_t>(size));
+  decoder_.set_input(data.substr(COMPRESSED_BLOB_HEADER_SIZE));
+  decoder_.close_input();
+  decoder_.set_output(result.as_mutable_slice());
+  auto r_state = decoder_.run();
+  if (r_state.is_error() || r_state.ok() != Gzip::State::Done || decoder_.left_output() != 0 ||
+      crc32(result.as_slice()) != crc) {
+    // an uncompressed blob, which accidentally begins with the magic
+    return BufferSlice(data);
+  }
+  return result;
+#else
+  return BufferSlice(data);
+#endif
+}
+
+void SqliteBlobCompressor::on_sample(Slice data) {
+  samples_.push_back(data.str());
+  if (samples_.size() < TRAINING_SAMPLE_COUNT) {
+    return;
+  }
+
+  auto dictionary = train_dictionary(samples_, MAX_DICTIONARY_SIZE);
+  reset_to_empty(samples_);
+  LOG(INFO) << "Trained blob dictionary of size " << dictionary.size() << " for " << name_;
+
+  SCOPE_EXIT {
+    add_dictionary_stmt_.reset();
+  };
+  add_dictionary_stmt_.bind_string(1, name_).ensure();
+  add_dictionary_stmt_.bind_blob(2, dictionary).ensure();
+  auto status = add_dictionary_stmt_.step();
+  if (status.is_ok()) {
+    status = load_dictionaries();
+  }
+  if (status.is_error()) {
+    LOG(ERROR) << "Failed to save blob dictionary: " << status;
+  }
+}
+
+string SqliteBlobCompressor::train_dictionary(const vector<string> &samples, size_t max_size) {
+  // the number of samples, which contain the k-mer
+  HashMap<uint64, int32> frequencies;
+  for (auto &sample : samples) {
+    for (auto kmer : get_distinct_kmers(sample)) {
+      frequencies[kmer]++;
+    }
+  }
+
+  // the score of a segment is the total frequency of its k-mers, which aren't in the dictionary yet
+  auto get_score = [&frequencies](Slice segment) {
+    int64 score = 0;
+    for (auto kmer : get_distinct_kmers(segment)) {
+      auto frequency = frequencies[kmer];
+      if (frequency > 1) {
+        score += frequency;
+      }
+    }
+    return score;
+  };
+
+  struct Segment {
+    int64 score;
+    Slice data;
+
+    bool operator<(const Segment &other) const {
+      return score < other.score;
+    }
+  };
+  std::priority_queue<Segment> segments;
+  for (auto &sample : samples) {
+    for (size_t pos = 0; pos + DICTIONARY_SEGMENT_SIZE <= sample.size(); pos += DICTIONARY_SEGMENT_STEP) {
+      Slice segment(sample.data() + pos, DICTIONARY_SEGMENT_SIZE);
+      segments.push(Segment{get_score(segment), segment});
+    }
+  }
+
+  // scores can only decrease, so a segment is chosen if its updated score is still the best
+  vector<Slice> chosen_segments;
+  size_t total_size = 0;
+  while (!segments.empty() && total_size + DICTIONARY_SEGMENT_SIZE <= max_size) {
+    auto segment = segments.top();
+    segments.pop();
+    auto score = get_score(segment.data);
+    if (score == 0) {
+      continue;
+    }
+    if (score < segment.score) {
+      segment.score = score;
+      segments.push(segment);
+      continue;
+    }
+    chosen_segments.push_back(segment.data);
+    total_size += segment.data.size();
+    for (auto kmer : get_distinct_kmers(segment.data)) {
+      frequencies[kmer] = 0;
+    }
+  }
+
+  // zlib finds matches with the end of the dictionary faster, so the best segments are placed last
+  string result;
+  result.reserve(total_size);
+  for (auto it = chosen_segments.rbegin(); it != chosen_segments.rend(); ++it) {
+    result.append(it->data(), it->size());
+  }
+  return result;
+}
+
+}  // namespace td
@@ -0,0 +1,77 @@
+//
+// Copyright Aliaksei Levin (levlam@telegram.org), Arseny Smirnov (arseny30@gmail.com) 2014-2024
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+#pragma once
+
+#include "td/db/SqliteDb.h"
+#include "td/db/SqliteStatement.h"
+
+#include "td/utils/buffer.h"
+#include "td/utils/common.h"
+#include "td/utils/FlatHashMap.h"
+#include "td/utils/Gzip.h"
+#include "td/utils/Slice.h"
+#include "td/utils/Status.h"
+
+#include <atomic>
+
+namespace td {
+
+// Compresses blobs stored in an SQLite database with zlib and a preset dictionary, which is trained on the first
+// blobs of the same kind and is stored in the table blob_dictionaries of the database.
+// Compressed blobs begin with a versioned header, so uncompressed blobs, including the ones stored
+// before compression was enabled, remain readable. Each connection must have its own instance.
+class SqliteBlobCompressor {
+ public:
+  // larger dictionaries give little gain, but slow down compression and decompression of each blob
+  static constexpr size_t MAX_DICTIONARY_SIZE = 1 << 14;
+
+  static constexpr size_t TRAINING_SAMPLE_COUNT = 1000;
+
+  // creates the table for dictionaries; must be called inside a transaction
+  static Status init_db(SqliteDb &db) TD_WARN_UNUSED_RESULT;
+
+  SqliteBlobCompressor() = default;
+
+  // name identifies the kind of blobs, for which a separate dictionary is trained;
+  // blobs are compressed only while is_enabled is true, but they are decompressed regardless;
+  // is_enabled is usually shared by all connections to the database and must outlive the compressor
+  Status init(SqliteDb db, string name, const std::atomic<bool> *is_enabled) TD_WARN_UNUSED_RESULT;
+
+  // returns the blob to store; the result is valid until the next call
+  // must be called inside a write transaction, because the trained dictionary is saved to the database
+  Slice compress(Slice data);
+
+  // returns the original blob
+  BufferSlice decompress(Slice data);
+
+  // builds a dictionary from substrings, which are frequent in the samples
+  static string train_dictionary(const vector<string> &samples, size_t max_size);
+
+ private:
+  const std::atomic<bool> *is_enabled_ = nullptr;
+  SqliteDb db_;
+  string name_;
+  SqliteStatement get_dictionaries_stmt_;
+  SqliteStatement add_dictionary_stmt_;
+  FlatHashMap<int32, string> dictionaries_;
+  int32 dictionary_id_ = 0;
+  vector<string> samples_;
+  string buffer_;
+#if TD_HAVE_ZLIB
+  // zlib streams are reused, because their initialization is much slower than compression of a small blob
+  Gzip encoder_;
+  Gzip decoder_;
+
+  static Status restart_gzip(Gzip &gzip, Gzip::Mode mode);
+#endif
+
+  Status load_dictionaries();
+
+  void on_sample(Slice data);
+};
+
+}  // namespace td
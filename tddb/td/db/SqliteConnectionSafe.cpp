@@ -9,13 +9,15 @@
 #include "td/utils/common.h"
 #include "td/utils/format.h"
 #include "td/utils/logging.h"
+#include "td/utils/SliceBuilder.h"
 
 namespace td {
 
-SqliteConnectionSafe::SqliteConnectionSafe(string path, DbKey key, optional<int32> cipher_version)
+SqliteConnectionSafe::SqliteConnectionSafe(string path, DbKey key, optional<int32> cipher_version,
+                                           SqliteConnectionSettings settings)
     : path_(std::move(path))
     , lsls_connection_([path = path_, close_state_ptr = &close_state_, key = std::move(key),
-                        cipher_version = std::move(cipher_version)] {
+                        cipher_version = std::move(cipher_version), settings] {
       auto r_db = SqliteDb::open_with_key(path, false, key, cipher_version.copy());
       if (r_db.is_error()) {
         LOG(FATAL) << "Can't open database in state " << close_state_ptr->load() << ": " << r_db.error().message();
@@ -23,10 +25,30 @@ SqliteConnectionSafe::SqliteConnectionSafe(string path, DbKey key, optional<int3
       auto db = r_db.move_as_ok();
       db.exec("PRAGMA journal_mode=WAL").ensure();
       db.exec("PRAGMA secure_delete=1").ensure();
+      init_connection(db, settings).ensure();
       return db;
     }) {
 }
 
+Status SqliteConnectionSafe::init_connection(SqliteDb &db, const SqliteConnectionSettings &settings) {
+  if (settings.trace != nullptr) {
+    db.set_trace(settings.trace);
+  }
+  if (settings.disable_auto_checkpoint) {
+    TRY_STATUS(db.exec("PRAGMA wal_autocheckpoint=0"));
+  }
+  if (settings.journal_size_limit >= 0) {
+    TRY_STATUS(db.exec(PSLICE() << "PRAGMA journal_size_limit=" << settings.journal_size_limit));
+  }
+  if (settings.cache_size > 0) {
+    TRY_STATUS(db.exec(PSLICE() << "PRAGMA cache_size=-" << (settings.cache_size >> 10)));
+  }
+  if (settings.mmap_size > 0) {
+    TRY_STATUS(db.exec(PSLICE() << "PRAGMA mmap_size=" << settings.mmap_size));
+  }
+  return Status::OK();
+}
+
 void SqliteConnectionSafe::set(SqliteDb &&db) {
   lsls_connection_.set(std::move(db));
 }
@@ -7,21 +7,38 @@
 #pragma once
 
 #include "td/db/DbKey.h"
+#include "td/db/DbTrace.h"
 #include "td/db/SqliteDb.h"
 
 #include "td/actor/SchedulerLocalStorage.h"
 
 #include "td/utils/common.h"
 #include "td/utils/optional.h"
+#include "td/utils/Status.h"
 
 #include <atomic>
+#include <memory>
 
 namespace td {
 
+// settings, which are applied to every connection to the database
+struct SqliteConnectionSettings {
+  int64 cache_size = 0;           // size of the page cache in bytes; 0 to keep the default
+  int64 mmap_size = 0;            // maximum size of memory-mapped I/O in bytes
+  int64 journal_size_limit = -1;  // -1 to keep the default
+  bool disable_auto_checkpoint = false;
+
+  // the trace, to which operations are recorded; nullptr if operations are never traced
+  std::shared_ptr<DbTrace> trace;
+};
+
 class SqliteConnectionSafe {
  public:
   SqliteConnectionSafe() = default;
-  SqliteConnectionSafe(string path, DbKey key, optional<int32> cipher_version = {});
+  SqliteConnectionSafe(string path, DbKey key, optional<int32> cipher_version = {},
+                       SqliteConnectionSettings settings = {});
+
+  static Status init_connection(SqliteDb &db, const SqliteConnectionSettings &settings) TD_WARN_UNUSED_RESULT;
 
   SqliteDb &get();
   void set(SqliteDb &&db);
@@ -30,9 +47,19 @@ class SqliteConnectionSafe {
 
   void close_and_destroy();
 
+  // blobs stored through SqliteBlobCompressor are compressed only if enabled
+  void set_use_blob_compression(bool use_blob_compression) {
+    use_blob_compression_.store(use_blob_compression, std::memory_order_relaxed);
+  }
+
+  const std::atomic<bool> *get_use_blob_compression_flag() const {
+    return &use_blob_compression_;
+  }
+
  private:
   string path_;
   std::atomic<uint32> close_state_{0};
+  std::atomic<bool> use_blob_compression_{false};
   LazySchedulerLocalStorage<SqliteDb> lsls_connection_;
 };
 
@@ -6,14 +6,19 @@
 //
 #include "td/db/SqliteDb.h"
 
+#include "td/db/DbTrace.h"
+#include "td/db/detail/SqliteFtsTokenizer.h"
+
 #include "td/utils/common.h"
 #include "td/utils/format.h"
 #include "td/utils/logging.h"
+#include "td/utils/misc.h"
 #include "td/utils/port/path.h"
 #include "td/utils/port/Stat.h"
 #include "td/utils/SliceBuilder.h"
 #include "td/utils/Status.h"
 #include "td/utils/StringBuilder.h"
+#include "td/utils/Time.h"
 #include "td/utils/Timer.h"
 
 #include "sqlite/sqlite3.h"
@@ -118,13 +123,33 @@ void SqliteDb::trace(bool flag) {
   tdsqlite3_trace_v2(raw_->db(), SQLITE_TRACE_STMT, flag ? trace_v2_callback : nullptr, nullptr);
 }
 
+void SqliteDb::set_trace(std::shared_ptr<DbTrace> trace) {
+  CHECK(!empty());
+  CHECK(trace != nullptr);
+  raw_->set_trace(std::move(trace));
+}
+
 Status SqliteDb::exec(CSlice cmd) {
   CHECK(!empty());
   char *msg;
   if (enable_logging_) {
     VLOG(sqlite) << "Start exec " << tag("query", cmd) << tag("database", raw_->db());
   }
+  // commands with encryption keys are never traced
+  auto trace = enable_logging_ ? raw_->get_enabled_trace() : nullptr;
+  bool need_trace = trace != nullptr && !begins_with(cmd, "PRAGMA key") && !begins_with(cmd, "PRAGMA rekey") &&
+                    !begins_with(cmd, "ATTACH");
+  auto start_time = need_trace ? Time::now() : 0.0;
   auto rc = tdsqlite3_exec(raw_->db(), cmd.c_str(), nullptr, nullptr, &msg);
+  if (need_trace) {
+    DbTraceEvent event;
+    event.type = DbTraceEvent::Type::Exec;
+    event.time = start_time;
+    event.duration = Time::now() - start_time;
+    event.connection_id = raw_->get_trace_connection_id();
+    event.query = cmd.str();
+    trace->add_event(std::move(event));
+  }
   if (rc != SQLITE_OK) {
     CHECK(msg != nullptr);
     if (enable_logging_) {
@@ -168,6 +193,16 @@ Result<string> SqliteDb::get_pragma_string(Slice name) {
   return std::move(res);
 }
 
+Result<int64> SqliteDb::get_pragma_int64(Slice name) {
+  TRY_RESULT(stmt, get_statement(PSLICE() << "PRAGMA " << name));
+  TRY_STATUS(stmt.step());
+  CHECK(stmt.has_row());
+  auto res = stmt.view_int64(0);
+  TRY_STATUS(stmt.step());
+  CHECK(!stmt.can_step());
+  return res;
+}
+
 Result<int32> SqliteDb::user_version() {
   TRY_RESULT(get_version_stmt, get_statement("PRAGMA user_version"));
   TRY_STATUS(get_version_stmt.step());
@@ -203,6 +238,40 @@ Status SqliteDb::commit_transaction() {
   return Status::OK();
 }
 
+bool SqliteDb::is_in_transaction() const {
+  CHECK(!empty());
+  return tdsqlite3_get_autocommit(raw_->db()) == 0;
+}
+
+Result<SqliteDb::CheckpointResult> SqliteDb::checkpoint(CheckpointMode mode) {
+  CHECK(!empty());
+  int sqlite_mode = [mode] {
+    switch (mode) {
+      case CheckpointMode::Passive:
+        return SQLITE_CHECKPOINT_PASSIVE;
+      case CheckpointMode::Full:
+        return SQLITE_CHECKPOINT_FULL;
+      case CheckpointMode::Restart:
+        return SQLITE_CHECKPOINT_RESTART;
+      case CheckpointMode::Truncate:
+        return SQLITE_CHECKPOINT_TRUNCATE;
+      default:
+        UNREACHABLE();
+        return SQLITE_CHECKPOINT_PASSIVE;
+    }
+  }();
+
+  CheckpointResult result;
+  auto rc = tdsqlite3_wal_checkpoint_v2(raw_->db(), nullptr, sqlite_mode, &result.wal_frame_count,
+                                        &result.checkpointed_frame_count);
+  if (rc == SQLITE_BUSY) {
+    result.is_busy = true;
+  } else if (rc != SQLITE_OK) {
+    return raw_->last_error();
+  }
+  return result;
+}
+
 Status SqliteDb::check_encryption() {
   auto status = exec("SELECT count(*) FROM sqlite_master");
   if (status.is_ok()) {
@@ -237,6 +306,7 @@ Result<SqliteDb> SqliteDb::do_open_with_key(CSlice path, bool allow_creation, co
     db.set_cipher_version(cipher_version);
   }
   TRY_STATUS_PREFIX(db.check_encryption(), "Can't check database: ");
+  TRY_STATUS(detail::register_sqlite_fts_tokenizer(db.get_native()));
   return std::move(db);
 }
 
@@ -47,15 +47,31 @@ class SqliteDb {
   Result<bool> has_table(Slice table);
   Result<string> get_pragma(Slice name);
   Result<string> get_pragma_string(Slice name);
+  Result<int64> get_pragma_int64(Slice name);
 
   Status begin_read_transaction() TD_WARN_UNUSED_RESULT;
   Status begin_write_transaction() TD_WARN_UNUSED_RESULT;
   Status commit_transaction() TD_WARN_UNUSED_RESULT;
 
+  // returns true if the connection has an open transaction, including one started by another owner of the connection
+  bool is_in_transaction() const;
+
+  enum class CheckpointMode : int32 { Passive, Full, Restart, Truncate };
+  struct CheckpointResult {
+    int32 wal_frame_count = 0;
+    int32 checkpointed_frame_count = 0;
+    bool is_busy = false;  // the checkpoint wasn't completed because of concurrent readers or writers
+  };
+  // checkpoints the database in WAL mode; frame counts are -1 if the database isn't in WAL mode
+  Result<CheckpointResult> checkpoint(CheckpointMode mode) TD_WARN_UNUSED_RESULT;
+
   Result<int32> user_version();
   Status set_user_version(int32 version) TD_WARN_UNUSED_RESULT;
   void trace(bool flag);
 
+  // records operations of the connection to the trace while it is enabled; must be called before the connection is used
+  void set_trace(std::shared_ptr<DbTrace> trace);
+
   static Status destroy(Slice path) TD_WARN_UNUSED_RESULT;
 
   // we can't change the key on the fly, so static functions are more than enough
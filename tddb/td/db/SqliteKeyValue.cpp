@@ -6,25 +6,45 @@
 //
 #include "td/db/SqliteKeyValue.h"
 
+#include "td/utils/algorithm.h"
 #include "td/utils/base64.h"
 #include "td/utils/logging.h"
 #include "td/utils/ScopeGuard.h"
 
 namespace td {
 
-Status SqliteKeyValue::init_with_connection(SqliteDb connection, string table_name) {
+constexpr int32 SqliteKeyValue::MAX_MANY_KEYS;
+
+Status SqliteKeyValue::init_with_connection(SqliteDb connection, string table_name,
+                                            std::shared_ptr<SqliteKeyValueFilter> filter) {
   auto init_guard = ScopeExit() + [&] {
     close();
   };
   db_ = std::move(connection);
   table_name_ = std::move(table_name);
+  filter_ = std::move(filter);
   TRY_STATUS(init(db_, table_name_));
 
   TRY_RESULT_ASSIGN(set_stmt_,
                     db_.get_statement(PSLICE() << "REPLACE INTO " << table_name_ << " (k, v) VALUES (?1, ?2)"));
+  string set_many_query = PSTRING() << "REPLACE INTO " << table_name_ << " (k, v) VALUES (?, ?)";
+  for (int32 i = 1; i < MAX_MANY_KEYS; i++) {
+    set_many_query += ", (?, ?)";
+  }
+  TRY_RESULT_ASSIGN(set_many_stmt_, db_.get_statement(set_many_query));
   TRY_RESULT_ASSIGN(get_stmt_, db_.get_statement(PSLICE() << "SELECT v FROM " << table_name_ << " WHERE k = ?1"));
+  string keys_list = "(?";
+  for (int32 i = 1; i < MAX_MANY_KEYS; i++) {
+    keys_list += ", ?";
+  }
+  keys_list += ')';
+  TRY_RESULT_ASSIGN(get_many_stmt_,
+                    db_.get_statement(PSLICE() << "SELECT k, v FROM " << table_name_ << " WHERE k IN " << keys_list));
   TRY_RESULT_ASSIGN(erase_stmt_, db_.get_statement(PSLICE() << "DELETE FROM " << table_name_ << " WHERE k = ?1"));
+  TRY_RESULT_ASSIGN(erase_many_stmt_,
+                    db_.get_statement(PSLICE() << "DELETE FROM " << table_name_ << " WHERE k IN " << keys_list));
   TRY_RESULT_ASSIGN(get_all_stmt_, db_.get_statement(PSLICE() << "SELECT k, v FROM " << table_name_));
+  TRY_RESULT_ASSIGN(get_keys_stmt_, db_.get_statement(PSLICE() << "SELECT k FROM " << table_name_));
 
   TRY_RESULT_ASSIGN(erase_by_prefix_stmt_,
                     db_.get_statement(PSLICE() << "DELETE FROM " << table_name_ << " WHERE ?1 <= k AND k < ?2"));
@@ -57,6 +77,9 @@ void SqliteKeyValue::set(Slice key, Slice value) {
   if (status.is_error()) {
     LOG(FATAL) << "Failed to set \"" << base64_encode(key) << "\": " << status;
   }
+  if (filter_ != nullptr) {
+    filter_->add(key);
+  }
   set_stmt_.reset();
 }
 
@@ -68,24 +91,98 @@ void SqliteKeyValue::set_all(const FlatHashMap<string, string> &key_values) {
   commit_transaction().ensure();
 }
 
+void SqliteKeyValue::set_many(const vector<std::pair<string, string>> &key_values) {
+  begin_write_transaction().ensure();
+  size_t pos = 0;
+  for (; pos + MAX_MANY_KEYS <= key_values.size(); pos += MAX_MANY_KEYS) {
+    SCOPE_EXIT {
+      set_many_stmt_.reset();
+    };
+    for (int32 i = 0; i < MAX_MANY_KEYS; i++) {
+      set_many_stmt_.bind_blob(2 * i + 1, key_values[pos + i].first).ensure();
+      set_many_stmt_.bind_blob(2 * i + 2, key_values[pos + i].second).ensure();
+    }
+    auto status = set_many_stmt_.step();
+    if (status.is_error()) {
+      LOG(FATAL) << "Failed to set " << MAX_MANY_KEYS << " values: " << status;
+    }
+    if (filter_ != nullptr) {
+      for (int32 i = 0; i < MAX_MANY_KEYS; i++) {
+        filter_->add(key_values[pos + i].first);
+      }
+    }
+  }
+  for (; pos < key_values.size(); pos++) {
+    set(key_values[pos].first, key_values[pos].second);
+  }
+  commit_transaction().ensure();
+}
+
 string SqliteKeyValue::get(Slice key) {
+  if (!may_contain(key)) {
+    return string();
+  }
+
   SCOPE_EXIT {
     get_stmt_.reset();
   };
   get_stmt_.bind_blob(1, key).ensure();
   get_stmt_.step().ensure();
   if (!get_stmt_.has_row()) {
+    on_lookup(false);
     return string();
   }
+  on_lookup(true);
   auto data = get_stmt_.view_blob(0).str();
   get_stmt_.step().ignore();
   return data;
 }
 
+vector<string> SqliteKeyValue::get_many(const vector<string> &keys) {
+  vector<Slice> lookup_keys;
+  for (auto &key : keys) {
+    if (may_contain(key)) {
+      lookup_keys.push_back(key);
+    }
+  }
+
+  FlatHashMap<string, string> found_values;
+  // all values are read from the same snapshot of the database
+  begin_read_transaction().ensure();
+  for (size_t pos = 0; pos < lookup_keys.size(); pos += MAX_MANY_KEYS) {
+    SCOPE_EXIT {
+      get_many_stmt_.reset();
+    };
+    bind_many_keys(get_many_stmt_, lookup_keys, pos);
+    get_many_stmt_.step().ensure();
+    while (get_many_stmt_.has_row()) {
+      found_values.emplace(get_many_stmt_.view_blob(0).str(), get_many_stmt_.view_blob(1).str());
+      get_many_stmt_.step().ensure();
+    }
+  }
+  commit_transaction().ensure();
+  for (auto &key : lookup_keys) {
+    on_lookup(found_values.count(key.str()) != 0);
+  }
+
+  vector<string> result;
+  result.reserve(keys.size());
+  for (auto &key : keys) {
+    auto it = found_values.find(key);
+    if (it == found_values.end()) {
+      result.emplace_back();
+    } else {
+      result.push_back(it->second);
+    }
+  }
+  return result;
+}
+
 void SqliteKeyValue::erase(Slice key) {
   erase_stmt_.bind_blob(1, key).ensure();
   erase_stmt_.step().ensure();
   erase_stmt_.reset();
+  on_erase();
 }
 
 void SqliteKeyValue::erase_batch(vector<string> keys) {
@@ -94,6 +191,20 @@ void SqliteKeyValue::erase_batch(vector<string> keys) {
   }
 }
 
+void SqliteKeyValue::erase_many(const vector<string> &keys) {
+  auto key_slices = transform(keys, [](const string &key) { return Slice(key); });
+  begin_write_transaction().ensure();
+  for (size_t pos = 0; pos < key_slices.size(); pos += MAX_MANY_KEYS) {
+    SCOPE_EXIT {
+      erase_many_stmt_.reset();
+    };
+    bind_many_keys(erase_many_stmt_, key_slices, pos);
+    erase_many_stmt_.step().ensure();
+  }
+  commit_transaction().ensure();
+  on_erase();
+}
+
 void SqliteKeyValue::erase_by_prefix(Slice prefix) {
   auto next = next_prefix(prefix);
   if (next.empty()) {
@@ -110,6 +221,14 @@ void SqliteKeyValue::erase_by_prefix(Slice prefix) {
     erase_by_prefix_stmt_.bind_blob(2, next).ensure();
     erase_by_prefix_stmt_.step().ensure();
   }
+  on_erase();
+}
+
+SqliteKeyValueFilter::Stats SqliteKeyValue::get_filter_stats() const {
+  if (filter_ == nullptr) {
+    return SqliteKeyValueFilter::Stats();
+  }
+  return filter_->get_stats();
 }
 
 string SqliteKeyValue::next_prefix(Slice prefix) {
@@ -127,4 +246,56 @@ string SqliteKeyValue::next_prefix(Slice prefix) {
   return string{};
 }
 
+void SqliteKeyValue::bind_many_keys(SqliteStatement &stmt, const vector<Slice> &keys, size_t pos) {
+  for (int32 i = 0; i < MAX_MANY_KEYS; i++) {
+    if (pos + i < keys.size()) {
+      stmt.bind_blob(i + 1, keys[pos + i]).ensure();
+    } else {
+      // NULL never matches, so unused parameters don't affect the result
+      stmt.bind_null(i + 1).ensure();
+    }
+  }
+}
+
+bool SqliteKeyValue::may_contain(Slice key) {
+  if (filter_ == nullptr) {
+    return true;
+  }
+  // inside a transaction other connections could have committed keys, which aren't visible to the connection
+  if (filter_->need_rebuild() && !db_.is_in_transaction()) {
+    rebuild_filter();
+  }
+  return filter_->may_contain(key);
+}
+
+void SqliteKeyValue::on_lookup(bool is_found) {
+  if (filter_ != nullptr) {
+    filter_->on_lookup(is_found);
+  }
+}
+
+void SqliteKeyValue::on_erase() {
+  if (filter_ != nullptr) {
+    filter_->on_erase();
+  }
+}
+
+void SqliteKeyValue::rebuild_filter() {
+  // the write transaction waits for commit of all keys, which were added to the filter,
+  // and forbids other connections to change the table until the filter is rebuilt
+  begin_write_transaction().ensure();
+  if (filter_->need_rebuild()) {
+    vector<uint64> key_hashes;
+    auto guard = get_keys_stmt_.guard();
+    get_keys_stmt_.step().ensure();
+    while (get_keys_stmt_.has_row()) {
+      key_hashes.push_back(SqliteKeyValueFilter::get_key_hash(get_keys_stmt_.view_blob(0)));
+      get_keys_stmt_.step().ensure();
+    }
+    filter_->rebuild(key_hashes);
+    LOG(INFO) << "Rebuilt key filter of table " << table_name_ << " with " << key_hashes.size() << " keys";
+  }
+  commit_transaction().ensure();
+}
+
 }  // namespace td
@@ -7,6 +7,7 @@
 #pragma once
 
 #include "td/db/SqliteDb.h"
+#include "td/db/SqliteKeyValueFilter.h"
 #include "td/db/SqliteStatement.h"
 
 #include "td/utils/common.h"
@@ -15,6 +16,9 @@
 #include "td/utils/SliceBuilder.h"
 #include "td/utils/Status.h"
 
+#include <memory>
+#include <utility>
+
 namespace td {
 
 class SqliteKeyValue {
@@ -31,7 +35,9 @@ class SqliteKeyValue {
     return db_.empty();
   }
 
-  Status init_with_connection(SqliteDb connection, string table_name) TD_WARN_UNUSED_RESULT;
+  // the filter must be shared by all instances, which use the table
+  Status init_with_connection(SqliteDb connection, string table_name,
+                              std::shared_ptr<SqliteKeyValueFilter> filter = nullptr) TD_WARN_UNUSED_RESULT;
 
   void close() {
     *this = SqliteKeyValue();
@@ -43,12 +49,21 @@ class SqliteKeyValue {
 
   void set_all(const FlatHashMap<string, string> &key_values);
 
+  // sets all values in one transaction using a few database queries
+  void set_many(const vector<std::pair<string, string>> &key_values);
+
   string get(Slice key);
 
+  // returns values for all keys in the same order; an empty string is returned for absent keys
+  vector<string> get_many(const vector<string> &keys);
+
   void erase(Slice key);
 
   void erase_batch(vector<string> keys);
 
+  // erases all keys in one transaction using a few database queries
+  void erase_many(const vector<string> &keys);
+
   Status begin_read_transaction() TD_WARN_UNUSED_RESULT {
     return db_.begin_read_transaction();
   }
@@ -63,6 +78,8 @@ class SqliteKeyValue {
 
   void erase_by_prefix(Slice prefix);
 
+  SqliteKeyValueFilter::Stats get_filter_stats() const;
+
   FlatHashMap<string, string> get_all() {
     FlatHashMap<string, string> res;
     get_by_prefix("", [&](Slice key, Slice value) {
@@ -119,16 +136,34 @@ class SqliteKeyValue {
 
   string table_name_;
   SqliteDb db_;
+  std::shared_ptr<SqliteKeyValueFilter> filter_;
+  // the maximum number of keys in one query of get_many, set_many or erase_many
+  static constexpr int32 MAX_MANY_KEYS = 64;
+
   SqliteStatement get_stmt_;
+  SqliteStatement get_many_stmt_;
   SqliteStatement set_stmt_;
+  SqliteStatement set_many_stmt_;
   SqliteStatement erase_stmt_;
+  SqliteStatement erase_many_stmt_;
   SqliteStatement get_all_stmt_;
+  SqliteStatement get_keys_stmt_;
   SqliteStatement erase_by_prefix_stmt_;
   SqliteStatement erase_by_prefix_rare_stmt_;
   SqliteStatement get_by_prefix_stmt_;
   SqliteStatement get_by_prefix_rare_stmt_;
 
   static string next_prefix(Slice prefix);
+
+  static void bind_many_keys(SqliteStatement &stmt, const vector<Slice> &keys, size_t pos);
+
+  bool may_contain(Slice key);
+
+  void on_lookup(bool is_found);
+
+  void on_erase();
+
+  void rebuild_filter();
 };
 
 }  // namespace td
@@ -36,6 +36,9 @@ class SqliteKeyValueAsync final : public SqliteKeyValueAsyncInterface {
   void get(string key, Promise<string> promise) final {
     send_closure_later(impl_, &Impl::get, std::move(key), std::move(promise));
   }
+  void get_many(vector<string> keys, Promise<vector<string>> promise) final {
+    send_closure_later(impl_, &Impl::get_many, std::move(keys), std::move(promise));
+  }
   void close(Promise<Unit> promise) final {
     send_closure_later(impl_, &Impl::close, std::move(promise));
   }
@@ -47,6 +50,7 @@ class SqliteKeyValueAsync final : public SqliteKeyValueAsyncInterface {
     }
 
     void set(string key, string value, Promise<Unit> promise) {
+      flush_pending_gets();
       auto it = buffer_.find(key);
       if (it != buffer_.end()) {
         it->second = std::move(value);
@@ -62,12 +66,14 @@ class SqliteKeyValueAsync final : public SqliteKeyValueAsyncInterface {
     }
 
     void set_all(FlatHashMap<string, string> key_values, Promise<Unit> promise) {
+      flush_pending_gets();
       do_flush(true /*force*/);
       kv_->set_all(key_values);
       promise.set_value(Unit());
     }
 
     void erase(string key, Promise<Unit> promise) {
+      flush_pending_gets();
       auto it = buffer_.find(key);
       if (it != buffer_.end()) {
         it->second = optional<string>();
@@ -83,20 +89,53 @@ class SqliteKeyValueAsync final : public SqliteKeyValueAsyncInterface {
     }
 
     void erase_by_prefix(string key_prefix, Promise<Unit> promise) {
+      flush_pending_gets();
       do_flush(true /*force*/);
       kv_->erase_by_prefix(key_prefix);
       promise.set_value(Unit());
     }
 
-    void get(const string &key, Promise<string> promise) {
+    void get(string key, Promise<string> promise) {
       auto it = buffer_.find(key);
       if (it != buffer_.end()) {
         return promise.set_value(it->second ? it->second.value() : "");
       }
-      promise.set_value(kv_->get(key));
+
+      // the request is merged with other requests, which are already in the mailbox
+      if (pending_get_keys_.empty()) {
+        send_closure_later(actor_id(this), &Impl::flush_pending_gets);
+      }
+      pending_get_keys_.push_back(std::move(key));
+      pending_get_promises_.push_back(std::move(promise));
+    }
+
+    void get_many(vector<string> keys, Promise<vector<string>> promise) {
+      vector<string> result(keys.size());
+      vector<size_t> database_key_positions;
+      vector<string> database_keys;
+      for (size_t i = 0; i < keys.size(); i++) {
+        auto it = buffer_.find(keys[i]);
+        if (it != buffer_.end()) {
+          if (it->second) {
+            result[i] = it->second.value();
+          }
+        } else {
+          database_key_positions.push_back(i);
+          database_keys.push_back(std::move(keys[i]));
+        }
+      }
+      if (!database_keys.empty()) {
+        auto values = kv_->get_many(database_keys);
+        CHECK(values.size() == database_keys.size());
+        for (size_t i = 0; i < values.size(); i++) {
+          result[database_key_positions[i]] = std::move(values[i]);
+        }
+      }
+      promise.set_value(std::move(result));
     }
 
     void close(Promise<Unit> promise) {
+      flush_pending_gets();
       do_flush(true /*force*/);
       kv_safe_.reset();
       kv_ = nullptr;
@@ -114,6 +153,29 @@ class SqliteKeyValueAsync final : public SqliteKeyValueAsyncInterface {
     vector<Promise<Unit>> buffer_promises_;
     size_t cnt_ = 0;
 
+    vector<string> pending_get_keys_;
+    vector<Promise<string>> pending_get_promises_;
+
+    void flush_pending_gets() {
+      if (pending_get_keys_.empty()) {
+        return;
+      }
+
+      auto keys = std::move(pending_get_keys_);
+      auto promises = std::move(pending_get_promises_);
+      pending_get_keys_.clear();
+      pending_get_promises_.clear();
+      if (keys.size() == 1) {
+        return promises[0].set_value(kv_->get(keys[0]));
+      }
+
+      auto values = kv_->get_many(keys);
+      CHECK(values.size() == promises.size());
+      for (size_t i = 0; i < values.size(); i++) {
+        promises[i].set_value(std::move(values[i]));
+      }
+    }
+
     double wakeup_at_ = 0;
     void do_flush(bool force) {
       if (buffer_.empty()) {
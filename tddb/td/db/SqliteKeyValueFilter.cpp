@@ -0,0 +1,151 @@
+//
+// Copyright Aliaksei Levin (levlam@telegram.org), Arseny Smirnov (arseny30@gmail.com) 2014-2024
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+#include "td/db/SqliteKeyValueFilter.h"
+
+#include "td/utils/bits.h"
+#include "td/utils/crypto.h"
+
+namespace td {
+
+namespace {
+
+// the filter is rebuilt if more than 1/MAX_FALSE_POSITIVE_RATE of misses are false positives
+constexpr int64 MAX_FALSE_POSITIVE_RATE = 20;
+constexpr int64 MIN_CHECKED_MISS_COUNT = 1000;
+
+uint64 mix_hash(uint64 h) {
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+}  // namespace
+
+constexpr size_t SqliteKeyValueFilter::MIN_KEY_CAPACITY;
+constexpr int32 SqliteKeyValueFilter::BITS_PER_KEY;
+constexpr int32 SqliteKeyValueFilter::HASH_COUNT;
+
+uint64 SqliteKeyValueFilter::get_key_hash(Slice key) {
+  return mix_hash(crc64(key) ^ key.size());
+}
+
+bool SqliteKeyValueFilter::add_hash(uint64 key_hash) {
+  // double hashing; the second hash must be odd to visit different bits
+  auto step = (key_hash >> 32) | 1;
+  bool is_added = false;
+  for (int32 i = 0; i < HASH_COUNT; i++) {
+    auto bit = key_hash & bit_mask_;
+    auto &word = bits_[static_cast<size_t>(bit >> 6)];
+    auto mask = static_cast<uint64>(1) << (bit & 63);
+    if ((word & mask) == 0) {
+      word |= mask;
+      is_added = true;
+    }
+    key_hash += step;
+  }
+  return is_added;
+}
+
+bool SqliteKeyValueFilter::contains_hash(uint64 key_hash) const {
+  auto step = (key_hash >> 32) | 1;
+  for (int32 i = 0; i < HASH_COUNT; i++) {
+    auto bit = key_hash & bit_mask_;
+    if ((bits_[static_cast<size_t>(bit >> 6)] & (static_cast<uint64>(1) << (bit & 63))) == 0) {
+      return false;
+    }
+    key_hash += step;
+  }
+  return true;
+}
+
+bool SqliteKeyValueFilter::may_contain(Slice key) {
+  auto key_hash = get_key_hash(key);
+  auto guard = mutex_.lock();
+  stats_.lookup_count++;
+  if (!is_built_ || contains_hash(key_hash)) {
+    return true;
+  }
+  stats_.skipped_lookup_count++;
+  miss_count_++;
+  return false;
+}
+
+void SqliteKeyValueFilter::on_lookup(bool is_found) {
+  if (is_found) {
+    return;
+  }
+  auto guard = mutex_.lock();
+  if (!is_built_) {
+    return;
+  }
+  stats_.false_positive_count++;
+  miss_count_++;
+  miss_false_positive_count_++;
+}
+
+void SqliteKeyValueFilter::add(Slice key) {
+  auto key_hash = get_key_hash(key);
+  auto guard = mutex_.lock();
+  if (bits_.empty()) {
+    // the filter will be rebuilt anyway
+    return;
+  }
+  if (add_hash(key_hash)) {
+    // count only new keys; most keys are rewritten many times
+    key_count_++;
+  }
+}
+
+void SqliteKeyValueFilter::on_erase() {
+  auto guard = mutex_.lock();
+  was_key_erased_ = true;
+}
+
+bool SqliteKeyValueFilter::need_rebuild() const {
+  auto guard = mutex_.lock();
+  if (!is_built_ || key_count_ > key_capacity_) {
+    return true;
+  }
+  // false positives are caused either by erased keys or by a few frequently requested keys;
+  // only the former can be fixed by a rebuild
+  return was_key_erased_ && miss_count_ >= MIN_CHECKED_MISS_COUNT &&
+         miss_false_positive_count_ * MAX_FALSE_POSITIVE_RATE > miss_count_;
+}
+
+void SqliteKeyValueFilter::rebuild(const vector<uint64> &key_hashes) {
+  // leave place for new keys
+  auto key_capacity = max(key_hashes.size() * 2, MIN_KEY_CAPACITY);
+  auto bit_count = static_cast<uint64>(1) << (64 - count_leading_zeroes64(key_capacity * BITS_PER_KEY - 1));
+
+  auto guard = mutex_.lock();
+  bits_.assign(static_cast<size_t>(bit_count / 64), 0);
+  bit_mask_ = bit_count - 1;
+  key_capacity_ = key_capacity;
+  key_count_ = 0;
+  for (auto key_hash : key_hashes) {
+    add_hash(key_hash);
+  }
+  key_count_ = key_hashes.size();
+  is_built_ = true;
+  was_key_erased_ = false;
+  miss_count_ = 0;
+  miss_false_positive_count_ = 0;
+  stats_.rebuild_count++;
+}
+
+SqliteKeyValueFilter::Stats SqliteKeyValueFilter::get_stats() const {
+  auto guard = mutex_.lock();
+  auto result = stats_;
+  result.key_count = static_cast<int64>(key_count_);
+  result.bit_count = static_cast<int64>(bits_.size() * 64);
+  return result;
+}
+
+}  // namespace td
@@ -0,0 +1,72 @@
+//
+// Copyright Aliaksei Levin (levlam@telegram.org), Arseny Smirnov (arseny30@gmail.com) 2014-2024
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+#pragma once
+
+#include "td/utils/common.h"
+#include "td/utils/port/Mutex.h"
+#include "td/utils/Slice.h"
+
+namespace td {
+
+// A Bloom filter of keys of a key-value table, which allows to skip database queries for absent keys.
+// The filter is shared by all connections to the table and all writers of the table must use it.
+// A key is added after it is written to the table, but before the write transaction is committed, so the filter
+// contains all keys visible to readers. Erased keys can't be removed from the filter, so it is rebuilt from the table
+// when it becomes too full or has too many false positives. Can be used from any thread.
+class SqliteKeyValueFilter {
+ public:
+  static constexpr size_t MIN_KEY_CAPACITY = 1024;
+
+  struct Stats {
+    int64 key_count = 0;
+    int64 bit_count = 0;
+    int64 lookup_count = 0;
+    int64 skipped_lookup_count = 0;  // lookups of keys, which were definitely absent
+    int64 false_positive_count = 0;
+    int64 rebuild_count = 0;
+  };
+
+  static uint64 get_key_hash(Slice key);
+
+  // returns false if the key is definitely absent from the table; returns true if the filter isn't built yet
+  bool may_contain(Slice key);
+
+  // must be called after a key, for which may_contain returned true, was looked up in the table
+  void on_lookup(bool is_found);
+
+  void add(Slice key);
+
+  void on_erase();
+
+  bool need_rebuild() const;
+
+  // replaces the filter with a filter of the given keys; the table must not be changed until the filter is rebuilt
+  void rebuild(const vector<uint64> &key_hashes);
+
+  Stats get_stats() const;
+
+ private:
+  static constexpr int32 BITS_PER_KEY = 10;
+  static constexpr int32 HASH_COUNT = 7;
+
+  mutable Mutex mutex_;
+  vector<uint64> bits_;
+  uint64 bit_mask_ = 0;
+  bool is_built_ = false;
+  size_t key_capacity_ = 0;
+  size_t key_count_ = 0;
+  bool was_key_erased_ = false;
+  int64 miss_count_ = 0;
+  int64 miss_false_positive_count_ = 0;
+  Stats stats_;
+
+  bool add_hash(uint64 key_hash);
+
+  bool contains_hash(uint64 key_hash) const;
+};
+
+}  // namespace td
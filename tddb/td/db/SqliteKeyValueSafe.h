@@ -8,6 +8,7 @@
 
 #include "td/db/SqliteConnectionSafe.h"
 #include "td/db/SqliteKeyValue.h"
+#include "td/db/SqliteKeyValueFilter.h"
 
 #include "td/actor/SchedulerLocalStorage.h"
 
@@ -20,9 +21,10 @@ namespace td {
 class SqliteKeyValueSafe {
  public:
   SqliteKeyValueSafe(string name, std::shared_ptr<SqliteConnectionSafe> safe_connection)
-      : lsls_kv_([name = std::move(name), safe_connection = std::move(safe_connection)] {
+      : lsls_kv_([name = std::move(name), safe_connection = std::move(safe_connection),
+                  filter = std::make_shared<SqliteKeyValueFilter>()] {
         SqliteKeyValue kv;
-        kv.init_with_connection(safe_connection->get().clone(), name).ensure();
+        kv.init_with_connection(safe_connection->get().clone(), name, filter).ensure();
         return kv;
       }) {
   }
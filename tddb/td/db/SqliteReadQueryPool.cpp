@@ -0,0 +1,67 @@
+//
+// Copyright Aliaksei Levin (levlam@telegram.org), Arseny Smirnov (arseny30@gmail.com) 2014-2024
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+#include "td/db/SqliteReadQueryPool.h"
+
+#include "td/db/SqliteConnectionSafe.h"
+#include "td/db/SqliteDb.h"
+
+#include "td/actor/MultiPromise.h"
+
+#include "td/utils/logging.h"
+
+namespace td {
+
+class SqliteReadQueryPool::Worker final : public Actor {
+ public:
+  explicit Worker(std::shared_ptr<SqliteConnectionSafe> connection) : connection_(std::move(connection)) {
+  }
+
+  void run_query(Promise<Unit> query) {
+    query.set_value(Unit());
+  }
+
+  void close(Promise<Unit> promise) {
+    promise.set_value(Unit());
+    stop();
+  }
+
+ private:
+  std::shared_ptr<SqliteConnectionSafe> connection_;
+
+  void start_up() final {
+    // the connection is used only by the pool, so it must never be used for writing
+    connection_->get().exec("PRAGMA query_only=1").ensure();
+  }
+};
+
+SqliteReadQueryPool::SqliteReadQueryPool(std::shared_ptr<SqliteConnectionSafe> connection,
+                                         vector<int32> scheduler_ids) {
+  for (auto scheduler_id : scheduler_ids) {
+    workers_.push_back(create_actor_on_scheduler<Worker>("SqliteReadQueryWorker", scheduler_id, connection));
+  }
+}
+
+SqliteReadQueryPool::~SqliteReadQueryPool() = default;
+
+void SqliteReadQueryPool::do_run_query(Promise<Unit> query) {
+  CHECK(!workers_.empty());
+  auto worker_index = next_worker_.fetch_add(1, std::memory_order_relaxed) % workers_.size();
+  send_closure_later(workers_[worker_index], &Worker::run_query, std::move(query));
+}
+
+void SqliteReadQueryPool::close(Promise<Unit> promise) {
+  is_closed_.store(true, std::memory_order_relaxed);
+  MultiPromiseActorSafe mpas{"SqliteReadQueryPoolCloseMultiPromiseActor"};
+  mpas.add_promise(std::move(promise));
+  auto lock = mpas.get_promise();
+  for (auto &worker : workers_) {
+    send_closure_later(worker, &Worker::close, mpas.get_promise());
+  }
+  lock.set_value(Unit());
+}
+
+}  // namespace td
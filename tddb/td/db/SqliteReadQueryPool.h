@@ -0,0 +1,74 @@
+//
+// Copyright Aliaksei Levin (levlam@telegram.org), Arseny Smirnov (arseny30@gmail.com) 2014-2024
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+#pragma once
+
+#include "td/actor/actor.h"
+
+#include "td/utils/common.h"
+#include "td/utils/Promise.h"
+
+#include <atomic>
+#include <memory>
+#include <utility>
+
+namespace td {
+
+class SqliteConnectionSafe;
+
+// Runs side-effect-free database queries in parallel on the given dedicated schedulers.
+// TDLib passes a single database reader scheduler, so the pool runs reads in parallel only with the writer.
+// SqliteConnectionSafe opens a separate connection for each scheduler, so in WAL mode the queries
+// wait neither for each other nor for the writer. The connections of the schedulers are made query-only.
+// A query can be run by the pool only if all write queries sent before it are committed,
+// so every query sees preceding writes as if it was run by the writer.
+class SqliteReadQueryPool {
+ public:
+  SqliteReadQueryPool(std::shared_ptr<SqliteConnectionSafe> connection, vector<int32> scheduler_ids);
+  SqliteReadQueryPool(const SqliteReadQueryPool &) = delete;
+  SqliteReadQueryPool &operator=(const SqliteReadQueryPool &) = delete;
+  SqliteReadQueryPool(SqliteReadQueryPool &&) = delete;
+  SqliteReadQueryPool &operator=(SqliteReadQueryPool &&) = delete;
+  ~SqliteReadQueryPool();
+
+  // must be called before a write query is sent to the writer
+  void on_write_query_sent() {
+    sent_write_query_count_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // must be called by the writer after the write queries are committed or executed outside of a transaction
+  void on_write_queries_committed(size_t count) {
+    committed_write_query_count_.fetch_add(count, std::memory_order_release);
+  }
+
+  // returns false if the query must be run by the writer
+  bool can_run_query() const {
+    return !workers_.empty() && !is_closed_.load(std::memory_order_relaxed) &&
+           committed_write_query_count_.load(std::memory_order_acquire) ==
+               sent_write_query_count_.load(std::memory_order_relaxed);
+  }
+
+  template <class F>
+  void run_query(F &&query) {
+    do_run_query(PromiseCreator::lambda(std::forward<F>(query)));
+  }
+
+  // waits for completion of all started queries
+  void close(Promise<Unit> promise);
+
+ private:
+  class Worker;
+
+  vector<ActorOwn<Worker>> workers_;
+  std::atomic<size_t> next_worker_{0};
+  std::atomic<uint64> sent_write_query_count_{0};
+  std::atomic<uint64> committed_write_query_count_{0};
+  std::atomic<bool> is_closed_{false};
+
+  void do_run_query(Promise<Unit> query);
+};
+
+}  // namespace td
@@ -10,6 +10,7 @@
 #include "td/utils/logging.h"
 #include "td/utils/StackAllocator.h"
 #include "td/utils/StringBuilder.h"
+#include "td/utils/Time.h"
 
 #include "sqlite/sqlite3.h"
 
@@ -72,6 +73,9 @@ Result<string> SqliteStatement::explain() {
   return sb.as_cslice().str();
 }
 Status SqliteStatement::bind_blob(int id, Slice blob) {
+  if (db_->get_enabled_trace() != nullptr) {
+    trace_bind(id, DbTraceValue::blob_value(blob));
+  }
   auto rc = tdsqlite3_bind_blob(stmt_.get(), id, blob.data(), static_cast<int>(blob.size()), nullptr);
   if (rc != SQLITE_OK) {
     return last_error();
@@ -79,6 +83,9 @@ Status SqliteStatement::bind_blob(int id, Slice blob) {
   return Status::OK();
 }
 Status SqliteStatement::bind_string(int id, Slice str) {
+  if (db_->get_enabled_trace() != nullptr) {
+    trace_bind(id, DbTraceValue::text_value(str));
+  }
   auto rc = tdsqlite3_bind_text(stmt_.get(), id, str.data(), static_cast<int>(str.size()), nullptr);
   if (rc != SQLITE_OK) {
     return last_error();
@@ -87,6 +94,9 @@ Status SqliteStatement::bind_string(int id, Slice str) {
 }
 
 Status SqliteStatement::bind_int32(int id, int32 value) {
+  if (db_->get_enabled_trace() != nullptr) {
+    trace_bind(id, DbTraceValue::integer_value(value));
+  }
   auto rc = tdsqlite3_bind_int(stmt_.get(), id, value);
   if (rc != SQLITE_OK) {
     return last_error();
@@ -94,6 +104,9 @@ Status SqliteStatement::bind_int32(int id, int32 value) {
   return Status::OK();
 }
 Status SqliteStatement::bind_int64(int id, int64 value) {
+  if (db_->get_enabled_trace() != nullptr) {
+    trace_bind(id, DbTraceValue::integer_value(value));
+  }
   auto rc = tdsqlite3_bind_int64(stmt_.get(), id, value);
   if (rc != SQLITE_OK) {
     return last_error();
@@ -101,6 +114,9 @@ Status SqliteStatement::bind_int64(int id, int64 value) {
   return Status::OK();
 }
 Status SqliteStatement::bind_null(int id) {
+  if (db_->get_enabled_trace() != nullptr) {
+    trace_bind(id, DbTraceValue());
+  }
   auto rc = tdsqlite3_bind_null(stmt_.get(), id);
   if (rc != SQLITE_OK) {
     return last_error();
@@ -170,17 +186,58 @@ SqliteStatement::Datatype SqliteStatement::view_datatype(int id) {
 }
 
 void SqliteStatement::reset() {
+  if (trace_event_ != nullptr) {
+    auto trace = db_->get_enabled_trace();
+    if (trace != nullptr && trace_event_->time != 0.0) {
+      trace->add_event(std::move(*trace_event_));
+    }
+    trace_event_ = nullptr;
+  }
   tdsqlite3_reset(stmt_.get());
   state_ = State::Start;
 }
 
+DbTraceEvent &SqliteStatement::get_trace_event() {
+  if (trace_event_ == nullptr) {
+    trace_event_ = make_unique<DbTraceEvent>();
+    trace_event_->type = DbTraceEvent::Type::Query;
+    trace_event_->connection_id = db_->get_trace_connection_id();
+    trace_event_->query = tdsqlite3_sql(stmt_.get());
+  }
+  return *trace_event_;
+}
+
+void SqliteStatement::trace_bind(int id, DbTraceValue &&value) {
+  auto &values = get_trace_event().values;
+  CHECK(id > 0);
+  if (values.size() < static_cast<size_t>(id)) {
+    values.resize(id);
+  }
+  values[id - 1] = std::move(value);
+}
+
+void SqliteStatement::trace_step(double start_time, bool has_row) {
+  auto &event = get_trace_event();
+  if (event.time == 0.0) {
+    event.time = start_time;
+  }
+  event.duration += Time::now() - start_time;
+  if (has_row) {
+    event.row_count++;
+  }
+}
+
 Status SqliteStatement::step() {
   if (state_ == State::Finish) {
     return Status::Error("One has to reset statement");
   }
   VLOG(sqlite) << "Start step " << tag("query", tdsqlite3_sql(stmt_.get())) << tag("statement", stmt_.get())
                << tag("database", db_.get());
+  auto start_time = db_->get_enabled_trace() != nullptr ? Time::now() : 0.0;
   auto rc = tdsqlite3_step(stmt_.get());
+  if (start_time != 0.0) {
+    trace_step(start_time, rc == SQLITE_ROW);
+  }
   VLOG(sqlite) << "Finish step with response " << (rc == SQLITE_ROW ? "ROW" : (rc == SQLITE_DONE ? "DONE" : "ERROR"));
   if (rc == SQLITE_ROW) {
     state_ = State::HaveRow;
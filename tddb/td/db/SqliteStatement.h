@@ -6,6 +6,7 @@
 //
 #pragma once
 
+#include "td/db/DbTrace.h"
 #include "td/db/detail/RawSqliteDb.h"
 
 #include "td/utils/common.h"
@@ -82,6 +83,15 @@ class SqliteStatement {
   std::unique_ptr<tdsqlite3_stmt, StmtDeleter> stmt_;
   std::shared_ptr<detail::RawSqliteDb> db_;
 
+  // bound values and statistics of the current execution if database operations are traced
+  unique_ptr<DbTraceEvent> trace_event_;
+
+  DbTraceEvent &get_trace_event();
+
+  void trace_bind(int id, DbTraceValue &&value);
+
+  void trace_step(double start_time, bool has_row);
+
   Status last_error();
 };
 
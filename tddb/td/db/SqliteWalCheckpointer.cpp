@@ -0,0 +1,152 @@
+//
+// Copyright Aliaksei Levin (levlam@telegram.org), Arseny Smirnov (arseny30@gmail.com) 2014-2024
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+#include "td/db/SqliteWalCheckpointer.h"
+
+#include "td/db/SqliteConnectionSafe.h"
+#include "td/db/SqliteDb.h"
+
+#include "td/utils/logging.h"
+#include "td/utils/SliceBuilder.h"
+#include "td/utils/port/Mutex.h"
+#include "td/utils/Time.h"
+
+namespace td {
+
+constexpr int64 SqliteWalCheckpointer::WAL_SIZE_LIMIT;
+
+class SqliteWalCheckpointer::StatsStorage {
+ public:
+  Stats get() const {
+    auto guard = mutex_.lock();
+    return stats_;
+  }
+
+  void on_checkpoint(int64 wal_size, bool is_restart, bool is_busy, double duration) {
+    auto guard = mutex_.lock();
+    stats_.wal_size = wal_size;
+    stats_.checkpoint_count++;
+    if (is_restart) {
+      stats_.restart_checkpoint_count++;
+    }
+    if (is_busy) {
+      stats_.busy_checkpoint_count++;
+    }
+    stats_.last_checkpoint_duration = duration;
+    stats_.max_checkpoint_duration = max(stats_.max_checkpoint_duration, duration);
+    stats_.total_checkpoint_duration += duration;
+  }
+
+ private:
+  mutable Mutex mutex_;
+  Stats stats_;
+};
+
+class SqliteWalCheckpointer::Impl final : public Actor {
+ public:
+  Impl(std::shared_ptr<SqliteConnectionSafe> connection, std::shared_ptr<StatsStorage> stats)
+      : connection_(std::move(connection)), stats_(std::move(stats)) {
+  }
+
+  void close(Promise<Unit> promise) {
+    connection_.reset();
+    promise.set_value(Unit());
+    stop();
+  }
+
+ private:
+  static constexpr double CHECKPOINT_PERIOD = 1.0;
+  static constexpr double SLOW_CHECKPOINT_DURATION = 0.1;
+  static constexpr int64 CACHE_SIZE = 64 << 10;
+
+  std::shared_ptr<SqliteConnectionSafe> connection_;
+  std::shared_ptr<StatsStorage> stats_;
+  int64 page_size_ = 0;
+  int64 wal_size_ = 0;
+  int64 data_version_ = 0;
+  bool is_wal_checkpointed_ = false;
+
+  void start_up() final {
+    set_timeout_in(CHECKPOINT_PERIOD);
+  }
+
+  void timeout_expired() final {
+    run_checkpoint();
+    set_timeout_in(CHECKPOINT_PERIOD);
+  }
+
+  void run_checkpoint() {
+    auto &db = connection_->get();
+    if (page_size_ == 0) {
+      // the connection is used only for checkpoints, which copy pages from the WAL without the page cache,
+      // so the page cache of readers and the writer isn't needed
+      auto status = db.exec(PSLICE() << "PRAGMA cache_size=-" << (CACHE_SIZE >> 10));
+      if (status.is_ok()) {
+        status = db.exec("PRAGMA mmap_size=0");
+      }
+      if (status.is_error()) {
+        LOG(ERROR) << "Failed to reduce page cache size: " << status;
+      }
+
+      auto r_page_size = db.get_pragma_int64("page_size");
+      if (r_page_size.is_error()) {
+        LOG(ERROR) << "Failed to get database page size: " << r_page_size.error();
+        return;
+      }
+      page_size_ = r_page_size.ok();
+    }
+
+    // data_version changes only if the database was modified by other connections,
+    // so there is nothing to checkpoint if it didn't change after the WAL was fully checkpointed
+    auto r_data_version = db.get_pragma_int64("data_version");
+    if (r_data_version.is_error()) {
+      LOG(ERROR) << "Failed to get database data version: " << r_data_version.error();
+      return;
+    }
+    if (is_wal_checkpointed_ && r_data_version.ok() == data_version_) {
+      return;
+    }
+    data_version_ = r_data_version.ok();
+
+    bool is_restart = wal_size_ > WAL_SIZE_LIMIT;
+    auto start_time = Time::now();
+    auto r_result = db.checkpoint(is_restart ? SqliteDb::CheckpointMode::Restart : SqliteDb::CheckpointMode::Passive);
+    auto duration = Time::now() - start_time;
+    if (r_result.is_error()) {
+      LOG(ERROR) << "Failed to checkpoint database: " << r_result.error();
+      return;
+    }
+    auto result = r_result.move_as_ok();
+    LOG_IF(WARNING, duration >= SLOW_CHECKPOINT_DURATION)
+        << "Checkpoint of " << result.checkpointed_frame_count << " pages took " << duration << " seconds";
+
+    if (is_restart && !result.is_busy) {
+      // the WAL will be reused from its beginning and truncated to journal_size_limit by the next write
+      wal_size_ = 0;
+    } else {
+      wal_size_ = max(result.wal_frame_count, 0) * page_size_;
+    }
+    is_wal_checkpointed_ = !result.is_busy && result.checkpointed_frame_count == result.wal_frame_count;
+    stats_->on_checkpoint(wal_size_, is_restart, result.is_busy, duration);
+  }
+};
+
+SqliteWalCheckpointer::SqliteWalCheckpointer(std::shared_ptr<SqliteConnectionSafe> connection, int32 scheduler_id)
+    : stats_(std::make_shared<StatsStorage>()) {
+  impl_ = create_actor_on_scheduler<Impl>("SqliteWalCheckpointer", scheduler_id, std::move(connection), stats_);
+}
+
+SqliteWalCheckpointer::~SqliteWalCheckpointer() = default;
+
+SqliteWalCheckpointer::Stats SqliteWalCheckpointer::get_stats() const {
+  return stats_->get();
+}
+
+void SqliteWalCheckpointer::close(Promise<Unit> promise) {
+  send_closure_later(impl_, &Impl::close, std::move(promise));
+}
+
+}  // namespace td
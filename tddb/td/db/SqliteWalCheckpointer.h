@@ -0,0 +1,61 @@
+//
+// Copyright Aliaksei Levin (levlam@telegram.org), Arseny Smirnov (arseny30@gmail.com) 2014-2024
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+#pragma once
+
+#include "td/actor/actor.h"
+
+#include "td/utils/common.h"
+#include "td/utils/Promise.h"
+
+#include <memory>
+
+namespace td {
+
+class SqliteConnectionSafe;
+
+// Runs checkpoints of a database in WAL mode on a separate scheduler, so commits of the writer don't wait for them.
+// Automatic checkpoints must be disabled on all connections with SqliteConnectionSettings::disable_auto_checkpoint.
+// A passive checkpoint, which never blocks readers or the writer, is run periodically if the WAL has new frames,
+// which weren't checkpointed yet; otherwise only the data version of the database is checked. If the WAL grows
+// bigger than WAL_SIZE_LIMIT, a restart checkpoint is run, so the writer starts to reuse the WAL from its beginning.
+// The connection of the checkpointer uses a small page cache regardless of SqliteConnectionSettings::cache_size.
+class SqliteWalCheckpointer {
+ public:
+  static constexpr int64 WAL_SIZE_LIMIT = 16 << 20;
+
+  struct Stats {
+    int64 wal_size = 0;
+    int64 checkpoint_count = 0;
+    int64 restart_checkpoint_count = 0;
+    int64 busy_checkpoint_count = 0;
+    double last_checkpoint_duration = 0.0;
+    double max_checkpoint_duration = 0.0;
+    double total_checkpoint_duration = 0.0;
+  };
+
+  SqliteWalCheckpointer(std::shared_ptr<SqliteConnectionSafe> connection, int32 scheduler_id);
+  SqliteWalCheckpointer(const SqliteWalCheckpointer &) = delete;
+  SqliteWalCheckpointer &operator=(const SqliteWalCheckpointer &) = delete;
+  SqliteWalCheckpointer(SqliteWalCheckpointer &&) = delete;
+  SqliteWalCheckpointer &operator=(SqliteWalCheckpointer &&) = delete;
+  ~SqliteWalCheckpointer();
+
+  // can be called from any thread
+  Stats get_stats() const;
+
+  // releases the connection; must be called before the connection is closed
+  void close(Promise<Unit> promise);
+
+ private:
+  class Impl;
+  class StatsStorage;
+
+  std::shared_ptr<StatsStorage> stats_;
+  ActorOwn<Impl> impl_;
+};
+
+}  // namespace td
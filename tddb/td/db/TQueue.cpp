@@ -11,16 +11,26 @@
 #include "td/db/binlog/BinlogHelper.h"
 #include "td/db/binlog/BinlogInterface.h"
 
+#include "td/utils/crypto.h"
+#include "td/utils/filesystem.h"
 #include "td/utils/FlatHashMap.h"
+#include "td/utils/HashTableUtils.h"
 #include "td/utils/logging.h"
 #include "td/utils/misc.h"
+#include "td/utils/PathView.h"
+#include "td/utils/port/Mutex.h"
+#include "td/utils/port/path.h"
+#include "td/utils/port/thread.h"
 #include "td/utils/Random.h"
+#include "td/utils/SliceBuilder.h"
 #include "td/utils/StorerBase.h"
 #include "td/utils/Time.h"
 #include "td/utils/tl_helpers.h"
 #include "td/utils/tl_parsers.h"
 #include "td/utils/tl_storers.h"
 
+#include <algorithm>
+#include <deque>
 #include <set>
 
 namespace td {
@@ -82,12 +92,195 @@ bool EventId::is_valid_id(int32 id) {
   return 0 <= id && id < MAX_ID;
 }
 
+// events of a queue ordered by identifier
+// identifiers of the events are almost always consecutive, so an event is found by its offset from the first event;
+// events deleted from the middle are kept as tombstones, so positions of other events don't change
+// until the events are compacted
+class TQueueEvents {
+ public:
+  using RawEvent = TQueue::RawEvent;
+
+  bool empty() const {
+    return size_ == 0;
+  }
+
+  // the number of events without tombstones
+  size_t size() const {
+    return size_;
+  }
+
+  size_t begin() const {
+    return begin_pos_;
+  }
+
+  size_t end() const {
+    return begin_pos_ + slots_.size();
+  }
+
+  RawEvent &get(size_t pos) {
+    return get_slot(pos).event;
+  }
+
+  RawEvent &front() {
+    CHECK(!empty());
+    return slots_.front().event;
+  }
+  const RawEvent &front() const {
+    CHECK(!empty());
+    return slots_.front().event;
+  }
+
+  RawEvent &back() {
+    CHECK(!empty());
+    return slots_.back().event;
+  }
+  const RawEvent &back() const {
+    CHECK(!empty());
+    return slots_.back().event;
+  }
+
+  // returns position of the next event after the given position
+  size_t next(size_t pos) const {
+    pos++;
+    while (pos < end() && get_slot(pos).is_deleted) {
+      pos++;
+    }
+    return pos;
+  }
+
+  // returns position of the previous event before the given position
+  size_t prev(size_t pos) const {
+    CHECK(pos > begin());
+    pos--;
+    while (get_slot(pos).is_deleted) {
+      CHECK(pos > begin());
+      pos--;
+    }
+    return pos;
+  }
+
+  size_t find(EventId event_id) const {
+    auto pos = lower_bound(event_id);
+    if (pos == end() || get_slot(pos).event.event_id != event_id) {
+      return end();
+    }
+    return pos;
+  }
+
+  // returns position of the first event with identifier not less than event_id
+  size_t lower_bound(EventId event_id) const {
+    if (empty() || !(front().event_id < event_id)) {
+      return begin();
+    }
+    if (back().event_id < event_id) {
+      return end();
+    }
+    auto offset = static_cast<size_t>(event_id.value() - front().event_id.value());
+    size_t index;
+    if (offset < slots_.size() && slots_[offset].event.event_id == event_id) {
+      index = offset;
+    } else {
+      index = static_cast<size_t>(std::lower_bound(slots_.begin(), slots_.end(), event_id,
+                                                   [](const Slot &slot, EventId event_id) {
+                                                     return slot.event.event_id < event_id;
+                                                   }) -
+                                  slots_.begin());
+    }
+    auto pos = begin_pos_ + index;
+    if (slots_[index].is_deleted) {
+      pos = next(pos);
+    }
+    return pos;
+  }
+
+  void push_back(RawEvent &&event) {
+    CHECK(empty() || back().event_id < event.event_id);
+    if (deleted_count_ > size_ + MIN_COMPACTED_DELETED_COUNT) {
+      compact();
+    }
+    slots_.emplace_back(std::move(event));
+    size_++;
+  }
+
+  // removes the event and returns position of the next event
+  size_t erase(size_t pos) {
+    CHECK(pos >= begin() && pos < end());
+    auto &slot = get_slot(pos);
+    CHECK(!slot.is_deleted);
+    size_--;
+    if (pos == begin()) {
+      pop_front();
+      while (!slots_.empty() && slots_.front().is_deleted) {
+        deleted_count_--;
+        pop_front();
+      }
+      return begin();
+    }
+    if (pos + 1 == end()) {
+      slots_.pop_back();
+      while (slots_.back().is_deleted) {
+        deleted_count_--;
+        slots_.pop_back();
+      }
+      return end();
+    }
+    // the identifier is kept to keep the events sorted
+    slot.is_deleted = true;
+    slot.event.data = string();
+    deleted_count_++;
+    return next(pos);
+  }
+
+ private:
+  static constexpr size_t MIN_COMPACTED_DELETED_COUNT = 16;
+
+  struct Slot {
+    RawEvent event;
+    bool is_deleted = false;
+
+    explicit Slot(RawEvent &&event) : event(std::move(event)) {
+    }
+  };
+
+  // std::deque doesn't move the events on insertion and deletion at the ends
+  std::deque<Slot> slots_;
+  size_t begin_pos_ = 0;
+  size_t size_ = 0;
+  size_t deleted_count_ = 0;
+
+  Slot &get_slot(size_t pos) {
+    return slots_[pos - begin_pos_];
+  }
+  const Slot &get_slot(size_t pos) const {
+    return slots_[pos - begin_pos_];
+  }
+
+  void pop_front() {
+    slots_.pop_front();
+    begin_pos_++;
+  }
+
+  // removes tombstones; changes positions of the events
+  void compact() {
+    std::deque<Slot> slots;
+    for (auto &slot : slots_) {
+      if (!slot.is_deleted) {
+        slots.push_back(std::move(slot));
+      }
+    }
+    slots_ = std::move(slots);
+    deleted_count_ = 0;
+  }
+};
+
 class TQueueImpl final : public TQueue {
   static constexpr size_t MAX_EVENT_LENGTH = 65536 * 8;
   static constexpr size_t MAX_QUEUE_EVENTS = 100000;
   static constexpr size_t MAX_TOTAL_EVENT_LENGTH = 1 << 27;
 
  public:
+  static constexpr double MAX_GC_TIME = 0.05;
+
   void set_callback(unique_ptr<StorageCallback> callback) final {
     callback_ = std::move(callback);
   }
@@ -112,13 +305,13 @@ class TQueueImpl final : public TQueue {
     }
 
     if (!q.events.empty()) {
-      auto it = q.events.end();
-      --it;
-      if (it->second.data.empty()) {
-        if (callback_ != nullptr && it->second.log_event_id != 0) {
-          callback_->pop(it->second.log_event_id);
+      auto &last_event = q.events.back();
+      if (last_event.data.empty()) {
+        if (callback_ != nullptr && last_event.log_event_id != 0) {
+          callback_->pop(last_event.log_event_id);
         }
-        q.events.erase(it);
+        auto pos = q.events.prev(q.events.end());
+        q.events.erase(pos);
       }
     }
     if (q.events.empty() && !raw_event.data.empty()) {
@@ -130,7 +323,7 @@ class TQueueImpl final : public TQueue {
     }
     q.tail_id = event_id.next().move_as_ok();
     q.total_event_length += raw_event.data.size();
-    q.events.emplace(event_id, std::move(raw_event));
+    q.events.push_back(std::move(raw_event));
     return true;
   }
 
@@ -171,8 +364,8 @@ class TQueueImpl final : public TQueue {
       if (event_id.next().is_ok()) {
         break;
       }
-      for (auto it = q.events.begin(); it != q.events.end();) {
-        pop(q, queue_id, it, {});
+      for (auto pos = q.events.begin(); pos != q.events.end();) {
+        pop(q, queue_id, pos, {});
       }
       q.tail_id = EventId();
       CHECK(hint_new_id.next().is_ok());
@@ -211,11 +404,11 @@ class TQueueImpl final : public TQueue {
       return;
     }
     auto &q = q_it->second;
-    auto it = q.events.find(event_id);
-    if (it == q.events.end()) {
+    auto pos = q.events.find(event_id);
+    if (pos == q.events.end()) {
       return;
     }
-    pop(q, queue_id, it, q.tail_id);
+    pop(q, queue_id, pos, q.tail_id);
   }
 
   std::map<EventId, RawEvent> clear(QueueId queue_id, size_t keep_count) final {
@@ -232,15 +425,15 @@ class TQueueImpl final : public TQueue {
     auto start_time = Time::now();
     auto total_event_length = q.total_event_length;
 
-    auto end_it = q.events.end();
+    auto end_pos = q.events.end();
     for (size_t i = 0; i < keep_count; i++) {
-      --end_it;
+      end_pos = q.events.prev(end_pos);
     }
     if (keep_count == 0) {
-      --end_it;
-      auto &event = end_it->second;
+      end_pos = q.events.prev(end_pos);
+      auto &event = q.events.get(end_pos);
       if (callback_ == nullptr || event.log_event_id == 0) {
-        ++end_it;
+        end_pos = q.events.end();
       } else if (!event.data.empty()) {
         clear_event_data(q, event);
         callback_->push(queue_id, event);
@@ -251,8 +444,8 @@ class TQueueImpl final : public TQueue {
     if (callback_ != nullptr) {
       vector<uint64> deleted_log_event_ids;
       deleted_log_event_ids.reserve(size - keep_count);
-      for (auto it = q.events.begin(); it != end_it; ++it) {
-        auto &event = it->second;
+      for (auto pos = q.events.begin(); pos != end_pos; pos = q.events.next(pos)) {
+        auto &event = q.events.get(pos);
         if (event.log_event_id != 0) {
           deleted_log_event_ids.push_back(event.log_event_id);
         }
@@ -263,22 +456,12 @@ class TQueueImpl final : public TQueue {
     auto callback_clear_time = Time::now() - start_time;
 
     std::map<EventId, RawEvent> deleted_events;
-    if (keep_count > size / 2) {
-      for (auto it = q.events.begin(); it != end_it;) {
-        q.total_event_length -= it->second.data.size();
-        bool is_inserted = deleted_events.emplace(it->first, std::move(it->second)).second;
-        CHECK(is_inserted);
-        it = q.events.erase(it);
-      }
-    } else {
-      q.total_event_length = 0;
-      for (auto it = end_it; it != q.events.end();) {
-        q.total_event_length += it->second.data.size();
-        bool is_inserted = deleted_events.emplace(it->first, std::move(it->second)).second;
-        CHECK(is_inserted);
-        it = q.events.erase(it);
-      }
-      std::swap(deleted_events, q.events);
+    for (auto pos = q.events.begin(); pos != end_pos;) {
+      auto &event = q.events.get(pos);
+      q.total_event_length -= event.data.size();
+      auto event_id = event.event_id;
+      deleted_events.emplace_hint(deleted_events.end(), event_id, std::move(event));
+      pos = q.events.erase(pos);
     }
 
     auto clear_time = Time::now() - start_time;
@@ -313,8 +496,11 @@ class TQueueImpl final : public TQueue {
   }
 
   std::pair<int64, bool> run_gc(int32 unix_time_now) final {
+    return run_gc(unix_time_now, Time::now() + MAX_GC_TIME);
+  }
+
+  std::pair<int64, bool> run_gc(int32 unix_time_now, double max_finish_time) {
     int64 deleted_events = 0;
-    auto max_finish_time = Time::now() + 0.05;
     int64 counter = 0;
     while (!queue_gc_at_.empty()) {
       auto it = queue_gc_at_.begin();
@@ -328,8 +514,8 @@ class TQueueImpl final : public TQueue {
 
       if (!q.events.empty()) {
         size_t size_before = get_size(q);
-        for (auto event_it = q.events.begin(); event_it != q.events.end();) {
-          auto &event = event_it->second;
+        for (auto pos = q.events.begin(); pos != q.events.end();) {
+          auto &event = q.events.get(pos);
           if ((++counter & 128) == 0 && Time::now() >= max_finish_time) {
             if (new_gc_at == 0) {
               new_gc_at = event.expires_at;
@@ -337,13 +523,13 @@ class TQueueImpl final : public TQueue {
             break;
           }
           if (event.expires_at < unix_time_now || event.data.empty()) {
-            pop(q, queue_id, event_it, q.tail_id);
+            pop(q, queue_id, pos, q.tail_id);
           } else {
             if (new_gc_at != 0) {
               break;
             }
             new_gc_at = event.expires_at;
-            ++event_it;
+            pos = q.events.next(pos);
           }
         }
         size_t size_after = get_size(q);
@@ -376,7 +562,7 @@ class TQueueImpl final : public TQueue {
  private:
   struct Queue {
     EventId tail_id;
-    std::map<EventId, RawEvent> events;
+    TQueueEvents events;
     size_t total_event_length = 0;
     int32 gc_at = 0;
   };
@@ -389,7 +575,7 @@ class TQueueImpl final : public TQueue {
     if (q.events.empty()) {
       return q.tail_id;
     }
-    return q.events.begin()->first;
+    return q.events.front().event_id;
   }
 
   static size_t get_size(const Queue &q) {
@@ -397,13 +583,13 @@ class TQueueImpl final : public TQueue {
       return 0;
     }
 
-    return q.events.size() - (q.events.rbegin()->second.data.empty() ? 1 : 0);
+    return q.events.size() - (q.events.back().data.empty() ? 1 : 0);
   }
 
-  void pop(Queue &q, QueueId queue_id, std::map<EventId, RawEvent>::iterator &it, EventId tail_id) {
-    auto &event = it->second;
+  void pop(Queue &q, QueueId queue_id, size_t &pos, EventId tail_id) {
+    auto &event = q.events.get(pos);
     if (callback_ == nullptr || event.log_event_id == 0) {
-      remove_event(q, it);
+      remove_event(q, pos);
       return;
     }
 
@@ -412,16 +598,16 @@ class TQueueImpl final : public TQueue {
         clear_event_data(q, event);
         callback_->push(queue_id, event);
       }
-      ++it;
+      pos = q.events.next(pos);
     } else {
       callback_->pop(event.log_event_id);
-      remove_event(q, it);
+      remove_event(q, pos);
     }
   }
 
-  static void remove_event(Queue &q, std::map<EventId, RawEvent>::iterator &it) {
-    q.total_event_length -= it->second.data.size();
-    it = q.events.erase(it);
+  static void remove_event(Queue &q, size_t &pos) {
+    q.total_event_length -= q.events.get(pos).data.size();
+    pos = q.events.erase(pos);
   }
 
   static void clear_event_data(Queue &q, RawEvent &event) {
@@ -432,16 +618,16 @@ class TQueueImpl final : public TQueue {
   void do_get(QueueId queue_id, Queue &q, EventId from_id, bool forget_previous, int32 unix_time_now,
               MutableSpan<Event> &result_events) {
     if (forget_previous) {
-      for (auto it = q.events.begin(); it != q.events.end() && it->first < from_id;) {
-        pop(q, queue_id, it, q.tail_id);
+      for (auto pos = q.events.begin(); pos != q.events.end() && q.events.get(pos).event_id < from_id;) {
+        pop(q, queue_id, pos, q.tail_id);
       }
     }
 
     size_t ready_n = 0;
-    for (auto it = q.events.lower_bound(from_id); it != q.events.end();) {
-      auto &event = it->second;
+    for (auto pos = q.events.lower_bound(from_id); pos != q.events.end();) {
+      auto &event = q.events.get(pos);
       if (event.expires_at < unix_time_now || event.data.empty()) {
-        pop(q, queue_id, it, q.tail_id);
+        pop(q, queue_id, pos, q.tail_id);
       } else {
         CHECK(!(event.event_id < from_id));
         if (ready_n == result_events.size()) {
@@ -454,7 +640,7 @@ class TQueueImpl final : public TQueue {
         to.expires_at = event.expires_at;
         to.extra = event.extra;
         ready_n++;
-        ++it;
+        pos = q.events.next(pos);
       }
     }
 
@@ -474,10 +660,166 @@ class TQueueImpl final : public TQueue {
   }
 };
 
+class TQueueConcurrent final : public TQueue {
+ public:
+  explicit TQueueConcurrent(size_t shard_count) : shards_(max(shard_count, static_cast<size_t>(1))) {
+    for (auto &shard : shards_) {
+      shard = make_unique<Shard>();
+    }
+  }
+
+  // must not be called simultaneously with other methods
+  void set_callback(unique_ptr<StorageCallback> callback) final {
+    callback_ = std::move(callback);
+    for (auto &shard : shards_) {
+      auto shard_lock = shard->mutex.lock();
+      shard->queue.set_callback(callback_ == nullptr ? nullptr
+                                                     : make_unique<LockedStorageCallback>(&callback_mutex_, callback_.get()));
+    }
+  }
+  unique_ptr<StorageCallback> extract_callback() final {
+    for (auto &shard : shards_) {
+      auto shard_lock = shard->mutex.lock();
+      shard->queue.extract_callback();
+    }
+    return std::move(callback_);
+  }
+
+  bool do_push(QueueId queue_id, RawEvent &&raw_event) final {
+    auto &shard = get_shard(queue_id);
+    auto lock = shard.mutex.lock();
+    return shard.queue.do_push(queue_id, std::move(raw_event));
+  }
+
+  Result<EventId> push(QueueId queue_id, string data, int32 expires_at, int64 extra, EventId hint_new_id) final {
+    auto &shard = get_shard(queue_id);
+    auto lock = shard.mutex.lock();
+    return shard.queue.push(queue_id, std::move(data), expires_at, extra, hint_new_id);
+  }
+
+  void forget(QueueId queue_id, EventId event_id) final {
+    auto &shard = get_shard(queue_id);
+    auto lock = shard.mutex.lock();
+    shard.queue.forget(queue_id, event_id);
+  }
+
+  std::map<EventId, RawEvent> clear(QueueId queue_id, size_t keep_count) final {
+    auto &shard = get_shard(queue_id);
+    auto lock = shard.mutex.lock();
+    return shard.queue.clear(queue_id, keep_count);
+  }
+
+  EventId get_head(QueueId queue_id) const final {
+    auto &shard = get_shard(queue_id);
+    auto lock = shard.mutex.lock();
+    return shard.queue.get_head(queue_id);
+  }
+
+  EventId get_tail(QueueId queue_id) const final {
+    auto &shard = get_shard(queue_id);
+    auto lock = shard.mutex.lock();
+    return shard.queue.get_tail(queue_id);
+  }
+
+  Result<size_t> get(QueueId queue_id, EventId from_id, bool forget_previous, int32 unix_time_now,
+                     MutableSpan<Event> &result_events) final {
+    auto &shard = get_shard(queue_id);
+    auto lock = shard.mutex.lock();
+    return shard.queue.get(queue_id, from_id, forget_previous, unix_time_now, result_events);
+  }
+
+  size_t get_size(QueueId queue_id) const final {
+    auto &shard = get_shard(queue_id);
+    auto lock = shard.mutex.lock();
+    return shard.queue.get_size(queue_id);
+  }
+
+  std::pair<int64, bool> run_gc(int32 unix_time_now) final {
+    // all shards share the time limit of a single queue; the next call continues from the unfinished shard,
+    // so that the first shards can't starve the others
+    auto max_finish_time = Time::now() + TQueueImpl::MAX_GC_TIME;
+    int64 deleted_events = 0;
+    for (size_t i = 0; i < shards_.size(); i++) {
+      auto &shard = shards_[next_gc_shard_];
+      auto lock = shard->mutex.lock();
+      auto result = shard->queue.run_gc(unix_time_now, max_finish_time);
+      deleted_events += result.first;
+      if (!result.second) {
+        return {deleted_events, false};
+      }
+      next_gc_shard_ = (next_gc_shard_ + 1) % shards_.size();
+    }
+    return {deleted_events, true};
+  }
+
+  void close(Promise<> promise) final {
+    auto callback = extract_callback();
+    if (callback != nullptr) {
+      callback->close(std::move(promise));
+    }
+  }
+
+ private:
+  // serializes calls to the common storage callback from different shards
+  class LockedStorageCallback final : public StorageCallback {
+   public:
+    LockedStorageCallback(Mutex *mutex, StorageCallback *callback) : mutex_(mutex), callback_(callback) {
+    }
+
+    uint64 push(QueueId queue_id, const RawEvent &event) final {
+      auto lock = mutex_->lock();
+      return callback_->push(queue_id, event);
+    }
+
+    void pop(uint64 log_event_id) final {
+      auto lock = mutex_->lock();
+      callback_->pop(log_event_id);
+    }
+
+    void pop_batch(std::vector<uint64> log_event_ids) final {
+      auto lock = mutex_->lock();
+      callback_->pop_batch(std::move(log_event_ids));
+    }
+
+    void close(Promise<> promise) final {
+      UNREACHABLE();
+    }
+
+   private:
+    Mutex *mutex_;
+    StorageCallback *callback_;
+  };
+
+  struct Shard {
+    mutable Mutex mutex;
+    TQueueImpl queue;
+  };
+
+  vector<unique_ptr<Shard>> shards_;
+  size_t next_gc_shard_ = 0;
+  Mutex callback_mutex_;
+  unique_ptr<StorageCallback> callback_;
+
+  size_t get_shard_index(QueueId queue_id) const {
+    return static_cast<size_t>(Hash<QueueId>()(queue_id)) % shards_.size();
+  }
+
+  Shard &get_shard(QueueId queue_id) {
+    return *shards_[get_shard_index(queue_id)];
+  }
+  const Shard &get_shard(QueueId queue_id) const {
+    return *shards_[get_shard_index(queue_id)];
+  }
+};
+
 unique_ptr<TQueue> TQueue::create() {
   return make_unique<TQueueImpl>();
 }
 
+unique_ptr<TQueue> TQueue::create_concurrent(size_t shard_count) {
+  return make_unique<TQueueConcurrent>(shard_count);
+}
+
 struct TQueueLogEvent final : public Storer {
   int64 queue_id;
   int32 event_id;
@@ -605,6 +947,422 @@ void TQueueMemoryStorage::close(Promise<> promise) {
   promise.set_value({});
 }
 
+namespace {
+
+struct TQueueSegmentRecord final : public Storer {
+  static constexpr int32 PUSH = 1;
+  static constexpr int32 ERASE = 2;
+
+  int32 type = 0;
+  uint64 log_event_id = 0;
+  int64 queue_id = 0;
+  int32 event_id = 0;
+  int32 expires_at = 0;
+  Slice data;
+  int64 extra = 0;
+
+  template <class StorerT>
+  void store(StorerT &&storer) const {
+    using td::store;
+    store(type, storer);
+    store(log_event_id, storer);
+    if (type == PUSH) {
+      store(queue_id, storer);
+      store(event_id, storer);
+      store(expires_at, storer);
+      store(data, storer);
+      store(extra, storer);
+    }
+  }
+
+  template <class ParserT>
+  void parse(ParserT &&parser) {
+    using td::parse;
+    parse(type, parser);
+    parse(log_event_id, parser);
+    if (type == PUSH) {
+      parse(queue_id, parser);
+      parse(event_id, parser);
+      parse(expires_at, parser);
+      data = parser.template fetch_string<Slice>();
+      parse(extra, parser);
+    } else if (type != ERASE) {
+      parser.set_error("Invalid record type");
+    }
+  }
+
+  size_t size() const final {
+    TlStorerCalcLength storer;
+    store(storer);
+    return storer.get_length();
+  }
+
+  size_t store(uint8 *ptr) const final {
+    TlStorerUnsafe storer(ptr);
+    store(storer);
+    return static_cast<size_t>(storer.get_buf() - ptr);
+  }
+};
+
+// a record is stored as its length, CRC32 and data
+constexpr size_t SEGMENT_RECORD_HEADER_SIZE = 8;
+
+struct TQueueSegment {
+  uint32 segment_id = 0;
+  string path;
+  BufferSlice data;
+  vector<TQueueSegmentRecord> records;
+};
+
+Status parse_tqueue_segment(TQueueSegment &segment) {
+  CSlice path = segment.path;
+  TRY_RESULT_ASSIGN(segment.data, read_file(path));
+  auto data = segment.data.as_slice();
+  while (!data.empty()) {
+    if (data.size() < SEGMENT_RECORD_HEADER_SIZE) {
+      LOG(WARNING) << "Ignore incomplete record header at the end of " << path;
+      break;
+    }
+    TlParser header_parser(data.substr(0, SEGMENT_RECORD_HEADER_SIZE));
+    auto record_size = static_cast<size_t>(header_parser.fetch_int());
+    auto record_crc = static_cast<uint32>(header_parser.fetch_int());
+    if (record_size > data.size() - SEGMENT_RECORD_HEADER_SIZE) {
+      LOG(WARNING) << "Ignore incomplete record at the end of " << path;
+      break;
+    }
+    auto record_data = data.substr(SEGMENT_RECORD_HEADER_SIZE, record_size);
+    if (crc32(record_data) != record_crc) {
+      LOG(WARNING) << "Ignore records with CRC mismatch at the end of " << path;
+      break;
+    }
+    TQueueSegmentRecord record;
+    TlParser parser(record_data);
+    record.parse(parser);
+    parser.fetch_end();
+    TRY_STATUS(parser.get_status());
+    segment.records.push_back(std::move(record));
+    data.remove_prefix(SEGMENT_RECORD_HEADER_SIZE + record_size);
+  }
+  return Status::OK();
+}
+
+Status parse_tqueue_segments(vector<TQueueSegment> &segments) {
+  auto parse_segments = [&](size_t first, size_t step) {
+    Status status;
+    for (size_t i = first; i < segments.size(); i += step) {
+      auto r_status = parse_tqueue_segment(segments[i]);
+      if (r_status.is_error() && status.is_ok()) {
+        status = std::move(r_status);
+      }
+    }
+    return status;
+  };
+
+#if !TD_THREAD_UNSUPPORTED
+  auto thread_count = min(static_cast<size_t>(max(thread::hardware_concurrency(), 1u)), segments.size());
+  if (thread_count > 1) {
+    vector<Status> statuses(thread_count);
+    vector<thread> threads;
+    for (size_t i = 1; i < thread_count; i++) {
+      threads.emplace_back([&, i] { statuses[i] = parse_segments(i, thread_count); });
+    }
+    statuses[0] = parse_segments(0, thread_count);
+    for (auto &parse_thread : threads) {
+      parse_thread.join();
+    }
+    for (auto &status : statuses) {
+      TRY_STATUS(std::move(status));
+    }
+    return Status::OK();
+  }
+#endif
+  return parse_segments(0, 1);
+}
+
+}  // namespace
+
+TQueueSegmentStorage::~TQueueSegmentStorage() {
+  if (!current_fd_.empty()) {
+    flush();
+    current_fd_.close();
+  }
+}
+
+Status TQueueSegmentStorage::init(string directory, TQueue &q, size_t max_segment_size) {
+  directory_ = std::move(directory);
+  max_segment_size_ = max_segment_size;
+  TRY_STATUS(mkpath(PSLICE() << directory_ << TD_DIR_SLASH));
+
+  vector<TQueueSegment> segments;
+  bool is_root_directory = true;
+  TRY_STATUS(WalkPath::run(directory_, [&](CSlice path, WalkPath::Type type) {
+    if (type == WalkPath::Type::EnterDir) {
+      if (is_root_directory) {
+        is_root_directory = false;
+        return WalkPath::Action::Continue;
+      }
+      return WalkPath::Action::SkipDir;
+    }
+    auto file_name = PathView(path).file_name();
+    if (type == WalkPath::Type::RegularFile && ends_with(file_name, ".tqs")) {
+      auto r_segment_id = to_integer_safe<uint32>(file_name.substr(0, file_name.size() - 4));
+      if (r_segment_id.is_ok()) {
+        TQueueSegment segment;
+        segment.segment_id = r_segment_id.ok();
+        segment.path = path.str();
+        segments.push_back(std::move(segment));
+      }
+    }
+    return WalkPath::Action::Continue;
+  }));
+  std::sort(segments.begin(), segments.end(),
+            [](const TQueueSegment &lhs, const TQueueSegment &rhs) { return lhs.segment_id < rhs.segment_id; });
+
+  TRY_STATUS(parse_tqueue_segments(segments));
+
+  struct Event {
+    uint32 segment_id;
+    int64 queue_id;
+    const TQueueSegmentRecord *record;
+  };
+  std::map<uint64, Event> events;
+  for (auto &segment : segments) {
+    auto segment_id = segment.segment_id;
+    auto &info = segments_[segment_id];
+    for (auto &record : segment.records) {
+      auto it = events.find(record.log_event_id);
+      if (it != events.end()) {
+        auto old_segment_id = it->second.segment_id;
+        segments_[old_segment_id].event_count--;
+        if (old_segment_id != segment_id) {
+          info.overridden_segments.insert(old_segment_id);
+        }
+      }
+      if (record.type == TQueueSegmentRecord::PUSH) {
+        events[record.log_event_id] = Event{segment_id, record.queue_id, &record};
+        info.event_count++;
+      } else if (it != events.end()) {
+        events.erase(it);
+      }
+      next_log_event_id_ = max(next_log_event_id_, record.log_event_id + 1);
+    }
+  }
+  current_segment_id_ = segments.empty() ? 1 : segments.back().segment_id + 1;
+  TRY_STATUS(open_segment(current_segment_id_));
+
+  for (auto &it : events) {
+    auto &record = *it.second.record;
+    event_segment_ids_[it.first] = it.second.segment_id;
+    auto r_event_id = EventId::from_int32(record.event_id);
+    RawEvent raw_event;
+    raw_event.log_event_id = it.first;
+    if (r_event_id.is_ok()) {
+      raw_event.event_id = r_event_id.move_as_ok();
+      raw_event.expires_at = record.expires_at;
+      raw_event.data = record.data.str();
+      raw_event.extra = record.extra;
+    }
+    if (r_event_id.is_error() || !q.do_push(it.second.queue_id, std::move(raw_event))) {
+      pop(it.first);
+    }
+  }
+  need_delete_segments_ = true;
+  delete_segments();
+  return Status::OK();
+}
+
+Status TQueueSegmentStorage::destroy(CSlice directory) {
+  return rmrf(directory);
+}
+
+uint64 TQueueSegmentStorage::push(QueueId queue_id, const RawEvent &event) {
+  CHECK(!current_fd_.empty());
+  auto log_event_id = event.log_event_id;
+  if (log_event_id == 0) {
+    log_event_id = next_log_event_id_++;
+  } else {
+    on_event_overridden(log_event_id);
+  }
+
+  TQueueSegmentRecord record;
+  record.type = TQueueSegmentRecord::PUSH;
+  record.log_event_id = log_event_id;
+  record.queue_id = queue_id;
+  record.event_id = event.event_id.value();
+  record.expires_at = event.expires_at;
+  record.data = event.data;
+  record.extra = event.extra;
+  append_record(record);
+
+  event_segment_ids_[log_event_id] = current_segment_id_;
+  segments_[current_segment_id_].event_count++;
+
+  // TQueue erases the previous empty last event of the queue just before a push, so the records are written only
+  // after pushes; otherwise, after a crash the queue could lose its last event and reuse event identifiers
+  if (current_segment_size_ >= max_segment_size_) {
+    start_next_segment();
+  } else if (buffer_.size() > (1 << 14)) {
+    write_buffer();
+  }
+  delete_segments();
+  return log_event_id;
+}
+
+void TQueueSegmentStorage::pop(uint64 log_event_id) {
+  CHECK(!current_fd_.empty());
+  if (event_segment_ids_.count(log_event_id) == 0) {
+    return;
+  }
+  on_event_overridden(log_event_id);
+  event_segment_ids_.erase(log_event_id);
+
+  TQueueSegmentRecord record;
+  record.type = TQueueSegmentRecord::ERASE;
+  record.log_event_id = log_event_id;
+  append_record(record);
+}
+
+void TQueueSegmentStorage::pop_batch(std::vector<uint64> log_event_ids) {
+  for (auto log_event_id : log_event_ids) {
+    pop(log_event_id);
+  }
+}
+
+void TQueueSegmentStorage::close(Promise<> promise) {
+  if (!current_fd_.empty()) {
+    flush();
+    sync();
+    current_fd_.close();
+  }
+  promise.set_value(Unit());
+}
+
+void TQueueSegmentStorage::flush() {
+  write_buffer();
+  delete_segments();
+}
+
+void TQueueSegmentStorage::write_buffer() {
+  Slice data = buffer_;
+  while (!data.empty()) {
+    auto r_size = current_fd_.write(data);
+    if (r_size.is_error()) {
+      LOG(FATAL) << "Failed to write to " << get_segment_path(current_segment_id_) << ": " << r_size.error();
+    }
+    data.remove_prefix(r_size.ok());
+  }
+  buffer_.clear();
+}
+
+void TQueueSegmentStorage::sync() {
+  auto status = current_fd_.sync();
+  if (status.is_error()) {
+    LOG(FATAL) << "Failed to sync " << get_segment_path(current_segment_id_) << ": " << status;
+  }
+}
+
+string TQueueSegmentStorage::get_segment_path(uint32 segment_id) const {
+  return PSTRING() << directory_ << TD_DIR_SLASH << segment_id << ".tqs";
+}
+
+Status TQueueSegmentStorage::open_segment(uint32 segment_id) {
+  TRY_RESULT(fd, FileFd::open(get_segment_path(segment_id), FileFd::Write | FileFd::CreateNew));
+  current_fd_ = std::move(fd);
+  current_segment_id_ = segment_id;
+  current_segment_size_ = 0;
+  segments_[segment_id];
+  return Status::OK();
+}
+
+void TQueueSegmentStorage::start_next_segment() {
+  write_buffer();
+  // records in the segment can override records from older segments, which can be deleted later
+  sync();
+  current_fd_.close();
+  // the previous segment can become deletable, because it isn't the current segment anymore
+  need_delete_segments_ = true;
+  auto status = open_segment(current_segment_id_ + 1);
+  if (status.is_error()) {
+    LOG(FATAL) << "Failed to create TQueue segment: " << status;
+  }
+}
+
+void TQueueSegmentStorage::append_record(const Storer &record) {
+  auto record_size = record.size();
+  auto old_buffer_size = buffer_.size();
+  buffer_.resize(old_buffer_size + SEGMENT_RECORD_HEADER_SIZE + record_size);
+  auto ptr = MutableSlice(buffer_).substr(old_buffer_size).ubegin();
+  auto stored_size = record.store(ptr + SEGMENT_RECORD_HEADER_SIZE);
+  CHECK(stored_size == record_size);
+  TlStorerUnsafe header_storer(ptr);
+  header_storer.store_int(static_cast<int32>(record_size));
+  header_storer.store_int(
+      static_cast<int32>(crc32(Slice(ptr + SEGMENT_RECORD_HEADER_SIZE, ptr + SEGMENT_RECORD_HEADER_SIZE + record_size))));
+  current_segment_size_ += SEGMENT_RECORD_HEADER_SIZE + record_size;
+}
+
+void TQueueSegmentStorage::on_event_overridden(uint64 log_event_id) {
+  auto it = event_segment_ids_.find(log_event_id);
+  if (it == event_segment_ids_.end()) {
+    return;
+  }
+  auto segment_id = it->second;
+  auto &segment = segments_[segment_id];
+  CHECK(segment.event_count > 0);
+  segment.event_count--;
+  if (segment_id != current_segment_id_) {
+    // the new record can't be deleted before the overridden one
+    segments_[current_segment_id_].overridden_segments.insert(segment_id);
+    if (segment.event_count == 0) {
+      need_delete_segments_ = true;
+    }
+  }
+}
+
+void TQueueSegmentStorage::delete_segments() {
+  if (!need_delete_segments_) {
+    return;
+  }
+  need_delete_segments_ = false;
+
+  // overridden segments are always older, so a single pass is enough
+  vector<uint32> deleted_segment_ids;
+  for (auto it = segments_.begin(); it != segments_.end();) {
+    auto &segment = it->second;
+    if (it->first == current_segment_id_ || segment.event_count != 0) {
+      ++it;
+      continue;
+    }
+    bool can_delete = true;
+    for (auto overridden_segment_id : segment.overridden_segments) {
+      if (segments_.count(overridden_segment_id) != 0) {
+        can_delete = false;
+        break;
+      }
+    }
+    if (!can_delete) {
+      ++it;
+      continue;
+    }
+    deleted_segment_ids.push_back(it->first);
+    it = segments_.erase(it);
+  }
+  if (deleted_segment_ids.empty()) {
+    return;
+  }
+
+  // records, which override records from the deleted segments, must be persisted before the segments are deleted;
+  // otherwise, after a crash both versions of the events would be lost and their identifiers could be reused
+  write_buffer();
+  sync();
+  for (auto segment_id : deleted_segment_ids) {
+    auto status = unlink(get_segment_path(segment_id));
+    if (status.is_error()) {
+      LOG(ERROR) << "Failed to delete TQueue segment: " << status;
+    }
+  }
+}
+
 void TQueue::StorageCallback::pop_batch(std::vector<uint64> log_event_ids) {
   for (auto id : log_event_ids) {
     pop(id);
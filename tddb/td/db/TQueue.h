@@ -7,14 +7,18 @@
 #pragma once
 
 #include "td/utils/common.h"
+#include "td/utils/FlatHashMap.h"
+#include "td/utils/port/FileFd.h"
 #include "td/utils/Promise.h"
 #include "td/utils/Slice.h"
 #include "td/utils/Span.h"
 #include "td/utils/Status.h"
+#include "td/utils/StorerBase.h"
 #include "td/utils/StringBuilder.h"
 
 #include <map>
 #include <memory>
+#include <set>
 #include <utility>
 
 namespace td {
@@ -88,6 +92,11 @@ class TQueue {
 
   static unique_ptr<TQueue> create();
 
+  // creates TQueue, which can be used from different threads simultaneously
+  // queues are distributed between shard_count independently locked shards, so the storage callback
+  // is called under a lock; data of events returned by get is valid only until the queue is changed
+  static unique_ptr<TQueue> create_concurrent(size_t shard_count);
+
   TQueue() = default;
   TQueue(const TQueue &) = delete;
   TQueue &operator=(const TQueue &) = delete;
@@ -154,4 +163,70 @@ class TQueueMemoryStorage final : public TQueue::StorageCallback {
   std::map<uint64, std::pair<QueueId, RawEvent>> events_;
 };
 
+// stores events in a directory as a sequence of append-only segment files of bounded size
+// a segment file is deleted as soon as all events in it are popped, so no compaction is needed
+class TQueueSegmentStorage final : public TQueue::StorageCallback {
+ public:
+  static constexpr size_t DEFAULT_MAX_SEGMENT_SIZE = 1 << 24;
+
+  TQueueSegmentStorage() = default;
+  TQueueSegmentStorage(const TQueueSegmentStorage &) = delete;
+  TQueueSegmentStorage &operator=(const TQueueSegmentStorage &) = delete;
+  TQueueSegmentStorage(TQueueSegmentStorage &&) = delete;
+  TQueueSegmentStorage &operator=(TQueueSegmentStorage &&) = delete;
+  ~TQueueSegmentStorage() final;
+
+  // replays existing segments to the queue, parsing them in parallel, and starts a new segment
+  Status init(string directory, TQueue &q, size_t max_segment_size = DEFAULT_MAX_SEGMENT_SIZE) TD_WARN_UNUSED_RESULT;
+
+  static Status destroy(CSlice directory) TD_WARN_UNUSED_RESULT;
+
+  uint64 push(QueueId queue_id, const RawEvent &event) final;
+  void pop(uint64 log_event_id) final;
+  void pop_batch(std::vector<uint64> log_event_ids) final;
+  void close(Promise<> promise) final;
+
+  // writes buffered records to the current segment and deletes unneeded segments; must be called periodically
+  void flush();
+
+  size_t get_segment_count() const {
+    return segments_.size();
+  }
+
+ private:
+  struct Segment {
+    // number of records with the last version of an event
+    size_t event_count = 0;
+    // older segments, records from which were overridden by records from the segment
+    std::set<uint32> overridden_segments;
+  };
+
+  string directory_;
+  size_t max_segment_size_ = DEFAULT_MAX_SEGMENT_SIZE;
+  std::map<uint32, Segment> segments_;
+  uint32 current_segment_id_ = 0;
+  FileFd current_fd_;
+  size_t current_segment_size_ = 0;
+  string buffer_;
+  uint64 next_log_event_id_{1};
+  bool need_delete_segments_ = false;
+  FlatHashMap<uint64, uint32> event_segment_ids_;
+
+  string get_segment_path(uint32 segment_id) const;
+
+  Status open_segment(uint32 segment_id);
+
+  void write_buffer();
+
+  void sync();
+
+  void start_next_segment();
+
+  void append_record(const Storer &record);
+
+  void on_event_overridden(uint64 log_event_id);
+
+  void delete_segments();
+};
+
 }  // namespace td
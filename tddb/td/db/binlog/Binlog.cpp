@@ -8,6 +8,7 @@
 
 #include "td/db/binlog/detail/BinlogEventsBuffer.h"
 #include "td/db/binlog/detail/BinlogEventsProcessor.h"
+#include "td/db/DbTrace.h"
 
 #include "td/utils/buffer.h"
 #include "td/utils/format.h"
@@ -231,6 +232,17 @@ void Binlog::add_event(BinlogEvent &&event) {
     LOG(FATAL) << "Trying to add event with bad size " << event.public_to_string();
   }
 
+  unique_ptr<DbTraceEvent> trace_event;
+  if (is_traced()) {
+    trace_event = make_unique<DbTraceEvent>();
+    trace_event->type = DbTraceEvent::Type::BinlogEvent;
+    trace_event->time = Time::now();
+    trace_event->binlog_event_id = event.id_;
+    trace_event->binlog_event_type = event.type_;
+    trace_event->binlog_event_flags = event.flags_;
+    trace_event->size = event.size_;
+  }
+
   if (!events_buffer_) {
     do_add_event(std::move(event));
   } else {
@@ -252,6 +264,11 @@ void Binlog::add_event(BinlogEvent &&event) {
       do_reindex();
     }
   }
+
+  if (trace_event != nullptr) {
+    trace_event->duration = Time::now() - trace_event->time;
+    trace_->add_event(std::move(*trace_event));
+  }
 }
 
 size_t Binlog::flush_events_buffer(bool force) {
@@ -408,8 +425,16 @@ void Binlog::sync(const char *source) {
   flush(source);
   if (need_sync_) {
     LOG(INFO) << "Sync binlog from " << source;
+    auto start_time = is_traced() ? Time::now() : 0.0;
     auto status = fd_.sync();
     LOG_IF(FATAL, status.is_error()) << "Failed to sync binlog: " << status;
+    if (start_time != 0.0) {
+      DbTraceEvent trace_event;
+      trace_event.type = DbTraceEvent::Type::BinlogSync;
+      trace_event.time = start_time;
+      trace_event.duration = Time::now() - start_time;
+      trace_->add_event(std::move(trace_event));
+    }
     need_sync_ = false;
   }
 }
@@ -8,6 +8,7 @@
 
 #include "td/db/binlog/BinlogEvent.h"
 #include "td/db/DbKey.h"
+#include "td/db/DbTrace.h"
 
 #include "td/utils/AesCtrByteFlow.h"
 #include "td/utils/buffer.h"
@@ -24,6 +25,7 @@
 #include "td/utils/UInt.h"
 
 #include <functional>
+#include <memory>
 
 namespace td {
 
@@ -117,6 +119,11 @@ class Binlog {
   }
   void change_key(DbKey new_db_key);
 
+  // records added events and syncs to the trace while it is enabled
+  void set_trace(std::shared_ptr<DbTrace> trace) {
+    trace_ = std::move(trace);
+  }
+
   Status close(bool need_sync = true) TD_WARN_UNUSED_RESULT;
   void close(Promise<> promise);
   Status close_and_destroy() TD_WARN_UNUSED_RESULT;
@@ -163,9 +170,13 @@ class Binlog {
   double need_flush_since_ = 0;
   double next_buffer_flush_time_ = 0;
   bool need_sync_{false};
+  std::shared_ptr<DbTrace> trace_;
   enum class State { Empty, Load, Reindex, Run } state_{State::Empty};
 
   static Result<FileFd> open_binlog(const string &path, int32 flags);
+  bool is_traced() const {
+    return trace_ != nullptr && trace_->is_enabled();
+  }
   size_t flush_events_buffer(bool force);
   void do_add_event(BinlogEvent &&event);
   void do_event(BinlogEvent &&event);
@@ -6,11 +6,15 @@
 //
 #pragma once
 
+#include "td/db/DbTrace.h"
+
 #include "td/utils/optional.h"
 #include "td/utils/Slice.h"
 #include "td/utils/SliceBuilder.h"
 #include "td/utils/Status.h"
 
+#include <memory>
+
 struct tdsqlite3;
 
 namespace td {
@@ -67,11 +71,27 @@ class RawSqliteDb {
     return cipher_version_.copy();
   }
 
+  void set_trace(std::shared_ptr<DbTrace> trace) {
+    trace_connection_id_ = trace->add_connection();
+    trace_ = std::move(trace);
+  }
+
+  // returns the trace if operations of the connection must be recorded now
+  DbTrace *get_enabled_trace() const {
+    return trace_ != nullptr && trace_->is_enabled() ? trace_.get() : nullptr;
+  }
+
+  int32 get_trace_connection_id() const {
+    return trace_connection_id_;
+  }
+
  private:
   tdsqlite3 *db_;
   std::string path_;
   size_t begin_cnt_{0};
   optional<int32> cipher_version_;
+  std::shared_ptr<DbTrace> trace_;
+  int32 trace_connection_id_ = 0;
 };
 
 }  // namespace detail
@@ -0,0 +1,136 @@
+//
+// Copyright Aliaksei Levin (levlam@telegram.org), Arseny Smirnov (arseny30@gmail.com) 2014-2024
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+#include "td/db/detail/SqliteFtsTokenizer.h"
+
+#include "sqlite/sqlite3.h"
+
+#include "td/utils/common.h"
+#include "td/utils/Slice.h"
+#include "td/utils/SliceBuilder.h"
+#include "td/utils/unicode.h"
+#include "td/utils/utf8.h"
+
+namespace td {
+namespace detail {
+
+namespace {
+
+// the tokenizer has no options, so the same dummy object is returned for all tables
+char tokenizer_instance;
+
+int create_tokenizer(void *, const char **, int, Fts5Tokenizer **tokenizer) {
+  *tokenizer = reinterpret_cast<Fts5Tokenizer *>(&tokenizer_instance);
+  return SQLITE_OK;
+}
+
+void delete_tokenizer(Fts5Tokenizer *) {
+}
+
+size_t get_utf8_character_length(unsigned char c) {
+  if (c < 0x80) {
+    return 1;
+  }
+  if (c < 0xe0) {
+    return 2;
+  }
+  if (c < 0xf0) {
+    return 3;
+  }
+  return 4;
+}
+
+int tokenize(Fts5Tokenizer *, void *context, int, const char *text, int text_size,
+             int (*on_token)(void *, int, const char *, int, int, int)) {
+  auto begin = reinterpret_cast<const unsigned char *>(text);
+  auto end = begin + text_size;
+  string token;
+  bool is_service_token = false;
+  int token_begin = 0;
+  int token_end = 0;
+  auto flush_token = [&] {
+    if (token.empty()) {
+      return SQLITE_OK;
+    }
+    auto rc = on_token(context, 0, token.data(), static_cast<int>(token.size()), token_begin, token_end);
+    token.clear();
+    is_service_token = false;
+    return rc;
+  };
+
+  auto pos = begin;
+  while (pos < end) {
+    auto code_begin = static_cast<int>(pos - begin);
+    if (static_cast<size_t>(end - pos) < get_utf8_character_length(*pos)) {
+      // the text is truncated in the middle of a character
+      break;
+    }
+    uint32 code;
+    pos = next_utf8_unsafe(pos, &code);
+
+    if (code == '\a' || (is_service_token && code > ' ' && code < 0x80)) {
+      if (token.empty()) {
+        is_service_token = true;
+        token_begin = code_begin;
+      }
+      if (is_service_token) {
+        token += static_cast<char>(code);
+        token_end = static_cast<int>(pos - begin);
+        continue;
+      }
+    }
+
+    code = prepare_search_character(code);
+    if (code == 0) {
+      continue;
+    }
+    if (code == ' ' || is_service_token) {
+      auto rc = flush_token();
+      if (rc != SQLITE_OK) {
+        return rc;
+      }
+      if (code == ' ') {
+        continue;
+      }
+    }
+    if (token.empty()) {
+      token_begin = code_begin;
+    }
+    append_utf8_character(token, remove_diacritics(code));
+    token_end = static_cast<int>(pos - begin);
+  }
+  return flush_token();
+}
+
+}  // namespace
+
+Status register_sqlite_fts_tokenizer(tdsqlite3 *db) {
+  fts5_api *api = nullptr;
+  tdsqlite3_stmt *stmt = nullptr;
+  auto rc = tdsqlite3_prepare_v2(db, "SELECT fts5(?1)", -1, &stmt, nullptr);
+  if (rc != SQLITE_OK) {
+    return Status::Error(PSLICE() << "Failed to register FTS5 tokenizer: " << Slice(tdsqlite3_errmsg(db)));
+  }
+  tdsqlite3_bind_pointer(stmt, 1, &api, "fts5_api_ptr", nullptr);
+  tdsqlite3_step(stmt);
+  tdsqlite3_finalize(stmt);
+  if (api == nullptr) {
+    return Status::Error("FTS5 is unavailable");
+  }
+
+  fts5_tokenizer tokenizer;
+  tokenizer.xCreate = create_tokenizer;
+  tokenizer.xDelete = delete_tokenizer;
+  tokenizer.xTokenize = tokenize;
+  rc = api->xCreateTokenizer(api, "td", nullptr, &tokenizer, nullptr);
+  if (rc != SQLITE_OK) {
+    return Status::Error(PSLICE() << "Failed to create FTS5 tokenizer: error " << rc);
+  }
+  return Status::OK();
+}
+
+}  // namespace detail
+}  // namespace td
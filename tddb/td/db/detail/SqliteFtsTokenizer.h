@@ -0,0 +1,22 @@
+//
+// Copyright Aliaksei Levin (levlam@telegram.org), Arseny Smirnov (arseny30@gmail.com) 2014-2024
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+#pragma once
+
+#include "td/utils/Status.h"
+
+struct tdsqlite3;
+
+namespace td {
+namespace detail {
+
+// Registers FTS5 tokenizer "td" for the database connection. The tokenizer splits a text into words
+// like utf8_get_search_words, so the index matches client-side search. Additionally, a word starting with '\a'
+// is a service token, which is kept as is up to the next space.
+Status register_sqlite_fts_tokenizer(tdsqlite3 *db) TD_WARN_UNUSED_RESULT;
+
+}  // namespace detail
+}  // namespace td
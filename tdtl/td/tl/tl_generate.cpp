@@ -138,6 +138,46 @@ static void write_class_constructor(tl_outputer &out, const tl_combinator *t, co
   out.append(w.gen_constructor_end(t, field_num, is_default));
 }
 
+// returns lengths, which need to be checked before fetching of each field, as expected by gen_fixed_size_field_fetch;
+// consecutive fixed-size fields are fetched after a single check of their total length
+static std::vector<int> get_fetch_checked_lengths(const tl_combinator *t, int parser_type, const TL_writer &w) {
+  // after a failed length check the parser returns zeroes for at most 32 bytes
+  const int MAX_CHECKED_LENGTH = 32;
+
+  std::vector<int> result(t->args.size(), 0);
+  std::size_t i = 0;
+  while (i < t->args.size()) {
+    int length = w.get_fixed_field_size(t->args[i], parser_type);
+    std::size_t j = i + 1;
+    if (length > 0) {
+      while (j < t->args.size()) {
+        int field_size = w.get_fixed_field_size(t->args[j], parser_type);
+        if (field_size <= 0 || length + field_size > MAX_CHECKED_LENGTH) {
+          break;
+        }
+        length += field_size;
+        j++;
+      }
+    }
+    if (j - i >= 2) {
+      result[i] = length;
+      for (std::size_t k = i + 1; k < j; k++) {
+        result[k] = -1;
+      }
+    }
+    i = j;
+  }
+  return result;
+}
+
+static std::string gen_field_fetch(int field_num, const arg &a, std::vector<var_description> &vars, bool flat,
+                                   int parser_type, int checked_length, const TL_writer &w) {
+  if (checked_length == 0) {
+    return w.gen_field_fetch(field_num, a, vars, flat, parser_type);
+  }
+  return w.gen_fixed_size_field_fetch(field_num, a, vars, parser_type, checked_length);
+}
+
 static void write_function_fetch(tl_outputer &out, const std::string &parser_name, const tl_combinator *t,
                                  const std::string &class_name, const std::set<std::string> &request_types,
                                  const std::set<std::string> &result_types, const TL_writer &w) {
@@ -152,9 +192,10 @@ static void write_function_fetch(tl_outputer &out, const std::string &parser_nam
   out.append(w.gen_fetch_function_begin(parser_name, class_name, class_name, 0, static_cast<int>(t->args.size()), vars,
                                         parser_type));
   out.append(w.gen_vars(t, NULL, vars));
+  std::vector<int> checked_lengths = get_fetch_checked_lengths(t, parser_type, w);
   int field_num = 0;
   for (std::size_t i = 0; i < t->args.size(); i++) {
-    std::string field_fetch = w.gen_field_fetch(field_num, t->args[i], vars, false, parser_type);
+    std::string field_fetch = gen_field_fetch(field_num, t->args[i], vars, false, parser_type, checked_lengths[i], w);
     if (!field_fetch.empty()) {
       out.append(field_fetch);
       field_num++;
@@ -237,9 +278,11 @@ static void write_constructor_fetch(tl_outputer &out, const std::string &parser_
                                         static_cast<int>(t->args.size()), vars, parser_type));
   out.append(w.gen_vars(t, result_type, vars));
   out.append(w.gen_uni(result_type, vars, true));
+  std::vector<int> checked_lengths = get_fetch_checked_lengths(t, parser_type, w);
   int field_num = 0;
   for (std::size_t i = 0; i < t->args.size(); i++) {
-    std::string field_fetch = w.gen_field_fetch(field_num, t->args[i], vars, is_flat, parser_type);
+    std::string field_fetch =
+        gen_field_fetch(field_num, t->args[i], vars, is_flat, parser_type, checked_lengths[i], w);
     if (!field_fetch.empty()) {
       out.append(field_fetch);
       field_num++;
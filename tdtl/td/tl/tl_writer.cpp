@@ -175,6 +175,15 @@ TL_writer::Mode TL_writer::get_storer_mode(int type) const {
   return All;
 }
 
+int TL_writer::get_fixed_field_size(const arg &a, int parser_type) const {
+  return 0;
+}
+
+std::string TL_writer::gen_fixed_size_field_fetch(int field_num, const arg &a, std::vector<var_description> &vars,
+                                                  int parser_type, int checked_length) const {
+  return gen_field_fetch(field_num, a, vars, false, parser_type);
+}
+
 std::string TL_writer::gen_field_type(const arg &a) const {
   if (a.flags & FLAG_EXCL) {
     assert(a.flags == FLAG_EXCL);
@@ -112,6 +112,13 @@ class TL_writer {
   virtual std::string gen_constructor_id_store(std::int32_t id, int storer_type) const = 0;
   virtual std::string gen_field_fetch(int field_num, const arg &a, std::vector<var_description> &vars, bool flat,
                                       int parser_type) const = 0;
+  // returns size of the field if it always has the same size and can be fetched without checking remaining length
+  virtual int get_fixed_field_size(const arg &a, int parser_type) const;
+  // fetches a field of fixed size; if checked_length > 0, then it also checks that there is enough data
+  // for checked_length bytes, i.e. for the field and some following fixed-size fields; if checked_length == -1,
+  // then the length was already checked
+  virtual std::string gen_fixed_size_field_fetch(int field_num, const arg &a, std::vector<var_description> &vars,
+                                                 int parser_type, int checked_length) const;
   virtual std::string gen_field_store(const arg &a, std::vector<var_description> &vars, bool flat,
                                       int storer_type) const = 0;
   virtual std::string gen_type_fetch(const std::string &field_name, const tl_tree_type *tree_type,
@@ -0,0 +1,609 @@
+//
+// Copyright Aliaksei Levin (levlam@telegram.org), Arseny Smirnov (arseny30@gmail.com) 2014-2024
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+#include "td/utils/BinaryFileLog.h"
+
+#include "td/utils/algorithm.h"
+#include "td/utils/misc.h"
+#include "td/utils/port/Clocks.h"
+#include "td/utils/port/FileFd.h"
+#include "td/utils/port/path.h"
+#include "td/utils/port/sleep.h"
+#include "td/utils/port/thread_local.h"
+#include "td/utils/SliceBuilder.h"
+#include "td/utils/StringBuilder.h"
+
+#include <cstring>
+#include <limits>
+#include <map>
+#include <memory>
+#include <utility>
+
+namespace td {
+
+namespace {
+
+template <class T>
+void append_raw(string &out, const T &value) {
+  out.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+template <class T>
+T fetch_raw(Slice &data) {
+  T result;
+  CHECK(data.size() >= sizeof(result));
+  std::memcpy(&result, data.data(), sizeof(result));
+  data.remove_prefix(sizeof(result));
+  return result;
+}
+
+}  // namespace
+
+constexpr uint32 BinaryLogFormat::MAGIC;
+constexpr uint32 BinaryLogFormat::VERSION;
+
+Status decode_binary_log(Slice data, const std::function<void(const BinaryLogMessage &)> &callback) {
+  if (data.size() < 2 * sizeof(uint32) || fetch_raw<uint32>(data) != BinaryLogFormat::MAGIC) {
+    return Status::Error("Not a binary log file");
+  }
+  auto version = fetch_raw<uint32>(data);
+  if (version != BinaryLogFormat::VERSION) {
+    return Status::Error(PSLICE() << "Unsupported binary log version " << version);
+  }
+
+  vector<std::pair<Slice, int32>> call_sites(1);
+  while (!data.empty()) {
+    if (data.size() < 2 * sizeof(uint32)) {
+      return Status::Error("Truncated record header");
+    }
+    auto size = fetch_raw<uint32>(data);
+    auto type = static_cast<BinaryLogFormat::RecordType>(fetch_raw<uint32>(data));
+    if (size < 2 * sizeof(uint32) || size - 2 * sizeof(uint32) > data.size()) {
+      return Status::Error(PSLICE() << "Invalid record size " << size);
+    }
+    auto record = data.substr(0, size - 2 * sizeof(uint32));
+    data.remove_prefix(record.size());
+
+    switch (type) {
+      case BinaryLogFormat::RecordType::CallSite: {
+        if (record.size() < 2 * sizeof(uint32)) {
+          return Status::Error("Invalid call site record");
+        }
+        auto call_site_id = fetch_raw<uint32>(record);
+        auto line_num = fetch_raw<int32>(record);
+        if (call_site_id != call_sites.size()) {
+          return Status::Error(PSLICE() << "Unexpected call site " << call_site_id);
+        }
+        call_sites.emplace_back(record, line_num);
+        break;
+      }
+      case BinaryLogFormat::RecordType::Message: {
+        if (record.size() < 4 * sizeof(uint32) + sizeof(uint64)) {
+          return Status::Error("Invalid message record");
+        }
+        BinaryLogMessage message;
+        auto call_site_id = fetch_raw<uint32>(record);
+        message.log_level = fetch_raw<int32>(record);
+        message.thread_id = fetch_raw<int32>(record);
+        fetch_raw<uint32>(record);
+        message.time_nsec = fetch_raw<uint64>(record);
+        if (call_site_id >= call_sites.size()) {
+          return Status::Error(PSLICE() << "Unknown call site " << call_site_id);
+        }
+        message.file_name = call_sites[call_site_id].first;
+        message.line_num = call_sites[call_site_id].second;
+        message.text = record;
+        callback(message);
+        break;
+      }
+      case BinaryLogFormat::RecordType::Dropped: {
+        if (record.size() < 2 * sizeof(uint32) + sizeof(uint64)) {
+          return Status::Error("Invalid dropped record");
+        }
+        BinaryLogMessage message;
+        message.thread_id = fetch_raw<int32>(record);
+        fetch_raw<uint32>(record);
+        message.dropped_count = fetch_raw<uint64>(record);
+        callback(message);
+        break;
+      }
+      default:
+        // skip records of unknown types
+        break;
+    }
+  }
+  return Status::OK();
+}
+
+string format_binary_log_message(const BinaryLogMessage &message) {
+  if (message.log_level == VERBOSITY_NAME(PLAIN) && message.file_name.empty()) {
+    return message.text.str();
+  }
+  if (message.dropped_count != 0) {
+    return PSTRING() << "[t" << message.thread_id << "] " << message.dropped_count << " messages were dropped\n";
+  }
+
+  auto unix_time = message.time_nsec / 1000000000;
+  auto nanoseconds = static_cast<uint32>(message.time_nsec % 1000000000);
+  string nanoseconds_str = to_string(nanoseconds);
+  if (nanoseconds_str.size() < 9) {
+    nanoseconds_str.insert(0, 9 - nanoseconds_str.size(), '0');
+  }
+
+  auto result = PSTRING() << '[' << (static_cast<uint32>(message.log_level) < 10 ? " " : "") << message.log_level
+                          << "][t" << (static_cast<uint32>(message.thread_id) < 10 ? " " : "") << message.thread_id
+                          << "][" << unix_time << '.' << nanoseconds_str << ']';
+  if (!message.file_name.empty()) {
+    result += PSTRING() << '[' << message.file_name << ':' << static_cast<uint32>(message.line_num) << ']';
+    // the text of a message from a known call site begins with the tags and '\t'
+  } else {
+    result += '\t';
+  }
+  result.append(message.text.data(), message.text.size());
+  if (result.back() != '\n') {
+    result += '\n';
+  }
+  return result;
+}
+
+#if !TD_THREAD_UNSUPPORTED
+
+// single-producer single-consumer ring buffer of variable-size records
+class BinaryFileLog::ThreadBuffer {
+ public:
+  struct RecordHeader {
+    uint32 size;  // size of the whole record including padding
+    int32 log_level;
+    int32 line_num;
+    int32 thread_id;
+    uint64 time_nsec;
+    const char *file_name;
+    uint32 file_name_size;
+    uint32 text_size;
+  };
+
+  static constexpr int32 PADDING_LOG_LEVEL = std::numeric_limits<int32>::min();
+  static constexpr size_t ALIGNMENT = 8;
+
+  explicit ThreadBuffer(size_t capacity) {
+    capacity_ = 1;
+    while (capacity_ < capacity) {
+      capacity_ *= 2;
+    }
+    CHECK(capacity_ >= 64 * sizeof(RecordHeader));
+    storage_.resize(capacity_ / sizeof(uint64));
+  }
+
+  // must be called only by the owner thread
+  bool push(int log_level, Slice file_name, int line_num, Slice text) {
+    auto max_text_size = capacity_ / 4;
+    if (text.size() > max_text_size) {
+      text.truncate(max_text_size);
+    }
+    auto size = align(sizeof(RecordHeader) + text.size());
+
+    auto write_pos = write_pos_.load(std::memory_order_relaxed);
+    auto read_pos = read_pos_.load(std::memory_order_acquire);
+    auto offset = static_cast<size_t>(write_pos & (capacity_ - 1));
+    auto tail_size = capacity_ - offset;
+    size_t padding_size = tail_size < size ? tail_size : 0;
+    if (write_pos + padding_size + size - read_pos > capacity_) {
+      dropped_count_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+
+    char *data = reinterpret_cast<char *>(storage_.data());
+    if (padding_size != 0) {
+      RecordHeader padding;
+      padding.size = static_cast<uint32>(padding_size);
+      padding.log_level = PADDING_LOG_LEVEL;
+      // only size and log_level fields of a padding record are used
+      std::memcpy(data + offset, &padding, ALIGNMENT);
+      offset = 0;
+    }
+
+    RecordHeader header;
+    header.size = static_cast<uint32>(size);
+    header.log_level = log_level;
+    header.line_num = line_num;
+    header.thread_id = get_thread_id();
+    auto time = Clocks::system();
+    auto unix_time = static_cast<uint64>(time);
+    header.time_nsec = unix_time * 1000000000 + static_cast<uint64>((time - static_cast<double>(unix_time)) * 1e9);
+    header.file_name = file_name.empty() ? nullptr : file_name.data();
+    header.file_name_size = static_cast<uint32>(file_name.size());
+    header.text_size = static_cast<uint32>(text.size());
+    std::memcpy(data + offset, &header, sizeof(header));
+    std::memcpy(data + offset + sizeof(header), text.data(), text.size());
+
+    write_pos_.store(write_pos + padding_size + size, std::memory_order_release);
+    return true;
+  }
+
+  // must be called only by the writer thread
+  template <class F>
+  size_t pop_all(F &&f) {
+    auto read_pos = read_pos_.load(std::memory_order_relaxed);
+    auto write_pos = write_pos_.load(std::memory_order_acquire);
+    const char *data = reinterpret_cast<const char *>(storage_.data());
+    size_t count = 0;
+    while (read_pos < write_pos) {
+      RecordHeader header;
+      auto offset = static_cast<size_t>(read_pos & (capacity_ - 1));
+      std::memcpy(&header, data + offset, ALIGNMENT);
+      if (header.log_level != PADDING_LOG_LEVEL) {
+        std::memcpy(&header, data + offset, sizeof(header));
+        f(header, Slice(data + offset + sizeof(header), header.text_size));
+        count++;
+      }
+      read_pos += header.size;
+    }
+    read_pos_.store(read_pos, std::memory_order_release);
+    return count;
+  }
+
+  uint64 get_dropped_count() {
+    return dropped_count_.exchange(0, std::memory_order_relaxed);
+  }
+
+  int32 get_thread_id_hint() const {
+    return thread_id_hint_;
+  }
+
+  // must be called by the owner thread after the last push
+  void release() {
+    is_released_.store(true, std::memory_order_release);
+  }
+
+  bool is_released() const {
+    return is_released_.load(std::memory_order_acquire);
+  }
+
+ private:
+  int32 thread_id_hint_ = get_thread_id();
+  size_t capacity_ = 0;
+  vector<uint64> storage_;
+  std::atomic<uint64> write_pos_{0};
+  char pad_[TD_CONCURRENCY_PAD - sizeof(std::atomic<uint64>)];
+  std::atomic<uint64> read_pos_{0};
+  std::atomic<uint64> dropped_count_{0};
+  std::atomic<bool> is_released_{false};
+
+  static size_t align(size_t size) {
+    return (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+  }
+};
+
+// owns the log file; is used only by the writer thread
+class BinaryFileLog::Writer {
+ public:
+  Writer(string path, int64 rotate_threshold, int32 max_old_file_count)
+      : path_(std::move(path)), rotate_threshold_(rotate_threshold), max_old_file_count_(max_old_file_count) {
+  }
+
+  void open() {
+    fd_.close();
+    auto r_stat = stat(path_);
+    if (r_stat.is_ok() && r_stat.ok().size_ > 0) {
+      // never append to an existing file, because it can have a different format
+      rotate_files();
+    }
+    auto r_fd = FileFd::open(path_, FileFd::Create | FileFd::Truncate | FileFd::Write);
+    if (r_fd.is_error()) {
+      process_fatal_error(PSLICE() << r_fd.error() << " in " << __FILE__ << " at " << __LINE__ << '\n');
+    }
+    fd_ = r_fd.move_as_ok();
+    size_ = 0;
+    call_site_ids_.clear();
+    append_raw(buffer_, BinaryLogFormat::MAGIC);
+    append_raw(buffer_, BinaryLogFormat::VERSION);
+  }
+
+  void close() {
+    flush();
+    fd_.close();
+  }
+
+  void add_message(const ThreadBuffer::RecordHeader &header, Slice text) {
+    if (size_ + static_cast<int64>(buffer_.size()) > rotate_threshold_) {
+      flush();
+      rotate_files();
+      open();
+    }
+
+    uint32 call_site_id = 0;
+    if (header.file_name != nullptr) {
+      auto it = call_site_ids_.find(std::make_pair(header.file_name, header.line_num));
+      if (it == call_site_ids_.end()) {
+        call_site_id = static_cast<uint32>(call_site_ids_.size() + 1);
+        call_site_ids_.emplace(std::make_pair(header.file_name, header.line_num), call_site_id);
+
+        Slice file_name(header.file_name, header.file_name_size);
+        auto last_slash = file_name.size();
+        while (last_slash > 0 && file_name[last_slash - 1] != '/' && file_name[last_slash - 1] != '\\') {
+          last_slash--;
+        }
+        file_name.remove_prefix(last_slash);
+
+        append_record_header(BinaryLogFormat::RecordType::CallSite, 2 * sizeof(uint32) + file_name.size());
+        append_raw(buffer_, call_site_id);
+        append_raw(buffer_, header.line_num);
+        buffer_.append(file_name.data(), file_name.size());
+      } else {
+        call_site_id = it->second;
+      }
+    }
+
+    append_record_header(BinaryLogFormat::RecordType::Message, 4 * sizeof(uint32) + sizeof(uint64) + text.size());
+    append_raw(buffer_, call_site_id);
+    append_raw(buffer_, header.log_level);
+    append_raw(buffer_, header.thread_id);
+    append_raw(buffer_, static_cast<uint32>(0));
+    append_raw(buffer_, header.time_nsec);
+    buffer_.append(text.data(), text.size());
+
+    if (buffer_.size() >= MAX_BUFFER_SIZE) {
+      flush();
+    }
+  }
+
+  void add_dropped(int32 thread_id, uint64 dropped_count) {
+    append_record_header(BinaryLogFormat::RecordType::Dropped, 2 * sizeof(uint32) + sizeof(uint64));
+    append_raw(buffer_, thread_id);
+    append_raw(buffer_, static_cast<uint32>(0));
+    append_raw(buffer_, dropped_count);
+  }
+
+  void flush() {
+    Slice slice = buffer_;
+    while (!slice.empty()) {
+      auto r_size = fd_.write(slice);
+      if (r_size.is_error()) {
+        process_fatal_error(PSLICE() << r_size.error() << " in " << __FILE__ << " at " << __LINE__ << '\n');
+      }
+      slice.remove_prefix(r_size.ok());
+    }
+    size_ += static_cast<int64>(buffer_.size());
+    written_size_ += buffer_.size();
+    buffer_.clear();
+  }
+
+  uint64 get_written_size() const {
+    return written_size_;
+  }
+
+ private:
+  static constexpr size_t MAX_BUFFER_SIZE = 1 << 20;
+
+  string path_;
+  int64 rotate_threshold_;
+  int32 max_old_file_count_;
+
+  FileFd fd_;
+  int64 size_ = 0;
+  uint64 written_size_ = 0;
+  string buffer_;
+  std::map<std::pair<const char *, int32>, uint32> call_site_ids_;
+
+  void append_record_header(BinaryLogFormat::RecordType type, size_t data_size) {
+    append_raw(buffer_, static_cast<uint32>(2 * sizeof(uint32) + data_size));
+    append_raw(buffer_, static_cast<uint32>(type));
+  }
+
+  void rotate_files() {
+    fd_.close();
+    if (max_old_file_count_ <= 0) {
+      unlink(path_).ignore();
+      return;
+    }
+    for (int32 i = max_old_file_count_ - 1; i >= 1; i--) {
+      rename(PSLICE() << path_ << '.' << i, PSLICE() << path_ << '.' << (i + 1)).ignore();
+    }
+    auto status = rename(path_, PSLICE() << path_ << ".1");
+    if (status.is_error()) {
+      process_fatal_error(PSLICE() << status << " in " << __FILE__ << " at " << __LINE__ << '\n');
+    }
+  }
+};
+
+// the buffer of a thread is released when the thread exits or starts to use another log
+struct BinaryFileLog::ThreadBufferRef {
+  uint64 log_id = 0;
+  std::shared_ptr<ThreadBuffer> buffer;
+
+  ThreadBufferRef() = default;
+  ThreadBufferRef(const ThreadBufferRef &) = delete;
+  ThreadBufferRef &operator=(const ThreadBufferRef &) = delete;
+  ThreadBufferRef(ThreadBufferRef &&) = delete;
+  ThreadBufferRef &operator=(ThreadBufferRef &&) = delete;
+  ~ThreadBufferRef() {
+    if (buffer != nullptr) {
+      buffer->release();
+    }
+  }
+};
+
+TD_THREAD_LOCAL BinaryFileLog::ThreadBufferRef *BinaryFileLog::thread_buffer_ref_;
+
+namespace {
+std::atomic<uint64> binary_file_log_id{0};
+}  // namespace
+
+BinaryFileLog::BinaryFileLog() = default;
+
+Status BinaryFileLog::init(string path, int64 rotate_threshold, int32 max_old_file_count,
+                           size_t thread_buffer_size) {
+  CHECK(path_.empty());
+  CHECK(!path.empty());
+  CHECK(max_old_file_count >= 0);
+
+  TRY_RESULT(fd, FileFd::open(path, FileFd::Create | FileFd::Write | FileFd::Append));
+  fd.close();
+
+  auto r_path = realpath(path, true);
+  if (r_path.is_error()) {
+    path_ = std::move(path);
+  } else {
+    path_ = r_path.move_as_ok();
+  }
+  max_old_file_count_ = max_old_file_count;
+  thread_buffer_size_ = thread_buffer_size;
+  log_id_ = ++binary_file_log_id;
+
+  writer_thread_ = td::thread([this, rotate_threshold] { run_writer(rotate_threshold); });
+  return Status::OK();
+}
+
+BinaryFileLog::~BinaryFileLog() {
+  if (path_.empty()) {
+    return;
+  }
+  need_close_ = true;
+  writer_waiter_.notify();
+  writer_thread_.join();
+}
+
+BinaryFileLog::Stats BinaryFileLog::get_stats() const {
+  Stats result;
+  result.message_count = message_count_.load(std::memory_order_relaxed);
+  result.dropped_count = dropped_count_.load(std::memory_order_relaxed);
+  result.written_size = written_size_.load(std::memory_order_relaxed);
+  std::lock_guard<std::mutex> guard(buffers_mutex_);
+  result.thread_buffer_count = buffers_.size();
+  return result;
+}
+
+void BinaryFileLog::flush() {
+  if (path_.empty()) {
+    return;
+  }
+  auto generation = ++flush_generation_;
+  writer_waiter_.notify();
+  while (flushed_generation_.load() < generation) {
+    usleep_for(100);
+  }
+}
+
+BinaryFileLog::ThreadBuffer *BinaryFileLog::get_thread_buffer() {
+  auto ref = thread_buffer_ref_;
+  if (ref != nullptr && ref->log_id == log_id_) {
+    return ref->buffer.get();
+  }
+
+  init_thread_local<ThreadBufferRef>(thread_buffer_ref_);
+  ref = thread_buffer_ref_;
+  if (ref->buffer != nullptr) {
+    ref->buffer->release();
+  }
+  ref->buffer = std::make_shared<ThreadBuffer>(thread_buffer_size_);
+  ref->log_id = log_id_;
+  {
+    std::lock_guard<std::mutex> guard(buffers_mutex_);
+    buffers_.push_back(ref->buffer);
+    buffers_generation_.fetch_add(1, std::memory_order_release);
+  }
+  return ref->buffer.get();
+}
+
+void BinaryFileLog::run_writer(int64 rotate_threshold) {
+  Writer writer(path_, rotate_threshold, max_old_file_count_);
+  writer.open();
+
+  vector<std::shared_ptr<ThreadBuffer>> buffers;
+  uint64 buffers_generation = 0;
+  MpmcEagerWaiter::Slot slot;
+  MpmcEagerWaiter::init_slot(slot, 0);
+  while (true) {
+    auto need_close = need_close_.load();
+    auto flush_generation = flush_generation_.load();
+    if (need_reopen_.exchange(false)) {
+      writer.flush();
+      writer.open();
+    }
+    if (buffers_generation != buffers_generation_.load(std::memory_order_acquire)) {
+      std::lock_guard<std::mutex> guard(buffers_mutex_);
+      buffers = buffers_;
+      buffers_generation = buffers_generation_.load(std::memory_order_relaxed);
+    }
+
+    size_t message_count = 0;
+    vector<const ThreadBuffer *> released_buffers;
+    for (auto &buffer : buffers) {
+      // the flag must be checked before the buffer is drained for the last time
+      auto is_released = buffer->is_released();
+      auto dropped_count = buffer->get_dropped_count();
+      if (dropped_count != 0) {
+        dropped_count_ += dropped_count;
+        writer.add_dropped(buffer->get_thread_id_hint(), dropped_count);
+      }
+      message_count += buffer->pop_all(
+          [&writer](const ThreadBuffer::RecordHeader &header, Slice text) { writer.add_message(header, text); });
+      if (is_released) {
+        released_buffers.push_back(buffer.get());
+      }
+    }
+    message_count_ += message_count;
+    if (!released_buffers.empty()) {
+      // free buffers of finished threads, which were drained after they were released
+      std::lock_guard<std::mutex> guard(buffers_mutex_);
+      td::remove_if(buffers_, [&released_buffers](const std::shared_ptr<ThreadBuffer> &buffer) {
+        return td::contains(released_buffers, buffer.get());
+      });
+      buffers = buffers_;
+      buffers_generation = buffers_generation_.load(std::memory_order_relaxed);
+    }
+
+    if (message_count == 0 || flush_generation != flushed_generation_.load(std::memory_order_relaxed)) {
+      writer.flush();
+      written_size_ = writer.get_written_size();
+      flushed_generation_ = flush_generation;
+      if (need_close) {
+        break;
+      }
+    }
+    if (message_count == 0) {
+      writer_waiter_.wait(slot);
+    } else {
+      writer_waiter_.stop_wait(slot);
+    }
+  }
+  writer.close();
+}
+
+vector<string> BinaryFileLog::get_file_paths() {
+  vector<string> result;
+  if (!path_.empty()) {
+    result.push_back(path_);
+    for (int32 i = 1; i <= max_old_file_count_; i++) {
+      result.push_back(PSTRING() << path_ << '.' << i);
+    }
+  }
+  return result;
+}
+
+void BinaryFileLog::after_rotation() {
+  need_reopen_ = true;
+  writer_waiter_.notify();
+}
+
+void BinaryFileLog::do_append(int log_level, CSlice slice) {
+  do_append_structured(log_level, Slice(), 0, slice);
+}
+
+void BinaryFileLog::do_append_structured(int log_level, Slice file_name, int line_num, CSlice slice) {
+  if (path_.empty()) {
+    process_fatal_error("BinaryFileLog is not inited");
+  }
+  get_thread_buffer()->push(log_level, file_name, line_num, slice);
+  writer_waiter_.notify();
+  if (log_level == VERBOSITY_NAME(FATAL)) {
+    flush();
+  }
+}
+
+#endif
+
+}  // namespace td
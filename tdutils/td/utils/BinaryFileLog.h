@@ -0,0 +1,136 @@
+//
+// Copyright Aliaksei Levin (levlam@telegram.org), Arseny Smirnov (arseny30@gmail.com) 2014-2024
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+#pragma once
+
+#include "td/utils/common.h"
+#include "td/utils/logging.h"
+#include "td/utils/MpmcWaiter.h"
+#include "td/utils/port/thread.h"
+#include "td/utils/port/thread_local.h"
+#include "td/utils/Slice.h"
+#include "td/utils/Status.h"
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+namespace td {
+
+// binary log file format:
+// file header: uint32 MAGIC, uint32 VERSION
+// record: uint32 size of the whole record, uint32 type, type-specific data
+//   CallSite: uint32 call_site_id, int32 line_num, file name
+//   Message: uint32 call_site_id, int32 log_level, int32 thread_id, uint32 padding, uint64 time_nsec, text
+//   Dropped: int32 thread_id, uint32 padding, uint64 dropped_count
+// call site identifiers are local to a file and 0 means that the call site is unknown
+struct BinaryLogFormat {
+  static constexpr uint32 MAGIC = 0x4C425444;
+  static constexpr uint32 VERSION = 1;
+  enum class RecordType : uint32 { CallSite = 1, Message = 2, Dropped = 3 };
+};
+
+struct BinaryLogMessage {
+  int32 log_level = 0;
+  int32 thread_id = 0;
+  uint64 time_nsec = 0;
+  Slice file_name;
+  int32 line_num = 0;
+  Slice text;
+  uint64 dropped_count = 0;  // if non-zero, the other fields except thread_id are empty
+};
+
+// calls the callback for every message in the content of a binary log file
+Status decode_binary_log(Slice data, const std::function<void(const BinaryLogMessage &)> &callback);
+
+// formats the message in the same way as Logger does
+string format_binary_log_message(const BinaryLogMessage &message);
+
+#if !TD_THREAD_UNSUPPORTED
+
+// writes compact binary records to per-thread lock-free ring buffers, which are drained to the file
+// by a background thread; a record is dropped instead of blocking if the buffer of the thread is full
+// the message text is still formatted by the caller, only formatting of the prefix is left to binary_log_dump,
+// which can be used to convert the file to text
+// the buffer of a thread is freed after the thread exits, if the thread was created with td::thread
+class BinaryFileLog final : public LogInterface {
+ public:
+  static constexpr int64 DEFAULT_ROTATE_THRESHOLD = 10 << 20;
+  static constexpr size_t DEFAULT_THREAD_BUFFER_SIZE = 1 << 20;
+
+  struct Stats {
+    uint64 message_count = 0;
+    uint64 dropped_count = 0;
+    uint64 written_size = 0;
+    size_t thread_buffer_count = 0;
+  };
+
+  BinaryFileLog();
+  BinaryFileLog(const BinaryFileLog &) = delete;
+  BinaryFileLog &operator=(const BinaryFileLog &) = delete;
+  BinaryFileLog(BinaryFileLog &&) = delete;
+  BinaryFileLog &operator=(BinaryFileLog &&) = delete;
+  ~BinaryFileLog() final;
+
+  // the log file is renamed to path.1 after reaching rotate_threshold bytes; at most max_old_file_count
+  // previous files path.1, ..., path.<max_old_file_count> are kept
+  Status init(string path, int64 rotate_threshold = DEFAULT_ROTATE_THRESHOLD, int32 max_old_file_count = 1,
+              size_t thread_buffer_size = DEFAULT_THREAD_BUFFER_SIZE);
+
+  // waits until all previously added messages are written to the file
+  void flush();
+
+  Stats get_stats() const;
+
+ private:
+  class ThreadBuffer;
+  class Writer;
+  struct ThreadBufferRef;
+
+  static TD_THREAD_LOCAL ThreadBufferRef *thread_buffer_ref_;
+
+  string path_;
+  int32 max_old_file_count_ = 0;
+  size_t thread_buffer_size_ = 0;
+  uint64 log_id_ = 0;
+
+  mutable std::mutex buffers_mutex_;
+  vector<std::shared_ptr<ThreadBuffer>> buffers_;
+  std::atomic<uint64> buffers_generation_{0};
+
+  std::atomic<uint64> flush_generation_{0};
+  std::atomic<uint64> flushed_generation_{0};
+  std::atomic<bool> need_reopen_{false};
+  std::atomic<bool> need_close_{false};
+  std::atomic<uint64> message_count_{0};
+  std::atomic<uint64> dropped_count_{0};
+  std::atomic<uint64> written_size_{0};
+
+  // the writer thread sleeps until it is notified about new messages or requests
+  MpmcEagerWaiter writer_waiter_;
+  thread writer_thread_;
+
+  ThreadBuffer *get_thread_buffer();
+
+  void run_writer(int64 rotate_threshold);
+
+  vector<string> get_file_paths() final;
+
+  void after_rotation() final;
+
+  bool is_structured() const final {
+    return true;
+  }
+
+  void do_append(int log_level, CSlice slice) final;
+
+  void do_append_structured(int log_level, Slice file_name, int line_num, CSlice slice) final;
+};
+
+#endif
+
+}  // namespace td
@@ -7,6 +7,10 @@
 #pragma once
 
 //#include "td/utils/FlatHashMapChunks.h"
+#include "td/utils/common.h"
+#if TD_FLAT_HASH_TABLE_SWISS
+#include "td/utils/FlatHashMapSwiss.h"
+#endif
 #include "td/utils/FlatHashTable.h"
 #include "td/utils/HashTableUtils.h"
 #include "td/utils/MapNode.h"
@@ -16,8 +20,13 @@
 
 namespace td {
 
+#if TD_FLAT_HASH_TABLE_SWISS
+template <class KeyT, class ValueT, class HashT = Hash<KeyT>, class EqT = std::equal_to<KeyT>>
+using FlatHashMap = FlatHashTableSwiss<MapNode<KeyT, ValueT, EqT>, HashT, EqT>;
+#else
 template <class KeyT, class ValueT, class HashT = Hash<KeyT>, class EqT = std::equal_to<KeyT>>
 using FlatHashMap = FlatHashTable<MapNode<KeyT, ValueT, EqT>, HashT, EqT>;
+#endif
 //using FlatHashMap = FlatHashMapChunks<KeyT, ValueT, HashT, EqT>;
 //using FlatHashMap = std::unordered_map<KeyT, ValueT, HashT, EqT>;
 
@@ -0,0 +1,676 @@
+//
+// Copyright Aliaksei Levin (levlam@telegram.org), Arseny Smirnov (arseny30@gmail.com) 2014-2024
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+#pragma once
+
+#include "td/utils/bits.h"
+#include "td/utils/common.h"
+#include "td/utils/FlatHashTable.h"
+#include "td/utils/HashTableUtils.h"
+#include "td/utils/MapNode.h"
+#include "td/utils/SetNode.h"
+
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <utility>
+
+#if defined(__SSE2__) || (TD_MSVC && (defined(_M_X64) || (defined(_M_IX86) && _M_IX86_FP >= 2)))
+#define TD_FLAT_HASH_TABLE_SWISS_SSE2 1
+#endif
+
+#ifdef __aarch64__
+#include <arm_neon.h>
+#endif
+
+#if TD_FLAT_HASH_TABLE_SWISS_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace td {
+
+namespace detail {
+
+// mask of matching slots in a group; each slot is represented by shift bits
+template <int shift>
+struct SwissMask {
+  uint64 mask;
+
+  explicit operator bool() const noexcept {
+    return mask != 0;
+  }
+  uint32 lowest_slot() const {
+    return static_cast<uint32>(count_trailing_zeroes64(mask)) / shift;
+  }
+  uint32 highest_slot() const {
+    return static_cast<uint32>(63 - count_leading_zeroes64(mask)) / shift;
+  }
+  void next() {
+    mask &= mask - 1;
+  }
+};
+
+// control bytes of 16 consecutive slots: EMPTY, DELETED or 7 bits of the hash of the key in the full slot
+struct SwissGroup {
+  static constexpr uint32 SIZE = 16;
+  static constexpr uint8 EMPTY = 0x80;
+  static constexpr uint8 DELETED = 0xFE;
+
+#if TD_FLAT_HASH_TABLE_SWISS_SSE2
+  using Mask = SwissMask<1>;
+
+  static Mask match(const uint8 *ctrl, uint8 value) {
+    auto group = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ctrl));
+    auto match_mask = _mm_cmpeq_epi8(_mm_set1_epi8(static_cast<char>(value)), group);
+    return {static_cast<uint32>(_mm_movemask_epi8(match_mask))};
+  }
+
+  static Mask match_empty_or_deleted(const uint8 *ctrl) {
+    auto group = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ctrl));
+    return {static_cast<uint32>(_mm_movemask_epi8(group))};
+  }
+#elif defined(__aarch64__)
+  using Mask = SwissMask<4>;
+
+  static Mask to_mask(uint8x16_t eq_mask) {
+    // get info from every byte into the bottom half of every uint16
+    // by shifting right 4, then round to get it into a 64-bit vector
+    uint8x8_t shifted_eq_mask = vshrn_n_u16(vreinterpretq_u16_u8(eq_mask), 4);
+    return {vget_lane_u64(vreinterpret_u64_u8(shifted_eq_mask), 0) & 0x1111111111111111};
+  }
+
+  static Mask match(const uint8 *ctrl, uint8 value) {
+    return to_mask(vceqq_u8(vld1q_u8(ctrl), vdupq_n_u8(value)));
+  }
+
+  static Mask match_empty_or_deleted(const uint8 *ctrl) {
+    return to_mask(vcltzq_s8(vreinterpretq_s8_u8(vld1q_u8(ctrl))));
+  }
+#else
+  using Mask = SwissMask<1>;
+
+  static Mask match(const uint8 *ctrl, uint8 value) {
+    uint64 mask = 0;
+    for (uint32 i = 0; i < SIZE; i++) {
+      mask |= static_cast<uint64>(ctrl[i] == value) << i;
+    }
+    return {mask};
+  }
+
+  static Mask match_empty_or_deleted(const uint8 *ctrl) {
+    uint64 mask = 0;
+    for (uint32 i = 0; i < SIZE; i++) {
+      mask |= static_cast<uint64>(ctrl[i] >> 7) << i;
+    }
+    return {mask};
+  }
+#endif
+
+  static Mask match_empty(const uint8 *ctrl) {
+    return match(ctrl, EMPTY);
+  }
+};
+
+}  // namespace detail
+
+// open addressing hash table with a control byte per slot, which are probed by groups of 16 slots
+// has the same interface as FlatHashTable, but uses less memory per element due to higher maximum load factor
+template <class NodeT, class HashT, class EqT>
+class FlatHashTableSwiss {
+  using Group = detail::SwissGroup;
+
+  static constexpr uint32 INVALID_BUCKET = 0xFFFFFFFF;
+  static constexpr uint32 MIN_BUCKET_COUNT = Group::SIZE;
+
+  void allocate_nodes(uint32 size) {
+    DCHECK(size >= MIN_BUCKET_COUNT);
+    DCHECK((size & (size - 1)) == 0);
+    CHECK(size <= min(static_cast<uint32>(1) << 29, static_cast<uint32>(0x7FFFFFFF / sizeof(NodeT))));
+    nodes_ = new NodeT[size];
+    // the first Group::SIZE - 1 control bytes are duplicated after the end to allow unaligned group loads
+    ctrl_ = new uint8[size + Group::SIZE];
+    std::memset(ctrl_, Group::EMPTY, size + Group::SIZE);
+    bucket_count_mask_ = size - 1;
+    bucket_count_ = size;
+    growth_left_ = get_max_used_node_count(size);
+    begin_bucket_ = INVALID_BUCKET;
+  }
+
+  static void clear_nodes(NodeT *nodes, uint8 *ctrl) {
+    delete[] nodes;
+    delete[] ctrl;
+  }
+
+ public:
+  using KeyT = typename NodeT::public_key_type;
+  using key_type = typename NodeT::public_key_type;
+  using value_type = typename NodeT::public_type;
+
+  struct Iterator {
+    using iterator_category = std::forward_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = typename NodeT::public_type;
+    using pointer = value_type *;
+    using reference = value_type &;
+
+    Iterator &operator++() {
+      DCHECK(it_ != nullptr);
+      do {
+        if (unlikely(++it_ == end_)) {
+          it_ = begin_;
+        }
+        if (unlikely(it_ == start_)) {
+          it_ = nullptr;
+          break;
+        }
+      } while (it_->empty());
+      return *this;
+    }
+    reference operator*() {
+      return it_->get_public();
+    }
+    const value_type &operator*() const {
+      return it_->get_public();
+    }
+    pointer operator->() {
+      return &it_->get_public();
+    }
+    const value_type *operator->() const {
+      return &it_->get_public();
+    }
+
+    NodeT *get() {
+      return it_;
+    }
+
+    bool operator==(const Iterator &other) const {
+      DCHECK(other.it_ == nullptr);
+      return it_ == nullptr;
+    }
+    bool operator!=(const Iterator &other) const {
+      DCHECK(other.it_ == nullptr);
+      return it_ != nullptr;
+    }
+
+    Iterator() = default;
+    Iterator(NodeT *it, NodeT *begin, NodeT *end) : it_(it), begin_(begin), start_(it), end_(end) {
+    }
+
+   private:
+    NodeT *it_ = nullptr;
+    NodeT *begin_ = nullptr;
+    NodeT *start_ = nullptr;
+    NodeT *end_ = nullptr;
+  };
+
+  struct ConstIterator {
+    using iterator_category = std::forward_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = typename NodeT::public_type;
+    using pointer = const value_type *;
+    using reference = const value_type &;
+
+    ConstIterator &operator++() {
+      ++it_;
+      return *this;
+    }
+    reference operator*() const {
+      return *it_;
+    }
+    pointer operator->() const {
+      return &*it_;
+    }
+    bool operator==(const ConstIterator &other) const {
+      return it_ == other.it_;
+    }
+    bool operator!=(const ConstIterator &other) const {
+      return it_ != other.it_;
+    }
+
+    ConstIterator() = default;
+    ConstIterator(Iterator it) : it_(std::move(it)) {
+    }
+
+   private:
+    Iterator it_;
+  };
+  using iterator = Iterator;
+  using const_iterator = ConstIterator;
+
+  struct NodePointer {
+    value_type &operator*() {
+      return it_->get_public();
+    }
+    const value_type &operator*() const {
+      return it_->get_public();
+    }
+    value_type *operator->() {
+      return &it_->get_public();
+    }
+    const value_type *operator->() const {
+      return &it_->get_public();
+    }
+
+    NodeT *get() {
+      return it_;
+    }
+
+    bool operator==(const Iterator &) const {
+      return it_ == nullptr;
+    }
+    bool operator!=(const Iterator &) const {
+      return it_ != nullptr;
+    }
+
+    explicit NodePointer(NodeT *it) : it_(it) {
+    }
+
+   private:
+    NodeT *it_ = nullptr;
+  };
+
+  struct ConstNodePointer {
+    const value_type &operator*() const {
+      return it_->get_public();
+    }
+    const value_type *operator->() const {
+      return &it_->get_public();
+    }
+
+    bool operator==(const ConstIterator &) const {
+      return it_ == nullptr;
+    }
+    bool operator!=(const ConstIterator &) const {
+      return it_ != nullptr;
+    }
+
+    const NodeT *get() const {
+      return it_;
+    }
+
+    explicit ConstNodePointer(const NodeT *it) : it_(it) {
+    }
+
+   private:
+    const NodeT *it_ = nullptr;
+  };
+
+  FlatHashTableSwiss() = default;
+  FlatHashTableSwiss(const FlatHashTableSwiss &) = delete;
+  FlatHashTableSwiss &operator=(const FlatHashTableSwiss &) = delete;
+
+  FlatHashTableSwiss(std::initializer_list<NodeT> nodes) {
+    if (nodes.size() == 0) {
+      return;
+    }
+    reserve(nodes.size());
+    for (auto &new_node : nodes) {
+      CHECK(!new_node.empty());
+      auto hash = calc_hash(new_node.key());
+      if (find_impl(new_node.key(), hash) != nullptr) {
+        continue;
+      }
+      insert_node(hash)->copy_from(new_node);
+    }
+  }
+
+  template <class T>
+  FlatHashTableSwiss(std::initializer_list<T> keys) {
+    for (auto &key : keys) {
+      emplace(KeyT(key));
+    }
+  }
+
+  FlatHashTableSwiss(FlatHashTableSwiss &&other) noexcept
+      : nodes_(other.nodes_)
+      , ctrl_(other.ctrl_)
+      , used_node_count_(other.used_node_count_)
+      , bucket_count_mask_(other.bucket_count_mask_)
+      , bucket_count_(other.bucket_count_)
+      , growth_left_(other.growth_left_)
+      , begin_bucket_(other.begin_bucket_) {
+    other.drop();
+  }
+  void operator=(FlatHashTableSwiss &&other) noexcept {
+    clear();
+    nodes_ = other.nodes_;
+    ctrl_ = other.ctrl_;
+    used_node_count_ = other.used_node_count_;
+    bucket_count_mask_ = other.bucket_count_mask_;
+    bucket_count_ = other.bucket_count_;
+    growth_left_ = other.growth_left_;
+    begin_bucket_ = other.begin_bucket_;
+    other.drop();
+  }
+  ~FlatHashTableSwiss() {
+    clear_nodes(nodes_, ctrl_);
+  }
+
+  void swap(FlatHashTableSwiss &other) noexcept {
+    std::swap(nodes_, other.nodes_);
+    std::swap(ctrl_, other.ctrl_);
+    std::swap(used_node_count_, other.used_node_count_);
+    std::swap(bucket_count_mask_, other.bucket_count_mask_);
+    std::swap(bucket_count_, other.bucket_count_);
+    std::swap(growth_left_, other.growth_left_);
+    std::swap(begin_bucket_, other.begin_bucket_);
+  }
+
+  uint32 bucket_count() const {
+    return bucket_count_;
+  }
+
+  NodePointer find(const KeyT &key) {
+    return NodePointer(find_impl(key));
+  }
+
+  ConstNodePointer find(const KeyT &key) const {
+    return ConstNodePointer(const_cast<FlatHashTableSwiss *>(this)->find_impl(key));
+  }
+
+  size_t size() const {
+    return used_node_count_;
+  }
+
+  bool empty() const {
+    return used_node_count_ == 0;
+  }
+
+  Iterator begin() {
+    return create_iterator(begin_impl());
+  }
+  Iterator end() {
+    return Iterator();
+  }
+  ConstIterator begin() const {
+    return ConstIterator(const_cast<FlatHashTableSwiss *>(this)->begin());
+  }
+  ConstIterator end() const {
+    return ConstIterator();
+  }
+
+  void reserve(size_t size) {
+    if (size == 0) {
+      return;
+    }
+    CHECK(size <= (1u << 29));
+    uint32 want_size = normalize_size(static_cast<uint32>(size) * 8 / 7 + 1);
+    if (want_size > bucket_count()) {
+      resize(want_size);
+    }
+  }
+
+  template <class... ArgsT>
+  std::pair<NodePointer, bool> emplace(KeyT key, ArgsT &&...args) {
+    CHECK(!is_hash_table_key_empty<EqT>(key));
+    auto hash = calc_hash(key);
+    auto *node = find_impl(key, hash);
+    if (node != nullptr) {
+      return {NodePointer(node), false};
+    }
+    invalidate_iterators();
+    node = insert_node(hash);
+    node->emplace(std::move(key), std::forward<ArgsT>(args)...);
+    return {NodePointer(node), true};
+  }
+
+  std::pair<NodePointer, bool> insert(KeyT key) {
+    return emplace(std::move(key));
+  }
+
+  template <class ItT>
+  void insert(ItT begin, ItT end) {
+    for (; begin != end; ++begin) {
+      emplace(*begin);
+    }
+  }
+
+  template <class T = typename NodeT::second_type>
+  T &operator[](const KeyT &key) {
+    return emplace(key).first->second;
+  }
+
+  size_t erase(const KeyT &key) {
+    auto *node = find_impl(key);
+    if (node == nullptr) {
+      return 0;
+    }
+    erase_node(node);
+    try_shrink();
+    return 1;
+  }
+
+  size_t count(const KeyT &key) const {
+    return const_cast<FlatHashTableSwiss *>(this)->find_impl(key) != nullptr;
+  }
+
+  void clear() {
+    if (nodes_ != nullptr) {
+      clear_nodes(nodes_, ctrl_);
+      drop();
+    }
+  }
+
+  void erase(Iterator it) {
+    DCHECK(it != end());
+    erase_node(it.get());
+    try_shrink();
+  }
+
+  void erase(NodePointer it) {
+    DCHECK(it != end());
+    erase_node(it.get());
+    try_shrink();
+  }
+
+  template <class F>
+  void remove_if(F &&f) {
+    if (empty()) {
+      return;
+    }
+
+    // erased nodes aren't moved, so each node is visited exactly once
+    auto end = nodes_ + bucket_count();
+    for (auto it = nodes_; it != end; ++it) {
+      if (!it->empty() && f(it->get_public())) {
+        erase_node(it);
+      }
+    }
+    try_shrink();
+  }
+
+ private:
+  NodeT *nodes_ = nullptr;
+  uint8 *ctrl_ = nullptr;
+  uint32 used_node_count_ = 0;
+  uint32 bucket_count_mask_ = 0;
+  uint32 bucket_count_ = 0;
+  uint32 growth_left_ = 0;  // number of EMPTY slots, which can be filled before resize
+  uint32 begin_bucket_ = 0;
+
+  void drop() {
+    nodes_ = nullptr;
+    ctrl_ = nullptr;
+    used_node_count_ = 0;
+    bucket_count_mask_ = 0;
+    bucket_count_ = 0;
+    growth_left_ = 0;
+    begin_bucket_ = 0;
+  }
+
+  static uint32 get_max_used_node_count(uint32 bucket_count) {
+    return bucket_count - bucket_count / 8;
+  }
+
+  static uint32 normalize_size(uint32 size) {
+    return max(detail::normalize_flat_hash_table_size(size), MIN_BUCKET_COUNT);
+  }
+
+  static uint32 calc_hash(const KeyT &key) {
+    return HashT()(key);
+  }
+
+  // the lowest bits of the hash are used to choose the bucket, so the highest bits are stored in control bytes
+  static uint8 get_hash_tag(uint32 hash) {
+    return static_cast<uint8>(hash >> 25);
+  }
+
+  void set_ctrl(uint32 bucket, uint8 value) {
+    ctrl_[bucket] = value;
+    if (bucket < Group::SIZE - 1) {
+      ctrl_[bucket + bucket_count_] = value;
+    }
+  }
+
+  NodeT *begin_impl() {
+    if (empty()) {
+      return nullptr;
+    }
+    if (begin_bucket_ == INVALID_BUCKET) {
+      begin_bucket_ = detail::get_random_flat_hash_table_bucket(bucket_count_mask_);
+      while (nodes_[begin_bucket_].empty()) {
+        begin_bucket_ = (begin_bucket_ + 1) & bucket_count_mask_;
+      }
+    }
+    return nodes_ + begin_bucket_;
+  }
+
+  NodeT *find_impl(const KeyT &key) {
+    if (unlikely(nodes_ == nullptr) || is_hash_table_key_empty<EqT>(key)) {
+      return nullptr;
+    }
+    return find_impl(key, calc_hash(key));
+  }
+
+  NodeT *find_impl(const KeyT &key, uint32 hash) {
+    if (unlikely(nodes_ == nullptr)) {
+      return nullptr;
+    }
+    auto tag = get_hash_tag(hash);
+    auto bucket = hash & bucket_count_mask_;
+    uint32 step = 0;
+    while (true) {
+      const uint8 *group = ctrl_ + bucket;
+      for (auto mask = Group::match(group, tag); mask; mask.next()) {
+        auto &node = nodes_[(bucket + mask.lowest_slot()) & bucket_count_mask_];
+        if (likely(EqT()(node.key(), key))) {
+          return &node;
+        }
+      }
+      if (likely(static_cast<bool>(Group::match_empty(group)))) {
+        return nullptr;
+      }
+      step += Group::SIZE;
+      bucket = (bucket + step) & bucket_count_mask_;
+    }
+  }
+
+  uint32 find_first_non_full(uint32 hash) const {
+    auto bucket = hash & bucket_count_mask_;
+    uint32 step = 0;
+    while (true) {
+      auto mask = Group::match_empty_or_deleted(ctrl_ + bucket);
+      if (mask) {
+        return (bucket + mask.lowest_slot()) & bucket_count_mask_;
+      }
+      step += Group::SIZE;
+      bucket = (bucket + step) & bucket_count_mask_;
+    }
+  }
+
+  // returns an empty node, which must be filled by the caller
+  NodeT *insert_node(uint32 hash) {
+    if (unlikely(nodes_ == nullptr)) {
+      allocate_nodes(MIN_BUCKET_COUNT);
+    }
+    auto bucket = find_first_non_full(hash);
+    if (unlikely(growth_left_ == 0 && ctrl_[bucket] == Group::EMPTY)) {
+      // if most of non-full slots are DELETED, then it is enough to rehash the table without increasing its size
+      auto new_size = used_node_count_ * 32 <= bucket_count_ * 25 ? bucket_count_ : 2 * bucket_count_;
+      resize(new_size);
+      bucket = find_first_non_full(hash);
+    }
+    if (ctrl_[bucket] == Group::EMPTY) {
+      growth_left_--;
+    }
+    set_ctrl(bucket, get_hash_tag(hash));
+    used_node_count_++;
+    return nodes_ + bucket;
+  }
+
+  void try_shrink() {
+    DCHECK(nodes_ != nullptr);
+    if (unlikely(used_node_count_ * 10 < bucket_count_mask_ && bucket_count_ > MIN_BUCKET_COUNT)) {
+      resize(normalize_size((used_node_count_ + 1) * 8 / 7 + 1));
+    }
+    invalidate_iterators();
+  }
+
+  void resize(uint32 new_size) {
+    if (unlikely(nodes_ == nullptr)) {
+      allocate_nodes(new_size);
+      return;
+    }
+
+    auto old_nodes = nodes_;
+    auto old_ctrl = ctrl_;
+    uint32 old_bucket_count = bucket_count_;
+    allocate_nodes(new_size);
+    CHECK(used_node_count_ <= growth_left_);
+    growth_left_ -= used_node_count_;
+
+    for (uint32 old_bucket = 0; old_bucket < old_bucket_count; old_bucket++) {
+      auto &old_node = old_nodes[old_bucket];
+      if (old_node.empty()) {
+        continue;
+      }
+      auto hash = calc_hash(old_node.key());
+      auto bucket = find_first_non_full(hash);
+      set_ctrl(bucket, get_hash_tag(hash));
+      nodes_[bucket] = std::move(old_node);
+    }
+    clear_nodes(old_nodes, old_ctrl);
+  }
+
+  void erase_node(NodeT *it) {
+    DCHECK(nodes_ <= it && static_cast<size_t>(it - nodes_) < bucket_count());
+    it->clear();
+    used_node_count_--;
+
+    // the slot can be marked as EMPTY only if no probe sequence has ever passed through it,
+    // i.e. if each group of slots containing it contains an EMPTY slot
+    auto bucket = static_cast<uint32>(it - nodes_);
+    auto empty_before = Group::match_empty(ctrl_ + ((bucket - Group::SIZE) & bucket_count_mask_));
+    auto empty_after = Group::match_empty(ctrl_ + bucket);
+    if (empty_before && empty_after &&
+        empty_after.lowest_slot() + (Group::SIZE - 1 - empty_before.highest_slot()) < Group::SIZE) {
+      set_ctrl(bucket, Group::EMPTY);
+      growth_left_++;
+    } else {
+      set_ctrl(bucket, Group::DELETED);
+    }
+  }
+
+  Iterator create_iterator(NodeT *node) {
+    return Iterator(node, nodes_, nodes_ + bucket_count());
+  }
+
+  void invalidate_iterators() {
+    begin_bucket_ = INVALID_BUCKET;
+  }
+};
+
+template <class KeyT, class ValueT, class HashT = Hash<KeyT>, class EqT = std::equal_to<KeyT>>
+using FlatHashMapSwiss = FlatHashTableSwiss<MapNode<KeyT, ValueT, EqT>, HashT, EqT>;
+
+template <class KeyT, class HashT = Hash<KeyT>, class EqT = std::equal_to<KeyT>>
+using FlatHashSetSwiss = FlatHashTableSwiss<SetNode<KeyT, EqT>, HashT, EqT>;
+
+}  // namespace td
+
+#undef TD_FLAT_HASH_TABLE_SWISS_SSE2
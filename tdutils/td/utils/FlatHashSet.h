@@ -7,6 +7,10 @@
 #pragma once
 
 //#include "td/utils/FlatHashMapChunks.h"
+#include "td/utils/common.h"
+#if TD_FLAT_HASH_TABLE_SWISS
+#include "td/utils/FlatHashMapSwiss.h"
+#endif
 #include "td/utils/FlatHashTable.h"
 #include "td/utils/HashTableUtils.h"
 #include "td/utils/SetNode.h"
@@ -16,8 +20,13 @@
 
 namespace td {
 
+#if TD_FLAT_HASH_TABLE_SWISS
+template <class KeyT, class HashT = Hash<KeyT>, class EqT = std::equal_to<KeyT>>
+using FlatHashSet = FlatHashTableSwiss<SetNode<KeyT, EqT>, HashT, EqT>;
+#else
 template <class KeyT, class HashT = Hash<KeyT>, class EqT = std::equal_to<KeyT>>
 using FlatHashSet = FlatHashTable<SetNode<KeyT, EqT>, HashT, EqT>;
+#endif
 //using FlatHashSet = FlatHashSetChunks<KeyT, HashT, EqT>;
 //using FlatHashSet = std::unordered_set<KeyT, HashT, EqT>;
 
@@ -36,7 +36,8 @@ Status Gzip::init_encode() {
   CHECK(mode_ == Mode::Empty);
   init_common();
   mode_ = Mode::Encode;
-  int ret = deflateInit2(&impl_->stream_, 6, Z_DEFLATED, 15, MAX_MEM_LEVEL, Z_DEFAULT_STRATEGY);
+  int ret = deflateInit2(&impl_->stream_, 6, Z_DEFLATED, is_raw_ ? -MAX_WBITS : MAX_WBITS, MAX_MEM_LEVEL,
+                         use_fixed_codes_ ? Z_FIXED : Z_DEFAULT_STRATEGY);
   if (ret != Z_OK) {
     return Status::Error(PSLICE() << "zlib deflate init failed: " << ret);
   }
@@ -47,13 +48,55 @@ Status Gzip::init_decode() {
   CHECK(mode_ == Mode::Empty);
   init_common();
   mode_ = Mode::Decode;
-  int ret = inflateInit2(&impl_->stream_, MAX_WBITS + 32);
+  int ret = inflateInit2(&impl_->stream_, is_raw_ ? -MAX_WBITS : MAX_WBITS + 32);
   if (ret != Z_OK) {
     return Status::Error(PSLICE() << "zlib inflate init failed: " << ret);
   }
   return Status::OK();
 }
 
+Status Gzip::set_dictionary(Slice dictionary) {
+  CHECK(mode_ != Mode::Empty);
+  CHECK(dictionary.size() <= std::numeric_limits<uInt>::max());
+  dictionary_ = dictionary;
+  if (mode_ == Mode::Encode && !dictionary.empty()) {
+    // the decoder receives the dictionary when the stream requests it
+    int ret = deflateSetDictionary(&impl_->stream_, dictionary.ubegin(), static_cast<uInt>(dictionary.size()));
+    if (ret != Z_OK) {
+      return Status::Error(PSLICE() << "zlib deflate set dictionary failed: " << ret);
+    }
+  }
+  if (mode_ == Mode::Decode && is_raw_ && !dictionary.empty()) {
+    // a raw stream never requests the dictionary
+    int ret = inflateSetDictionary(&impl_->stream_, dictionary.ubegin(), static_cast<uInt>(dictionary.size()));
+    if (ret != Z_OK) {
+      return Status::Error(PSLICE() << "zlib inflate set dictionary failed: " << ret);
+    }
+  }
+  return Status::OK();
+}
+
+Status Gzip::reset() {
+  if (mode_ == Mode::Empty) {
+    return Status::Error("Stream isn't initialized");
+  }
+  int ret = mode_ == Mode::Encode ? deflateReset(&impl_->stream_) : inflateReset(&impl_->stream_);
+  if (ret != Z_OK) {
+    return Status::Error(PSLICE() << "zlib reset failed: " << ret);
+  }
+  impl_->stream_.avail_in = 0;
+  impl_->stream_.next_in = nullptr;
+  impl_->stream_.avail_out = 0;
+  impl_->stream_.next_out = nullptr;
+
+  input_size_ = 0;
+  output_size_ = 0;
+
+  close_input_flag_ = false;
+  dictionary_ = Slice();
+  return Status::OK();
+}
+
 void Gzip::set_input(Slice input) {
   CHECK(input_size_ == 0);
   CHECK(!close_input_flag_);
@@ -78,6 +121,12 @@ Result<Gzip::State> Gzip::run() {
     int ret;
     if (mode_ == Mode::Decode) {
       ret = inflate(&impl_->stream_, Z_NO_FLUSH);
+      if (ret == Z_NEED_DICT && !dictionary_.empty()) {
+        ret = inflateSetDictionary(&impl_->stream_, dictionary_.ubegin(), static_cast<uInt>(dictionary_.size()));
+        if (ret == Z_OK) {
+          continue;
+        }
+      }
     } else {
       ret = deflate(&impl_->stream_, close_input_flag_ ? Z_FINISH : Z_NO_FLUSH);
     }
@@ -87,7 +136,9 @@ Result<Gzip::State> Gzip::run() {
     }
     if (ret == Z_STREAM_END) {
       // TODO(now): fail if input is not empty;
-      clear();
+      if (!is_reusable_) {
+        clear();
+      }
       return State::Done;
     }
     clear();
@@ -116,6 +167,7 @@ void Gzip::init_common() {
   output_size_ = 0;
 
   close_input_flag_ = false;
+  dictionary_ = Slice();
 }
 
 void Gzip::clear() {
@@ -148,15 +200,20 @@ void Gzip::swap(Gzip &other) {
   swap(output_size_, other.output_size_);
   swap(close_input_flag_, other.close_input_flag_);
   swap(mode_, other.mode_);
+  swap(is_reusable_, other.is_reusable_);
+  swap(is_raw_, other.is_raw_);
+  swap(use_fixed_codes_, other.use_fixed_codes_);
+  swap(dictionary_, other.dictionary_);
 }
 
 Gzip::~Gzip() {
   clear();
 }
 
-BufferSlice gzdecode(Slice s) {
+BufferSlice gzdecode(Slice s, Slice dictionary) {
   Gzip gzip;
   gzip.init_decode().ensure();
+  gzip.set_dictionary(dictionary).ensure();
   ChainBufferWriter message;
   gzip.set_input(s);
   gzip.close_input();
@@ -184,9 +241,12 @@ BufferSlice gzdecode(Slice s) {
   return message.extract_reader().move_as_buffer_slice();
 }
 
-BufferSlice gzencode(Slice s, double max_compression_ratio) {
+BufferSlice gzencode(Slice s, double max_compression_ratio, Slice dictionary) {
   Gzip gzip;
   gzip.init_encode().ensure();
+  if (gzip.set_dictionary(dictionary).is_error()) {
+    return BufferSlice();
+  }
   gzip.set_input(s);
   gzip.close_input();
   auto max_size = static_cast<size_t>(static_cast<double>(s.size()) * max_compression_ratio);
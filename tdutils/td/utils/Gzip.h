@@ -39,6 +39,33 @@ class Gzip {
 
   Status init_decode() TD_WARN_UNUSED_RESULT;
 
+  // sets a preset dictionary; must be called after init_encode or init_decode and before the first run
+  // the dictionary must be kept alive until the end of the stream
+  Status set_dictionary(Slice dictionary) TD_WARN_UNUSED_RESULT;
+
+  // a reusable stream isn't destroyed when finished, so it can be restarted without memory reallocation
+  void set_is_reusable(bool is_reusable) {
+    is_reusable_ = is_reusable;
+  }
+
+  // a raw stream has no header and checksum, so a preset dictionary must be known to the decoder in advance;
+  // must be called before init
+  void set_is_raw(bool is_raw) {
+    CHECK(mode_ == Mode::Empty);
+    is_raw_ = is_raw;
+  }
+
+  // fixed Huffman codes compress worse, but the decoder doesn't need to build code tables,
+  // which is the main cost of decoding of small inputs; must be called before init_encode
+  void set_use_fixed_codes(bool use_fixed_codes) {
+    CHECK(mode_ == Mode::Empty);
+    use_fixed_codes_ = use_fixed_codes;
+  }
+
+  // restarts an initialized stream; the dictionary must be set again
+  // fails if the stream isn't initialized or was destroyed because of an error
+  Status reset() TD_WARN_UNUSED_RESULT;
+
   void set_input(Slice input);
 
   void set_output(MutableSlice output);
@@ -90,6 +117,10 @@ class Gzip {
   size_t output_size_ = 0;
   bool close_input_flag_ = false;
   Mode mode_ = Mode::Empty;
+  bool is_reusable_ = false;
+  bool is_raw_ = false;
+  bool use_fixed_codes_ = false;
+  Slice dictionary_;
 
   void init_common();
   void clear();
@@ -97,9 +128,9 @@ class Gzip {
   void swap(Gzip &other);
 };
 
-BufferSlice gzdecode(Slice s);
+BufferSlice gzdecode(Slice s, Slice dictionary = Slice());
 
-BufferSlice gzencode(Slice s, double max_compression_ratio);
+BufferSlice gzencode(Slice s, double max_compression_ratio, Slice dictionary = Slice());
 
 }  // namespace td
 
@@ -0,0 +1,163 @@
+//
+// Copyright Aliaksei Levin (levlam@telegram.org), Arseny Smirnov (arseny30@gmail.com) 2014-2024
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+#include "td/utils/TlObjectArena.h"
+
+#include "td/utils/logging.h"
+#include "td/utils/port/thread_local.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+namespace td {
+
+namespace {
+
+constexpr size_t MIN_CHUNK_SIZE = 1 << 10;
+constexpr size_t MAX_CHUNK_SIZE = 1 << 16;
+
+struct Chunk {
+  std::atomic<size_t> ref_cnt{1};
+  size_t size = 0;
+  size_t used = 0;
+};
+
+// Objects allocated on the heap have no header and are aligned like the memory returned by operator new.
+// Objects allocated in a chunk are preceded by the header and are placed at addresses, which are equal to HEADER_SIZE
+// modulo ALIGNMENT, so deallocate can distinguish them by their address.
+struct Header {
+  Chunk *chunk;
+};
+
+constexpr size_t ALIGNMENT = 16;
+constexpr size_t HEADER_SIZE = sizeof(Header);
+constexpr size_t CHUNK_HEADER_SIZE = (sizeof(Chunk) + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+constexpr bool IS_ARENA_SUPPORTED = alignof(std::max_align_t) >= ALIGNMENT && HEADER_SIZE % alignof(int64) == 0 &&
+                                    HEADER_SIZE % alignof(double) == 0;
+
+bool is_chunk_object(const void *ptr) {
+  return IS_ARENA_SUPPORTED && reinterpret_cast<std::uintptr_t>(ptr) % ALIGNMENT == HEADER_SIZE;
+}
+
+std::atomic<uint64> arena_allocation_count{0};
+std::atomic<uint64> heap_allocation_count{0};
+std::atomic<size_t> chunk_count{0};
+std::atomic<size_t> chunk_memory_size{0};
+
+// the current chunk and size of new chunks of the thread; new chunks aren't created if the size is 0
+TD_THREAD_LOCAL Chunk *current_chunk;
+TD_THREAD_LOCAL size_t current_chunk_size;
+
+char *get_chunk_data(Chunk *chunk) {
+  return reinterpret_cast<char *>(chunk) + CHUNK_HEADER_SIZE;
+}
+
+Chunk *create_chunk(size_t size) {
+  auto chunk = new (::operator new(CHUNK_HEADER_SIZE + size)) Chunk();
+  chunk->size = size;
+  chunk_count.fetch_add(1, std::memory_order_relaxed);
+  chunk_memory_size.fetch_add(CHUNK_HEADER_SIZE + size, std::memory_order_relaxed);
+  return chunk;
+}
+
+void release_chunk(Chunk *chunk) {
+  if (chunk->ref_cnt.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+    return;
+  }
+  chunk_count.fetch_sub(1, std::memory_order_relaxed);
+  chunk_memory_size.fetch_sub(CHUNK_HEADER_SIZE + chunk->size, std::memory_order_relaxed);
+  chunk->~Chunk();
+  ::operator delete(chunk);
+}
+
+}  // namespace
+
+bool TlObjectArena::is_supported() {
+  return IS_ARENA_SUPPORTED;
+}
+
+void *TlObjectArena::allocate(size_t size) {
+  // the size is rounded, so that the memory is aligned to ALIGNMENT even with allocators, which return memory
+  // with a smaller alignment for smaller objects
+  size = (size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+  if (current_chunk_size == 0) {
+    auto ptr = ::operator new(size);
+    CHECK(!is_chunk_object(ptr));
+    return ptr;
+  }
+
+  // big objects are allocated separately to avoid waste of chunk memory
+  auto total_size = size + ALIGNMENT;
+  if (total_size > current_chunk_size / 4) {
+    heap_allocation_count.fetch_add(1, std::memory_order_relaxed);
+    auto ptr = ::operator new(size);
+    CHECK(!is_chunk_object(ptr));
+    return ptr;
+  }
+
+  auto chunk = current_chunk;
+  if (chunk == nullptr || chunk->used + total_size > chunk->size) {
+    if (chunk != nullptr) {
+      release_chunk(chunk);
+    }
+    chunk = create_chunk(current_chunk_size);
+    current_chunk = chunk;
+  }
+  auto ptr = get_chunk_data(chunk) + chunk->used + HEADER_SIZE;
+  chunk->used += total_size;
+  chunk->ref_cnt.fetch_add(1, std::memory_order_relaxed);
+  reinterpret_cast<Header *>(ptr - HEADER_SIZE)->chunk = chunk;
+  arena_allocation_count.fetch_add(1, std::memory_order_relaxed);
+  return ptr;
+}
+
+void TlObjectArena::deallocate(void *ptr) noexcept {
+  if (ptr == nullptr) {
+    return;
+  }
+  if (is_chunk_object(ptr)) {
+    release_chunk(reinterpret_cast<Header *>(static_cast<char *>(ptr) - HEADER_SIZE)->chunk);
+  } else {
+    ::operator delete(ptr);
+  }
+}
+
+TlObjectArena::Stats TlObjectArena::get_stats() {
+  Stats stats;
+  stats.arena_allocation_count = arena_allocation_count.load(std::memory_order_relaxed);
+  stats.heap_allocation_count = heap_allocation_count.load(std::memory_order_relaxed);
+  stats.chunk_count = chunk_count.load(std::memory_order_relaxed);
+  stats.chunk_memory_size = chunk_memory_size.load(std::memory_order_relaxed);
+  return stats;
+}
+
+TlObjectArena::Guard::Guard(size_t expected_size, bool is_enabled) {
+  if (!is_enabled || !IS_ARENA_SUPPORTED) {
+    return;
+  }
+  is_active_ = true;
+  old_chunk_ = current_chunk;
+  old_chunk_size_ = current_chunk_size;
+  current_chunk = nullptr;
+  // objects usually take at most twice as much memory as their serialized representation
+  current_chunk_size = std::min(std::max(expected_size * 2, MIN_CHUNK_SIZE), MAX_CHUNK_SIZE);
+}
+
+TlObjectArena::Guard::~Guard() {
+  if (!is_active_) {
+    return;
+  }
+  if (current_chunk != nullptr) {
+    release_chunk(current_chunk);
+  }
+  current_chunk = static_cast<Chunk *>(old_chunk_);
+  current_chunk_size = old_chunk_size_;
+}
+
+}  // namespace td
@@ -0,0 +1,54 @@
+//
+// Copyright Aliaksei Levin (levlam@telegram.org), Arseny Smirnov (arseny30@gmail.com) 2014-2024
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+#pragma once
+
+#include "td/utils/common.h"
+
+namespace td {
+
+// Allocates memory for TL objects, received from the server.
+// While a Guard is alive, objects allocated by the current thread are placed in reference-counted chunks,
+// so an object tree of a response needs a few allocations instead of one allocation per object.
+// A chunk is freed when all objects allocated in it are destroyed, so the objects can be owned by anyone
+// and destroyed in any order and on any thread. An object, which is kept for a long time, keeps its whole chunk alive.
+// Objects allocated outside of chunks have no memory overhead. The objects must need at most pointer alignment.
+class TlObjectArena {
+ public:
+  struct Stats {
+    uint64 arena_allocation_count = 0;
+    uint64 heap_allocation_count = 0;  // only allocations of big objects while a Guard was active are counted
+    size_t chunk_count = 0;
+    size_t chunk_memory_size = 0;
+  };
+
+  // returns false if the arena can't be used on the current platform
+  static bool is_supported();
+
+  static void *allocate(size_t size);
+
+  static void deallocate(void *ptr) noexcept;
+
+  static Stats get_stats();
+
+  class Guard {
+   public:
+    // expected_size is the size of the serialized response; the arena is used only if is_enabled is true
+    Guard(size_t expected_size, bool is_enabled);
+    Guard(const Guard &) = delete;
+    Guard &operator=(const Guard &) = delete;
+    Guard(Guard &&) = delete;
+    Guard &operator=(Guard &&) = delete;
+    ~Guard();
+
+   private:
+    bool is_active_ = false;
+    size_t old_chunk_size_ = 0;
+    void *old_chunk_ = nullptr;
+  };
+};
+
+}  // namespace td
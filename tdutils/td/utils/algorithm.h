@@ -272,4 +272,12 @@ void table_remove_if(FlatHashTable<NodeT, HashT, EqT> &table, FuncT &&func) {
   table.remove_if(func);
 }
 
+template <class NodeT, class HashT, class EqT>
+class FlatHashTableSwiss;
+
+template <class NodeT, class HashT, class EqT, class FuncT>
+void table_remove_if(FlatHashTableSwiss<NodeT, HashT, EqT> &table, FuncT &&func) {
+  table.remove_if(func);
+}
+
 }  // namespace td
@@ -0,0 +1,50 @@
+//
+// Copyright Aliaksei Levin (levlam@telegram.org), Arseny Smirnov (arseny30@gmail.com) 2014-2024
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+#include "td/utils/BinaryFileLog.h"
+#include "td/utils/common.h"
+#include "td/utils/filesystem.h"
+#include "td/utils/logging.h"
+#include "td/utils/port/Stat.h"
+
+int main(int argc, char *argv[]) {
+  if (argc < 2) {
+    LOG(PLAIN) << "Usage: binary_log_dump <log_file_name>";
+    return 1;
+  }
+  td::string log_file_name = argv[1];
+  auto r_stat = td::stat(log_file_name);
+  if (r_stat.is_error() || r_stat.ok().size_ == 0 || !r_stat.ok().is_reg_) {
+    LOG(PLAIN) << "Wrong log file name specified";
+    LOG(PLAIN) << "Usage: binary_log_dump <log_file_name>";
+    return 1;
+  }
+
+  auto r_data = td::read_file_str(log_file_name);
+  if (r_data.is_error()) {
+    LOG(PLAIN) << "Failed to read the log file: " << r_data.error();
+    return 1;
+  }
+
+  td::uint64 message_count = 0;
+  td::uint64 dropped_count = 0;
+  auto status = td::decode_binary_log(r_data.ok(), [&](const td::BinaryLogMessage &message) {
+    if (message.dropped_count != 0) {
+      dropped_count += message.dropped_count;
+    } else {
+      message_count++;
+    }
+    LOG(PLAIN) << td::format_binary_log_message(message);
+  });
+  if (status.is_error()) {
+    LOG(PLAIN) << "Failed to decode the log file after " << message_count << " messages: " << status;
+    return 1;
+  }
+  if (dropped_count != 0) {
+    LOG(PLAIN) << "Total " << message_count << " messages, " << dropped_count << " dropped messages";
+  }
+  return 0;
+}
@@ -9,7 +9,9 @@
 #include "td/utils/logging.h"
 #include "td/utils/port/thread_local.h"
 
+#include <array>
 #include <cstddef>
+#include <mutex>
 #include <new>
 
 // fixes https://bugs.llvm.org/show_bug.cgi?id=33723 for clang >= 3.6 + c++11 + libc++
@@ -21,6 +23,153 @@
 
 namespace td {
 
+namespace {
+
+// caches memory of big buffers, which are allocated and freed often, for example, for file parts, gzip output and
+// big network packets; a buffer freed by another thread is cached by the thread, which has freed it
+class BigBufferPool {
+ public:
+  static constexpr size_t MIN_SIZE = 1 << 16;
+  static constexpr size_t MAX_SIZE = 1 << 21;
+  static constexpr size_t HEADER_SIZE = TD_OFFSETOF(BufferRaw, data_);
+
+  // returns nullptr if the size isn't pooled
+  static char *allocate(size_t size) {
+    auto size_class = get_size_class(size);
+    if (size_class == SIZE_CLASS_COUNT) {
+      return nullptr;
+    }
+
+    init_thread_local<ThreadCache>(thread_cache_);
+    auto &blocks = thread_cache_->blocks[size_class];
+    if (!blocks.empty()) {
+      auto *result = blocks.back();
+      blocks.pop_back();
+      thread_cache_->size -= get_block_size(size_class);
+      pooled_mem_ -= get_block_size(size_class);
+      return result;
+    }
+
+    auto &global_pool = get_global_pool();
+    {
+      std::lock_guard<std::mutex> guard(global_pool.mutex);
+      auto &global_blocks = global_pool.blocks[size_class];
+      if (!global_blocks.empty()) {
+        auto *result = global_blocks.back();
+        global_blocks.pop_back();
+        global_pool.size -= get_block_size(size_class);
+        pooled_mem_ -= get_block_size(size_class);
+        return result;
+      }
+    }
+    return new char[get_block_size(size_class)];
+  }
+
+  // returns false if the size isn't pooled
+  static bool deallocate(char *ptr, size_t size) {
+    auto size_class = get_size_class(size);
+    if (size_class == SIZE_CLASS_COUNT) {
+      return false;
+    }
+
+    // the thread cache isn't created here, because the function can be called during thread locals destruction
+    auto block_size = get_block_size(size_class);
+    auto *thread_cache = thread_cache_;
+    if (thread_cache != nullptr && thread_cache->size + block_size <= MAX_THREAD_CACHE_SIZE) {
+      thread_cache->blocks[size_class].push_back(ptr);
+      thread_cache->size += block_size;
+      pooled_mem_ += block_size;
+      return true;
+    }
+    add_to_global_pool(ptr, size_class);
+    return true;
+  }
+
+  static size_t get_pooled_mem() {
+    return pooled_mem_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  // 4 size classes per each doubling of the size
+  static constexpr size_t SIZE_CLASS_COUNT = 4 * 5 + 1;
+  static constexpr size_t MAX_THREAD_CACHE_SIZE = 1 << 22;
+  static constexpr size_t MAX_GLOBAL_POOL_SIZE = 1 << 24;
+
+  struct ThreadCache {
+    std::array<vector<char *>, SIZE_CLASS_COUNT> blocks;
+    size_t size = 0;
+
+    ThreadCache() = default;
+    ThreadCache(const ThreadCache &) = delete;
+    ThreadCache &operator=(const ThreadCache &) = delete;
+    ThreadCache(ThreadCache &&) = delete;
+    ThreadCache &operator=(ThreadCache &&) = delete;
+    ~ThreadCache() {
+      for (size_t size_class = 0; size_class < SIZE_CLASS_COUNT; size_class++) {
+        for (auto *ptr : blocks[size_class]) {
+          pooled_mem_ -= get_block_size(size_class);
+          add_to_global_pool(ptr, size_class);
+        }
+      }
+    }
+  };
+
+  struct GlobalPool {
+    std::mutex mutex;
+    std::array<vector<char *>, SIZE_CLASS_COUNT> blocks;
+    size_t size = 0;
+  };
+
+  static TD_THREAD_LOCAL ThreadCache *thread_cache_;
+  static std::atomic<size_t> pooled_mem_;
+
+  static GlobalPool &get_global_pool() {
+    // is never destroyed, because buffers can be freed during destruction of static objects
+    static GlobalPool *global_pool = new GlobalPool();
+    return *global_pool;
+  }
+
+  static size_t get_size_class(size_t size) {
+    if (size < MIN_SIZE || size > MAX_SIZE) {
+      return SIZE_CLASS_COUNT;
+    }
+    size_t size_class = 0;
+    while (get_class_size(size_class) < size) {
+      size_class++;
+    }
+    return size_class;
+  }
+
+  static size_t get_class_size(size_t size_class) {
+    return (MIN_SIZE << (size_class / 4)) / 4 * (4 + size_class % 4);
+  }
+
+  static size_t get_block_size(size_t size_class) {
+    return HEADER_SIZE + get_class_size(size_class);
+  }
+
+  static void add_to_global_pool(char *ptr, size_t size_class) {
+    auto block_size = get_block_size(size_class);
+    auto &global_pool = get_global_pool();
+    {
+      std::lock_guard<std::mutex> guard(global_pool.mutex);
+      if (global_pool.size + block_size <= MAX_GLOBAL_POOL_SIZE) {
+        global_pool.blocks[size_class].push_back(ptr);
+        global_pool.size += block_size;
+        pooled_mem_ += block_size;
+        return;
+      }
+    }
+    delete[] ptr;
+  }
+};
+
+TD_THREAD_LOCAL BigBufferPool::ThreadCache *BigBufferPool::thread_cache_;  // static zero-initialized
+
+std::atomic<size_t> BigBufferPool::pooled_mem_;
+
+}  // namespace
+
 TD_THREAD_LOCAL BufferAllocator::BufferRawTls *BufferAllocator::buffer_raw_tls;  // static zero-initialized
 
 std::atomic<size_t> BufferAllocator::buffer_mem;
@@ -33,6 +182,10 @@ size_t BufferAllocator::get_buffer_mem() {
   return buffer_mem;
 }
 
+size_t BufferAllocator::get_buffer_pool_mem() {
+  return BigBufferPool::get_pooled_mem();
+}
+
 BufferAllocator::WriterPtr BufferAllocator::create_writer(size_t size) {
   if (size < 512) {
     size = 512;
@@ -91,8 +244,12 @@ void BufferAllocator::dec_ref_cnt(BufferRaw *ptr) {
   if (left == 1) {
     auto buf_size = max(sizeof(BufferRaw), TD_OFFSETOF(BufferRaw, data_) + ptr->data_size_);
     buffer_mem -= buf_size;
+    auto data_size = ptr->data_size_;
     ptr->~BufferRaw();
-    delete[] ptr;
+    auto *raw_ptr = reinterpret_cast<char *>(ptr);
+    if (!BigBufferPool::deallocate(raw_ptr, data_size)) {
+      delete[] raw_ptr;
+    }
   }
 }
 
@@ -110,8 +267,11 @@ BufferRaw *BufferAllocator::create_buffer_raw(size_t size) {
     buf_size = sizeof(BufferRaw);
   }
   buffer_mem += buf_size;
-  auto *buffer_raw = reinterpret_cast<BufferRaw *>(new char[buf_size]);
-  return new (buffer_raw) BufferRaw(size);
+  auto *raw_ptr = BigBufferPool::allocate(size);
+  if (raw_ptr == nullptr) {
+    raw_ptr = new char[buf_size];
+  }
+  return new (raw_ptr) BufferRaw(size);
 }
 
 void BufferBuilder::append(BufferSlice slice) {
@@ -67,6 +67,9 @@ class BufferAllocator {
   static ReaderPtr create_reader(const ReaderPtr &raw);
 
   static size_t get_buffer_mem();
+
+  // returns size of memory, which is cached for reuse by big buffers
+  static size_t get_buffer_pool_mem();
   static int64 get_buffer_slice_size();
 
   static void clear_thread_local();
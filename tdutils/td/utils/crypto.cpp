@@ -13,6 +13,7 @@
 #include "td/utils/Destructor.h"
 #include "td/utils/logging.h"
 #include "td/utils/misc.h"
+#include "td/utils/port/FileFd.h"
 #include "td/utils/port/RwMutex.h"
 #include "td/utils/port/thread_local.h"
 #include "td/utils/Random.h"
@@ -903,6 +904,28 @@ void Sha256State::extract(MutableSlice output, bool destroy) {
   }
 }
 
+Status sha256_feed_file(Sha256State &state, const FileFd &fd, int64 offset, int64 size) {
+  // the file is read instead of being memory mapped, because access to a mapping of a file,
+  // which was truncated by another process, raises SIGBUS
+  constexpr size_t READ_BUFFER_SIZE = 1 << 20;
+  if (offset < 0 || size < 0) {
+    return Status::Error("Invalid file part");
+  }
+
+  BufferSlice buffer(static_cast<size_t>(min(size, static_cast<int64>(READ_BUFFER_SIZE))));
+  while (size > 0) {
+    auto part = buffer.as_mutable_slice().truncate(static_cast<size_t>(min(size, static_cast<int64>(buffer.size()))));
+    TRY_RESULT(read_size, fd.pread(part, offset));
+    if (read_size == 0) {
+      return Status::Error("Unexpected end of file");
+    }
+    state.feed(part.truncate(read_size));
+    offset += static_cast<int64>(read_size);
+    size -= static_cast<int64>(read_size);
+  }
+  return Status::OK();
+}
+
 void md5(Slice input, MutableSlice output) {
   CHECK(output.size() >= 16);
 #if OPENSSL_VERSION_NUMBER >= 0x30000000L && !defined(LIBRESSL_VERSION_NUMBER)
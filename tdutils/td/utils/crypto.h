@@ -14,6 +14,8 @@
 
 namespace td {
 
+class FileFd;
+
 uint64 pq_factorize(uint64 pq);
 
 #if TD_HAVE_OPENSSL
@@ -149,6 +151,10 @@ class Sha256State {
   bool is_inited_ = false;
 };
 
+// feeds size bytes of the file starting at the given offset to the state
+// the file is read in big chunks; returns an error if the file is shorter than expected
+Status sha256_feed_file(Sha256State &state, const FileFd &fd, int64 offset, int64 size) TD_WARN_UNUSED_RESULT;
+
 void md5(Slice input, MutableSlice output);
 
 void pbkdf2_sha256(Slice password, Slice salt, int iteration_count, MutableSlice dest);
@@ -55,52 +55,38 @@ void LogInterface::append(int log_level, CSlice slice) {
   }
 }
 
-TD_THREAD_LOCAL const char *Logger::tag_ = nullptr;
-TD_THREAD_LOCAL const char *Logger::tag2_ = nullptr;
-
-Logger::Logger(LogInterface &log, const LogOptions &options, int log_level, Slice file_name, int line_num,
-               Slice comment)
-    : Logger(log, options, log_level) {
-  if (log_level == VERBOSITY_NAME(PLAIN) && &options == &log_options) {
-    return;
-  }
-  if (!options_.add_info) {
-    return;
-  }
-  if (ExitGuard::is_exited()) {
-    return;
-  }
-
+// log level, thread identifier, timestamp and call site
+static void append_log_prefix(StringBuilder &sb, int log_level, Slice file_name, int line_num) {
   // log level
-  sb_ << '[';
+  sb << '[';
   if (static_cast<uint32>(log_level) < 10) {
-    sb_ << ' ' << static_cast<char>('0' + log_level);
+    sb << ' ' << static_cast<char>('0' + log_level);
   } else {
-    sb_ << log_level;
+    sb << log_level;
   }
-  sb_ << ']';
+  sb << ']';
 
   // thread identifier
   auto thread_id = get_thread_id();
-  sb_ << "[t";
+  sb << "[t";
   if (static_cast<uint32>(thread_id) < 10) {
-    sb_ << ' ' << static_cast<char>('0' + thread_id);
+    sb << ' ' << static_cast<char>('0' + thread_id);
   } else {
-    sb_ << thread_id;
+    sb << thread_id;
   }
-  sb_ << ']';
+  sb << ']';
 
   // timestamp
   auto time = Clocks::system();
   auto unix_time = static_cast<uint32>(time);
   auto nanoseconds = static_cast<uint32>((time - unix_time) * 1e9);
-  sb_ << '[' << unix_time << '.';
+  sb << '[' << unix_time << '.';
   uint32 limit = 100000000;
   while (nanoseconds < limit && limit > 1) {
-    sb_ << '0';
+    sb << '0';
     limit /= 10;
   }
-  sb_ << nanoseconds << ']';
+  sb << nanoseconds << ']';
 
   // file : line
   if (!file_name.empty()) {
@@ -109,9 +95,72 @@ Logger::Logger(LogInterface &log, const LogOptions &options, int log_level, Slic
       last_slash_--;
     }
     file_name = file_name.substr(last_slash_ + 1);
-    sb_ << '[' << file_name << ':' << static_cast<uint32>(line_num) << ']';
+    sb << '[' << file_name << ':' << static_cast<uint32>(line_num) << ']';
+  }
+}
+
+void LogInterface::append(int log_level, Slice file_name, int line_num, CSlice slice) {
+  do_append_structured(log_level, file_name, line_num, slice);
+
+  OnLogMessageCallback callback = nullptr;
+  if (log_level != VERBOSITY_NAME(FATAL)) {
+    if (log_level > max_callback_verbosity_level.load(std::memory_order_relaxed)) {
+      return;
+    }
+    callback = on_log_message_callback.load(std::memory_order_relaxed);
+    if (callback == nullptr) {
+      return;
+    }
+  }
+
+  // the structured log has stored the message without the prefix, but everyone else expects it
+  StringBuilder sb;
+  append_log_prefix(sb, log_level, file_name, line_num);
+  sb << slice;
+  auto message = sb.as_cslice();
+  if (log_level == VERBOSITY_NAME(FATAL)) {
+    process_fatal_error(message);
+  } else {
+    callback(log_level, message);
+  }
+}
+
+TD_THREAD_LOCAL const char *Logger::tag_ = nullptr;
+TD_THREAD_LOCAL const char *Logger::tag2_ = nullptr;
+
+Logger::Logger(LogInterface &log, const LogOptions &options, int log_level, Slice file_name, int line_num,
+               Slice comment)
+    : Logger(log, options, log_level) {
+  if (log_level == VERBOSITY_NAME(PLAIN) && &options == &log_options) {
+    return;
+  }
+  if (!options_.add_info) {
+    return;
+  }
+  if (ExitGuard::is_exited()) {
+    return;
   }
 
+  if (log_.is_structured() && !file_name.empty()) {
+    // log level, thread identifier, timestamp and call site are stored by the log itself
+    is_structured_ = true;
+    file_name_ = file_name;
+    line_num_ = line_num;
+    if (tag_ != nullptr && *tag_) {
+      sb_ << "[#" << Slice(tag_) << ']';
+    }
+    if (tag2_ != nullptr && *tag2_) {
+      sb_ << "[!" << Slice(tag2_) << ']';
+    }
+    if (!comment.empty()) {
+      sb_ << "[&" << comment << ']';
+    }
+    sb_ << '\t';
+    return;
+  }
+
+  append_log_prefix(sb_, log_level, file_name, line_num);
+
   // context from tag_
   if (tag_ != nullptr && *tag_) {
     sb_ << "[#" << Slice(tag_) << ']';
@@ -144,7 +193,13 @@ Logger::~Logger() {
       slice.back() = '\0';
       slice = MutableCSlice(slice.begin(), slice.begin() + slice.size() - 1);
     }
-    log_.append(log_level_, slice);
+    if (is_structured_) {
+      log_.append(log_level_, file_name_, line_num_, slice);
+    } else {
+      log_.append(log_level_, slice);
+    }
+  } else if (is_structured_) {
+    log_.append(log_level_, file_name_, line_num_, as_cslice());
   } else {
     log_.append(log_level_, as_cslice());
   }
@@ -160,6 +160,9 @@ class LogInterface {
 
   void append(int log_level, CSlice slice);
 
+  // file_name must be a string literal
+  void append(int log_level, Slice file_name, int line_num, CSlice slice);
+
   virtual void after_rotation() {
   }
 
@@ -167,7 +170,17 @@ class LogInterface {
     return {};
   }
 
+  // returns true if the log stores log level, thread, time and call site of messages by itself,
+  // so the message text passed to do_append_structured must not include them
+  virtual bool is_structured() const {
+    return false;
+  }
+
   virtual void do_append(int log_level, CSlice slice) = 0;
+
+  virtual void do_append_structured(int log_level, Slice /*file_name*/, int /*line_num*/, CSlice slice) {
+    do_append(log_level, slice);
+  }
 };
 
 extern LogInterface *const default_log_interface;
@@ -219,6 +232,9 @@ class Logger {
   StringBuilder sb_;
   const LogOptions &options_;
   int log_level_;
+  Slice file_name_;
+  int line_num_ = 0;
+  bool is_structured_ = false;
 };
 
 class LogGuard {
@@ -555,6 +555,7 @@ uint64 filetime_to_unix_time_nsec(LONGLONG filetime) {
 struct FileSize {
   int64 size_;
   int64 real_size_;
+  int64 link_count_;
 };
 
 Result<FileSize> get_file_size(const FileFd &file_fd) {
@@ -566,6 +567,7 @@ Result<FileSize> get_file_size(const FileFd &file_fd) {
   FileSize res;
   res.size_ = standard_info.EndOfFile.QuadPart;
   res.real_size_ = standard_info.AllocationSize.QuadPart;
+  res.link_count_ = static_cast<int64>(standard_info.NumberOfLinks);
 
   if (res.size_ > 0 && res.real_size_ <= 0) {  // just in case
     LOG(ERROR) << "Fix real file size from " << res.real_size_ << " to " << res.size_;
@@ -628,6 +630,7 @@ Result<Stat> FileFd::stat() const {
   TRY_RESULT(file_size, get_file_size(*this));
   res.size_ = file_size.size_;
   res.real_size_ = file_size.real_size_;
+  res.link_count_ = file_size.link_count_;
 
   return res;
 #endif
@@ -686,6 +689,26 @@ Status FileFd::truncate_to_current_position(int64 current_position) {
   }
   return Status::OK();
 }
+Status FileFd::reserve_space(int64 size) {
+  CHECK(!empty());
+#if (TD_LINUX || TD_ANDROID) && defined(FALLOC_FL_KEEP_SIZE)
+  TRY_RESULT(size_off_t, narrow_cast_safe<off_t>(size));
+  if (detail::skip_eintr([&] { return ::fallocate(get_native_fd().fd(), FALLOC_FL_KEEP_SIZE, 0, size_off_t); }) < 0) {
+    return OS_ERROR("Reserve space failed");
+  }
+  return Status::OK();
+#else
+  return Status::Error("Unsupported");
+#endif
+}
+
+void FileFd::advise_sequential_access() {
+  CHECK(!empty());
+#if TD_LINUX || TD_ANDROID
+  posix_fadvise(get_native_fd().fd(), 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+}
+
 PollableFdInfo &FileFd::get_poll_info() {
   CHECK(!empty());
   return impl_->info_;
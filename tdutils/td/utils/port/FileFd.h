@@ -68,6 +68,12 @@ class FileFd {
 
   Status truncate_to_current_position(int64 current_position) TD_WARN_UNUSED_RESULT;
 
+  // allocates disk space for the first size bytes of the file without changing the file size
+  Status reserve_space(int64 size) TD_WARN_UNUSED_RESULT;
+
+  // hints that the file will be accessed sequentially
+  void advise_sequential_access();
+
   const NativeFd &get_native_fd() const;
   NativeFd move_as_native_fd();
 
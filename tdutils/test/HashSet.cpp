@@ -8,6 +8,7 @@
 #include "td/utils/common.h"
 #include "td/utils/FlatHashMap.h"
 #include "td/utils/FlatHashMapChunks.h"
+#include "td/utils/FlatHashMapSwiss.h"
 #include "td/utils/FlatHashSet.h"
 #include "td/utils/HashTableUtils.h"
 #include "td/utils/logging.h"
@@ -44,6 +45,27 @@ TEST(FlatHashMapChunks, basic) {
   ASSERT_EQ(4, kv[3]);
 }
 
+TEST(FlatHashMapSwiss, basic) {
+  td::FlatHashMapSwiss<int, int> kv;
+  kv[5] = 3;
+  ASSERT_EQ(3, kv[5]);
+  kv[3] = 4;
+  ASSERT_EQ(4, kv[3]);
+  ASSERT_EQ(2u, kv.size());
+  ASSERT_EQ(1u, kv.erase(5));
+  ASSERT_EQ(0u, kv.count(5));
+  ASSERT_EQ(4, kv.find(3)->second);
+
+  td::FlatHashMapSwiss<td::int32, td::string> map = {{1, "hello"}, {1, "world"}, {2, "!"}};
+  ASSERT_EQ("hello", map[1]);
+  ASSERT_EQ(2u, map.size());
+
+  td::FlatHashSetSwiss<td::Slice, td::SliceHash> s{"1", "22", "333", "4444"};
+  ASSERT_EQ(4u, s.size());
+  ASSERT_EQ(1u, s.count("22"));
+  ASSERT_EQ(0u, s.count("222"));
+}
+
 TEST(FlatHashMap, probing) {
   auto test = [](int buckets, int elements) {
     CHECK(buckets >= elements);
@@ -252,11 +274,13 @@ TEST(FlatHashMap, remove_if_basic) {
 }
 
 static constexpr size_t MAX_TABLE_SIZE = 1000;
-TEST(FlatHashMap, stress_test) {
+
+template <class TableT>
+static void test_hash_map_stress() {
   td::Random::Xorshift128plus rnd(123);
   size_t max_table_size = MAX_TABLE_SIZE;  // dynamic value
   std::unordered_map<td::uint64, td::uint64, td::Hash<td::uint64>> ref;
-  td::FlatHashMap<td::uint64, td::uint64> tbl;
+  TableT tbl;
 
   auto validate = [&] {
     ASSERT_EQ(ref.empty(), tbl.empty());
@@ -369,7 +393,16 @@ TEST(FlatHashMap, stress_test) {
   }
 }
 
-TEST(FlatHashSet, stress_test) {
+TEST(FlatHashMap, stress_test) {
+  test_hash_map_stress<td::FlatHashMap<td::uint64, td::uint64>>();
+}
+
+TEST(FlatHashMapSwiss, stress_test) {
+  test_hash_map_stress<td::FlatHashMapSwiss<td::uint64, td::uint64>>();
+}
+
+template <class TableT>
+static void test_hash_set_stress() {
   td::vector<td::RandomSteps::Step> steps;
   auto add_step = [&steps](td::Slice, td::uint32 weight, auto f) {
     steps.emplace_back(td::RandomSteps::Step{std::move(f), weight});
@@ -378,7 +411,7 @@ TEST(FlatHashSet, stress_test) {
   td::Random::Xorshift128plus rnd(123);
   size_t max_table_size = MAX_TABLE_SIZE;  // dynamic value
   std::unordered_set<td::uint64, td::Hash<td::uint64>> ref;
-  td::FlatHashSet<td::uint64> tbl;
+  TableT tbl;
 
   auto validate = [&] {
     ASSERT_EQ(ref.empty(), tbl.empty());
@@ -450,3 +483,11 @@ TEST(FlatHashSet, stress_test) {
     runner.step(rnd);
   }
 }
+
+TEST(FlatHashSet, stress_test) {
+  test_hash_set_stress<td::FlatHashSet<td::uint64>>();
+}
+
+TEST(FlatHashSetSwiss, stress_test) {
+  test_hash_set_stress<td::FlatHashSetSwiss<td::uint64>>();
+}
@@ -0,0 +1,108 @@
+//
+// Copyright Aliaksei Levin (levlam@telegram.org), Arseny Smirnov (arseny30@gmail.com) 2014-2024
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+#include "td/utils/common.h"
+#include "td/utils/port/thread.h"
+#include "td/utils/Random.h"
+#include "td/utils/Span.h"
+#include "td/utils/tests.h"
+#include "td/utils/TlObjectArena.h"
+
+#include <cstdint>
+#include <cstring>
+
+static td::vector<void *> allocate_objects(size_t count, size_t max_size) {
+  td::vector<void *> objects;
+  for (size_t i = 0; i < count; i++) {
+    auto size = static_cast<size_t>(td::Random::fast(1, static_cast<int>(max_size)));
+    auto object = td::TlObjectArena::allocate(size);
+    std::memset(object, static_cast<int>(i), size);
+    objects.push_back(object);
+  }
+  return objects;
+}
+
+TEST(TlObjectArena, disabled) {
+  auto old_stats = td::TlObjectArena::get_stats();
+  td::vector<void *> objects;
+  {
+    td::TlObjectArena::Guard guard(1000, false);
+    objects = allocate_objects(10, 100);
+  }
+  auto stats = td::TlObjectArena::get_stats();
+  ASSERT_EQ(old_stats.arena_allocation_count, stats.arena_allocation_count);
+  ASSERT_EQ(old_stats.heap_allocation_count, stats.heap_allocation_count);
+  ASSERT_EQ(old_stats.chunk_count, stats.chunk_count);
+  for (auto object : objects) {
+    // the objects are allocated directly by operator new without a header
+    ASSERT_EQ(0u, reinterpret_cast<std::uintptr_t>(object) % 16);
+  }
+  for (auto object : objects) {
+    td::TlObjectArena::deallocate(object);
+  }
+}
+
+TEST(TlObjectArena, chunks) {
+  if (!td::TlObjectArena::is_supported()) {
+    return;
+  }
+  auto old_stats = td::TlObjectArena::get_stats();
+  td::vector<void *> objects;
+  {
+    td::TlObjectArena::Guard guard(10000, true);
+    objects = allocate_objects(1000, 200);
+
+    // big objects are allocated on the heap
+    objects.push_back(td::TlObjectArena::allocate(100000));
+  }
+  // objects allocated outside of a guard are allocated on the heap
+  objects.push_back(td::TlObjectArena::allocate(10));
+
+  auto stats = td::TlObjectArena::get_stats();
+  ASSERT_EQ(old_stats.arena_allocation_count + 1000, stats.arena_allocation_count);
+  ASSERT_EQ(old_stats.heap_allocation_count + 1, stats.heap_allocation_count);
+  ASSERT_TRUE(stats.chunk_count > old_stats.chunk_count);
+  ASSERT_TRUE(stats.chunk_count < old_stats.chunk_count + 100);
+
+  td::Random::Xorshift128plus rnd(123);
+  td::rand_shuffle(td::as_mutable_span(objects), rnd);
+  auto last_object = objects.back();
+  objects.pop_back();
+  for (auto object : objects) {
+    td::TlObjectArena::deallocate(object);
+  }
+  // a chunk is kept while there is an object in it
+  ASSERT_TRUE(td::TlObjectArena::get_stats().chunk_count <= old_stats.chunk_count + 1);
+  td::TlObjectArena::deallocate(last_object);
+  ASSERT_EQ(old_stats.chunk_count, td::TlObjectArena::get_stats().chunk_count);
+}
+
+#if !TD_THREAD_UNSUPPORTED
+TEST(TlObjectArena, other_thread) {
+  if (!td::TlObjectArena::is_supported()) {
+    return;
+  }
+  auto old_chunk_count = td::TlObjectArena::get_stats().chunk_count;
+  td::vector<void *> objects;
+  {
+    td::TlObjectArena::Guard guard(100000, true);
+    objects = allocate_objects(10000, 50);
+  }
+  auto middle = objects.begin() + objects.size() / 2;
+  td::vector<void *> other_objects(middle, objects.end());
+  objects.erase(middle, objects.end());
+  td::thread thread([&] {
+    for (auto object : other_objects) {
+      td::TlObjectArena::deallocate(object);
+    }
+  });
+  for (auto object : objects) {
+    td::TlObjectArena::deallocate(object);
+  }
+  thread.join();
+  ASSERT_EQ(old_chunk_count, td::TlObjectArena::get_stats().chunk_count);
+}
+#endif
@@ -7,6 +7,8 @@
 #include "td/utils/tests.h"
 
 #include "td/utils/buffer.h"
+#include "td/utils/common.h"
+#include "td/utils/port/thread.h"
 #include "td/utils/Random.h"
 
 TEST(Buffer, buffer_builder) {
@@ -54,3 +56,38 @@ TEST(Buffer, buffer_builder) {
     ASSERT_EQ(builder.extract().as_slice(), str);
   }
 }
+
+TEST(Buffer, big_buffer_pool) {
+  auto start_mem = td::BufferAllocator::get_buffer_mem();
+  {
+    td::BufferSlice slice(512 << 10);
+    slice.as_mutable_slice().fill('a');
+  }
+  auto pool_mem = td::BufferAllocator::get_buffer_pool_mem();
+  ASSERT_TRUE(pool_mem > 0);
+  ASSERT_EQ(start_mem, td::BufferAllocator::get_buffer_mem());
+
+  {
+    // the memory must be reused by a buffer of the same size class
+    td::BufferSlice slice((512 << 10) - 100);
+    ASSERT_TRUE(td::BufferAllocator::get_buffer_pool_mem() < pool_mem);
+    slice.as_mutable_slice().fill('b');
+    ASSERT_EQ(td::string((512 << 10) - 100, 'b'), slice.as_slice());
+  }
+  ASSERT_EQ(pool_mem, td::BufferAllocator::get_buffer_pool_mem());
+
+#if !TD_THREAD_UNSUPPORTED
+  td::vector<td::BufferSlice> slices;
+  for (int i = 0; i < 100; i++) {
+    slices.emplace_back(td::Random::fast(1, 2 << 20));
+  }
+  td::thread thread([slices = std::move(slices)]() mutable { slices.clear(); });
+  thread.join();
+  for (int i = 0; i < 100; i++) {
+    slices.emplace_back(td::Random::fast(1, 2 << 20));
+  }
+  slices.clear();
+#endif
+
+  ASSERT_EQ(start_mem, td::BufferAllocator::get_buffer_mem());
+}
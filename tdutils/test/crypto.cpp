@@ -8,6 +8,8 @@
 #include "td/utils/benchmark.h"
 #include "td/utils/common.h"
 #include "td/utils/crypto.h"
+#include "td/utils/port/FileFd.h"
+#include "td/utils/port/path.h"
 #include "td/utils/Random.h"
 #include "td/utils/Slice.h"
 #include "td/utils/SliceBuilder.h"
@@ -237,6 +239,35 @@ TEST(Crypto, Sha256State) {
   }
 }
 
+TEST(Crypto, sha256_feed_file) {
+  td::CSlice path = "sha256_feed_file.tmp";
+  auto s = td::rand_string(std::numeric_limits<char>::min(), std::numeric_limits<char>::max(), 3000001);
+  {
+    auto fd = td::FileFd::open(path, td::FileFd::Write | td::FileFd::Create | td::FileFd::Truncate).move_as_ok();
+    ASSERT_EQ(s.size(), fd.write(s).move_as_ok());
+  }
+  auto fd = td::FileFd::open(path, td::FileFd::Read).move_as_ok();
+  for (auto offset : {0, 1, 1048576, 2999999}) {
+    auto part = td::Slice(s).substr(offset);
+    td::UInt256 baseline;
+    td::sha256(part, as_mutable_slice(baseline));
+
+    td::Sha256State state;
+    state.init();
+    ASSERT_TRUE(td::sha256_feed_file(state, fd, offset, static_cast<td::int64>(part.size())).is_ok());
+    td::UInt256 result;
+    state.extract(as_mutable_slice(result));
+    ASSERT_TRUE(baseline == result);
+  }
+
+  // the file can be truncated while it is hashed
+  td::Sha256State state;
+  state.init();
+  ASSERT_TRUE(td::sha256_feed_file(state, fd, 0, static_cast<td::int64>(s.size()) + 1).is_error());
+  fd.close();
+  td::unlink(path).ignore();
+}
+
 TEST(Crypto, PBKDF) {
   td::vector<td::string> passwords{"", "qwerty", td::string(1000, 'a')};
   td::vector<td::string> salts{"", "qwerty", td::string(1000, 'a')};
@@ -29,6 +29,70 @@ TEST(Gzip, gzencode_gzdecode) {
   encode_decode(td::string(1000000, 'a'));
 }
 
+TEST(Gzip, dictionary) {
+  auto dictionary = td::rand_string(0, 255, 1000);
+  auto s = dictionary.substr(100, 500) + td::rand_string('a', 'z', 10) + dictionary.substr(600, 300);
+  auto r = td::gzencode(s, 2, dictionary);
+  ASSERT_TRUE(!r.empty());
+  ASSERT_TRUE(r.size() < 100u);
+  ASSERT_EQ(s, td::gzdecode(r.as_slice(), dictionary));
+  ASSERT_TRUE(td::gzdecode(r.as_slice()).empty());
+  ASSERT_TRUE(td::gzdecode(r.as_slice(), td::rand_string(0, 255, 1000)).empty());
+  ASSERT_TRUE(td::gzencode(s, 2).size() > 800u);
+}
+
+TEST(Gzip, reset) {
+  td::Gzip gzip;
+  gzip.set_is_reusable(true);
+  ASSERT_TRUE(gzip.reset().is_error());
+  gzip.init_encode().ensure();
+  for (int i = 0; i < 3; i++) {
+    auto s = td::rand_string('a', 'b', 1000);
+    td::string output(1000, '\0');
+    gzip.reset().ensure();
+    gzip.set_input(s);
+    gzip.close_input();
+    gzip.set_output(td::MutableSlice(output));
+    ASSERT_TRUE(gzip.run().move_as_ok() == td::Gzip::State::Done);
+    output.resize(gzip.used_output());
+    ASSERT_EQ(s, td::gzdecode(output));
+  }
+}
+
+TEST(Gzip, raw_dictionary) {
+  auto dictionary = td::rand_string(0, 255, 1000);
+  td::Gzip encoder;
+  encoder.set_is_reusable(true);
+  encoder.set_is_raw(true);
+  encoder.set_use_fixed_codes(true);
+  encoder.init_encode().ensure();
+  td::Gzip decoder;
+  decoder.set_is_reusable(true);
+  decoder.set_is_raw(true);
+  decoder.init_decode().ensure();
+  for (int i = 0; i < 3; i++) {
+    auto s = dictionary.substr(i * 100, 500) + td::rand_string('a', 'z', 10);
+    td::string compressed(s.size(), '\0');
+    encoder.reset().ensure();
+    encoder.set_dictionary(dictionary).ensure();
+    encoder.set_input(s);
+    encoder.close_input();
+    encoder.set_output(td::MutableSlice(compressed));
+    ASSERT_TRUE(encoder.run().move_as_ok() == td::Gzip::State::Done);
+    compressed.resize(encoder.used_output());
+    ASSERT_TRUE(compressed.size() < 100u);
+
+    td::string output(s.size(), '\0');
+    decoder.reset().ensure();
+    decoder.set_dictionary(dictionary).ensure();
+    decoder.set_input(compressed);
+    decoder.close_input();
+    decoder.set_output(td::MutableSlice(output));
+    ASSERT_TRUE(decoder.run().move_as_ok() == td::Gzip::State::Done);
+    ASSERT_EQ(s, output);
+  }
+}
+
 static void test_gzencode(const td::string &s) {
   auto begin_time = td::Time::now();
   auto r = td::gzencode(s, td::max(2, static_cast<int>(100 / s.size())));
@@ -6,13 +6,16 @@
 //
 #include "td/utils/AsyncFileLog.h"
 #include "td/utils/benchmark.h"
+#include "td/utils/BinaryFileLog.h"
 #include "td/utils/CombinedLog.h"
+#include "td/utils/filesystem.h"
 #include "td/utils/FileLog.h"
 #include "td/utils/format.h"
 #include "td/utils/logging.h"
 #include "td/utils/MemoryLog.h"
 #include "td/utils/NullLog.h"
 #include "td/utils/port/path.h"
+#include "td/utils/port/Stat.h"
 #include "td/utils/port/thread.h"
 #include "td/utils/Slice.h"
 #include "td/utils/SliceBuilder.h"
@@ -183,5 +186,124 @@ TEST(Log, Bench) {
     return td::make_unique<AsyncFileLog>();
   });
 #endif
+
+  bench_log("BinaryFileLog", [] {
+    auto result = td::make_unique<td::BinaryFileLog>();
+    result->init("tmplog", std::numeric_limits<td::int64>::max(), 0).ensure();
+    return result;
+  });
+}
+
+TEST(Log, BinaryFileLog) {
+  td::string path = "tmp_binary_log";
+  td::unlink(path).ignore();
+  td::unlink(path + ".1").ignore();
+
+  auto old_log_interface = td::log_interface;
+  auto old_verbosity_level = GET_VERBOSITY_LEVEL();
+  SET_VERBOSITY_LEVEL(VERBOSITY_NAME(INFO));
+  {
+    td::BinaryFileLog log;
+    log.init(path, std::numeric_limits<td::int64>::max(), 1, 1 << 16).ensure();
+    td::log_interface = &log;
+
+    td::vector<td::thread> threads(4);
+    for (size_t i = 0; i < threads.size(); i++) {
+      threads[i] = td::thread([i] {
+        for (int j = 0; j < 100; j++) {
+          LOG(WARNING) << "Message " << j << " from thread " << i;
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    log.flush();
+    // buffers of finished threads must be freed
+    ASSERT_EQ(0u, log.get_stats().thread_buffer_count);
+
+    LOG(PLAIN) << "Plain message";
+    LOG(INFO) << td::string(1 << 20, 'a');  // must be truncated
+    log.flush();
+
+    auto stats = log.get_stats();
+    td::log_interface = old_log_interface;
+    ASSERT_EQ(0u, stats.dropped_count);
+    ASSERT_EQ(402u, stats.message_count);
+    ASSERT_EQ(1u, stats.thread_buffer_count);
+  }
+  SET_VERBOSITY_LEVEL(old_verbosity_level);
+
+  auto data = td::read_file_str(path).move_as_ok();
+  size_t message_count = 0;
+  td::decode_binary_log(data, [&](const td::BinaryLogMessage &message) {
+                          ASSERT_EQ(0u, message.dropped_count);
+                          message_count++;
+                          if (message.log_level == VERBOSITY_NAME(WARNING)) {
+                            ASSERT_EQ("log.cpp", message.file_name);
+                            ASSERT_TRUE(td::begins_with(message.text, "\tMessage "));
+                            ASSERT_TRUE(message.thread_id != 0);
+                            auto text = td::format_binary_log_message(message);
+                            ASSERT_TRUE(td::begins_with(text, "[ 2]"));
+                            ASSERT_TRUE(text.find("[log.cpp:") != td::string::npos);
+                          } else if (message.log_level == VERBOSITY_NAME(PLAIN)) {
+                            ASSERT_EQ("Plain message\n", td::format_binary_log_message(message));
+                          } else {
+                            ASSERT_EQ(VERBOSITY_NAME(INFO), message.log_level);
+                            ASSERT_TRUE(message.text.size() < (1 << 16));
+                          }
+                        })
+      .ensure();
+  ASSERT_EQ(402u, message_count);
+
+  // a new log must not be appended to the existing file
+  {
+    td::BinaryFileLog log;
+    log.init(path, 1 << 10, 1).ensure();
+    log.flush();
+    auto paths = static_cast<td::LogInterface &>(log).get_file_paths();
+    ASSERT_EQ(2u, paths.size());
+    ASSERT_EQ(data, td::read_file_str(paths[1]).move_as_ok());
+    for (int i = 0; i < 100; i++) {
+      static_cast<td::LogInterface &>(log).append(VERBOSITY_NAME(ERROR), __FILE__, __LINE__,
+                                                  td::CSlice("Message to the rotated log"));
+    }
+  }
+  auto new_data = td::read_file_str(path).move_as_ok();
+  ASSERT_TRUE(new_data.size() <= (2 << 10));
+  td::decode_binary_log(new_data, [](const td::BinaryLogMessage &message) {
+                          ASSERT_EQ("Message to the rotated log", message.text);
+                        })
+      .ensure();
+  td::unlink(path).ignore();
+  td::unlink(path + ".1").ignore();
+}
+
+static td::string last_callback_message;
+
+static void on_log_message(int /*verbosity_level*/, td::CSlice message) {
+  last_callback_message = message.str();
+}
+
+TEST(Log, BinaryFileLogCallback) {
+  td::string path = "tmp_binary_log";
+  td::unlink(path).ignore();
+
+  auto old_log_interface = td::log_interface;
+  {
+    td::BinaryFileLog log;
+    log.init(path, std::numeric_limits<td::int64>::max(), 0).ensure();
+    td::log_interface = &log;
+    td::set_log_message_callback(VERBOSITY_NAME(ERROR), on_log_message);
+    LOG(ERROR) << "Message to the callback";
+    td::set_log_message_callback(VERBOSITY_NAME(ERROR), nullptr);
+    td::log_interface = old_log_interface;
+  }
+
+  // the callback must receive the message with the usual prefix, which isn't stored in the binary log
+  ASSERT_TRUE(td::begins_with(last_callback_message, "[ 1][t"));
+  ASSERT_TRUE(last_callback_message.find("[log.cpp:") != td::string::npos);
+  ASSERT_TRUE(td::ends_with(last_callback_message, "\tMessage to the callback\n"));
+  td::unlink(path).ignore();
 }
 #endif
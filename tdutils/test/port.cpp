@@ -124,6 +124,29 @@ TEST(Port, SparseFiles) {
   td::unlink(path).ensure();
 }
 
+TEST(Port, HardLinks) {
+  td::CSlice path = "link_source.txt";
+  td::CSlice link_path = "link_target.txt";
+  td::unlink(path).ignore();
+  td::unlink(link_path).ignore();
+  auto fd = td::FileFd::open(path, td::FileFd::Write | td::FileFd::CreateNew).move_as_ok();
+  fd.write("abcd").ensure();
+  fd.close();
+  ASSERT_EQ(1, td::stat(path).move_as_ok().link_count_);
+  if (td::link(path, link_path).is_error()) {
+    LOG(ERROR) << "File system doesn't support hard links";
+    td::unlink(path).ensure();
+    return;
+  }
+  ASSERT_EQ(2, td::stat(path).move_as_ok().link_count_);
+  ASSERT_TRUE(td::link(path, link_path).is_error());
+  td::unlink(path).ensure();
+  auto link_stat = td::stat(link_path).move_as_ok();
+  ASSERT_EQ(1, link_stat.link_count_);
+  ASSERT_EQ(4, link_stat.size_);
+  td::unlink(link_path).ensure();
+}
+
 TEST(Port, LargeFiles) {
   td::CSlice path = "large.txt";
   td::unlink(path).ignore();
@@ -0,0 +1,122 @@
+//
+// Copyright Aliaksei Levin (levlam@telegram.org), Arseny Smirnov (arseny30@gmail.com) 2014-2024
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+#include "td/telegram/ColdObjectEvictor.h"
+#include "td/telegram/UserId.h"
+
+#include "td/utils/common.h"
+#include "td/utils/tests.h"
+#include "td/utils/WaitFreeHashMap.h"
+
+namespace {
+
+struct TestObject {
+  td::int32 value = 0;
+  mutable bool was_accessed = true;
+};
+
+using Evictor = td::ColdObjectEvictor<td::UserId, TestObject, td::UserIdHash>;
+
+}  // namespace
+
+static td::vector<td::int64> get_cold_objects(Evictor &evictor, Evictor::Objects &objects, size_t max_count) {
+  auto user_ids = evictor.get_cold_objects(objects, max_count, [](td::UserId, const TestObject *object) {
+    return object->value % 10 != 0;  // objects with round values are pinned
+  });
+  td::vector<td::int64> result;
+  for (auto user_id : user_ids) {
+    result.push_back(user_id.get());
+  }
+  return result;
+}
+
+static void evict(Evictor &evictor, Evictor::Objects &objects, const td::vector<td::int64> &user_ids) {
+  for (auto user_id : user_ids) {
+    objects.erase(td::UserId(user_id));
+    evictor.on_object_evicted(td::UserId(user_id));
+  }
+}
+
+TEST(ColdObjectEvictor, clock) {
+  Evictor evictor;
+  Evictor::Objects objects;
+  for (td::int32 i = 1; i <= 10; i++) {
+    auto object = td::make_unique<TestObject>();
+    object->value = i;
+    objects.set(td::UserId(static_cast<td::int64>(i)), std::move(object));
+  }
+
+  // all objects were recently accessed, so they get a second chance
+  ASSERT_TRUE(get_cold_objects(evictor, objects, 3).empty());
+
+  ASSERT_EQ((td::vector<td::int64>{1, 2, 3}), get_cold_objects(evictor, objects, 3));
+  evict(evictor, objects, {1, 2, 3});
+
+  // the hand continues after the last visited object and skips recently accessed objects
+  objects.get_pointer(td::UserId(static_cast<td::int64>(5)))->was_accessed = true;
+  ASSERT_EQ((td::vector<td::int64>{4, 6, 7}), get_cold_objects(evictor, objects, 3));
+  evict(evictor, objects, {4, 6, 7});
+
+  // the hand wraps around, and pinned objects are never evicted
+  auto object = td::make_unique<TestObject>();
+  object->value = 11;
+  object->was_accessed = false;
+  objects.set(td::UserId(static_cast<td::int64>(2)), std::move(object));
+  ASSERT_EQ((td::vector<td::int64>{8, 9, 2}), get_cold_objects(evictor, objects, 3));
+  evict(evictor, objects, {8, 9, 2});
+  ASSERT_EQ((td::vector<td::int64>{5}), get_cold_objects(evictor, objects, 3));
+  evict(evictor, objects, {5});
+  ASSERT_EQ(1u, objects.calc_size());
+  ASSERT_EQ(9u, evictor.get_evicted_object_count());
+}
+
+TEST(ColdObjectEvictor, restore) {
+  Evictor evictor;
+  td::UserId user_id(static_cast<td::int64>(1));
+  td::UserId other_user_id(static_cast<td::int64>(2));
+  ASSERT_TRUE(!evictor.is_evicted(user_id));
+  ASSERT_TRUE(evictor.take_object(user_id) == nullptr);
+
+  evictor.on_object_evicted(user_id);
+  evictor.on_object_evicted(other_user_id);
+  ASSERT_TRUE(evictor.is_evicted(user_id));
+  ASSERT_TRUE(!evictor.has_restored_objects());
+
+  int load_count = 0;
+  auto load_object = [&] {
+    load_count++;
+    auto object = td::make_unique<TestObject>();
+    object->value = 5;
+    return object;
+  };
+  const Evictor &const_evictor = evictor;
+  auto object = const_evictor.get_evicted_object(user_id, load_object);
+  ASSERT_TRUE(object != nullptr);
+  ASSERT_EQ(5, object->value);
+  ASSERT_EQ(object, const_evictor.get_evicted_object(user_id, load_object));
+  ASSERT_EQ(1, load_count);
+  ASSERT_TRUE(evictor.has_restored_objects());
+  ASSERT_TRUE(evictor.is_evicted(user_id));
+  ASSERT_EQ(1u, evictor.get_restored_object_keys().size());
+
+  // the restored object is returned with the same address
+  auto restored_object = evictor.take_object(user_id);
+  ASSERT_EQ(object, restored_object.get());
+  ASSERT_TRUE(!evictor.is_evicted(user_id));
+  ASSERT_TRUE(!evictor.has_restored_objects());
+
+  // the object, which failed to load, isn't loaded again
+  auto fail_load_object = [&] {
+    load_count++;
+    return td::unique_ptr<TestObject>();
+  };
+  ASSERT_TRUE(const_evictor.get_evicted_object(other_user_id, fail_load_object) == nullptr);
+  ASSERT_TRUE(const_evictor.get_evicted_object(other_user_id, fail_load_object) == nullptr);
+  ASSERT_EQ(2, load_count);
+  ASSERT_TRUE(evictor.take_object(other_user_id) == nullptr);
+  ASSERT_TRUE(!evictor.is_evicted(other_user_id));
+  ASSERT_EQ(0u, evictor.get_evicted_object_count());
+}
@@ -10,11 +10,17 @@
 #include "td/db/binlog/ConcurrentBinlog.h"
 #include "td/db/BinlogKeyValue.h"
 #include "td/db/DbKey.h"
+#include "td/db/DbTrace.h"
 #include "td/db/SeqKeyValue.h"
+#include "td/db/SqliteBlobCompressor.h"
 #include "td/db/SqliteConnectionSafe.h"
 #include "td/db/SqliteDb.h"
 #include "td/db/SqliteKeyValue.h"
+#include "td/db/SqliteKeyValueAsync.h"
+#include "td/db/SqliteKeyValueFilter.h"
 #include "td/db/SqliteKeyValueSafe.h"
+#include "td/db/SqliteReadQueryPool.h"
+#include "td/db/SqliteStatement.h"
 #include "td/db/TsSeqKeyValue.h"
 
 #include "td/actor/actor.h"
@@ -25,14 +31,18 @@
 #include "td/utils/filesystem.h"
 #include "td/utils/FlatHashMap.h"
 #include "td/utils/logging.h"
+#include "td/utils/misc.h"
 #include "td/utils/port/FileFd.h"
+#include "td/utils/port/path.h"
 #include "td/utils/port/thread.h"
+#include "td/utils/Promise.h"
 #include "td/utils/Random.h"
 #include "td/utils/Slice.h"
 #include "td/utils/Status.h"
 #include "td/utils/StringBuilder.h"
 #include "td/utils/tests.h"
 
+#include <atomic>
 #include <limits>
 #include <map>
 #include <memory>
@@ -147,6 +157,217 @@ TEST(DB, sqlite_lfs) {
   td::SqliteDb::destroy(path).ignore();
 }
 
+TEST(DB, sqlite_checkpoint) {
+  td::string path = "test_sqlite_db";
+  td::SqliteDb::destroy(path).ignore();
+  auto db = td::SqliteDb::open_with_key(path, true, td::DbKey::empty()).move_as_ok();
+  auto result = db.checkpoint(td::SqliteDb::CheckpointMode::Passive).move_as_ok();
+  ASSERT_EQ(-1, result.wal_frame_count);
+
+  db.exec("PRAGMA journal_mode=WAL").ensure();
+  db.exec("PRAGMA wal_autocheckpoint=0").ensure();
+  db.exec("CREATE TABLE t (k INT PRIMARY KEY, v BLOB)").ensure();
+  db.exec("INSERT INTO t VALUES (1, zeroblob(100000))").ensure();
+
+  auto reader = td::SqliteDb::open_with_key(path, false, td::DbKey::empty()).move_as_ok();
+  reader.exec("BEGIN TRANSACTION").ensure();
+  reader.exec("SELECT * FROM t").ensure();
+  db.exec("INSERT INTO t VALUES (2, zeroblob(100000))").ensure();
+
+  // frames written after the start of the read transaction can't be checkpointed
+  result = db.checkpoint(td::SqliteDb::CheckpointMode::Passive).move_as_ok();
+  ASSERT_TRUE(result.wal_frame_count > 0);
+  ASSERT_TRUE(result.checkpointed_frame_count < result.wal_frame_count);
+  ASSERT_TRUE(!result.is_busy);
+
+  reader.exec("COMMIT TRANSACTION").ensure();
+  result = db.checkpoint(td::SqliteDb::CheckpointMode::Restart).move_as_ok();
+  ASSERT_EQ(result.wal_frame_count, result.checkpointed_frame_count);
+  ASSERT_TRUE(!result.is_busy);
+  td::SqliteDb::destroy(path).ignore();
+}
+
+TEST(DB, sqlite_fts_tokenizer) {
+  td::string path = "test_sqlite_db";
+  td::SqliteDb::destroy(path).ignore();
+  auto db = td::SqliteDb::open_with_key(path, true, td::DbKey::empty()).move_as_ok();
+  db.exec("CREATE VIRTUAL TABLE t USING fts5(text, tokenize='td', prefix='2 3', detail=none)").ensure();
+  db.exec("INSERT INTO t(rowid, text) VALUES (1, 'Привет, Мир! \a-100 \a\a5')").ensure();
+  db.exec("INSERT INTO t(rowid, text) VALUES (2, 'Crème brûlée résumé \a100 \a\a15')").ensure();
+  db.exec("INSERT INTO t(rowid, text) VALUES (3, 'hello_world 2024 \a100')").ensure();
+
+  auto stmt = db.get_statement("SELECT group_concat(rowid) FROM t WHERE t MATCH ?1").move_as_ok();
+  auto search = [&](td::Slice query) {
+    stmt.bind_string(1, query).ensure();
+    stmt.step().ensure();
+    CHECK(stmt.has_row());
+    auto result =
+        stmt.view_datatype(0) == td::SqliteStatement::Datatype::Null ? td::string() : stmt.view_string(0).str();
+    stmt.reset();
+    return result;
+  };
+  ASSERT_EQ("1", search("\"мир\""));
+  ASSERT_EQ("1", search("\"ПРИВ\"*"));
+  ASSERT_EQ("2", search("\"creme\" \"brulee\""));
+  ASSERT_EQ("2", search("\"resu\"*"));
+  ASSERT_EQ("3", search("\"hello\" \"world\""));
+  ASSERT_EQ("3", search("\"20\"*"));
+  ASSERT_EQ("1", search("\"\a-100\""));
+  ASSERT_EQ("2,3", search("\"\a100\""));
+  ASSERT_EQ("1", search("\"\a\a5\""));
+  ASSERT_EQ("", search("\"\a10\""));
+  ASSERT_EQ("", search("\"\a\a1\""));
+  stmt = td::SqliteStatement();
+  db.close();
+  td::SqliteDb::destroy(path).ignore();
+}
+
+TEST(DB, sqlite_blob_compressor) {
+  td::string path = "test_sqlite_db";
+  td::SqliteDb::destroy(path).ignore();
+  auto db = td::SqliteDb::open_with_key(path, true, td::DbKey::empty()).move_as_ok();
+  td::SqliteBlobCompressor::init_db(db).ensure();
+
+  std::atomic<bool> is_enabled{false};
+  td::SqliteBlobCompressor compressor;
+  compressor.init(db.clone(), "test", &is_enabled).ensure();
+  td::SqliteBlobCompressor other_compressor;
+  other_compressor.init(db.clone(), "test", &is_enabled).ensure();
+
+  td::Random::Xorshift128plus rnd(123);
+  td::vector<td::string> words;
+  for (int i = 0; i < 100; i++) {
+    words.push_back(td::rand_string('a', 'z', rnd.fast(2, 8)));
+  }
+  auto gen_blob = [&] {
+    td::string blob = "\x01\x00\x00\x00message#";
+    blob += td::to_string(rnd.fast(1, 1000000));
+    blob += " from_id:peerUser date:1700000000 flags:reply_markup,entities,views text:";
+    while (blob.size() < 600) {
+      blob += words[rnd.fast(0, 99)];
+      blob += ' ';
+    }
+    blob += " media:messageMediaEmpty views:0 forwards:0 replies:messageReplies";
+    return blob;
+  };
+
+  ASSERT_EQ("short", compressor.compress("short"));
+  auto blob = gen_blob();
+  ASSERT_EQ(blob, compressor.compress(blob));
+  ASSERT_EQ(blob, compressor.decompress(blob).as_slice());
+
+  is_enabled = true;
+  td::vector<std::pair<td::string, td::string>> blobs;
+  db.begin_write_transaction().ensure();
+  for (size_t i = 0; i < td::SqliteBlobCompressor::TRAINING_SAMPLE_COUNT + 100; i++) {
+    blob = gen_blob();
+    blobs.emplace_back(blob, compressor.compress(blob).str());
+  }
+  db.commit_transaction().ensure();
+  is_enabled = false;
+
+  size_t first_size = 0;
+  size_t last_size = 0;
+  for (size_t i = 0; i < blobs.size(); i++) {
+    ASSERT_TRUE(blobs[i].second.size() < blobs[i].first.size());
+    ASSERT_EQ(blobs[i].first, compressor.decompress(blobs[i].second).as_slice());
+    ASSERT_EQ(blobs[i].first, other_compressor.decompress(blobs[i].second).as_slice());
+    if (i < 100) {
+      first_size += blobs[i].second.size();
+    } else if (i >= td::SqliteBlobCompressor::TRAINING_SAMPLE_COUNT) {
+      last_size += blobs[i].second.size();
+    }
+  }
+  // blobs compressed with the trained dictionary must be smaller
+  ASSERT_TRUE(last_size < first_size);
+
+  compressor = td::SqliteBlobCompressor();
+  other_compressor = td::SqliteBlobCompressor();
+  db.close();
+  td::SqliteDb::destroy(path).ignore();
+}
+
+TEST(DB, sqlite_trace) {
+  td::string path = "test_sqlite_db";
+  td::string trace_path = "test_db_trace";
+  td::SqliteDb::destroy(path).ignore();
+  auto db = td::SqliteDb::open_with_key(path, true, td::DbKey::empty()).move_as_ok();
+  auto other_db = td::SqliteDb::open_with_key(path, true, td::DbKey::empty()).move_as_ok();
+  auto untraced_db = td::SqliteDb::open_with_key(path, true, td::DbKey::empty()).move_as_ok();
+  auto trace = std::make_shared<td::DbTrace>();
+  db.set_trace(trace);
+  other_db.set_trace(trace);
+
+  trace->start(trace_path).ensure();
+  db.exec("CREATE TABLE t (k INT PRIMARY KEY, v BLOB)").ensure();
+  auto stmt = db.get_statement("INSERT INTO t VALUES (?1, ?2)").move_as_ok();
+  auto get_value = [](int i) {
+    return td::string(i == 3 ? 50 : i * 50, 'a');
+  };
+  for (int i = 0; i < 4; i++) {
+    stmt.bind_int32(1, i).ensure();
+    stmt.bind_blob(2, get_value(i)).ensure();
+    stmt.step().ensure();
+    stmt.reset();
+  }
+  other_db.exec("SELECT COUNT(*) FROM t").ensure();
+  // connections, which aren't registered with the trace, aren't traced
+  untraced_db.exec("SELECT k FROM t").ensure();
+  trace->stop();
+  db.exec("DROP TABLE t").ensure();
+
+  auto events = td::DbTrace::read(trace_path).move_as_ok();
+  ASSERT_EQ(6u, events.size());
+  ASSERT_TRUE(events[0].type == td::DbTraceEvent::Type::Exec);
+  ASSERT_EQ("CREATE TABLE t (k INT PRIMARY KEY, v BLOB)", events[0].query);
+  ASSERT_TRUE(events[0].connection_id != 0);
+  for (int i = 0; i < 4; i++) {
+    auto &event = events[i + 1];
+    ASSERT_TRUE(event.type == td::DbTraceEvent::Type::Query);
+    ASSERT_EQ(events[0].connection_id, event.connection_id);
+    ASSERT_EQ("INSERT INTO t VALUES (?1, ?2)", event.query);
+    ASSERT_EQ(2u, event.values.size());
+    ASSERT_EQ(i, event.values[0].integer);
+    ASSERT_TRUE(event.values[1].type == td::DbTraceValue::Type::Blob);
+    auto value = get_value(i);
+    ASSERT_EQ(static_cast<td::int64>(value.size()), event.values[1].integer);
+    // values are never recorded; only hashes of short values are recorded
+    auto &data = event.values[1].data;
+    ASSERT_EQ(value.empty() || value.size() > td::DbTraceValue::MAX_DATA_SIZE ? 0u : td::DbTraceValue::HASH_SIZE,
+              data.size());
+  }
+  // equal values have equal hashes
+  ASSERT_EQ(events[2].values[1].data, events[4].values[1].data);
+  ASSERT_EQ("SELECT COUNT(*) FROM t", events[5].query);
+  ASSERT_TRUE(events[5].connection_id != 0);
+  ASSERT_TRUE(events[5].connection_id != events[0].connection_id);
+
+  stmt = td::SqliteStatement();
+  db.close();
+  other_db.close();
+  untraced_db.close();
+  td::unlink(trace_path).ignore();
+  td::SqliteDb::destroy(path).ignore();
+}
+
+TEST(DB, sqlite_connection_settings) {
+  td::string path = "test_sqlite_db";
+  td::SqliteDb::destroy(path).ignore();
+  auto db = td::SqliteDb::open_with_key(path, true, td::DbKey::empty()).move_as_ok();
+  ASSERT_EQ(1000, db.get_pragma_int64("wal_autocheckpoint").move_as_ok());
+
+  td::SqliteConnectionSettings settings;
+  settings.disable_auto_checkpoint = true;
+  settings.journal_size_limit = 1 << 20;
+  settings.cache_size = 4 << 20;
+  td::SqliteConnectionSafe::init_connection(db, settings).ensure();
+  ASSERT_EQ(0, db.get_pragma_int64("wal_autocheckpoint").move_as_ok());
+  ASSERT_EQ(1 << 20, db.get_pragma_int64("journal_size_limit").move_as_ok());
+  ASSERT_EQ(-4096, db.get_pragma_int64("cache_size").move_as_ok());
+  db.close();
+  td::SqliteDb::destroy(path).ignore();
+}
+
 TEST(DB, sqlite_encryption) {
   td::string path = "test_sqlite_db";
   td::SqliteDb::destroy(path).ignore();
@@ -405,6 +626,12 @@ class BaselineKV {
     current_tid_ += map_.size();
     return result;
   }
+  void erase_by_prefix(const td::string &prefix) {
+    auto it = map_.lower_bound(prefix);
+    while (it != map_.end() && td::begins_with(it->first, prefix)) {
+      it = map_.erase(it);
+    }
+  }
 
  private:
   std::map<td::string, td::string> map_;
@@ -524,6 +751,300 @@ TEST(DB, key_value_set_all) {
   td::SqliteDb::destroy(sqlite_kv_name).ignore();
 }
 
+TEST(DB, key_value_get_many) {
+  td::vector<td::string> keys;
+  for (int i = 0; i < 300; i++) {
+    keys.push_back(td::rand_string('a', 'c', td::Random::fast(1, 10)));
+  }
+
+  td::SqliteKeyValue sqlite_kv;
+  td::CSlice sqlite_kv_name = "test_sqlite_kv";
+  td::SqliteDb::destroy(sqlite_kv_name).ignore();
+  auto db = td::SqliteDb::open_with_key(sqlite_kv_name, true, td::DbKey::empty()).move_as_ok();
+  sqlite_kv.init_with_connection(std::move(db), "KV").ensure();
+
+  BaselineKV kv;
+  for (auto &key : keys) {
+    if (td::Random::fast_bool()) {
+      auto value = td::rand_string('a', 'z', td::Random::fast(1, 100));
+      kv.set(key, value);
+      sqlite_kv.set(key, value);
+    }
+  }
+
+  for (int query_n = 0; query_n < 100; query_n++) {
+    td::vector<td::string> query_keys;
+    int cnt = td::Random::fast(0, 200);
+    for (int i = 0; i < cnt; i++) {
+      query_keys.push_back(rand_elem(keys));
+    }
+    auto values = sqlite_kv.get_many(query_keys);
+    ASSERT_EQ(query_keys.size(), values.size());
+    for (size_t i = 0; i < query_keys.size(); i++) {
+      ASSERT_EQ(kv.get(query_keys[i]), values[i]);
+    }
+  }
+  td::SqliteDb::destroy(sqlite_kv_name).ignore();
+}
+
+TEST(DB, key_value_set_many) {
+  td::vector<td::string> keys;
+  for (int i = 0; i < 300; i++) {
+    keys.push_back(td::rand_string('a', 'c', td::Random::fast(1, 10)));
+  }
+
+  td::SqliteKeyValue sqlite_kv;
+  td::CSlice sqlite_kv_name = "test_sqlite_kv";
+  td::SqliteDb::destroy(sqlite_kv_name).ignore();
+  auto db = td::SqliteDb::open_with_key(sqlite_kv_name, true, td::DbKey::empty()).move_as_ok();
+  sqlite_kv.init_with_connection(std::move(db), "KV").ensure();
+
+  BaselineKV kv;
+  for (int query_n = 0; query_n < 100; query_n++) {
+    int cnt = td::Random::fast(0, 200);
+    if (td::Random::fast_bool()) {
+      td::vector<std::pair<td::string, td::string>> key_values;
+      for (int i = 0; i < cnt; i++) {
+        auto key = rand_elem(keys);
+        auto value = td::rand_string('a', 'z', td::Random::fast(1, 100));
+        kv.set(key, value);
+        key_values.emplace_back(key, value);
+      }
+      sqlite_kv.set_many(key_values);
+    } else {
+      td::vector<td::string> erased_keys;
+      for (int i = 0; i < cnt; i++) {
+        erased_keys.push_back(rand_elem(keys));
+        kv.erase(erased_keys.back());
+      }
+      sqlite_kv.erase_many(erased_keys);
+    }
+
+    auto values = sqlite_kv.get_many(keys);
+    for (size_t i = 0; i < keys.size(); i++) {
+      ASSERT_EQ(kv.get(keys[i]), values[i]);
+    }
+  }
+  td::SqliteDb::destroy(sqlite_kv_name).ignore();
+}
+
+TEST(DB, key_value_filter) {
+  td::CSlice sqlite_kv_name = "test_sqlite_kv";
+  td::SqliteDb::destroy(sqlite_kv_name).ignore();
+
+  auto filter = std::make_shared<td::SqliteKeyValueFilter>();
+  td::SqliteKeyValue sqlite_kvs[2];
+  for (auto &sqlite_kv : sqlite_kvs) {
+    auto db = td::SqliteDb::open_with_key(sqlite_kv_name, true, td::DbKey::empty()).move_as_ok();
+    sqlite_kv.init_with_connection(std::move(db), "KV", filter).ensure();
+  }
+  sqlite_kvs[0].set("stored", "value");
+
+  BaselineKV kv;
+  kv.set("stored", "value");
+  for (int query_n = 0; query_n < 5000; query_n++) {
+    auto &sqlite_kv = sqlite_kvs[td::Random::fast(0, 1)];
+    auto key = td::rand_string('a', 'z', td::Random::fast(1, 3));
+    int op = td::Random::fast(0, 9);
+    if (op < 3) {
+      auto value = td::rand_string('a', 'z', td::Random::fast(1, 10));
+      kv.set(key, value);
+      sqlite_kv.set(key, value);
+    } else if (op == 3) {
+      kv.erase(key);
+      sqlite_kv.erase(key);
+    } else if (op == 4 && td::Random::fast(0, 99) == 0) {
+      kv.erase_by_prefix(key.substr(0, 1));
+      sqlite_kv.erase_by_prefix(key.substr(0, 1));
+    } else if (op == 5) {
+      td::vector<td::string> keys{key, "stored", key + "a"};
+      auto values = sqlite_kv.get_many(keys);
+      for (size_t i = 0; i < keys.size(); i++) {
+        ASSERT_EQ(kv.get(keys[i]), values[i]);
+      }
+    } else if (op == 6) {
+      // the filter isn't rebuilt inside a transaction
+      sqlite_kv.begin_write_transaction().ensure();
+      ASSERT_EQ(kv.get(key), sqlite_kv.get(key));
+      auto value = td::rand_string('a', 'z', 5);
+      kv.set(key, value);
+      sqlite_kv.set(key, value);
+      sqlite_kv.commit_transaction().ensure();
+    } else {
+      ASSERT_EQ(kv.get(key), sqlite_kv.get(key));
+    }
+  }
+
+  auto stats = sqlite_kvs[0].get_filter_stats();
+  ASSERT_TRUE(stats.skipped_lookup_count > 0);
+  ASSERT_TRUE(stats.rebuild_count > 1);
+  ASSERT_TRUE(stats.false_positive_count * 5 < stats.lookup_count);
+  td::SqliteDb::destroy(sqlite_kv_name).ignore();
+}
+
+TEST(DB, key_value_async_get_many) {
+  td::string sqlite_kv_name = "test_sqlite_kv";
+  td::SqliteDb::destroy(sqlite_kv_name).ignore();
+  td::SqliteDb::open_with_key(sqlite_kv_name, true, td::DbKey::empty()).ensure();
+
+  td::ConcurrentScheduler sched(1, 0);
+  std::shared_ptr<td::SqliteConnectionSafe> sql_connection;
+  td::unique_ptr<td::SqliteKeyValueAsyncInterface> kv_async;
+  td::vector<td::string> result;
+  td::vector<td::string> get_results;
+  {
+    auto guard = sched.get_main_guard();
+    sql_connection = std::make_shared<td::SqliteConnectionSafe>(sqlite_kv_name, td::DbKey::empty());
+    auto kv = std::make_shared<td::SqliteKeyValueSafe>("kv", sql_connection);
+    kv->get().set("stored", "value");
+    kv->get().set("erased", "value");
+    kv->get().set("changed", "value");
+    kv_async = td::create_sqlite_key_value_async(std::move(kv), 0);
+    // single-key requests are merged, but must be ordered with writes
+    for (auto key : {"stored", "absent", "changed"}) {
+      kv_async->get(key, td::PromiseCreator::lambda([&](td::string value) { get_results.push_back(value); }));
+    }
+    kv_async->set("changed", "new_value", td::Auto());
+    kv_async->get("changed", td::PromiseCreator::lambda([&](td::string value) { get_results.push_back(value); }));
+    kv_async->set("buffered", "new_value", td::Auto());
+    kv_async->erase("erased", td::Auto());
+    kv_async->get_many({"buffered", "erased", "stored", "absent", "stored"},
+                       td::PromiseCreator::lambda([&](td::vector<td::string> values) {
+                         result = std::move(values);
+                         kv_async->close(td::PromiseCreator::lambda([](td::Unit) {
+                           td::Scheduler::instance()->finish();
+                         }));
+                       }));
+  }
+  sched.start();
+  while (sched.run_main(10)) {
+    // empty
+  }
+  {
+    auto guard = sched.get_main_guard();
+    kv_async.reset();
+    sql_connection->close_and_destroy();
+  }
+  sched.finish();
+
+  ASSERT_EQ(5u, result.size());
+  ASSERT_EQ("new_value", result[0]);
+  ASSERT_EQ("", result[1]);
+  ASSERT_EQ("value", result[2]);
+  ASSERT_EQ("", result[3]);
+  ASSERT_EQ("value", result[4]);
+  ASSERT_EQ(td::vector<td::string>({"value", "", "value", "new_value"}), get_results);
+}
+
+#if !TD_THREAD_UNSUPPORTED
+TEST(DB, sqlite_read_query_pool) {
+  td::string path = "test_sqlite_db";
+  td::SqliteDb::destroy(path).ignore();
+  td::SqliteDb::open_with_key(path, true, td::DbKey::empty())
+      .move_as_ok()
+      .exec("CREATE TABLE t (k INT PRIMARY KEY, v INT)")
+      .ensure();
+
+  static auto read_value = [](td::SqliteDb &db, int k) {
+    auto stmt = db.get_statement("SELECT v FROM t WHERE k = ?1").move_as_ok();
+    stmt.bind_int32(1, k).ensure();
+    stmt.step().ensure();
+    return stmt.has_row() ? stmt.view_int32(0) : -1;
+  };
+
+  class Writer final : public td::Actor {
+   public:
+    Writer(std::shared_ptr<td::SqliteConnectionSafe> connection,
+           std::shared_ptr<td::SqliteReadQueryPool> read_query_pool)
+        : connection_(std::move(connection)), read_query_pool_(std::move(read_query_pool)) {
+    }
+
+    void write(int k, td::Promise<td::Unit> promise) {
+      connection_->get().exec(PSLICE() << "INSERT INTO t VALUES (" << k << ", " << k << ")").ensure();
+      read_query_pool_->on_write_queries_committed(1);
+      promise.set_value(td::Unit());
+    }
+
+    void read(int k, td::Promise<int> promise) {
+      promise.set_value(read_value(connection_->get(), k));
+    }
+
+   private:
+    std::shared_ptr<td::SqliteConnectionSafe> connection_;
+    std::shared_ptr<td::SqliteReadQueryPool> read_query_pool_;
+  };
+
+  const int WRITE_COUNT = 100;
+  // the main scheduler, the database scheduler and the reader scheduler
+  td::ConcurrentScheduler sched(2, 0);
+  std::shared_ptr<td::SqliteConnectionSafe> connection;
+  std::shared_ptr<td::SqliteReadQueryPool> read_query_pool;
+  td::ActorOwn<Writer> writer;
+  // the reads are issued and finished on different schedulers
+  std::atomic<int> pool_read_count{0};
+  std::atomic<int> writer_read_count{0};
+  std::atomic<int> found_count{0};
+  std::atomic<int> left_read_count{2 * WRITE_COUNT};
+  std::atomic<bool> is_write_failed{false};
+  auto read = [&](int k, td::Promise<int> promise) {
+    if (read_query_pool->can_run_query()) {
+      pool_read_count++;
+      read_query_pool->run_query([&, k, promise = std::move(promise)](td::Unit) mutable {
+        if (connection->get().exec("INSERT INTO t VALUES (-1, -1)").is_error()) {
+          is_write_failed = true;
+        }
+        promise.set_value(read_value(connection->get(), k));
+      });
+    } else {
+      writer_read_count++;
+      td::send_closure(writer, &Writer::read, k, std::move(promise));
+    }
+  };
+  auto on_read = [&](int k, int v) {
+    if (k == v) {
+      found_count++;
+    }
+    if (--left_read_count == 0) {
+      read_query_pool->close(td::PromiseCreator::lambda([](td::Unit) {
+        td::Scheduler::instance()->run_on_scheduler(0, [](td::Unit) { td::Scheduler::instance()->finish(); });
+      }));
+    }
+  };
+  {
+    auto guard = sched.get_main_guard();
+    connection = std::make_shared<td::SqliteConnectionSafe>(path, td::DbKey::empty());
+    read_query_pool = std::make_shared<td::SqliteReadQueryPool>(connection, td::vector<td::int32>{2});
+    writer = td::create_actor_on_scheduler<Writer>("Writer", 1, connection, read_query_pool);
+
+    for (int k = 0; k < WRITE_COUNT; k++) {
+      // the first read is issued after the write is committed by the database scheduler
+      read_query_pool->on_write_query_sent();
+      td::send_closure(writer, &Writer::write, k, td::PromiseCreator::lambda([&, k](td::Unit) {
+                         read(k, td::PromiseCreator::lambda([&, k](int v) { on_read(k, v); }));
+                       }));
+      // the second read is issued before the write is committed
+      read(k, td::PromiseCreator::lambda([&, k](int v) { on_read(k, v); }));
+    }
+  }
+  sched.start();
+  while (sched.run_main(10)) {
+    // empty
+  }
+  {
+    auto guard = sched.get_main_guard();
+    writer.reset();
+    read_query_pool.reset();
+    connection->close_and_destroy();
+  }
+  sched.finish();
+
+  ASSERT_EQ(2 * WRITE_COUNT, found_count.load());
+  ASSERT_TRUE(pool_read_count.load() > 0);
+  ASSERT_TRUE(writer_read_count.load() > 0);
+  ASSERT_TRUE(is_write_failed.load());
+}
+#endif
+
 #if !TD_THREAD_UNSUPPORTED
 TEST(DB, thread_key_value) {
   td::vector<td::string> keys;
@@ -9,6 +9,7 @@
 #include "td/telegram/net/Session.h"
 #include "td/telegram/NotificationManager.h"
 #include "td/telegram/telegram_api.h"
+#include "td/telegram/telegram_api.hpp"
 
 #include "td/mtproto/AuthData.h"
 #include "td/mtproto/DhCallback.h"
@@ -27,10 +28,13 @@
 #include "td/net/Socks5.h"
 #include "td/net/TransparentProxy.h"
 
+#include "td/tl/tl_object_parse.h"
+
 #include "td/actor/actor.h"
 #include "td/actor/ConcurrentScheduler.h"
 
 #include "td/utils/base64.h"
+#include "td/utils/buffer.h"
 #include "td/utils/BufferedFd.h"
 #include "td/utils/common.h"
 #include "td/utils/crypto.h"
@@ -45,6 +49,8 @@
 #include "td/utils/Status.h"
 #include "td/utils/tests.h"
 #include "td/utils/Time.h"
+#include "td/utils/tl_parsers.h"
+#include "td/utils/tl_storers.h"
 
 #include <memory>
 
@@ -480,6 +486,53 @@ class Socks5TestActor final : public td::Actor {
   }
 };
 
+template <class StorerT>
+static void store_geo_point_and_ids(StorerT &s) {
+  s.store_int(td::telegram_api::geoPoint::ID);
+  s.store_int(1);
+  s.store_binary(1.5);
+  s.store_binary(-2.5);
+  s.store_long(1234567890123);
+  s.store_int(100);
+
+  s.store_int(3);
+  s.store_long(1);
+  s.store_long(-2);
+  s.store_long(3);
+}
+
+TEST(Mtproto, parse_fixed_size_fields) {
+  td::TlStorerCalcLength calc_length;
+  store_geo_point_and_ids(calc_length);
+  td::BufferSlice buffer(calc_length.get_length());
+  td::TlStorerUnsafe storer(buffer.as_mutable_slice().ubegin());
+  store_geo_point_and_ids(storer);
+
+  for (size_t length = 0; length <= buffer.size(); length += 4) {
+    td::BufferSlice data(buffer.as_slice().substr(0, length));
+    td::TlBufferParser parser(&data);
+    auto geo_point = td::telegram_api::GeoPoint::fetch(parser);
+    auto ids = td::TlFetchVector<td::TlFetchLong>::parse(parser);
+    parser.fetch_end();
+    if (length < buffer.size()) {
+      ASSERT_TRUE(parser.get_error() != nullptr);
+      continue;
+    }
+
+    ASSERT_TRUE(parser.get_error() == nullptr);
+    ASSERT_EQ(td::telegram_api::geoPoint::ID, geo_point->get_id());
+    auto point = static_cast<const td::telegram_api::geoPoint *>(geo_point.get());
+    ASSERT_EQ(1.5, point->long_);
+    ASSERT_EQ(-2.5, point->lat_);
+    ASSERT_EQ(1234567890123, point->access_hash_);
+    ASSERT_EQ(100, point->accuracy_radius_);
+    ASSERT_EQ(3u, ids.size());
+    ASSERT_EQ(1, ids[0]);
+    ASSERT_EQ(-2, ids[1]);
+    ASSERT_EQ(3, ids[2]);
+  }
+}
+
 TEST(Mtproto, socks5) {
   return;
   int threads_n = 0;
@@ -0,0 +1,238 @@
+//
+// Copyright Aliaksei Levin (levlam@telegram.org), Arseny Smirnov (arseny30@gmail.com) 2014-2024
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+#include "td/telegram/ObjectSnapshotCache.h"
+#include "td/telegram/td_api.h"
+#include "td/telegram/td_api_copy.h"
+
+#include "td/utils/common.h"
+#include "td/utils/tests.h"
+
+static td::td_api::object_ptr<td::td_api::file> get_file_object(td::int32 file_id) {
+  return td::td_api::make_object<td::td_api::file>(
+      file_id, 123456, 123456, td::td_api::make_object<td::td_api::localFile>("", true, true, false, false, 0, 0, 0),
+      td::td_api::make_object<td::td_api::remoteFile>("remote", "unique", false, true, 123456));
+}
+
+static td::td_api::object_ptr<td::td_api::user> get_user_object(td::int64 user_id, td::string first_name,
+                                                                td::int32 photo_file_id = 0) {
+  auto user = td::td_api::make_object<td::td_api::user>();
+  user->id_ = user_id;
+  user->first_name_ = std::move(first_name);
+  user->type_ = td::td_api::make_object<td::td_api::userTypeRegular>();
+  if (photo_file_id != 0) {
+    user->profile_photo_ = td::td_api::make_object<td::td_api::profilePhoto>(
+        1, get_file_object(photo_file_id), get_file_object(photo_file_id + 1), nullptr, false, false);
+  }
+  return user;
+}
+
+static td::td_api::object_ptr<td::td_api::message> get_message_object(td::int64 chat_id, td::int64 message_id) {
+  auto message = td::td_api::make_object<td::td_api::message>();
+  message->id_ = message_id;
+  message->chat_id_ = chat_id;
+  message->content_ = td::td_api::make_object<td::td_api::messageText>(
+      td::td_api::make_object<td::td_api::formattedText>("text", td::Auto()), nullptr, nullptr);
+  return message;
+}
+
+static td::string get_cached_object(td::ObjectSnapshotCache &cache, const td::td_api::Function &request) {
+  auto object = cache.get_object(request);
+  if (object == nullptr) {
+    return td::string();
+  }
+  return to_string(object);
+}
+
+static void send_update(td::ObjectSnapshotCache &cache, const td::td_api::Update &update) {
+  cache.on_update(update);
+  cache.on_object_sent();
+}
+
+static void send_result(td::ObjectSnapshotCache &cache, td::uint64 id, const td::td_api::Object &object) {
+  cache.on_result(id, object);
+  cache.on_object_sent();
+}
+
+static void authorize(td::ObjectSnapshotCache &cache) {
+  cache.set_is_enabled(true);
+  send_update(cache,
+              td::td_api::updateAuthorizationState(td::td_api::make_object<td::td_api::authorizationStateReady>()));
+}
+
+TEST(ObjectSnapshotCache, copy_object) {
+  auto user = get_user_object(1, "First", 10);
+  auto copy = td::td_api::copy_object(*user);
+  ASSERT_TRUE(copy.get() != user.get());
+  ASSERT_TRUE(copy->profile_photo_->small_.get() != user->profile_photo_->small_.get());
+  ASSERT_EQ(to_string(user), to_string(copy));
+
+  td::vector<td::int32> file_ids;
+  td::td_api::for_each_nested_object(*user, [&](const td::td_api::Object &object) {
+    if (object.get_id() == td::td_api::file::ID) {
+      file_ids.push_back(static_cast<const td::td_api::file &>(object).id_);
+    }
+  });
+  ASSERT_EQ(2u, file_ids.size());
+  ASSERT_EQ(10, file_ids[0]);
+  ASSERT_EQ(11, file_ids[1]);
+}
+
+TEST(ObjectSnapshotCache, users) {
+  td::ObjectSnapshotCache cache;
+  td::td_api::getUser get_user(1);
+  ASSERT_TRUE(td::ObjectSnapshotCache::is_cacheable_request(get_user));
+  ASSERT_TRUE(!td::ObjectSnapshotCache::is_cacheable_request(td::td_api::getMe()));
+
+  send_update(cache, td::td_api::updateUser(get_user_object(1, "First")));
+  ASSERT_TRUE(get_cached_object(cache, get_user).empty());
+
+  authorize(cache);
+  send_update(cache, td::td_api::updateUser(get_user_object(1, "First", 10)));
+  ASSERT_EQ(to_string(get_user_object(1, "First", 10)), get_cached_object(cache, get_user));
+
+  send_update(cache, td::td_api::updateUser(get_user_object(1, "Second", 10)));
+  ASSERT_EQ(to_string(get_user_object(1, "Second", 10)), get_cached_object(cache, get_user));
+
+  // the profile photo has changed
+  send_update(cache, td::td_api::updateFile(get_file_object(11)));
+  ASSERT_TRUE(get_cached_object(cache, get_user).empty());
+  ASSERT_EQ(to_string(get_file_object(11)), get_cached_object(cache, td::td_api::getFile(11)));
+
+  // the user is received through a request
+  cache.on_request(5, get_user);
+  send_result(cache, 5, *get_user_object(1, "Third"));
+  ASSERT_EQ(to_string(get_user_object(1, "Third")), get_cached_object(cache, get_user));
+
+  send_update(cache, td::td_api::updateUserStatus(1, td::td_api::make_object<td::td_api::userStatusEmpty>()));
+  ASSERT_TRUE(get_cached_object(cache, get_user).empty());
+
+  send_update(cache, td::td_api::updateUser(get_user_object(1, "First")));
+  send_update(cache,
+              td::td_api::updateAuthorizationState(td::td_api::make_object<td::td_api::authorizationStateClosing>()));
+  ASSERT_TRUE(get_cached_object(cache, get_user).empty());
+  ASSERT_EQ(0u, cache.get_stats().object_count);
+}
+
+TEST(ObjectSnapshotCache, messages) {
+  td::ObjectSnapshotCache cache;
+  authorize(cache);
+
+  td::td_api::getMessage get_message(100, 5);
+  td::td_api::getMessage get_other_message(200, 5);
+  send_update(cache, td::td_api::updateNewMessage(get_message_object(100, 5)));
+  send_update(cache, td::td_api::updateNewMessage(get_message_object(200, 5)));
+  ASSERT_EQ(to_string(get_message_object(100, 5)), get_cached_object(cache, get_message));
+
+  // an unsuccessful request doesn't change the cache
+  cache.on_request(6, get_message);
+  cache.on_error(6);
+  ASSERT_EQ(to_string(get_message_object(100, 5)), get_cached_object(cache, get_message));
+
+  // any update about the chat invalidates its messages
+  send_update(cache, td::td_api::updateMessageContentOpened(100, 5));
+  ASSERT_TRUE(get_cached_object(cache, get_message).empty());
+  ASSERT_TRUE(!get_cached_object(cache, get_other_message).empty());
+
+  cache.on_request(7, get_message);
+  send_result(cache, 7, *get_message_object(100, 6));
+  ASSERT_TRUE(get_cached_object(cache, get_message).empty());
+
+  cache.on_request(8, get_message);
+  send_result(cache, 8, *get_message_object(100, 5));
+  ASSERT_EQ(to_string(get_message_object(100, 5)), get_cached_object(cache, get_message));
+
+  cache.set_is_enabled(false);
+  ASSERT_TRUE(get_cached_object(cache, get_message).empty());
+  ASSERT_TRUE(get_cached_object(cache, get_other_message).empty());
+
+  auto stats = cache.get_stats();
+  ASSERT_EQ(0u, stats.object_count);
+  ASSERT_TRUE(stats.hit_count > 0);
+  ASSERT_TRUE(stats.miss_count > 0);
+}
+
+TEST(ObjectSnapshotCache, publish_after_send) {
+  td::ObjectSnapshotCache cache;
+  authorize(cache);
+
+  td::td_api::getUser get_user(1);
+  cache.on_update(td::td_api::updateUser(get_user_object(1, "First")));
+  // the client hasn't received the update yet
+  ASSERT_TRUE(get_cached_object(cache, get_user).empty());
+  cache.on_object_sent();
+  ASSERT_EQ(to_string(get_user_object(1, "First")), get_cached_object(cache, get_user));
+
+  cache.on_update(td::td_api::updateUser(get_user_object(1, "Second")));
+  // the previous snapshot is still consistent with what the client knows
+  ASSERT_EQ(to_string(get_user_object(1, "First")), get_cached_object(cache, get_user));
+  cache.on_object_sent();
+  ASSERT_EQ(to_string(get_user_object(1, "Second")), get_cached_object(cache, get_user));
+
+  cache.on_request(5, td::td_api::getUser(2));
+  cache.on_result(5, *get_user_object(2, "Third"));
+  ASSERT_TRUE(get_cached_object(cache, td::td_api::getUser(2)).empty());
+  cache.on_object_sent();
+  ASSERT_EQ(to_string(get_user_object(2, "Third")), get_cached_object(cache, td::td_api::getUser(2)));
+}
+
+TEST(ObjectSnapshotCache, pending_requests) {
+  td::ObjectSnapshotCache cache;
+  authorize(cache);
+
+  td::td_api::getUser get_user(1);
+  send_update(cache, td::td_api::updateUser(get_user_object(1, "First")));
+  ASSERT_EQ(to_string(get_user_object(1, "First")), get_cached_object(cache, get_user));
+
+  // a request, which can change the user, is sent before the getter
+  cache.on_request_sent();
+  cache.on_request(5, td::td_api::setName("Second", td::string()));
+  ASSERT_TRUE(get_cached_object(cache, get_user).empty());
+
+  send_update(cache, td::td_api::updateUser(get_user_object(1, "Second")));
+  ASSERT_TRUE(get_cached_object(cache, get_user).empty());
+
+  cache.on_result(5, td::td_api::ok());
+  cache.on_response_sent();
+  cache.on_object_sent();
+  ASSERT_EQ(to_string(get_user_object(1, "Second")), get_cached_object(cache, get_user));
+}
+
+TEST(ObjectSnapshotCache, time_dependent_message_fields) {
+  td::ObjectSnapshotCache cache;
+  authorize(cache);
+
+  td::td_api::getMessage get_message(100, 5);
+  send_update(cache, td::td_api::updateNewMessage(get_message_object(100, 5)));
+  ASSERT_TRUE(!get_cached_object(cache, get_message).empty());
+
+  // the message can be edited only for some time, so it must not be cached
+  auto message = get_message_object(100, 5);
+  message->can_be_edited_ = true;
+  send_update(cache, td::td_api::updateNewMessage(std::move(message)));
+  ASSERT_TRUE(get_cached_object(cache, get_message).empty());
+
+  message = get_message_object(100, 5);
+  message->can_get_read_date_ = true;
+  send_update(cache, td::td_api::updateNewMessage(std::move(message)));
+  ASSERT_TRUE(get_cached_object(cache, get_message).empty());
+
+  // timers are counted from the time when the snapshot was created
+  message = get_message_object(100, 5);
+  message->self_destruct_in_ = 1000.0;
+  message->auto_delete_in_ = 2000.0;
+  send_update(cache, td::td_api::updateNewMessage(std::move(message)));
+  auto cached_message = cache.get_object(get_message);
+  ASSERT_TRUE(cached_message != nullptr);
+  const auto &cached = static_cast<const td::td_api::message &>(*cached_message);
+  ASSERT_TRUE(cached.self_destruct_in_ > 0.0 && cached.self_destruct_in_ <= 1000.0);
+  ASSERT_TRUE(cached.auto_delete_in_ > 1000.0 && cached.auto_delete_in_ <= 2000.0);
+
+  message = get_message_object(100, 5);
+  message->self_destruct_in_ = 1e-9;
+  send_update(cache, td::td_api::updateNewMessage(std::move(message)));
+  ASSERT_TRUE(get_cached_object(cache, get_message).empty());
+}
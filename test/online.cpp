@@ -458,7 +458,7 @@ class TestDownloadFile : public Task {
   void start_chunk() {
     send_query(td::make_tl_object<td::td_api::downloadFile>(
                    file_id_, 1, static_cast<int64>(ranges_.back().begin),
-                   static_cast<int64>(ranges_.back().end - ranges_.back().begin), true),
+                   static_cast<int64>(ranges_.back().end - ranges_.back().begin), false, true),
                [this](td::Result<td::td_api::object_ptr<td::td_api::file>> res) { on_get_chunk(*res.ok()); });
   }
 };
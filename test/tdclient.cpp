@@ -8,14 +8,32 @@
 
 #include "td/telegram/Client.h"
 #include "td/telegram/ClientActor.h"
+#include "td/telegram/DialogId.h"
+#include "td/telegram/files/FileBitmask.h"
+#include "td/telegram/files/FileDownloader.h"
+#include "td/telegram/files/FileEncryptionKey.h"
+#include "td/telegram/files/FileLoaderActor.h"
+#include "td/telegram/files/FileId.h"
+#include "td/telegram/files/FileLocation.h"
+#include "td/telegram/files/FileManager.h"
+#include "td/telegram/files/FileType.h"
 #include "td/telegram/files/PartsManager.h"
+#include "td/telegram/files/ResourceState.h"
+#include "td/telegram/files/StreamingReadAhead.h"
+#include "td/telegram/Global.h"
+#include "td/telegram/net/DcId.h"
+#include "td/telegram/net/NetQuery.h"
+#include "td/telegram/net/NetQueryStats.h"
 #include "td/telegram/td_api.h"
+#include "td/telegram/telegram_api.h"
 
 #include "td/actor/actor.h"
 #include "td/actor/ConcurrentScheduler.h"
 #include "td/actor/PromiseFuture.h"
 
+#include "td/utils/as.h"
 #include "td/utils/base64.h"
+#include "td/utils/buffer.h"
 #include "td/utils/BufferedFd.h"
 #include "td/utils/common.h"
 #include "td/utils/filesystem.h"
@@ -31,7 +49,9 @@
 #include "td/utils/Slice.h"
 #include "td/utils/SliceBuilder.h"
 #include "td/utils/Status.h"
+#include "td/utils/StringBuilder.h"
 #include "td/utils/tests.h"
+#include "td/utils/tl_storers.h"
 
 #include <atomic>
 #include <cstdio>
@@ -631,7 +651,7 @@ class CheckTestC final : public TestClinetTask {
         if (text.substr(0, tag_.size()) == tag_) {
           file_id_to_check_ = messageDocument->document_->document_->id_;
           LOG(ERROR) << "Receive file " << to_string(messageDocument->document_->document_);
-          send_query(td::make_tl_object<td::td_api::downloadFile>(file_id_to_check_, 1, 0, 0, false),
+          send_query(td::make_tl_object<td::td_api::downloadFile>(file_id_to_check_, 1, 0, 0, false, false),
                      [](auto res) { check_td_error(res); });
         }
       }
@@ -1190,3 +1210,325 @@ TEST(PartsManager, hands) {
     pm.init(1, 100000, true, 10, {0, 1, 2}, false, true).ensure_error();
   }
 }
+
+namespace {
+
+struct PlaybackStats {
+  int stall_count = 0;
+  double stall_time = 0.0;
+  double startup_time = 0.0;
+  int download_count = 0;
+  int downloaded_part_count = 0;
+};
+
+td::StringBuilder &operator<<(td::StringBuilder &string_builder, const PlaybackStats &stats) {
+  return string_builder << td::tag("stall_count", stats.stall_count) << td::tag("stall_time", stats.stall_time)
+                        << td::tag("startup_time", stats.startup_time) << td::tag("download_count", stats.download_count)
+                        << td::tag("downloaded_part_count", stats.downloaded_part_count);
+}
+
+// simulates a player, which reads a video with a constant bitrate and repeatedly calls downloadFile
+// with its current offset, over a network, which periodically becomes slower than the bitrate;
+// the player either sets a fixed limit or leaves the limit to the read-ahead, like FileNode::get_download_limit does
+PlaybackStats simulate_playback(bool use_read_ahead) {
+  constexpr td::int64 FILE_SIZE = 48 << 20;
+  constexpr size_t PART_SIZE = 512 << 10;
+  constexpr int PART_COUNT = static_cast<int>(FILE_SIZE / PART_SIZE);
+  constexpr double READ_RATE = 1 << 20;
+  constexpr double FAST_DOWNLOAD_RATE = 3 << 20;
+  constexpr double SLOW_DOWNLOAD_RATE = 256 << 10;
+  constexpr td::int64 REQUESTED_LIMIT = 1 << 20;
+  constexpr double REQUEST_PERIOD = 0.5;
+  constexpr double DOWNLOAD_START_DELAY = 0.3;
+  constexpr double STEP = 0.01;
+
+  PlaybackStats stats;
+  std::vector<bool> is_part_ready(PART_COUNT, false);
+  std::vector<int> ready_parts;
+  td::int64 ready_size = 0;
+  auto is_range_ready = [&](td::int64 begin, td::int64 limit) {
+    auto end = limit == 0 ? FILE_SIZE : td::min(begin + limit, FILE_SIZE);
+    for (auto part_id = begin / static_cast<td::int64>(PART_SIZE); part_id * static_cast<td::int64>(PART_SIZE) < end;
+         part_id++) {
+      if (!is_part_ready[static_cast<size_t>(part_id)]) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  td::StreamingReadAhead read_ahead;
+  td::PartsManager parts_manager;
+  bool is_downloading = false;
+  double download_start_time = -1.0;
+  td::Part pending_part{0, 0, 0};
+  double pending_part_left_size = 0.0;
+
+  td::int64 read_offset = 0;
+  td::int64 requested_offset = 0;
+  td::int64 requested_limit = 0;
+  bool is_stalled = false;
+  double next_request_time = 0.0;
+  for (double now = 0.0; read_offset < FILE_SIZE; now += STEP) {
+    CHECK(now < 1000.0);
+    if (now >= next_request_time) {
+      next_request_time += REQUEST_PERIOD;
+      requested_offset = read_offset;
+      read_ahead.on_read_offset(read_offset, now);
+      requested_limit = read_ahead.get_download_limit(requested_offset, use_read_ahead ? 0 : REQUESTED_LIMIT);
+      if (is_downloading) {
+        parts_manager.set_streaming_offset(requested_offset, requested_limit);
+      } else if (download_start_time < 0 && !is_range_ready(requested_offset, requested_limit)) {
+        download_start_time = now + DOWNLOAD_START_DELAY;
+      }
+    }
+
+    if (!is_downloading && download_start_time >= 0 && now >= download_start_time) {
+      parts_manager = td::PartsManager();
+      parts_manager.init(FILE_SIZE, FILE_SIZE, true, PART_SIZE, ready_parts, false, false).ensure();
+      parts_manager.set_streaming_offset(requested_offset, requested_limit);
+      read_ahead.on_download_start(ready_size, now);
+      is_downloading = true;
+      download_start_time = -1.0;
+      stats.download_count++;
+    }
+    if (is_downloading && pending_part.size == 0) {
+      if (parts_manager.may_finish()) {
+        is_downloading = false;
+      } else {
+        pending_part = parts_manager.start_part().move_as_ok();
+        CHECK(pending_part.size != 0);
+        pending_part_left_size = static_cast<double>(pending_part.size);
+      }
+    }
+    if (pending_part.size != 0) {
+      auto download_rate = static_cast<int>(now) % 20 < 15 ? FAST_DOWNLOAD_RATE : SLOW_DOWNLOAD_RATE;
+      pending_part_left_size -= download_rate * STEP;
+      if (pending_part_left_size <= 0) {
+        // already downloaded parts must never be downloaded again
+        CHECK(!is_part_ready[pending_part.id]);
+        is_part_ready[pending_part.id] = true;
+        ready_parts.push_back(pending_part.id);
+        ready_size += static_cast<td::int64>(pending_part.size);
+        stats.downloaded_part_count++;
+        parts_manager.on_part_ok(pending_part.id, pending_part.size, pending_part.size).ensure();
+        read_ahead.on_download_progress(ready_size, now);
+        pending_part = td::Part{0, 0, 0};
+      }
+    }
+
+    auto next_read_offset = td::min(FILE_SIZE, read_offset + static_cast<td::int64>(READ_RATE * STEP));
+    if (is_range_ready(read_offset, next_read_offset - read_offset)) {
+      read_offset = next_read_offset;
+      is_stalled = false;
+    } else if (read_offset == 0) {
+      stats.startup_time += STEP;
+    } else {
+      if (!is_stalled) {
+        is_stalled = true;
+        stats.stall_count++;
+      }
+      stats.stall_time += STEP;
+    }
+  }
+  CHECK(stats.downloaded_part_count == PART_COUNT);
+  return stats;
+}
+
+}  // namespace
+
+TEST(PartsManager, streaming_playback) {
+  auto fixed_window_stats = simulate_playback(false);
+  auto read_ahead_stats = simulate_playback(true);
+  LOG(INFO) << "Playback with fixed window: " << fixed_window_stats;
+  LOG(INFO) << "Playback with read-ahead: " << read_ahead_stats;
+  ASSERT_TRUE(fixed_window_stats.stall_count > 0);
+  ASSERT_TRUE(read_ahead_stats.stall_count < fixed_window_stats.stall_count);
+  ASSERT_TRUE(read_ahead_stats.stall_time < fixed_window_stats.stall_time);
+}
+
+TEST(StreamingReadAhead, download_limit) {
+  constexpr td::int64 CLIENT_LIMIT = 1 << 20;
+  td::StreamingReadAhead read_ahead;
+  ASSERT_EQ(0, read_ahead.get_download_limit(0, 0));
+  ASSERT_EQ(CLIENT_LIMIT, read_ahead.get_download_limit(0, CLIENT_LIMIT));
+
+  read_ahead.on_read_offset(0, 0.0);
+  read_ahead.on_read_offset(4 << 20, 1.0);
+  auto read_ahead_size = read_ahead.get_read_ahead_size();
+  ASSERT_TRUE(read_ahead_size > CLIENT_LIMIT);
+
+  // an explicit limit must never be changed
+  ASSERT_EQ(CLIENT_LIMIT, read_ahead.get_download_limit(0, CLIENT_LIMIT));
+  ASSERT_EQ(CLIENT_LIMIT, read_ahead.get_download_limit(4 << 20, CLIENT_LIMIT));
+
+  // without a limit the download covers the read-ahead window after the read offset
+  ASSERT_EQ(read_ahead_size, read_ahead.get_download_limit(4 << 20, 0));
+  ASSERT_EQ((4 << 20) + read_ahead_size, read_ahead.get_download_limit(0, 0));
+  ASSERT_EQ(read_ahead_size, read_ahead.get_download_limit(8 << 20, 0));
+}
+
+TEST(FileNode, read_ahead) {
+  constexpr td::int64 FILE_SIZE = 256 << 20;
+  td::FileNode node(td::LocalFileLocation(), td::NewRemoteFileLocation(), nullptr, FILE_SIZE, 0, "", "",
+                    td::DialogId(), td::FileEncryptionKey(), td::FileId(1, 0), 0);
+  auto read_file = [&node](td::int64 first_offset, td::int64 second_offset) {
+    node.on_read_offset(first_offset);
+    // the read rate is sampled at most twice per second
+    td::usleep_for(600000);
+    node.on_read_offset(second_offset);
+  };
+
+  // a download without a limit must never be limited, even if the client reads the beginning of the file
+  node.set_download_offset(0);
+  node.set_download_limit(0);
+  read_file(0, 1 << 20);
+  ASSERT_EQ(0, node.get_download_limit());
+  ASSERT_TRUE(!node.is_download_limited_by_read_ahead());
+
+  // the download is limited by the read-ahead window only if the client has asked for it
+  node.set_use_read_ahead(true);
+  read_file(2 << 20, 4 << 20);
+  ASSERT_TRUE(node.is_download_limited_by_read_ahead());
+  ASSERT_TRUE(node.get_download_limit() >= (4 << 20) + td::StreamingReadAhead::MIN_READ_AHEAD_SIZE);
+  ASSERT_TRUE(node.get_download_limit() < FILE_SIZE);
+
+  node.set_use_read_ahead(false);
+  ASSERT_EQ(0, node.get_download_limit());
+  ASSERT_TRUE(!node.is_download_limited_by_read_ahead());
+}
+
+class FileDownloaderLimitTest final : public td::Actor {
+ public:
+  static constexpr td::int32 PART_SIZE = 128 << 10;
+  static constexpr td::int64 WINDOW_SIZE = 8 * PART_SIZE;
+  static constexpr td::int64 FILE_SIZE = 4 * WINDOW_SIZE;
+  // the last window isn't downloaded, because a finished download is moved to the files directory of a Td instance
+  static constexpr td::int64 DOWNLOADED_SIZE = 3 * WINDOW_SIZE;
+
+  static td::string get_part_data(td::int64 offset, size_t size) {
+    td::string data(size, '\0');
+    for (size_t i = 0; i < size; i++) {
+      data[i] = static_cast<char>((offset + static_cast<td::int64>(i)) * 7 % 251);
+    }
+    return data;
+  }
+
+ private:
+  class Callback final : public td::FileDownloader::Callback {
+   public:
+    explicit Callback(td::ActorId<FileDownloaderLimitTest> parent) : parent_(std::move(parent)) {
+    }
+
+    void send_query(td::NetQueryPtr query, td::ActorShared<td::NetQueryCallback> callback) final {
+      send_closure(parent_, &FileDownloaderLimitTest::on_query, std::move(query), std::move(callback));
+    }
+
+    void on_start_download() final {
+    }
+
+    void on_partial_download(td::PartialLocalFileLocation partial_local, td::int64 ready_size, td::int64 size) final {
+      send_closure(parent_, &FileDownloaderLimitTest::on_partial_download, std::move(partial_local));
+    }
+
+    void on_ok(td::FullLocalFileLocation full_local, td::int64 size, bool is_new) final {
+      UNREACHABLE();
+    }
+
+    void on_error(td::Status status) final {
+      send_closure(parent_, &FileDownloaderLimitTest::on_error, std::move(status));
+    }
+
+   private:
+    td::ActorId<FileDownloaderLimitTest> parent_;
+  };
+
+  td::string path_ = "download_limit_test";
+  td::PartialLocalFileLocation partial_;
+  td::int64 window_offset_ = 0;
+  td::int64 downloaded_size_ = 0;
+  td::ActorOwn<td::FileDownloader> downloader_;
+
+  void start_up() final {
+    set_context(std::make_shared<td::Global>());
+    td::G()->set_net_query_stats(std::make_shared<td::NetQueryStats>());
+
+    td::unlink(path_).ignore();
+    td::FileFd::open(path_, td::FileFd::Create | td::FileFd::Write).move_as_ok().close();
+    partial_ = td::PartialLocalFileLocation{td::FileType::Document, PART_SIZE, path_, "", td::Bitmask().encode()};
+    start_download();
+  }
+
+  void start_download() {
+    td::FullRemoteFileLocation remote(td::FileType::Document, 1, 2, td::DcId::internal(2), "");
+    downloader_ = td::create_actor<td::FileDownloader>(
+        "FileDownloader", remote, td::LocalFileLocation(partial_), FILE_SIZE, "test", td::FileEncryptionKey(), true,
+        false, window_offset_, WINDOW_SIZE, td::make_unique<Callback>(actor_id(this)));
+    td::ResourceState resource_state;
+    resource_state.update_limit(FILE_SIZE);
+    send_closure(downloader_, &td::FileLoaderActor::update_resources, resource_state);
+  }
+
+  void on_query(td::NetQueryPtr query, td::ActorShared<td::NetQueryCallback> callback) {
+    // upload.getFile ends with the offset and the limit of the part
+    auto request = query->query().as_slice();
+    auto offset = td::as<td::int64>(request.end() - 12);
+    auto limit = td::as<td::int32>(request.end() - 4);
+    // parts of the previous windows must never be downloaded again
+    ASSERT_TRUE(offset >= window_offset_);
+    ASSERT_TRUE(offset < window_offset_ + WINDOW_SIZE);
+    downloaded_size_ += limit;
+
+    auto data = get_part_data(offset, static_cast<size_t>(limit));
+    auto store_answer = [&](auto &storer) {
+      storer.store_binary(td::telegram_api::upload_file::ID);
+      storer.store_binary(td::telegram_api::storage_fileUnknown::ID);
+      storer.store_binary(static_cast<td::int32>(0));
+      storer.store_string(data);
+    };
+    td::TlStorerCalcLength calc_length;
+    store_answer(calc_length);
+    td::BufferSlice answer(calc_length.get_length());
+    td::TlStorerUnsafe storer(answer.as_mutable_slice().ubegin());
+    store_answer(storer);
+    query->set_ok(std::move(answer));
+    send_closure(std::move(callback), &td::NetQueryCallback::on_result, std::move(query));
+  }
+
+  void on_partial_download(td::PartialLocalFileLocation partial_local) {
+    partial_ = std::move(partial_local);
+  }
+
+  void on_error(td::Status status) {
+    ASSERT_EQ("FILE_DOWNLOAD_LIMIT", status.message());
+    // all downloaded parts must be written and reported before the error
+    auto window_end = window_offset_ + WINDOW_SIZE;
+    ASSERT_EQ(window_end,
+              td::Bitmask(td::Bitmask::Decode{}, partial_.ready_bitmask_).get_ready_prefix_size(0, PART_SIZE, FILE_SIZE));
+
+    downloader_.reset();
+    window_offset_ = window_end;
+    if (window_offset_ < DOWNLOADED_SIZE) {
+      return start_download();
+    }
+
+    ASSERT_EQ(DOWNLOADED_SIZE, downloaded_size_);
+    auto content = td::read_file_str(path_).move_as_ok();
+    ASSERT_EQ(get_part_data(0, static_cast<size_t>(DOWNLOADED_SIZE)), content.substr(0, static_cast<size_t>(DOWNLOADED_SIZE)));
+    td::unlink(path_).ignore();
+    stop();
+  }
+
+  void tear_down() final {
+    td::Scheduler::instance()->finish();
+  }
+};
+
+TEST(FileDownloader, download_limit) {
+  td::ConcurrentScheduler sched(0, 0);
+  sched.create_actor_unsafe<FileDownloaderLimitTest>(0, "FileDownloaderLimitTest").release();
+  sched.start();
+  while (sched.run_main(10)) {
+  }
+  sched.finish();
+}
@@ -11,8 +11,12 @@
 
 #include "td/utils/buffer.h"
 #include "td/utils/common.h"
+#include "td/utils/filesystem.h"
 #include "td/utils/int_types.h"
 #include "td/utils/logging.h"
+#include "td/utils/PathView.h"
+#include "td/utils/port/path.h"
+#include "td/utils/port/thread.h"
 #include "td/utils/Random.h"
 #include "td/utils/Slice.h"
 #include "td/utils/SliceBuilder.h"
@@ -20,6 +24,7 @@
 #include "td/utils/tests.h"
 #include "td/utils/Time.h"
 
+#include <algorithm>
 #include <memory>
 #include <utility>
 
@@ -51,9 +56,15 @@ class TestTQueue {
     return td::CSlice("tqueue_binlog");
   }
 
+  static td::CSlice segment_storage_path() {
+    return td::CSlice("tqueue_segments");
+  }
+
   TestTQueue() {
     baseline_ = td::TQueue::create();
 
+    concurrent_ = td::TQueue::create_concurrent(3);
+
     memory_ = td::TQueue::create();
     auto memory_storage = td::make_unique<td::TQueueMemoryStorage>();
     memory_storage_ = memory_storage.get();
@@ -66,6 +77,9 @@ class TestTQueue {
     binlog->init(binlog_path().str(), [&](const td::BinlogEvent &event) { UNREACHABLE(); }).ensure();
     tqueue_binlog->set_binlog(std::move(binlog));
     binlog_->set_callback(std::move(tqueue_binlog));
+
+    td::TQueueSegmentStorage::destroy(segment_storage_path()).ignore();
+    restart_segment_storage();
   }
 
   TestTQueue(const TestTQueue &) = delete;
@@ -75,11 +89,22 @@ class TestTQueue {
 
   ~TestTQueue() {
     td::Binlog::destroy(binlog_path()).ensure();
+    segment_storage_ = nullptr;
+    td::TQueueSegmentStorage::destroy(segment_storage_path()).ensure();
+  }
+
+  void restart_segment_storage() {
+    segment_storage_ = nullptr;
+    segment_storage_ = td::TQueue::create();
+    auto storage = td::make_unique<td::TQueueSegmentStorage>();
+    storage->init(segment_storage_path().str(), *segment_storage_, 1 << 12).ensure();
+    segment_storage_->set_callback(std::move(storage));
   }
 
   void restart(td::Random::Xorshift128plus &rnd, td::int32 now) {
     if (rnd.fast(0, 10) == 0) {
       baseline_->run_gc(now);
+      concurrent_->run_gc(now);
     }
 
     memory_->extract_callback().release();
@@ -95,7 +120,9 @@ class TestTQueue {
       return;
     }
 
-    LOG(INFO) << "Restart binlog";
+    LOG(INFO) << "Restart binlog and segment storage";
+    restart_segment_storage();
+
     binlog_ = td::TQueue::create();
     auto tqueue_binlog = td::make_unique<td::TQueueBinlog<td::Binlog>>();
     auto binlog = std::make_shared<td::Binlog>();
@@ -114,8 +141,12 @@ class TestTQueue {
     auto a_id = baseline_->push(queue_id, data, expires_at, 0, new_id).move_as_ok();
     auto b_id = memory_->push(queue_id, data, expires_at, 0, new_id).move_as_ok();
     auto c_id = binlog_->push(queue_id, data, expires_at, 0, new_id).move_as_ok();
+    auto d_id = concurrent_->push(queue_id, data, expires_at, 0, new_id).move_as_ok();
+    auto e_id = segment_storage_->push(queue_id, data, expires_at, 0, new_id).move_as_ok();
     ASSERT_EQ(a_id, b_id);
     ASSERT_EQ(a_id, c_id);
+    ASSERT_EQ(a_id, d_id);
+    ASSERT_EQ(a_id, e_id);
     return a_id;
   }
 
@@ -124,6 +155,10 @@ class TestTQueue {
     //ASSERT_EQ(baseline_->get_head(qid), binlog_->get_head(qid));
     ASSERT_EQ(baseline_->get_tail(qid), memory_->get_tail(qid));
     ASSERT_EQ(baseline_->get_tail(qid), binlog_->get_tail(qid));
+    ASSERT_EQ(baseline_->get_tail(qid), segment_storage_->get_tail(qid));
+    ASSERT_EQ(baseline_->get_head(qid), concurrent_->get_head(qid));
+    ASSERT_EQ(baseline_->get_tail(qid), concurrent_->get_tail(qid));
+    ASSERT_EQ(baseline_->get_size(qid), concurrent_->get_size(qid));
   }
 
   void check_get(td::TQueue::QueueId qid, td::Random::Xorshift128plus &rnd, td::int32 now) {
@@ -133,6 +168,10 @@ class TestTQueue {
     td::MutableSpan<td::TQueue::Event> b_span(b, 10);
     td::TQueue::Event c[10];
     td::MutableSpan<td::TQueue::Event> c_span(c, 10);
+    td::TQueue::Event d[10];
+    td::MutableSpan<td::TQueue::Event> d_span(d, 10);
+    td::TQueue::Event e[10];
+    td::MutableSpan<td::TQueue::Event> e_span(e, 10);
 
     auto a_from = baseline_->get_head(qid);
     //auto b_from = memory_->get_head(qid);
@@ -147,13 +186,21 @@ class TestTQueue {
     baseline_->get(qid, a_from, true, now, a_span).move_as_ok();
     memory_->get(qid, a_from, true, now, b_span).move_as_ok();
     binlog_->get(qid, a_from, true, now, c_span).move_as_ok();
+    concurrent_->get(qid, a_from, true, now, d_span).move_as_ok();
+    segment_storage_->get(qid, a_from, true, now, e_span).move_as_ok();
     ASSERT_EQ(a_span.size(), b_span.size());
     ASSERT_EQ(a_span.size(), c_span.size());
+    ASSERT_EQ(a_span.size(), d_span.size());
+    ASSERT_EQ(a_span.size(), e_span.size());
     for (size_t i = 0; i < a_span.size(); i++) {
       ASSERT_EQ(a_span[i].id, b_span[i].id);
       ASSERT_EQ(a_span[i].id, c_span[i].id);
+      ASSERT_EQ(a_span[i].id, d_span[i].id);
+      ASSERT_EQ(a_span[i].id, e_span[i].id);
       ASSERT_EQ(a_span[i].data, b_span[i].data);
       ASSERT_EQ(a_span[i].data, c_span[i].data);
+      ASSERT_EQ(a_span[i].data, d_span[i].data);
+      ASSERT_EQ(a_span[i].data, e_span[i].data);
     }
   }
 
@@ -161,6 +208,8 @@ class TestTQueue {
   td::unique_ptr<td::TQueue> baseline_;
   td::unique_ptr<td::TQueue> memory_;
   td::unique_ptr<td::TQueue> binlog_;
+  td::unique_ptr<td::TQueue> concurrent_;
+  td::unique_ptr<td::TQueue> segment_storage_;
   td::TQueueMemoryStorage *memory_storage_{nullptr};
 };
 
@@ -258,3 +307,170 @@ TEST(TQueue, clear) {
   CHECK(tqueue->get_tail(1) == tail_id);
   CHECK(deleted_events.size() == 100000 - keep_count);
 }
+
+TEST(TQueue, segment_storage) {
+  td::CSlice path("tqueue_segment_storage");
+  td::TQueueSegmentStorage::destroy(path).ignore();
+
+  auto tqueue = td::TQueue::create();
+  auto storage = td::make_unique<td::TQueueSegmentStorage>();
+  auto storage_ptr = storage.get();
+  storage->init(path.str(), *tqueue, 1 << 12).ensure();
+  tqueue->set_callback(std::move(storage));
+
+  td::vector<td::TQueue::EventId> ids;
+  for (int i = 0; i < 10000; i++) {
+    ids.push_back(tqueue->push(i % 10 + 1, td::string(100, 'a'), 1000, 0, {}).move_as_ok());
+  }
+  ASSERT_TRUE(storage_ptr->get_segment_count() > 100);
+  for (int i = 0; i < 10000; i++) {
+    if (i % 10 != 0) {
+      tqueue->forget(i % 10 + 1, ids[i]);
+    }
+  }
+  for (int i = 0; i < 9990; i++) {
+    if (i % 10 == 0) {
+      tqueue->forget(i % 10 + 1, ids[i]);
+    }
+  }
+  // only the last events of the queues are kept
+  storage_ptr->flush();
+  ASSERT_TRUE(storage_ptr->get_segment_count() < 10);
+  tqueue = nullptr;
+
+  tqueue = td::TQueue::create();
+  storage = td::make_unique<td::TQueueSegmentStorage>();
+  storage->init(path.str(), *tqueue, 1 << 12).ensure();
+  tqueue->set_callback(std::move(storage));
+  for (int i = 1; i <= 10; i++) {
+    ASSERT_EQ(i == 1 ? 1u : 0u, tqueue->get_size(i));
+    ASSERT_EQ(ids[9999 - 10 + i].next().ok(), tqueue->get_tail(i));
+  }
+  tqueue = nullptr;
+  td::TQueueSegmentStorage::destroy(path).ensure();
+}
+
+TEST(TQueue, segment_storage_crash) {
+  td::CSlice path("tqueue_segment_storage");
+  td::CSlice crash_path("tqueue_segment_storage_crash");
+  td::TQueueSegmentStorage::destroy(path).ignore();
+  td::TQueueSegmentStorage::destroy(crash_path).ignore();
+
+  auto tqueue = td::TQueue::create();
+  auto storage = td::make_unique<td::TQueueSegmentStorage>();
+  storage->init(path.str(), *tqueue, 1 << 12).ensure();
+  tqueue->set_callback(std::move(storage));
+
+  // the files are copied without flushing the storage, which is the state of the disk after a crash of the process
+  auto copy_segments = [&] {
+    td::TQueueSegmentStorage::destroy(crash_path).ignore();
+    td::mkpath(PSLICE() << crash_path << TD_DIR_SLASH).ensure();
+    td::WalkPath::run(path, [&](td::CSlice file_path, td::WalkPath::Type type) {
+      if (type == td::WalkPath::Type::RegularFile) {
+        td::copy_file(file_path, PSLICE() << crash_path << TD_DIR_SLASH << td::PathView(file_path).file_name())
+            .ensure();
+      }
+    }).ensure();
+  };
+
+  const int QUEUE_COUNT = 3;
+  td::vector<td::TQueue::EventId> crash_tail_ids(QUEUE_COUNT + 1);
+  for (int i = 0; i < 3000; i++) {
+    auto queue_id = i % QUEUE_COUNT + 1;
+    auto event_id = tqueue->push(queue_id, td::string(100, 'a'), 1000, 0, {}).move_as_ok();
+    // only an empty last event is kept in the queue, so the previous segments can be deleted
+    tqueue->forget(queue_id, event_id);
+
+    if (i % 7 == 6) {
+      copy_segments();
+      auto crash_tqueue = td::TQueue::create();
+      auto crash_storage = td::make_unique<td::TQueueSegmentStorage>();
+      crash_storage->init(crash_path.str(), *crash_tqueue, 1 << 12).ensure();
+      for (int j = 1; j <= QUEUE_COUNT; j++) {
+        auto tail_id = crash_tqueue->get_tail(j);
+        // event identifiers must never be reused after a crash
+        ASSERT_TRUE(!(tail_id < crash_tail_ids[j]));
+        ASSERT_TRUE(!(tqueue->get_tail(j) < tail_id));
+        crash_tail_ids[j] = tail_id;
+      }
+    }
+  }
+  tqueue = nullptr;
+  td::TQueueSegmentStorage::destroy(path).ensure();
+  td::TQueueSegmentStorage::destroy(crash_path).ensure();
+}
+
+TEST(TQueue, forget) {
+  auto tqueue = td::TQueue::create();
+  td::vector<td::TQueue::EventId> ids;
+  for (int i = 0; i < 1000; i++) {
+    ids.push_back(tqueue->push(1, PSTRING() << i, 1000, 0, {}).move_as_ok());
+  }
+  td::Random::Xorshift128plus rnd(123);
+  for (int i = 0; i < 100000; i++) {
+    auto pos = static_cast<size_t>(rnd()) % ids.size();
+    tqueue->forget(1, ids[pos]);
+    ids[pos] = tqueue->push(1, PSTRING() << i, 1000, 0, {}).move_as_ok();
+  }
+  ASSERT_EQ(ids.size(), tqueue->get_size(1));
+
+  std::sort(ids.begin(), ids.end());
+  td::TQueue::Event events[100];
+  size_t pos = 0;
+  while (pos < ids.size()) {
+    auto events_span = td::MutableSpan<td::TQueue::Event>(events, 100);
+    tqueue->get(1, ids[pos], false, 0, events_span).ensure();
+    ASSERT_TRUE(!events_span.empty());
+    for (auto &event : events_span) {
+      ASSERT_EQ(ids[pos], event.id);
+      pos++;
+    }
+  }
+}
+
+static void bench_tqueue(td::TQueue &tqueue, td::TQueue::QueueId first_queue_id, int queue_count, int event_count) {
+  td::TQueue::Event events[10];
+  for (int i = 0; i < event_count; i++) {
+    for (int j = 0; j < queue_count; j++) {
+      tqueue.push(first_queue_id + j, "event", 1000, 0, {}).ensure();
+    }
+    if (i % 10 == 9) {
+      for (int j = 0; j < queue_count; j++) {
+        auto events_span = td::MutableSpan<td::TQueue::Event>(events, 10);
+        auto queue_id = first_queue_id + j;
+        tqueue.get(queue_id, tqueue.get_head(queue_id).advance(5).move_as_ok(), true, 0, events_span).ensure();
+      }
+    }
+  }
+}
+
+TEST(TQueue, throughput) {
+  constexpr int QUEUE_COUNT = 10000;
+  constexpr int EVENT_COUNT = 100;
+
+  auto tqueue = td::TQueue::create();
+  auto start_time = td::Time::now();
+  bench_tqueue(*tqueue, 1, QUEUE_COUNT, EVENT_COUNT);
+  LOG(INFO) << "Processed " << QUEUE_COUNT * EVENT_COUNT << " TQueue events in " << td::Time::now() - start_time
+            << " seconds";
+
+#if !TD_THREAD_UNSUPPORTED
+  constexpr int THREAD_COUNT = 4;
+  auto concurrent_tqueue = td::TQueue::create_concurrent(16);
+  start_time = td::Time::now();
+  td::vector<td::thread> threads;
+  for (int i = 0; i < THREAD_COUNT; i++) {
+    threads.emplace_back([&, i] {
+      bench_tqueue(*concurrent_tqueue, 1 + i * QUEUE_COUNT / THREAD_COUNT, QUEUE_COUNT / THREAD_COUNT, EVENT_COUNT);
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  LOG(INFO) << "Processed " << QUEUE_COUNT * EVENT_COUNT << " concurrent TQueue events in " << THREAD_COUNT
+            << " threads in " << td::Time::now() - start_time << " seconds";
+  for (int i = 1; i <= QUEUE_COUNT; i++) {
+    ASSERT_EQ(tqueue->get_size(i), concurrent_tqueue->get_size(i));
+  }
+#endif
+}